@@ -0,0 +1,13 @@
+#version 450
+
+// depth-only проход каскада тени
+
+layout(push_constant) uniform PC {
+  mat4 mvp; // lightViewProj * model
+} pc;
+
+layout(location = 0) in vec3 inPos;
+
+void main() {
+  gl_Position = pc.mvp * vec4(inPos, 1.0);
+}
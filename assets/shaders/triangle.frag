@@ -1,8 +1,88 @@
 #version 450
 
+// Clustered forward: кластер фрагмента = тайл экрана + экспоненциальный срез по глубине,
+// освещение только от источников из списка этого кластера.
+// Солнце: каскадные тени (каскад выбирается по глубине во view space).
+
+struct Light {
+  vec4 posRadius;       // view space
+  vec4 colorIntensity;
+};
+
+layout(set = 0, binding = 0) uniform UBO {
+  mat4 view;
+  mat4 proj;
+  vec4 clusterZ;      // near, far, sliceScale, sliceBias
+  uvec4 clusterDims;  // x, y, z, tileSize
+  mat4 shadowMats[4]; // world -> shadow clip каждого каскада
+  vec4 cascadeSplits; // дальняя граница каскадов (глубина во view space)
+  vec4 sunDir;        // направление на солнце (world), w = тени включены
+} ubo;
+
+layout(std430, set = 0, binding = 1) readonly buffer Lights { Light lights[]; };
+layout(std430, set = 0, binding = 2) readonly buffer Grid { uvec2 grid[]; };
+layout(std430, set = 0, binding = 3) readonly buffer Indices {
+  uint counter;
+  uint indices[];
+};
+layout(set = 0, binding = 4) uniform sampler2DArrayShadow shadowMap;
+
 layout(location = 0) in vec3 vColor;
+layout(location = 1) in vec3 vViewPos;
+layout(location = 2) in vec3 vViewNormal;
+layout(location = 3) in vec3 vWorldPos;
+
 layout(location = 0) out vec4 outColor;
 
+uint clusterIndex() {
+  uvec2 tile = min(uvec2(gl_FragCoord.xy) / ubo.clusterDims.w, ubo.clusterDims.xy - 1u);
+  float depth = max(-vViewPos.z, ubo.clusterZ.x);
+  uint slice = min(uint(max(log(depth) * ubo.clusterZ.z + ubo.clusterZ.w, 0.0)), ubo.clusterDims.z - 1u);
+  return tile.x + ubo.clusterDims.x * (tile.y + ubo.clusterDims.y * slice);
+}
+
+float sunShadow(float depth) {
+  if (ubo.sunDir.w < 0.5 || depth > ubo.cascadeSplits[3]) return 1.0;
+
+  int c = 0;
+  while (c < 3 && depth > ubo.cascadeSplits[c]) c++;
+
+  vec4 p = ubo.shadowMats[c] * vec4(vWorldPos, 1.0);
+  vec2 uv = p.xy * 0.5 + 0.5;
+
+  // 4 выборки со сдвигом в полтекселя, каждая — аппаратный 2x2 PCF
+  vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+  float sum = 0.0;
+  sum += texture(shadowMap, vec4(uv + vec2(-0.5, -0.5) * texel, float(c), p.z));
+  sum += texture(shadowMap, vec4(uv + vec2( 0.5, -0.5) * texel, float(c), p.z));
+  sum += texture(shadowMap, vec4(uv + vec2(-0.5,  0.5) * texel, float(c), p.z));
+  sum += texture(shadowMap, vec4(uv + vec2( 0.5,  0.5) * texel, float(c), p.z));
+  return sum * 0.25;
+}
+
 void main() {
-  outColor = vec4(vColor, 1.0);
+  vec3 n = normalize(vViewNormal);
+
+  // базовое освещение: ambient + солнце с тенью (направление задано в world, переводим в view)
+  vec3 sunDir = normalize(mat3(ubo.view) * ubo.sunDir.xyz);
+  // выборки тени вне ветвлений: неявный LOD требует uniform control flow
+  float sun = max(dot(n, sunDir), 0.0) * sunShadow(-vViewPos.z);
+  vec3 light = vec3(0.55 + 0.45 * sun);
+
+  uvec2 cell = grid[clusterIndex()];
+  for (uint i = 0u; i < cell.y; ++i) {
+    Light l = lights[indices[cell.x + i]];
+    vec3 toLight = l.posRadius.xyz - vViewPos;
+    float d2 = dot(toLight, toLight);
+    float r2 = l.posRadius.w * l.posRadius.w;
+    if (d2 >= r2) continue;
+
+    // плавное затухание до нуля на радиусе
+    float falloff = 1.0 - d2 / r2;
+    falloff *= falloff;
+    float ndl = max(dot(n, toLight * inversesqrt(max(d2, 1e-6))), 0.0);
+    light += l.colorIntensity.rgb * (l.colorIntensity.w * falloff * ndl);
+  }
+
+  outColor = vec4(vColor * light, 1.0);
 }
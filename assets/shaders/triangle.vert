@@ -3,6 +3,11 @@
 layout(set = 0, binding = 0) uniform UBO {
   mat4 view;
   mat4 proj;
+  vec4 clusterZ;      // near, far, sliceScale, sliceBias
+  uvec4 clusterDims;  // x, y, z, tileSize
+  mat4 shadowMats[4];
+  vec4 cascadeSplits;
+  vec4 sunDir;
 } ubo;
 
 layout(push_constant) uniform PC {
@@ -10,11 +15,22 @@ layout(push_constant) uniform PC {
 } pc;
 
 layout(location = 0) in vec3 inPos;
-layout(location = 1) in vec3 inColor;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec3 inColor;
 
 layout(location = 0) out vec3 vColor;
+layout(location = 1) out vec3 vViewPos;
+layout(location = 2) out vec3 vViewNormal;
+layout(location = 3) out vec3 vWorldPos;
 
 void main() {
-  gl_Position = ubo.proj * ubo.view * pc.model * vec4(inPos, 1.0);
+  vec4 worldPos = pc.model * vec4(inPos, 1.0);
+  mat4 modelView = ubo.view * pc.model;
+  vec4 viewPos = ubo.view * worldPos;
+  gl_Position = ubo.proj * viewPos;
   vColor = inColor;
+  vViewPos = viewPos.xyz;
+  vWorldPos = worldPos.xyz;
+  // без неравномерного масштаба mat3(modelView) годится для нормалей
+  vViewNormal = mat3(modelView) * inNormal;
 }
@@ -0,0 +1,278 @@
+#include "asset/Level.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char LEVEL_MAGIC[4] = { 'D', 'W', 'L', 'V' };
+    constexpr uint32_t LEVEL_VERSION = 1;
+
+    size_t align16(size_t v) { return (v + 15) & ~size_t(15); }
+
+    // поле-массив на позиции fieldPos указывает на dataPos
+    template <typename T>
+    void setArray(std::vector<uint8_t>& out, size_t fieldPos, size_t dataPos, size_t count) {
+        LevelArray<T> a{ (uint32_t)(dataPos - fieldPos), (uint32_t)count };
+        std::memcpy(out.data() + fieldPos, &a, sizeof(a));
+    }
+
+    template <typename T>
+    bool arrayInBounds(const uint8_t* base, size_t size, const LevelArray<T>& a, size_t extra = 0) {
+        size_t field = (size_t)(reinterpret_cast<const uint8_t*>(&a) - base);
+        size_t begin = field + a.offset;
+        return begin >= field && begin % alignof(T) == 0 && begin <= size &&
+            ((uint64_t)a.count * sizeof(T) + extra) <= size - begin;
+    }
+}
+
+uint64_t levelContentHash(const uint8_t* data, size_t size) {
+    uint64_t h = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h ^= w;
+        h *= 1099511628211ull;
+    }
+    for (; i < size; ++i) {
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool LevelFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "LevelFile: can't open " << path << "\n";
+        return false;
+    }
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = size.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cerr << "LevelFile: can't map " << path << "\n";
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    file_ = file;
+    mapping_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = (size_t)size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "LevelFile: can't open " << path << "\n";
+        return false;
+    }
+    struct stat st {};
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // отображение держит файл само
+    if (view == MAP_FAILED) {
+        std::cerr << "LevelFile: can't map " << path << "\n";
+        return false;
+    }
+    mapped_ = true;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = (size_t)st.st_size;
+#endif
+    if (!validate(path)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool LevelFile::openMemory(std::vector<uint8_t> bytes) {
+    close();
+    memory_ = std::move(bytes);
+    data_ = memory_.data();
+    size_ = memory_.size();
+    if (!validate("<memory>")) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LevelFile::close() {
+#ifdef _WIN32
+    if (mapping_) {
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+    }
+    mapping_ = nullptr;
+    file_ = nullptr;
+#else
+    if (mapped_) munmap(const_cast<uint8_t*>(data_), size_);
+    mapped_ = false;
+#endif
+    memory_.clear();
+    memory_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool LevelFile::validate(const std::string& name) {
+    if (size_ < sizeof(LevelHeader) || reinterpret_cast<uintptr_t>(data_) % 16 != 0 ||
+        std::memcmp(data_, LEVEL_MAGIC, 4) != 0) {
+        std::cerr << "LevelFile: not a level file " << name << "\n";
+        return false;
+    }
+    const LevelHeader& h = header();
+    if (h.version != LEVEL_VERSION) {
+        std::cerr << "LevelFile: unsupported version " << h.version << " in " << name << "\n";
+        return false;
+    }
+    if (h.fileSize != size_) {
+        std::cerr << "LevelFile: size mismatch (" << size_ << " of " << h.fileSize << " bytes) in " << name << "\n";
+        return false;
+    }
+    // только границы массивов; индексы внутри записей проверяет тот, кто их обходит
+    bool ok = arrayInBounds(data_, size_, h.meshes) && arrayInBounds(data_, size_, h.entities) &&
+        arrayInBounds(data_, size_, h.colliders) && arrayInBounds(data_, size_, h.spawns) &&
+        (h.mapMesh == LEVEL_NONE || h.mapMesh < h.meshes.count);
+    for (uint32_t i = 0; ok && i < h.meshes.count; ++i) {
+        const LevelArray<char>& p = h.meshes[i].path;
+        ok = arrayInBounds(data_, size_, p, 1) && p.data()[p.count] == '\0';
+    }
+    if (!ok) {
+        std::cerr << "LevelFile: corrupt section table in " << name << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool LevelFile::verifyHash() const {
+    if (!isOpen()) return false;
+    return levelContentHash(data_ + sizeof(LevelHeader), size_ - sizeof(LevelHeader)) == header().contentHash;
+}
+
+uint32_t LevelBuilder::addMesh(const std::string& path, const float boundsMin[3], const float boundsMax[3]) {
+    Mesh m;
+    m.path = path;
+    std::memcpy(m.boundsMin, boundsMin, sizeof(m.boundsMin));
+    std::memcpy(m.boundsMax, boundsMax, sizeof(m.boundsMax));
+    meshes.push_back(std::move(m));
+    return (uint32_t)meshes.size() - 1;
+}
+
+std::vector<uint8_t> LevelBuilder::build() const {
+    // раскладка: заголовок, секции (каждая с 16-байтной границы), строки
+    size_t pos = sizeof(LevelHeader);
+    const size_t meshesPos = pos;
+    pos = align16(pos + meshes.size() * sizeof(LevelMesh));
+    const size_t entitiesPos = pos;
+    pos = align16(pos + entities.size() * sizeof(LevelEntity));
+    const size_t collidersPos = pos;
+    pos = align16(pos + colliders.size() * sizeof(LevelCollider));
+    const size_t spawnsPos = pos;
+    pos += spawns.size() * sizeof(LevelSpawn);
+    const size_t stringsPos = pos;
+    for (const Mesh& m : meshes) pos += m.path.size() + 1;
+
+    std::vector<uint8_t> out(align16(pos), 0);
+
+    LevelHeader h{};
+    std::memcpy(h.magic, LEVEL_MAGIC, 4);
+    h.version = LEVEL_VERSION;
+    h.fileSize = out.size();
+    h.mapMesh = mapMesh;
+    std::memcpy(out.data(), &h, sizeof(h));
+    setArray<LevelMesh>(out, offsetof(LevelHeader, meshes), meshesPos, meshes.size());
+    setArray<LevelEntity>(out, offsetof(LevelHeader, entities), entitiesPos, entities.size());
+    setArray<LevelCollider>(out, offsetof(LevelHeader, colliders), collidersPos, colliders.size());
+    setArray<LevelSpawn>(out, offsetof(LevelHeader, spawns), spawnsPos, spawns.size());
+
+    size_t str = stringsPos;
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const size_t rec = meshesPos + i * sizeof(LevelMesh);
+        LevelMesh m{};
+        std::memcpy(m.boundsMin, meshes[i].boundsMin, sizeof(m.boundsMin));
+        std::memcpy(m.boundsMax, meshes[i].boundsMax, sizeof(m.boundsMax));
+        std::memcpy(out.data() + rec, &m, sizeof(m));
+        setArray<char>(out, rec + offsetof(LevelMesh, path), str, meshes[i].path.size());
+        std::memcpy(out.data() + str, meshes[i].path.data(), meshes[i].path.size());
+        str += meshes[i].path.size() + 1;
+    }
+    if (!entities.empty()) std::memcpy(out.data() + entitiesPos, entities.data(), entities.size() * sizeof(LevelEntity));
+    if (!colliders.empty()) std::memcpy(out.data() + collidersPos, colliders.data(), colliders.size() * sizeof(LevelCollider));
+    if (!spawns.empty()) std::memcpy(out.data() + spawnsPos, spawns.data(), spawns.size() * sizeof(LevelSpawn));
+
+    const uint64_t hash = levelContentHash(out.data() + sizeof(LevelHeader), out.size() - sizeof(LevelHeader));
+    std::memcpy(out.data() + offsetof(LevelHeader, contentHash), &hash, sizeof(hash));
+    return out;
+}
+
+bool LevelBuilder::save(const std::string& path) const {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) {
+        std::cerr << "LevelBuilder: can't open " << path << "\n";
+        return false;
+    }
+    std::vector<uint8_t> bytes = build();
+    f.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+    if (!f) {
+        std::cerr << "LevelBuilder: write failed " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+LevelBuilder makeArenaLevel(const MeshData& map, const MeshData& rock) {
+    LevelBuilder b;
+    b.mapMesh = b.addMesh(LEVEL_MESH_ARENA, map.boundsMin, map.boundsMax);
+    const float cubeMin[3] = { -0.5f, -0.5f, -0.5f };
+    const float cubeMax[3] = { 0.5f, 0.5f, 0.5f };
+    const uint32_t cubeMesh = b.addMesh(LEVEL_MESH_CUBE, cubeMin, cubeMax);
+    const uint32_t rockMesh = b.addMesh(LEVEL_MESH_ROCK, rock.boundsMin, rock.boundsMax);
+
+    // куб в центре
+    b.entities.push_back({ { 0.0f, 0.5f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f },
+        cubeMesh, LEVEL_NONE, LEVEL_ENTITY_STATIC, {} });
+    // коллайдер вокруг куба (чуть шире самого куба)
+    b.colliders.push_back({ { -0.6f, 0.0f, -0.6f }, { 0.6f, 1.2f, 0.6f } });
+    b.spawns.push_back({ { 0.0f, 0.0f, 3.0f }, 0.0f, 0, {} });
+
+    // камни-пропы: фиксированный seed, как у бенчмарка света — сцена одна и та же от запуска к запуску
+    std::mt19937 rng(77u);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+
+    const uint32_t count = 300;
+    for (uint32_t placed = 0; placed < count;) {
+        float x = -18.5f + 37.0f * u01(rng);
+        float z = -18.5f + 37.0f * u01(rng);
+        if (x * x + z * z < 16.0f) continue; // центр (спавн и куб) свободен
+
+        float s = 0.3f + 0.6f * u01(rng);
+        float yaw = 6.2831853f * u01(rng);
+
+        // низ камня на полу
+        b.entities.push_back({ { x, -rock.boundsMin[1] * s, z }, { 0.0f, std::sin(yaw * 0.5f), 0.0f, std::cos(yaw * 0.5f) },
+            { s, s, s }, rockMesh, LEVEL_NONE, LEVEL_ENTITY_STATIC, {} });
+        placed++;
+    }
+    return b;
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "asset/Mesh.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cooked-уровень .dwlevel: сущности, ссылки на меши, коллизия, точки спавна.
+// Файл используется как есть, без разбора: mmap + проверка заголовка и границ массивов (O(число секций)),
+// дальше записи читаются прямо из отображения. Поэтому:
+//  - все записи POD фиксированного размера, little-endian, секции выровнены по 16;
+//  - массивы задаются смещением от самого поля (self-relative) -> не зависят от адреса отображения;
+//  - строки (пути мешей) лежат в конце файла с '\0', LevelArray<char>::data() — готовая C-строка;
+//  - contentHash — от байтов после заголовка: ключ кэшей и проверка целостности (verifyHash(), O(размер)).
+
+constexpr uint32_t LEVEL_NONE = ~0u;
+
+// встроенные меши и меши арены (их же знает fallback движка)
+constexpr const char* LEVEL_MESH_CUBE = "builtin:cube";
+constexpr const char* LEVEL_MESH_ARENA = "meshes/arena.dwmesh";
+constexpr const char* LEVEL_MESH_ROCK = "meshes/rock.dwmesh";
+
+template <typename T>
+struct LevelArray {
+	uint32_t offset; // байт от начала этого поля; данные всегда дальше по файлу
+	uint32_t count;
+
+	const T* data() const { return reinterpret_cast<const T*>(reinterpret_cast<const char*>(this) + offset); }
+	const T* begin() const { return data(); }
+	const T* end() const { return data() + count; }
+	uint32_t size() const { return count; }
+	const T& operator[](uint32_t i) const { return data()[i]; }
+};
+
+struct LevelMesh {
+	LevelArray<char> path; // count — длина без '\0'
+	float boundsMin[3];
+	float boundsMax[3];
+};
+
+enum LevelEntityFlags : uint32_t {
+	LEVEL_ENTITY_STATIC = 1u << 0,
+};
+
+// локальный TRS относительно parent (родитель всегда раньше ребёнка)
+struct LevelEntity {
+	float position[3];
+	float rotation[4]; // кватернион x, y, z, w
+	float scale[3];
+	uint32_t mesh;     // индекс в meshes или LEVEL_NONE
+	uint32_t parent;   // индекс сущности или LEVEL_NONE
+	uint32_t flags;
+	uint32_t pad[3];
+};
+
+struct LevelCollider {
+	float min[3];
+	float max[3];
+};
+
+struct LevelSpawn {
+	float position[3];
+	float yaw;
+	uint32_t team;
+	uint32_t pad[3];
+};
+
+struct LevelHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t fileSize;
+	uint64_t contentHash;
+	uint32_t mapMesh; // индекс в meshes (геометрия карты) или LEVEL_NONE
+	uint32_t pad;
+	LevelArray<LevelMesh> meshes;
+	LevelArray<LevelEntity> entities;
+	LevelArray<LevelCollider> colliders;
+	LevelArray<LevelSpawn> spawns;
+};
+
+static_assert(sizeof(LevelMesh) == 32 && sizeof(LevelEntity) == 64 && sizeof(LevelCollider) == 24 &&
+	sizeof(LevelSpawn) == 32 && sizeof(LevelHeader) == 64, "dwlevel layout changed: bump LEVEL_VERSION");
+
+// Открытый уровень: отображение файла (или буфер в памяти) + указатель на заголовок
+class LevelFile {
+public:
+	LevelFile() = default;
+	~LevelFile() { close(); }
+	LevelFile(const LevelFile&) = delete;
+	LevelFile& operator=(const LevelFile&) = delete;
+
+	bool open(const std::string& path);
+	// уже собранный уровень (LevelBuilder::build) — тот же формат, только без файла
+	bool openMemory(std::vector<uint8_t> bytes);
+	void close();
+
+	bool isOpen() const { return data_ != nullptr; }
+	const LevelHeader& header() const { return *reinterpret_cast<const LevelHeader*>(data_); }
+	size_t size() const { return size_; }
+	// пересчитать хэш содержимого и сравнить с заголовком
+	bool verifyHash() const;
+
+private:
+	bool validate(const std::string& name);
+
+	const uint8_t* data_ = nullptr;
+	size_t size_ = 0;
+	std::vector<uint8_t> memory_; // openMemory
+#ifdef _WIN32
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#else
+	bool mapped_ = false;
+#endif
+};
+
+// хэш содержимого (FNV-1a по 8-байтовым словам; хвост — по байтам)
+uint64_t levelContentHash(const uint8_t* data, size_t size);
+
+// Сборка уровня в cook-инструменте (и fallback-уровня в движке)
+struct LevelBuilder {
+	struct Mesh {
+		std::string path;
+		float boundsMin[3];
+		float boundsMax[3];
+	};
+
+	std::vector<Mesh> meshes;
+	std::vector<LevelEntity> entities;
+	std::vector<LevelCollider> colliders;
+	std::vector<LevelSpawn> spawns;
+	uint32_t mapMesh = LEVEL_NONE;
+
+	uint32_t addMesh(const std::string& path, const float boundsMin[3], const float boundsMax[3]);
+
+	std::vector<uint8_t> build() const;
+	bool save(const std::string& path) const;
+};
+
+// Арена: карта, куб в центре, 300 камней-пропов, коллайдер куба, спавн.
+// От мешей нужны только границы (низ камня ставится на пол).
+LevelBuilder makeArenaLevel(const MeshData& map, const MeshData& rock);
@@ -0,0 +1,131 @@
+#include "asset/Mesh.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr char MESH_MAGIC[4] = { 'D', 'W', 'M', 'S' };
+    // 1: без LOD'ов; 2: + lodCount (бывший reserved) и массив MeshLod в конце
+    constexpr uint32_t MESH_VERSION = 2;
+
+    struct MeshFileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t meshletCount;
+        uint32_t meshletVertexCount;
+        uint32_t meshletTriangleBytes;
+        uint32_t lodCount;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    template <typename T>
+    void writeArray(std::ofstream& f, const std::vector<T>& v) {
+        if (!v.empty()) f.write(reinterpret_cast<const char*>(v.data()), (std::streamsize)(sizeof(T) * v.size()));
+    }
+
+    template <typename T>
+    bool readArray(std::ifstream& f, std::vector<T>& v, uint32_t count) {
+        v.resize(count);
+        if (count == 0) return true;
+        f.read(reinterpret_cast<char*>(v.data()), (std::streamsize)(sizeof(T) * count));
+        return (bool)f;
+    }
+}
+
+void computeBounds(MeshData& mesh) {
+    if (mesh.vertices.empty()) return;
+    for (int a = 0; a < 3; ++a) {
+        mesh.boundsMin[a] = mesh.vertices[0].pos[a];
+        mesh.boundsMax[a] = mesh.vertices[0].pos[a];
+    }
+    for (const MeshVertex& v : mesh.vertices) {
+        for (int a = 0; a < 3; ++a) {
+            mesh.boundsMin[a] = std::min(mesh.boundsMin[a], v.pos[a]);
+            mesh.boundsMax[a] = std::max(mesh.boundsMax[a], v.pos[a]);
+        }
+    }
+}
+
+bool saveMesh(const std::string& path, const MeshData& mesh) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) {
+        std::cerr << "saveMesh: can't open " << path << "\n";
+        return false;
+    }
+
+    MeshFileHeader h{};
+    std::memcpy(h.magic, MESH_MAGIC, 4);
+    h.version = MESH_VERSION;
+    h.vertexCount = (uint32_t)mesh.vertices.size();
+    h.indexCount = (uint32_t)mesh.indices.size();
+    h.meshletCount = (uint32_t)mesh.meshlets.size();
+    h.meshletVertexCount = (uint32_t)mesh.meshletVertices.size();
+    h.meshletTriangleBytes = (uint32_t)mesh.meshletTriangles.size();
+    h.lodCount = (uint32_t)mesh.lods.size();
+    std::memcpy(h.boundsMin, mesh.boundsMin, sizeof(h.boundsMin));
+    std::memcpy(h.boundsMax, mesh.boundsMax, sizeof(h.boundsMax));
+
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    writeArray(f, mesh.vertices);
+    writeArray(f, mesh.indices);
+    writeArray(f, mesh.meshlets);
+    writeArray(f, mesh.meshletVertices);
+    writeArray(f, mesh.meshletTriangles);
+    writeArray(f, mesh.lods);
+
+    if (!f) {
+        std::cerr << "saveMesh: write failed " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool loadMesh(const std::string& path, MeshData& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        std::cerr << "loadMesh: can't open " << path << "\n";
+        return false;
+    }
+
+    MeshFileHeader h{};
+    f.read(reinterpret_cast<char*>(&h), sizeof(h));
+    if (!f || std::memcmp(h.magic, MESH_MAGIC, 4) != 0) {
+        std::cerr << "loadMesh: not a mesh file " << path << "\n";
+        return false;
+    }
+    if (h.version != 1 && h.version != MESH_VERSION) {
+        std::cerr << "loadMesh: unsupported version " << h.version << " in " << path << "\n";
+        return false;
+    }
+
+    MeshData m;
+    std::memcpy(m.boundsMin, h.boundsMin, sizeof(m.boundsMin));
+    std::memcpy(m.boundsMax, h.boundsMax, sizeof(m.boundsMax));
+    if (!readArray(f, m.vertices, h.vertexCount) ||
+        !readArray(f, m.indices, h.indexCount) ||
+        !readArray(f, m.meshlets, h.meshletCount) ||
+        !readArray(f, m.meshletVertices, h.meshletVertexCount) ||
+        !readArray(f, m.meshletTriangles, h.meshletTriangleBytes) ||
+        !readArray(f, m.lods, h.version >= 2 ? h.lodCount : 0)) {
+        std::cerr << "loadMesh: truncated file " << path << "\n";
+        return false;
+    }
+
+    if (m.lods.size() > MAX_MESH_LODS) {
+        std::cerr << "loadMesh: too many LODs (" << m.lods.size() << ") in " << path << "\n";
+        return false;
+    }
+    for (const MeshLod& l : m.lods) {
+        if ((uint64_t)l.indexOffset + l.indexCount > m.indices.size()) {
+            std::cerr << "loadMesh: bad LOD range in " << path << "\n";
+            return false;
+        }
+    }
+
+    out = std::move(m);
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Вершина движкового меша (совпадает с vertex input основного pipeline)
+struct MeshVertex {
+	float pos[3];
+	float normal[3];
+	float color[3];
+};
+
+constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+// Кусок меша для culling'а: сфера + конус нормалей.
+// Layout совпадает с Meshlet в meshlet_cull.comp (std430, 48 байт).
+struct Meshlet {
+	float center[3];
+	float radius;
+	float coneAxis[3];
+	float coneCutoff;        // sin(раствора конуса нормалей); 1 = по конусу не отсекаем
+	uint32_t vertexOffset;   // в meshletVertices
+	uint32_t triangleOffset; // в meshletTriangles (байты, по 3 на треугольник)
+	uint32_t vertexCount;
+	uint32_t triangleCount;
+};
+
+constexpr uint32_t MAX_MESH_LODS = 8;
+
+// Уровень детализации: свой диапазон в indices поверх общих вершин
+struct MeshLod {
+	uint32_t indexOffset;
+	uint32_t indexCount;
+	float error;   // геометрическая ошибка относительно LOD 0 (единицы меша)
+	uint32_t pad;
+};
+
+struct MeshData {
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32_t> indices;  // все LOD'ы подряд (LOD 0 первым)
+	std::vector<MeshLod> lods;      // пусто = один LOD на весь indices
+
+	// meshlet'ы строятся только для LOD 0
+	std::vector<Meshlet> meshlets;
+	std::vector<uint32_t> meshletVertices; // индексы в vertices
+	std::vector<uint8_t> meshletTriangles; // локальные индексы, по 3 на треугольник (размер кратен 4)
+
+	float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+	float boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+void computeBounds(MeshData& mesh);
+
+inline uint32_t lodCount(const MeshData& m) { return m.lods.empty() ? 1u : (uint32_t)m.lods.size(); }
+inline MeshLod meshLod(const MeshData& m, uint32_t lod) {
+	if (m.lods.empty()) return { 0, (uint32_t)m.indices.size(), 0.0f, 0 };
+	return m.lods[lod];
+}
+
+// cooked-формат .dwmesh: заголовок + массивы подряд (little-endian)
+bool saveMesh(const std::string& path, const MeshData& mesh);
+bool loadMesh(const std::string& path, MeshData& out);
@@ -0,0 +1,193 @@
+#include "asset/MeshGen.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+
+namespace {
+    // одна грань бокса сеткой nu x nv квадов: origin + u*s + v*t, нормаль = u x v
+    void addGrid(MeshData& m, const float origin[3], const float u[3], const float v[3],
+        uint32_t nu, uint32_t nv, const float color[3]) {
+        float n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        for (float& c : n) c /= len;
+
+        uint32_t base = (uint32_t)m.vertices.size();
+        for (uint32_t j = 0; j <= nv; ++j) {
+            for (uint32_t i = 0; i <= nu; ++i) {
+                float s = (float)i / (float)nu;
+                float t = (float)j / (float)nv;
+                MeshVertex vx{};
+                for (int a = 0; a < 3; ++a) {
+                    vx.pos[a] = origin[a] + u[a] * s + v[a] * t;
+                    vx.normal[a] = n[a];
+                    vx.color[a] = color[a];
+                }
+                m.vertices.push_back(vx);
+            }
+        }
+        for (uint32_t j = 0; j < nv; ++j) {
+            for (uint32_t i = 0; i < nu; ++i) {
+                uint32_t i0 = base + j * (nu + 1) + i;
+                uint32_t i1 = i0 + 1;
+                uint32_t i2 = i0 + (nu + 1) + 1;
+                uint32_t i3 = i0 + (nu + 1);
+                m.indices.insert(m.indices.end(), { i0, i1, i2, i0, i2, i3 });
+            }
+        }
+    }
+
+    uint32_t cells(float len, float cell) { return std::max(1u, (uint32_t)std::ceil(len / cell)); }
+
+    // бокс без нижней грани (стоит на полу)
+    void addBox(MeshData& m, const float mn[3], const float mx[3], float cell, const float color[3]) {
+        float sx = mx[0] - mn[0], sy = mx[1] - mn[1], sz = mx[2] - mn[2];
+        uint32_t cx = cells(sx, cell), cy = cells(sy, cell), cz = cells(sz, cell);
+
+        // порядок (u, v) подобран так, чтобы u x v смотрел наружу
+        { float o[3] = { mn[0], mn[1], mx[2] }; float u[3] = { sx, 0, 0 }; float v[3] = { 0, sy, 0 }; addGrid(m, o, u, v, cx, cy, color); } // +Z
+        { float o[3] = { mx[0], mn[1], mn[2] }; float u[3] = { -sx, 0, 0 }; float v[3] = { 0, sy, 0 }; addGrid(m, o, u, v, cx, cy, color); } // -Z
+        { float o[3] = { mx[0], mn[1], mx[2] }; float u[3] = { 0, 0, -sz }; float v[3] = { 0, sy, 0 }; addGrid(m, o, u, v, cz, cy, color); } // +X
+        { float o[3] = { mn[0], mn[1], mn[2] }; float u[3] = { 0, 0, sz }; float v[3] = { 0, sy, 0 }; addGrid(m, o, u, v, cz, cy, color); } // -X
+        { float o[3] = { mn[0], mx[1], mx[2] }; float u[3] = { sx, 0, 0 }; float v[3] = { 0, 0, -sz }; addGrid(m, o, u, v, cx, cz, color); } // +Y
+    }
+}
+
+MeshData generateArena(float halfSize, float cellSize) {
+    MeshData m;
+    const float h = halfSize;
+    const float wallT = 0.5f;
+    const float wallH = 3.0f;
+
+    const float wallColor[3] = { 0.55f, 0.5f, 0.45f };
+    const float pillarColor[3] = { 0.4f, 0.45f, 0.55f };
+    const float crateColor[3] = { 0.6f, 0.45f, 0.25f };
+
+    // стены: внутренняя грань по краю пола
+    { float a[3] = { -h - wallT, 0, -h - wallT }; float b[3] = { h + wallT, wallH, -h }; addBox(m, a, b, cellSize, wallColor); }
+    { float a[3] = { -h - wallT, 0, h }; float b[3] = { h + wallT, wallH, h + wallT }; addBox(m, a, b, cellSize, wallColor); }
+    { float a[3] = { -h - wallT, 0, -h }; float b[3] = { -h, wallH, h }; addBox(m, a, b, cellSize, wallColor); }
+    { float a[3] = { h, 0, -h }; float b[3] = { h + wallT, wallH, h }; addBox(m, a, b, cellSize, wallColor); }
+
+    // колонны по кольцу, в стороне от точки спавна
+    const float ring = h * 0.6f;
+    for (int i = 0; i < 8; ++i) {
+        float ang = (float)i * 0.7853982f + 0.3926991f;
+        float cx = ring * std::cos(ang), cz = ring * std::sin(ang);
+        float a[3] = { cx - 0.6f, 0, cz - 0.6f };
+        float b[3] = { cx + 0.6f, wallH * 1.5f, cz + 0.6f };
+        addBox(m, a, b, cellSize, pillarColor);
+    }
+
+    // ящики: укрытия на средней дистанции
+    const float crates[][3] = {
+        { -6.0f, 0.0f, -9.0f }, { 6.0f, 0.0f, -9.0f }, { -9.0f, 0.0f, 6.0f }, { 9.0f, 0.0f, 6.0f },
+        { 0.0f, 0.0f, -15.0f }, { 0.0f, 0.0f, 15.0f }, { -15.0f, 0.0f, 0.0f }, { 15.0f, 0.0f, 0.0f },
+    };
+    for (const auto& c : crates) {
+        float a[3] = { c[0] - 1.0f, 0, c[2] - 1.0f };
+        float b[3] = { c[0] + 1.0f, 1.2f, c[2] + 1.0f };
+        addBox(m, a, b, cellSize, crateColor);
+    }
+
+    computeBounds(m);
+    return m;
+}
+
+MeshData generateRock(uint32_t seed, uint32_t subdivisions) {
+    // икосаэдр
+    const float t = 1.6180340f;
+    std::vector<float> p = {
+        -1, t, 0,  1, t, 0,  -1, -t, 0,  1, -t, 0,
+        0, -1, t,  0, 1, t,  0, -1, -t,  0, 1, -t,
+        t, 0, -1,  t, 0, 1,  -t, 0, -1,  -t, 0, 1,
+    };
+    std::vector<uint32_t> idx = {
+        0, 11, 5,  0, 5, 1,  0, 1, 7,  0, 7, 10,  0, 10, 11,
+        1, 5, 9,  5, 11, 4,  11, 10, 2,  10, 7, 6,  7, 1, 8,
+        3, 9, 4,  3, 4, 2,  3, 2, 6,  3, 6, 8,  3, 8, 9,
+        4, 9, 5,  2, 4, 11,  6, 2, 10,  8, 6, 7,  9, 8, 1,
+    };
+    auto toSphere = [&](uint32_t i) {
+        float* v = &p[i * 3];
+        float len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        v[0] /= len; v[1] /= len; v[2] /= len;
+    };
+    for (uint32_t i = 0; i < 12; ++i) toSphere(i);
+
+    for (uint32_t s = 0; s < subdivisions; ++s) {
+        std::map<uint64_t, uint32_t> mid;
+        auto midpoint = [&](uint32_t a, uint32_t b) {
+            uint64_t key = ((uint64_t)std::min(a, b) << 32) | std::max(a, b);
+            auto it = mid.find(key);
+            if (it != mid.end()) return it->second;
+            uint32_t i = (uint32_t)(p.size() / 3);
+            for (int k = 0; k < 3; ++k) p.push_back((p[a * 3 + k] + p[b * 3 + k]) * 0.5f);
+            toSphere(i);
+            mid.emplace(key, i);
+            return i;
+        };
+        std::vector<uint32_t> next;
+        next.reserve(idx.size() * 4);
+        for (size_t i = 0; i < idx.size(); i += 3) {
+            uint32_t a = idx[i], b = idx[i + 1], c = idx[i + 2];
+            uint32_t ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+            next.insert(next.end(), { a, ab, ca,  b, bc, ab,  c, ca, bc,  ab, bc, ca });
+        }
+        idx.swap(next);
+    }
+
+    // шум: сумма случайных "волн" по направлениям -> бугристая, но гладкая поверхность
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    struct Wave { float dir[3]; float freq, phase, amp; };
+    std::vector<Wave> waves(12);
+    for (uint32_t i = 0; i < waves.size(); ++i) {
+        Wave& w = waves[i];
+        float d[3] = { u(rng), u(rng), u(rng) };
+        float len = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) + 1e-6f;
+        for (int k = 0; k < 3; ++k) w.dir[k] = d[k] / len;
+        w.freq = 1.5f + 3.0f * (float)i / (float)waves.size();
+        w.phase = 3.14159265f * u(rng);
+        w.amp = 0.12f / (1.0f + (float)i * 0.35f);
+    }
+
+    MeshData m;
+    const uint32_t n = (uint32_t)(p.size() / 3);
+    m.vertices.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        const float* v = &p[i * 3];
+        float r = 1.0f;
+        for (const Wave& w : waves)
+            r += w.amp * std::sin(w.freq * (v[0] * w.dir[0] + v[1] * w.dir[1] + v[2] * w.dir[2]) + w.phase);
+        MeshVertex& mv = m.vertices[i];
+        // приплюснутый по Y: лежит на земле
+        mv.pos[0] = v[0] * r;
+        mv.pos[1] = v[1] * r * 0.7f;
+        mv.pos[2] = v[2] * r;
+        float shade = 0.42f + 0.12f * v[1] + 0.25f * (r - 1.0f);
+        mv.color[0] = shade;
+        mv.color[1] = shade * 0.97f;
+        mv.color[2] = shade * 0.92f;
+    }
+    m.indices = std::move(idx);
+
+    // гладкие нормали по граням (CCW снаружи)
+    for (size_t i = 0; i < m.indices.size(); i += 3) {
+        const float* a = m.vertices[m.indices[i]].pos;
+        const float* b = m.vertices[m.indices[i + 1]].pos;
+        const float* c = m.vertices[m.indices[i + 2]].pos;
+        float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float nn[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        for (int k = 0; k < 3; ++k)
+            for (int a2 = 0; a2 < 3; ++a2) m.vertices[m.indices[i + k]].normal[a2] += nn[a2];
+    }
+    for (MeshVertex& v : m.vertices) {
+        float len = std::sqrt(v.normal[0] * v.normal[0] + v.normal[1] * v.normal[1] + v.normal[2] * v.normal[2]);
+        if (len > 1e-12f) for (float& c : v.normal) c /= len;
+    }
+
+    computeBounds(m);
+    return m;
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "asset/Mesh.h"
+
+// Процедурная арена под пол 2*halfSize x 2*halfSize: толстые стены по периметру, колонны и ящики.
+// Грани мелко нарезаны (cellSize), чтобы получалось много meshlet'ов — удобно для проверки culling'а.
+// Треугольники CCW снаружи. Заполняет vertices/indices/bounds (meshlet'ы строит buildMeshlets).
+MeshData generateArena(float halfSize, float cellSize);
+
+// Камень-проп: икосфера (subdivisions раз по 4 треугольника) с шумовым смещением, радиус ~1.
+// Замкнутый и плотный (5120 треугольников при 4) — материал для LOD-цепочки.
+MeshData generateRock(uint32_t seed, uint32_t subdivisions);
@@ -0,0 +1,171 @@
+#include "asset/MeshletBuilder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+    struct V3 { float x, y, z; };
+
+    V3 pos(const MeshData& m, uint32_t i) { return { m.vertices[i].pos[0], m.vertices[i].pos[1], m.vertices[i].pos[2] }; }
+    V3 sub(V3 a, V3 b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    V3 cross(V3 a, V3 b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+    float dot(V3 a, V3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    float length(V3 a) { return std::sqrt(dot(a, a)); }
+
+    // сфера по AABB вершин + конус по нормалям треугольников (как в meshoptimizer)
+    void computeMeshletBounds(const MeshData& mesh, Meshlet& m) {
+        V3 mn = pos(mesh, mesh.meshletVertices[m.vertexOffset]);
+        V3 mx = mn;
+        for (uint32_t i = 1; i < m.vertexCount; ++i) {
+            V3 p = pos(mesh, mesh.meshletVertices[m.vertexOffset + i]);
+            mn = { std::min(mn.x, p.x), std::min(mn.y, p.y), std::min(mn.z, p.z) };
+            mx = { std::max(mx.x, p.x), std::max(mx.y, p.y), std::max(mx.z, p.z) };
+        }
+        V3 c{ (mn.x + mx.x) * 0.5f, (mn.y + mx.y) * 0.5f, (mn.z + mx.z) * 0.5f };
+        float r = 0.0f;
+        for (uint32_t i = 0; i < m.vertexCount; ++i)
+            r = std::max(r, length(sub(pos(mesh, mesh.meshletVertices[m.vertexOffset + i]), c)));
+
+        m.center[0] = c.x; m.center[1] = c.y; m.center[2] = c.z;
+        m.radius = r;
+
+        // нормали треугольников (winding CCW = лицевая сторона)
+        std::vector<V3> normals;
+        normals.reserve(m.triangleCount);
+        V3 axis{ 0.0f, 0.0f, 0.0f };
+        for (uint32_t t = 0; t < m.triangleCount; ++t) {
+            const uint8_t* lt = &mesh.meshletTriangles[m.triangleOffset + t * 3];
+            V3 a = pos(mesh, mesh.meshletVertices[m.vertexOffset + lt[0]]);
+            V3 b = pos(mesh, mesh.meshletVertices[m.vertexOffset + lt[1]]);
+            V3 d = pos(mesh, mesh.meshletVertices[m.vertexOffset + lt[2]]);
+            V3 n = cross(sub(b, a), sub(d, a));
+            float len = length(n);
+            if (len <= 1e-12f) continue; // вырожденный
+            n = { n.x / len, n.y / len, n.z / len };
+            normals.push_back(n);
+            axis = { axis.x + n.x, axis.y + n.y, axis.z + n.z };
+        }
+
+        float axisLen = length(axis);
+        m.coneAxis[0] = 0.0f; m.coneAxis[1] = 0.0f; m.coneAxis[2] = 1.0f;
+        m.coneCutoff = 1.0f;
+        if (normals.empty() || axisLen <= 1e-6f) return;
+        axis = { axis.x / axisLen, axis.y / axisLen, axis.z / axisLen };
+
+        float minDot = 1.0f;
+        for (const V3& n : normals) minDot = std::min(minDot, dot(n, axis));
+
+        m.coneAxis[0] = axis.x; m.coneAxis[1] = axis.y; m.coneAxis[2] = axis.z;
+        // конус шире ~84 градусов почти никогда ничего не отсекает — не тратим на него тест
+        if (minDot > 0.1f) m.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+void buildMeshlets(MeshData& mesh) {
+    mesh.meshlets.clear();
+    mesh.meshletVertices.clear();
+    mesh.meshletTriangles.clear();
+
+    // только LOD 0: дальние уровни рисуются целиком
+    const MeshLod lod0 = meshLod(mesh, 0);
+    const uint32_t* indices = mesh.indices.data() + lod0.indexOffset;
+    const uint32_t vertexCount = (uint32_t)mesh.vertices.size();
+    const uint32_t triCount = lod0.indexCount / 3;
+    if (triCount == 0) return;
+
+    // vertex -> треугольники
+    std::vector<uint32_t> adjOffset(vertexCount + 1, 0);
+    for (uint32_t i = 0; i < triCount * 3; ++i) adjOffset[indices[i] + 1]++;
+    for (uint32_t v = 0; v < vertexCount; ++v) adjOffset[v + 1] += adjOffset[v];
+    std::vector<uint32_t> adjTris(triCount * 3);
+    {
+        std::vector<uint32_t> fill(adjOffset.begin(), adjOffset.end() - 1);
+        for (uint32_t t = 0; t < triCount; ++t)
+            for (int k = 0; k < 3; ++k) adjTris[fill[indices[t * 3 + k]]++] = t;
+    }
+
+    std::vector<uint8_t> emitted(triCount, 0);
+    std::vector<int32_t> localIndex(vertexCount, -1); // вершина -> индекс в текущем meshlet'е
+    std::vector<uint32_t> curVerts;
+    std::vector<uint8_t> curTris;
+    V3 curSum{ 0.0f, 0.0f, 0.0f };
+    uint32_t seedCursor = 0;
+
+    auto flush = [&]() {
+        if (curTris.empty()) return;
+        Meshlet m{};
+        m.vertexOffset = (uint32_t)mesh.meshletVertices.size();
+        m.triangleOffset = (uint32_t)mesh.meshletTriangles.size();
+        m.vertexCount = (uint32_t)curVerts.size();
+        m.triangleCount = (uint32_t)(curTris.size() / 3);
+        mesh.meshletVertices.insert(mesh.meshletVertices.end(), curVerts.begin(), curVerts.end());
+        mesh.meshletTriangles.insert(mesh.meshletTriangles.end(), curTris.begin(), curTris.end());
+        computeMeshletBounds(mesh, m);
+        mesh.meshlets.push_back(m);
+
+        for (uint32_t v : curVerts) localIndex[v] = -1;
+        curVerts.clear();
+        curTris.clear();
+        curSum = { 0.0f, 0.0f, 0.0f };
+    };
+
+    auto newVertices = [&](uint32_t t) {
+        uint32_t n = 0;
+        for (int k = 0; k < 3; ++k) n += localIndex[indices[t * 3 + k]] < 0 ? 1u : 0u;
+        return n;
+    };
+
+    for (uint32_t emittedCount = 0; emittedCount < triCount; ++emittedCount) {
+        // лучший кандидат среди соседей текущего meshlet'а: меньше новых вершин, потом ближе к центру
+        uint32_t best = UINT32_MAX;
+        uint32_t bestNew = 4;
+        float bestDist = std::numeric_limits<float>::max();
+        if (!curVerts.empty()) {
+            float inv = 1.0f / (float)curVerts.size();
+            V3 centroid{ curSum.x * inv, curSum.y * inv, curSum.z * inv };
+            for (uint32_t v : curVerts) {
+                for (uint32_t a = adjOffset[v]; a < adjOffset[v + 1]; ++a) {
+                    uint32_t t = adjTris[a];
+                    if (emitted[t]) continue;
+                    uint32_t nv = newVertices(t);
+                    if (nv > bestNew) continue;
+                    V3 p0 = pos(mesh, indices[t * 3]);
+                    float d = length(sub(p0, centroid));
+                    if (nv < bestNew || d < bestDist) {
+                        best = t; bestNew = nv; bestDist = d;
+                    }
+                }
+            }
+        }
+
+        // соседей нет (или meshlet пуст) -> первый свободный треугольник
+        if (best == UINT32_MAX) {
+            while (emitted[seedCursor]) ++seedCursor;
+            best = seedCursor;
+            bestNew = newVertices(best);
+        }
+
+        if (curVerts.size() + bestNew > MESHLET_MAX_VERTICES || curTris.size() / 3 + 1 > MESHLET_MAX_TRIANGLES) {
+            flush();
+            bestNew = 3;
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = indices[best * 3 + k];
+            if (localIndex[v] < 0) {
+                localIndex[v] = (int32_t)curVerts.size();
+                curVerts.push_back(v);
+                V3 p = pos(mesh, v);
+                curSum = { curSum.x + p.x, curSum.y + p.y, curSum.z + p.z };
+            }
+            curTris.push_back((uint8_t)localIndex[v]);
+        }
+        emitted[best] = 1;
+    }
+    flush();
+
+    // шейдер читает треугольники словами по 4 байта
+    while (mesh.meshletTriangles.size() % 4) mesh.meshletTriangles.push_back(0);
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include "asset/Mesh.h"
+
+// Offline-разбиение LOD 0 из mesh.indices на meshlet'ы (до MESHLET_MAX_VERTICES / MESHLET_MAX_TRIANGLES).
+// Жадно наращивает кусок по смежным треугольникам, чтобы meshlet был компактным
+// (узкая сфера и узкий конус нормалей -> лучше отсекается).
+// Заполняет mesh.meshlets / meshletVertices / meshletTriangles, старые данные выбрасываются.
+void buildMeshlets(MeshData& mesh);
@@ -0,0 +1,124 @@
+#include "asset/ObjLoader.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+    struct Key {
+        int v, vn;
+        bool operator==(const Key& o) const { return v == o.v && vn == o.vn; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const { return (size_t)k.v * 73856093u ^ (size_t)k.vn * 19349663u; }
+    };
+
+    // OBJ индексы 1-based, отрицательные — от конца списка
+    int resolveIndex(int i, size_t count) {
+        if (i > 0) return i - 1;
+        if (i < 0) return (int)count + i;
+        return -1;
+    }
+}
+
+bool loadObj(const std::string& path, MeshData& out) {
+    std::ifstream f(path);
+    if (!f) {
+        std::cerr << "loadObj: can't open " << path << "\n";
+        return false;
+    }
+
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::unordered_map<Key, uint32_t, KeyHash> remap;
+    MeshData m;
+    bool hasNormals = true;
+
+    std::string line;
+    std::vector<uint32_t> poly;
+    uint32_t lineNo = 0;
+    while (std::getline(f, line)) {
+        ++lineNo;
+        std::istringstream ls(line);
+        std::string tag;
+        ls >> tag;
+
+        if (tag == "v") {
+            float x = 0, y = 0, z = 0;
+            ls >> x >> y >> z;
+            positions.insert(positions.end(), { x, y, z });
+        }
+        else if (tag == "vn") {
+            float x = 0, y = 0, z = 0;
+            ls >> x >> y >> z;
+            normals.insert(normals.end(), { x, y, z });
+        }
+        else if (tag == "f") {
+            poly.clear();
+            std::string tok;
+            while (ls >> tok) {
+                // v, v/vt, v//vn, v/vt/vn
+                int vi = std::atoi(tok.c_str());
+                int ni = 0;
+                size_t s1 = tok.find('/');
+                if (s1 != std::string::npos) {
+                    size_t s2 = tok.find('/', s1 + 1);
+                    if (s2 != std::string::npos) ni = std::atoi(tok.c_str() + s2 + 1);
+                }
+
+                Key k{ resolveIndex(vi, positions.size() / 3), resolveIndex(ni, normals.size() / 3) };
+                if (k.v < 0 || k.v >= (int)(positions.size() / 3) || k.vn >= (int)(normals.size() / 3)) {
+                    std::cerr << "loadObj: bad index at " << path << ":" << lineNo << "\n";
+                    return false;
+                }
+                if (k.vn < 0) hasNormals = false;
+
+                auto it = remap.find(k);
+                if (it == remap.end()) {
+                    MeshVertex v{};
+                    for (int a = 0; a < 3; ++a) {
+                        v.pos[a] = positions[k.v * 3 + a];
+                        v.normal[a] = k.vn >= 0 ? normals[k.vn * 3 + a] : 0.0f;
+                        v.color[a] = 0.7f;
+                    }
+                    it = remap.emplace(k, (uint32_t)m.vertices.size()).first;
+                    m.vertices.push_back(v);
+                }
+                poly.push_back(it->second);
+            }
+            for (size_t i = 2; i < poly.size(); ++i)
+                m.indices.insert(m.indices.end(), { poly[0], poly[i - 1], poly[i] });
+        }
+    }
+
+    if (m.indices.empty()) {
+        std::cerr << "loadObj: no faces in " << path << "\n";
+        return false;
+    }
+
+    // нормалей нет хотя бы у части вершин -> усредняем нормали граней
+    if (!hasNormals) {
+        for (MeshVertex& v : m.vertices) v.normal[0] = v.normal[1] = v.normal[2] = 0.0f;
+        for (size_t t = 0; t + 2 < m.indices.size(); t += 3) {
+            const float* a = m.vertices[m.indices[t]].pos;
+            const float* b = m.vertices[m.indices[t + 1]].pos;
+            const float* c = m.vertices[m.indices[t + 2]].pos;
+            float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+            float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+            float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+            for (int k = 0; k < 3; ++k)
+                for (int a2 = 0; a2 < 3; ++a2) m.vertices[m.indices[t + k]].normal[a2] += n[a2];
+        }
+        for (MeshVertex& v : m.vertices) {
+            float len = std::sqrt(v.normal[0] * v.normal[0] + v.normal[1] * v.normal[1] + v.normal[2] * v.normal[2]);
+            if (len > 1e-12f) for (int a = 0; a < 3; ++a) v.normal[a] /= len;
+            else v.normal[1] = 1.0f;
+        }
+    }
+
+    computeBounds(m);
+    out = std::move(m);
+    return true;
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include "asset/Mesh.h"
+#include <string>
+
+// Минимальный Wavefront OBJ: v / vn / f (полигоны режутся веером), остальное игнорируется.
+// Без нормалей в файле нормали считаются по граням. Заполняет vertices/indices/bounds.
+bool loadObj(const std::string& path, MeshData& out);
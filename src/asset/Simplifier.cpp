@@ -0,0 +1,288 @@
+#include "asset/Simplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+    struct Quadric {
+        double a2 = 0, ab = 0, ac = 0, ad = 0;
+        double b2 = 0, bc = 0, bd = 0;
+        double c2 = 0, cd = 0;
+        double d2 = 0;
+        double w = 0; // суммарная площадь (для перевода ошибки в расстояние)
+
+        void addPlane(double a, double b, double c, double d, double weight) {
+            a2 += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+            b2 += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+            c2 += weight * c * c; cd += weight * c * d;
+            d2 += weight * d * d;
+            w += weight;
+        }
+        void add(const Quadric& q) {
+            a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+            b2 += q.b2; bc += q.bc; bd += q.bd;
+            c2 += q.c2; cd += q.cd;
+            d2 += q.d2;
+            w += q.w;
+        }
+        double eval(const double p[3]) const {
+            const double x = p[0], y = p[1], z = p[2];
+            double e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                + c2 * z * z + 2 * cd * z + d2;
+            return std::max(e, 0.0);
+        }
+    };
+
+    struct Collapse {
+        double cost;
+        uint32_t v, u;       // v -> u
+        uint32_t stampV, stampU;
+        bool operator>(const Collapse& o) const { return cost > o.cost; }
+    };
+
+    struct PosKey {
+        float x, y, z;
+        bool operator==(const PosKey& o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+    struct PosHash {
+        size_t operator()(const PosKey& k) const {
+            uint32_t h[3];
+            std::memcpy(h, &k, sizeof(h));
+            return (size_t)h[0] * 73856093u ^ (size_t)h[1] * 19349663u ^ (size_t)h[2] * 83492791u;
+        }
+    };
+
+    void cross3(const double a[3], const double b[3], double out[3]) {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+}
+
+std::vector<uint32_t> simplifyMesh(const std::vector<MeshVertex>& vertices,
+    const uint32_t* indices, size_t indexCount, size_t targetIndexCount,
+    float maxError, const SimplifyOptions& opt, float* outError) {
+    const uint32_t vertexCount = (uint32_t)vertices.size();
+    const uint32_t triCount = (uint32_t)(indexCount / 3);
+    if (outError) *outError = 0.0f;
+
+    // позиции в единичном кубе: ошибки и веса атрибутов не зависят от масштаба меша
+    double mn[3] = { 1e30, 1e30, 1e30 }, mx[3] = { -1e30, -1e30, -1e30 };
+    for (size_t i = 0; i < indexCount; ++i) {
+        const float* p = vertices[indices[i]].pos;
+        for (int a = 0; a < 3; ++a) { mn[a] = std::min(mn[a], (double)p[a]); mx[a] = std::max(mx[a], (double)p[a]); }
+    }
+    double extent = std::max({ mx[0] - mn[0], mx[1] - mn[1], mx[2] - mn[2], 1e-12 });
+    std::vector<double> pos((size_t)vertexCount * 3);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        for (int a = 0; a < 3; ++a) pos[v * 3 + a] = (vertices[v].pos[a] - mn[a]) / extent;
+
+    std::vector<uint32_t> tris(indices, indices + triCount * 3);
+    std::vector<uint8_t> triAlive(triCount, 1);
+    std::vector<std::vector<uint32_t>> vertTris(vertexCount);
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<double> area(vertexCount, 0.0);
+
+    for (uint32_t t = 0; t < triCount; ++t) {
+        const uint32_t* tri = &tris[t * 3];
+        const double* p0 = &pos[tri[0] * 3];
+        const double* p1 = &pos[tri[1] * 3];
+        const double* p2 = &pos[tri[2] * 3];
+        double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        double n[3];
+        cross3(e1, e2, n);
+        double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        double triArea = len * 0.5;
+        if (len > 1e-20) { n[0] /= len; n[1] /= len; n[2] /= len; }
+        double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+
+        for (int k = 0; k < 3; ++k) {
+            quadrics[tri[k]].addPlane(n[0], n[1], n[2], d, triArea);
+            area[tri[k]] += triArea;
+            vertTris[tri[k]].push_back(t);
+        }
+    }
+
+    // блокировки: граничные рёбра и швы
+    std::vector<uint8_t> locked(vertexCount, 0);
+    if (opt.lockBorder) {
+        std::unordered_map<uint64_t, uint32_t> edgeCount;
+        edgeCount.reserve((size_t)triCount * 3);
+        for (uint32_t t = 0; t < triCount; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                uint32_t a = tris[t * 3 + k], b = tris[t * 3 + (k + 1) % 3];
+                uint64_t key = ((uint64_t)std::min(a, b) << 32) | std::max(a, b);
+                edgeCount[key]++;
+            }
+        }
+        for (const auto& e : edgeCount) {
+            if (e.second != 1) continue;
+            locked[(uint32_t)(e.first >> 32)] = 1;
+            locked[(uint32_t)(e.first & 0xFFFFFFFFu)] = 1;
+        }
+    }
+    {
+        std::unordered_map<PosKey, uint32_t, PosHash> firstAt;
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            if (vertTris[v].empty()) continue;
+            PosKey k{ vertices[v].pos[0], vertices[v].pos[1], vertices[v].pos[2] };
+            auto it = firstAt.find(k);
+            if (it == firstAt.end()) firstAt.emplace(k, v);
+            else { locked[v] = 1; locked[it->second] = 1; }
+        }
+    }
+
+    auto attrCost = [&](uint32_t v, uint32_t u) {
+        double dn = 0.0, dc = 0.0;
+        for (int a = 0; a < 3; ++a) {
+            double n = vertices[v].normal[a] - vertices[u].normal[a];
+            double c = vertices[v].color[a] - vertices[u].color[a];
+            dn += n * n;
+            dc += c * c;
+        }
+        return (opt.normalWeight * dn + opt.colorWeight * dc) * area[v];
+    };
+
+    std::vector<uint32_t> stamp(vertexCount, 0);
+    std::vector<uint32_t> remap(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v) remap[v] = v;
+
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+    auto push = [&](uint32_t v, uint32_t u) {
+        if (locked[v] || v == u) return;
+        Quadric q = quadrics[v];
+        q.add(quadrics[u]);
+        double cost = q.eval(&pos[u * 3]) + attrCost(v, u);
+        heap.push({ cost, v, u, stamp[v], stamp[u] });
+    };
+
+    for (uint32_t t = 0; t < triCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            uint32_t a = tris[t * 3 + k], b = tris[t * 3 + (k + 1) % 3];
+            push(a, b);
+            push(b, a);
+        }
+    }
+
+    // треугольники v, не содержащие u, не должны перевернуться и выродиться после v -> u
+    auto flips = [&](uint32_t v, uint32_t u) {
+        for (uint32_t t : vertTris[v]) {
+            if (!triAlive[t]) continue;
+            uint32_t* tri = &tris[t * 3];
+            if (tri[0] == u || tri[1] == u || tri[2] == u) continue;
+
+            const double* p[3];
+            const double* q[3];
+            for (int k = 0; k < 3; ++k) {
+                p[k] = &pos[tri[k] * 3];
+                q[k] = tri[k] == v ? &pos[u * 3] : p[k];
+            }
+            double e1[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+            double e2[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+            double f1[3] = { q[1][0] - q[0][0], q[1][1] - q[0][1], q[1][2] - q[0][2] };
+            double f2[3] = { q[2][0] - q[0][0], q[2][1] - q[0][1], q[2][2] - q[0][2] };
+            double n0[3], n1[3];
+            cross3(e1, e2, n0);
+            cross3(f1, f2, n1);
+            double l0 = std::sqrt(n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]);
+            double l1 = std::sqrt(n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]);
+            if (l1 < 1e-14) return true;
+            // > ~78 градусов поворота грани — тоже отказ (почти вывернутые иголки)
+            if (n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] < 0.2 * l0 * l1) return true;
+        }
+        return false;
+    };
+
+    const double maxErrorNorm = (double)maxError / extent;
+    size_t aliveTris = triCount;
+    double reachedError = 0.0;
+
+    while (aliveTris * 3 > targetIndexCount && !heap.empty()) {
+        Collapse c = heap.top();
+        heap.pop();
+        if (c.stampV != stamp[c.v] || c.stampU != stamp[c.u]) continue; // устарел
+        if (remap[c.v] != c.v || remap[c.u] != c.u) continue;
+
+        Quadric q = quadrics[c.v];
+        q.add(quadrics[c.u]);
+        double dist = std::sqrt(q.eval(&pos[c.u * 3]) / std::max(q.w, 1e-30));
+        if (dist > maxErrorNorm) break;
+        if (flips(c.v, c.u)) continue;
+
+        // v -> u
+        remap[c.v] = c.u;
+        quadrics[c.u] = q;
+        area[c.u] += area[c.v];
+        reachedError = std::max(reachedError, dist);
+
+        for (uint32_t t : vertTris[c.v]) {
+            if (!triAlive[t]) continue;
+            uint32_t* tri = &tris[t * 3];
+            if (tri[0] == c.u || tri[1] == c.u || tri[2] == c.u) {
+                triAlive[t] = 0;
+                --aliveTris;
+                continue;
+            }
+            for (int k = 0; k < 3; ++k) if (tri[k] == c.v) tri[k] = c.u;
+            vertTris[c.u].push_back(t);
+        }
+        vertTris[c.v].clear();
+
+        // у u и соседей изменились цены
+        stamp[c.u]++;
+        auto& ut = vertTris[c.u];
+        ut.erase(std::remove_if(ut.begin(), ut.end(), [&](uint32_t t) { return !triAlive[t]; }), ut.end());
+        for (uint32_t t : ut) {
+            for (int k = 0; k < 3; ++k) {
+                uint32_t w = tris[t * 3 + k];
+                if (w == c.u) continue;
+                push(w, c.u);
+                push(c.u, w);
+            }
+        }
+    }
+
+    std::vector<uint32_t> out;
+    out.reserve(aliveTris * 3);
+    for (uint32_t t = 0; t < triCount; ++t)
+        if (triAlive[t]) out.insert(out.end(), &tris[t * 3], &tris[t * 3] + 3);
+
+    if (outError) *outError = (float)(reachedError * extent);
+    return out;
+}
+
+void buildLodChain(MeshData& mesh, uint32_t maxLods, float ratio, const SimplifyOptions& opt) {
+    // цепочку строим заново от LOD 0
+    const MeshLod base = meshLod(mesh, 0);
+    std::vector<uint32_t> lod0(mesh.indices.begin() + base.indexOffset,
+        mesh.indices.begin() + base.indexOffset + base.indexCount);
+
+    mesh.indices = lod0;
+    mesh.lods.clear();
+    mesh.lods.push_back({ 0, (uint32_t)lod0.size(), 0.0f, 0 });
+
+    maxLods = std::min(maxLods, MAX_MESH_LODS);
+    std::vector<uint32_t> prev = std::move(lod0);
+    float error = 0.0f;
+    for (uint32_t l = 1; l < maxLods; ++l) {
+        size_t target = (size_t)((double)(prev.size() / 3) * ratio) * 3;
+        if (target < 3) break;
+
+        float e = 0.0f;
+        std::vector<uint32_t> next = simplifyMesh(mesh.vertices, prev.data(), prev.size(), target,
+            std::numeric_limits<float>::max(), opt, &e);
+        // почти не упростилось (всё заблокировано) — дальше смысла нет
+        if (next.empty() || next.size() > prev.size() * 9 / 10) break;
+
+        // ошибка считается от предыдущего уровня -> копим (оценка сверху)
+        error += e;
+        mesh.lods.push_back({ (uint32_t)mesh.indices.size(), (uint32_t)next.size(), error, 0 });
+        mesh.indices.insert(mesh.indices.end(), next.begin(), next.end());
+        prev = std::move(next);
+    }
+}
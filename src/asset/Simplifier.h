@@ -0,0 +1,26 @@
+#pragma once
+#include "asset/Mesh.h"
+#include <vector>
+
+// Упрощение меша схлопыванием рёбер по quadric error metrics (Garland-Heckbert):
+//  - вершина схлопывается в соседа (новых вершин нет -> все LOD'ы делят один vertex buffer);
+//  - к ошибке положения добавляется взвешенная разница нормалей/цветов (веса ниже);
+//  - вершины на границах (ребро у одного треугольника) и на швах (та же позиция, другие атрибуты)
+//    заблокированы — силуэт и стыки не расползаются;
+//  - схлопывания, переворачивающие треугольники, отбрасываются.
+
+struct SimplifyOptions {
+	float normalWeight = 0.5f; // цена разницы нормалей (|dn|^2) относительно ошибки положения
+	float colorWeight = 0.5f;  // цена разницы цветов
+	bool lockBorder = true;
+};
+
+// Упрощает треугольники indices[0..indexCount) до targetIndexCount (или пока ошибка <= maxError).
+// outError — достигнутая геометрическая ошибка в единицах меша.
+std::vector<uint32_t> simplifyMesh(const std::vector<MeshVertex>& vertices,
+	const uint32_t* indices, size_t indexCount, size_t targetIndexCount,
+	float maxError, const SimplifyOptions& opt, float* outError);
+
+// LOD-цепочка в mesh.indices/mesh.lods: LOD 0 = текущие индексы, каждый следующий ~ratio от предыдущего.
+// Останавливается раньше maxLods, если меш больше не упрощается.
+void buildLodChain(MeshData& mesh, uint32_t maxLods, float ratio, const SimplifyOptions& opt);
@@ -0,0 +1,181 @@
+#include "core/AllocCounter.h"
+#include "core/MemoryTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace {
+
+std::atomic<uint64_t> g_allocs{ 0 };
+thread_local uint64_t t_allocs = 0; // тривиальный тип: доступен и до/после конструкторов потока
+
+} // namespace
+
+uint64_t heapAllocCount() {
+    return g_allocs.load(std::memory_order_relaxed);
+}
+
+uint64_t threadHeapAllocCount() {
+    return t_allocs;
+}
+
+void SteadyAllocCheck::beginFrame() {
+    start_ = heapAllocCount();
+    threadStart_ = threadHeapAllocCount();
+}
+
+uint64_t SteadyAllocCheck::endFrame(uint64_t frame) {
+    const uint64_t allocs = heapAllocCount() - start_;
+    if (!enabled()) return allocs;
+    if (quiet_ < WARMUP_FRAMES) {
+        quiet_++;
+        return allocs;
+    }
+    if (allocs > 0) {
+        std::cerr << "alloc check: " << allocs << " heap allocation(s) in steady-state frame " << frame
+                  << " (" << threadHeapAllocCount() - threadStart_ << " on the game thread)\n";
+        std::abort();
+    }
+    return allocs;
+}
+
+#if DW_ALLOC_CHECK || DW_MEM_TRACKING
+
+namespace {
+
+void* alignedMalloc(size_t size, size_t align) {
+#if defined(_MSC_VER)
+    return _aligned_malloc(size, align);
+#else
+    return std::aligned_alloc(align, (size + align - 1) & ~(align - 1));
+#endif
+}
+
+void alignedFree(void* p) {
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+#if DW_MEM_TRACKING
+// перед каждым блоком: сколько и на чей счёт — delete списывает с того же тега
+struct alignas(16) AllocHeader {
+    uint64_t size;
+    MemTag tag;
+};
+static_assert(sizeof(AllocHeader) == 16, "header must keep the default new alignment");
+
+// выровненный блок: заголовок — в отступе перед пользовательским адресом
+size_t headerOffset(size_t align) {
+    return align > sizeof(AllocHeader) ? align : sizeof(AllocHeader);
+}
+
+void* track(void* user, size_t size) {
+    AllocHeader* h = static_cast<AllocHeader*>(user) - 1;
+    h->size = size;
+    h->tag = currentMemTag();
+    memTrackAlloc(h->tag, size);
+    return user;
+}
+
+void untrack(void* user) {
+    const AllocHeader* h = static_cast<const AllocHeader*>(user) - 1;
+    memTrackFree(h->tag, (size_t)h->size);
+}
+#endif
+
+void* countedAlloc(size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    t_allocs++;
+#if DW_MEM_TRACKING
+    unsigned char* raw = static_cast<unsigned char*>(std::malloc(sizeof(AllocHeader) + size));
+    return raw ? track(raw + sizeof(AllocHeader), size) : nullptr;
+#else
+    return std::malloc(size ? size : 1);
+#endif
+}
+
+void countedFree(void* p) {
+    if (!p) return;
+#if DW_MEM_TRACKING
+    untrack(p);
+    std::free(static_cast<unsigned char*>(p) - sizeof(AllocHeader));
+#else
+    std::free(p);
+#endif
+}
+
+void* countedAllocAligned(size_t size, size_t align) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    t_allocs++;
+    if (size == 0) size = 1;
+#if DW_MEM_TRACKING
+    const size_t offset = headerOffset(align);
+    unsigned char* raw = static_cast<unsigned char*>(alignedMalloc(offset + size, align));
+    return raw ? track(raw + offset, size) : nullptr;
+#else
+    return alignedMalloc(size, align);
+#endif
+}
+
+void countedFreeAligned(void* p, size_t align) {
+    if (!p) return;
+#if DW_MEM_TRACKING
+    untrack(p);
+    alignedFree(static_cast<unsigned char*>(p) - headerOffset(align));
+#else
+    (void)align;
+    alignedFree(p);
+#endif
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (void* p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    if (void* p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void* operator new(size_t size, std::align_val_t align) {
+    if (void* p = countedAllocAligned(size, (size_t)align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t align) {
+    if (void* p = countedAllocAligned(size, (size_t)align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return countedAllocAligned(size, (size_t)align);
+}
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return countedAllocAligned(size, (size_t)align);
+}
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+
+void operator delete(void* p, std::align_val_t a) noexcept { countedFreeAligned(p, (size_t)a); }
+void operator delete[](void* p, std::align_val_t a) noexcept { countedFreeAligned(p, (size_t)a); }
+void operator delete(void* p, size_t, std::align_val_t a) noexcept { countedFreeAligned(p, (size_t)a); }
+void operator delete[](void* p, size_t, std::align_val_t a) noexcept { countedFreeAligned(p, (size_t)a); }
+void operator delete(void* p, std::align_val_t a, const std::nothrow_t&) noexcept { countedFreeAligned(p, (size_t)a); }
+void operator delete[](void* p, std::align_val_t a, const std::nothrow_t&) noexcept { countedFreeAligned(p, (size_t)a); }
+
+#endif
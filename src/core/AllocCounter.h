@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+
+// Счётчик выделений из глобальной кучи (operator new/new[] во всех вариантах) — для правила
+// "стабильная игра не аллоцирует". DW_ALLOC_CHECK=1 или DW_MEM_TRACKING=1 (CMake-опции) подменяют
+// глобальные operator new/delete (с DW_MEM_TRACKING — ещё и учёт по тегам, core/MemoryTracker.h);
+// без них подмены нет, счётчики всегда 0, проверка ничего не делает.
+// malloc и аллокации внутри SDL/драйвера не видны.
+
+#ifndef DW_ALLOC_CHECK
+#define DW_ALLOC_CHECK 0
+#endif
+
+// все потоки с запуска
+uint64_t heapAllocCount();
+// вызывающий поток с его запуска
+uint64_t threadHeapAllocCount();
+
+// Проверка по кадрам: кадр стабилен, если WARMUP_FRAMES кадров подряд до него не было событий,
+// которые аллоцируют законно (загрузка, ресайз, переключатели, запись trace'а...) — о них сообщает disturb().
+// Аллокация в стабильном кадре (в любом потоке) -> отчёт в std::cerr и abort().
+class SteadyAllocCheck {
+public:
+	static constexpr uint32_t WARMUP_FRAMES = 120;
+
+	void setEnabled(bool e) { enabled_ = e; quiet_ = 0; }
+	bool enabled() const { return enabled_ && DW_ALLOC_CHECK; }
+
+	void beginFrame();
+	void disturb() { quiet_ = 0; }
+	// -> выделений за кадр (всего)
+	uint64_t endFrame(uint64_t frame);
+
+private:
+	bool enabled_ = true;
+	uint32_t quiet_ = 0;
+	uint64_t start_ = 0;
+	uint64_t threadStart_ = 0;
+};
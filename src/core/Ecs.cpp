@@ -0,0 +1,308 @@
+#include "core/Ecs.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+std::array<ComponentInfo, ComponentRegistry::MAX_COMPONENTS> g_components;
+std::atomic<uint32_t> g_componentCount{ 0 };
+std::mutex g_componentMutex;
+
+uint32_t alignUp(uint32_t v, uint32_t a) {
+    return (v + a - 1) / a * a;
+}
+
+// раскладка колонок на capacity строк: массив Entity, затем колонки с выравниванием; влезает ли в чанк
+bool layoutColumns(Archetype& a, uint32_t capacity) {
+    uint32_t offset = capacity * (uint32_t)sizeof(Entity);
+    for (size_t c = 0; c < a.components.size(); ++c) {
+        uint32_t align = std::max(Archetype::COLUMN_ALIGN, ComponentRegistry::info(a.components[c]).align);
+        offset = alignUp(offset, align);
+        a.offsets[c] = offset;
+        offset += capacity * a.sizes[c];
+    }
+    return offset <= EcsChunk::SIZE;
+}
+}
+
+ComponentId ComponentRegistry::add(uint32_t size, uint32_t align) {
+    std::lock_guard<std::mutex> lock(g_componentMutex);
+    uint32_t id = g_componentCount.load(std::memory_order_relaxed);
+    if (id >= MAX_COMPONENTS) {
+        // маска — 64 бита; дальше расширять ComponentMask
+        std::cerr << "ECS: more than " << MAX_COMPONENTS << " component types\n";
+        std::abort();
+    }
+    g_components[id] = { size, align };
+    g_componentCount.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+const ComponentInfo& ComponentRegistry::info(ComponentId id) {
+    return g_components[id];
+}
+
+uint32_t ComponentRegistry::count() {
+    return g_componentCount.load(std::memory_order_acquire);
+}
+
+World::~World() {
+    clear();
+    for (EcsChunk* ch : freeChunks_) delete ch;
+}
+
+void World::clear() {
+    for (const std::unique_ptr<Archetype>& a : archetypes_) {
+        freeChunks_.insert(freeChunks_.end(), a->chunks.begin(), a->chunks.end());
+        a->chunks.clear();
+        a->count = 0;
+    }
+    // handle'ы, выданные до clear(), должны стать недействительными: поколения не сбрасываем
+    freeIndices_.clear();
+    for (uint32_t i = (uint32_t)records_.size(); i-- > 0;) {
+        Record& r = records_[i];
+        if (r.archetype) {
+            r.archetype = nullptr;
+            if (++r.generation == 0) r.generation = 1;
+        }
+        freeIndices_.push_back(i);
+    }
+    alive_ = 0;
+}
+
+uint32_t World::chunkCount() const {
+    uint32_t n = 0;
+    for (const std::unique_ptr<Archetype>& a : archetypes_) n += (uint32_t)a->chunks.size();
+    return n;
+}
+
+EcsChunk* World::allocChunk() {
+    if (!freeChunks_.empty()) {
+        EcsChunk* ch = freeChunks_.back();
+        freeChunks_.pop_back();
+        return ch;
+    }
+    return new EcsChunk;
+}
+
+Archetype* World::archetype(ComponentMask mask) {
+    auto it = byMask_.find(mask);
+    if (it != byMask_.end()) return it->second;
+
+    auto a = std::make_unique<Archetype>();
+    a->mask = mask;
+    a->column.fill(-1);
+    uint32_t rowBytes = (uint32_t)sizeof(Entity);
+    for (ComponentId id = 0; id < ComponentRegistry::MAX_COMPONENTS; ++id) {
+        if (!(mask & (ComponentMask(1) << id))) continue;
+        a->column[id] = (int8_t)a->components.size();
+        a->components.push_back(id);
+        a->sizes.push_back(ComponentRegistry::info(id).size);
+        rowBytes += ComponentRegistry::info(id).size;
+    }
+    a->offsets.resize(a->components.size());
+
+    // сколько строк влезает с учётом выравнивания колонок
+    uint32_t capacity = EcsChunk::SIZE / rowBytes;
+    while (capacity > 0 && !layoutColumns(*a, capacity)) --capacity;
+    if (capacity == 0) {
+        // одна строка не влезает в чанк: крупные данные держать вне ECS (handle/указатель в компоненте)
+        std::cerr << "ECS: archetype row of " << rowBytes << " bytes does not fit a " << EcsChunk::SIZE
+                  << "-byte chunk\n";
+        std::abort();
+    }
+    a->capacity = capacity;
+
+    Archetype* raw = a.get();
+    archetypes_.push_back(std::move(a));
+    byMask_[mask] = raw;
+    return raw;
+}
+
+uint32_t World::pushRow(Archetype* a, Entity e) {
+    const uint32_t row = a->count;
+    if (row / a->capacity >= a->chunks.size()) a->chunks.push_back(allocChunk());
+    a->entities(a->chunks[row / a->capacity])[row % a->capacity] = e;
+    a->count++;
+    return row;
+}
+
+void World::eraseRow(Archetype* a, uint32_t row) {
+    const uint32_t last = a->count - 1;
+    if (row != last) {
+        // дырку закрывает последняя сущность архетипа
+        EcsChunk* dst = a->chunks[row / a->capacity];
+        EcsChunk* src = a->chunks[last / a->capacity];
+        const uint32_t di = row % a->capacity, si = last % a->capacity;
+        for (size_t c = 0; c < a->components.size(); ++c) {
+            const uint32_t size = a->sizes[c];
+            std::memcpy(a->columnData(dst, (int)c) + (size_t)di * size, a->columnData(src, (int)c) + (size_t)si * size, size);
+        }
+        Entity moved = a->entities(src)[si];
+        a->entities(dst)[di] = moved;
+        records_[moved.index].row = row;
+    }
+    a->count = last;
+
+    // последний чанк опустел -> в запас
+    if (a->count <= (uint32_t)(a->chunks.size() - 1) * a->capacity) {
+        freeChunks_.push_back(a->chunks.back());
+        a->chunks.pop_back();
+    }
+}
+
+Entity World::createWithMask(ComponentMask mask) {
+    uint32_t index;
+    if (!freeIndices_.empty()) {
+        index = freeIndices_.back();
+        freeIndices_.pop_back();
+    }
+    else {
+        index = (uint32_t)records_.size();
+        records_.push_back({});
+        records_.back().generation = 1;
+    }
+
+    Record& r = records_[index];
+    Entity e{ index, r.generation };
+    r.archetype = archetype(mask);
+    r.row = pushRow(r.archetype, e);
+    alive_++;
+    return e;
+}
+
+void World::destroy(Entity e) {
+    if (!alive(e)) return;
+    Record& r = records_[e.index];
+    eraseRow(r.archetype, r.row);
+    r.archetype = nullptr;
+    if (++r.generation == 0) r.generation = 1;
+    freeIndices_.push_back(e.index);
+    alive_--;
+}
+
+void World::moveEntity(Record& r, Archetype* to) {
+    Archetype* from = r.archetype;
+    const uint32_t oldRow = r.row;
+    const Entity e = from->entities(from->chunks[oldRow / from->capacity])[oldRow % from->capacity];
+    const uint32_t newRow = pushRow(to, e);
+
+    // общие компоненты переезжают; новых (add) пока нет — их пишет вызывающий
+    EcsChunk* src = from->chunks[oldRow / from->capacity];
+    EcsChunk* dst = to->chunks[newRow / to->capacity];
+    const uint32_t si = oldRow % from->capacity, di = newRow % to->capacity;
+    for (size_t c = 0; c < from->components.size(); ++c) {
+        const int dc = to->column[from->components[c]];
+        if (dc < 0) continue;
+        const uint32_t size = from->sizes[c];
+        std::memcpy(to->columnData(dst, dc) + (size_t)di * size, from->columnData(src, (int)c) + (size_t)si * size, size);
+    }
+
+    eraseRow(from, oldRow);
+    r.archetype = to;
+    r.row = newRow;
+}
+
+void* World::addComponent(Entity e, ComponentId id) {
+    if (!alive(e)) return nullptr;
+    Record& r = records_[e.index];
+    Archetype* from = r.archetype;
+    if (from->column[id] < 0) {
+        Archetype* to = from->addEdge[id];
+        if (!to) {
+            to = archetype(from->mask | (ComponentMask(1) << id));
+            from->addEdge[id] = to;
+            to->removeEdge[id] = from;
+        }
+        moveEntity(r, to);
+    }
+    return componentPtr(e, id);
+}
+
+void World::removeComponent(Entity e, ComponentId id) {
+    if (!alive(e)) return;
+    Record& r = records_[e.index];
+    Archetype* from = r.archetype;
+    if (from->column[id] < 0) return;
+
+    Archetype* to = from->removeEdge[id];
+    if (!to) {
+        to = archetype(from->mask & ~(ComponentMask(1) << id));
+        from->removeEdge[id] = to;
+        to->addEdge[id] = from;
+    }
+    moveEntity(r, to);
+}
+
+void* World::componentPtr(Entity e, ComponentId id) const {
+    if (!alive(e)) return nullptr;
+    const Record& r = records_[e.index];
+    const Archetype* a = r.archetype;
+    const int c = a->column[id];
+    if (c < 0) return nullptr;
+    return a->columnData(a->chunks[r.row / a->capacity], c) + (size_t)(r.row % a->capacity) * a->sizes[c];
+}
+
+void World::collectChunks(ComponentMask mask, std::vector<ChunkRef>& out) const {
+    out.clear();
+    for (const std::unique_ptr<Archetype>& a : archetypes_) {
+        if ((a->mask & mask) != mask) continue;
+        for (uint32_t c = 0; c < (uint32_t)a->chunks.size(); ++c) out.push_back({ a.get(), c });
+    }
+}
+
+void World::flush(EcsCommandBuffer& cmd) {
+    std::lock_guard<std::mutex> lock(cmd.mutex_);
+    for (const EcsCommandBuffer::Command& c : cmd.commands_) {
+        switch (c.op) {
+        case EcsCommandBuffer::Create: {
+            Entity e = createWithMask(c.mask);
+            for (uint32_t i = 0; i < c.count; ++i) {
+                const EcsCommandBuffer::Payload& p = cmd.payloads_[c.first + i];
+                std::memcpy(componentPtr(e, p.id), cmd.bytes_.data() + p.offset, ComponentRegistry::info(p.id).size);
+            }
+            break;
+        }
+        case EcsCommandBuffer::Destroy:
+            destroy(c.entity);
+            break;
+        case EcsCommandBuffer::Add: {
+            const EcsCommandBuffer::Payload& p = cmd.payloads_[c.first];
+            if (void* dst = addComponent(c.entity, p.id))
+                std::memcpy(dst, cmd.bytes_.data() + p.offset, ComponentRegistry::info(p.id).size);
+            break;
+        }
+        case EcsCommandBuffer::Remove:
+            for (ComponentId id = 0; id < ComponentRegistry::MAX_COMPONENTS; ++id)
+                if (c.mask & (ComponentMask(1) << id)) removeComponent(c.entity, id);
+            break;
+        }
+    }
+    cmd.commands_.clear();
+    cmd.payloads_.clear();
+    cmd.bytes_.clear();
+}
+
+void EcsCommandBuffer::destroy(Entity e) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Command c;
+    c.op = Destroy;
+    c.entity = e;
+    commands_.push_back(c);
+}
+
+void EcsCommandBuffer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    commands_.clear();
+    payloads_.clear();
+    bytes_.clear();
+}
+
+void EcsCommandBuffer::pushPayload(ComponentId id, const void* src, uint32_t size) {
+    // вызывается под mutex_
+    const uint32_t offset = (uint32_t)bytes_.size();
+    bytes_.resize(offset + size);
+    std::memcpy(bytes_.data() + offset, src, size);
+    payloads_.push_back({ id, offset });
+}
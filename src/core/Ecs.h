@@ -0,0 +1,305 @@
+#pragma once
+#include "core/JobSystem.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// ECS на архетипах. Сущности с одинаковым набором компонентов (архетип) лежат в чанках по 16 КБ:
+// в чанке — массив Entity и по массиву на каждый компонент (SoA). Чанки архетипа плотные (дырку от
+// удаления закрывает последняя сущность), так что запрос — линейный проход по массивам.
+//  - компонент — любой trivially copyable тип (копируется memcpy при смене архетипа), до 64 типов;
+//  - add/remove меняют архетип (переезд сущности, переходы кэшируются в рёбрах архетипа);
+//  - во время обхода структуру менять нельзя — для этого EcsCommandBuffer, применяется flush();
+//  - parallelEach раздаёт чанки worker'ам JobSystem.
+
+struct Entity {
+	uint32_t index = 0;
+	uint32_t generation = 0; // 0 = пустой handle
+
+	bool valid() const { return generation != 0; }
+	bool operator==(const Entity& o) const { return index == o.index && generation == o.generation; }
+	bool operator!=(const Entity& o) const { return !(*this == o); }
+};
+
+using ComponentId = uint32_t;
+using ComponentMask = uint64_t;
+
+struct ComponentInfo {
+	uint32_t size = 0;
+	uint32_t align = 0;
+};
+
+// id компонентов раздаются при первом обращении к componentId<T>() (на весь процесс)
+class ComponentRegistry {
+public:
+	static constexpr uint32_t MAX_COMPONENTS = 64;
+
+	static ComponentId add(uint32_t size, uint32_t align);
+	static const ComponentInfo& info(ComponentId id);
+	static uint32_t count();
+};
+
+template <typename T>
+ComponentId componentTypeId() {
+	static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+		"ECS components must be trivially copyable (they are moved between chunks with memcpy)");
+	static_assert(sizeof(T) <= 1024, "ECS component is too large for a 16 KB chunk");
+	static const ComponentId id = ComponentRegistry::add((uint32_t)sizeof(T), (uint32_t)alignof(T));
+	return id;
+}
+
+// const T — тот же компонент (запросы только на чтение: each<const Position>)
+template <typename T>
+ComponentId componentId() { return componentTypeId<std::remove_cv_t<T>>(); }
+
+template <typename... Cs>
+ComponentMask componentMask() {
+	return (ComponentMask(0) | ... | (ComponentMask(1) << componentId<Cs>()));
+}
+
+struct alignas(64) EcsChunk {
+	static constexpr uint32_t SIZE = 16 * 1024;
+	unsigned char data[SIZE];
+};
+
+// Набор компонентов и его чанки. Строка row архетипа = чанк row / capacity, место row % capacity;
+// заполнены все чанки, кроме, может быть, последнего.
+class Archetype {
+public:
+	static constexpr uint32_t COLUMN_ALIGN = 16; // начало каждого массива в чанке (SIMD)
+
+	ComponentMask mask = 0;
+	std::vector<ComponentId> components; // по возрастанию id
+	std::array<int8_t, ComponentRegistry::MAX_COMPONENTS> column; // id -> колонка, -1 = нет
+	std::vector<uint32_t> offsets; // колонка -> смещение массива в чанке
+	std::vector<uint32_t> sizes;   // колонка -> размер компонента
+	uint32_t capacity = 0;         // сущностей в чанке
+	uint32_t count = 0;
+	std::vector<EcsChunk*> chunks;
+
+	// переходы add/remove компонента id (заполняются по мере надобности)
+	std::array<Archetype*, ComponentRegistry::MAX_COMPONENTS> addEdge{};
+	std::array<Archetype*, ComponentRegistry::MAX_COMPONENTS> removeEdge{};
+
+	uint32_t chunkSize(uint32_t c) const {
+		uint32_t begin = c * capacity;
+		return count - begin < capacity ? count - begin : capacity;
+	}
+	Entity* entities(EcsChunk* ch) const { return reinterpret_cast<Entity*>(ch->data); }
+	unsigned char* columnData(EcsChunk* ch, int col) const { return ch->data + offsets[col]; }
+	template <typename T>
+	T* data(EcsChunk* ch) const { return reinterpret_cast<T*>(ch->data + offsets[column[componentId<T>()]]); }
+};
+
+class EcsCommandBuffer;
+
+class World {
+public:
+	World() = default;
+	~World();
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
+
+	Entity create() { return createWithMask(0); }
+	template <typename... Cs>
+	Entity create(const Cs&... cs);
+	void destroy(Entity e);
+	bool alive(Entity e) const {
+		return e.index < records_.size() && e.generation != 0 && records_[e.index].generation == e.generation;
+	}
+
+	// add: если компонент уже есть — перезаписывает
+	template <typename T>
+	void add(Entity e, const T& value);
+	template <typename T>
+	void remove(Entity e) { removeComponent(e, componentId<T>()); }
+	// nullptr, если сущности нет или у неё нет T; указатель живёт до следующего структурного изменения
+	template <typename T>
+	T* get(Entity e) const { return static_cast<T*>(componentPtr(e, componentId<T>())); }
+	template <typename T>
+	bool has(Entity e) const { return componentPtr(e, componentId<T>()) != nullptr; }
+
+	// Запросы: все архетипы, где есть Cs... (могут быть и другие компоненты).
+	//   eachChunk: fn(uint32_t n, const Entity* entities, Cs*... arrays) — по чанку
+	//   each:      fn(Cs&...) — по сущности
+	//   parallel*: то же из worker'ов JobSystem (чанк целиком в одном потоке), возврат после всех
+	template <typename... Cs, typename Fn>
+	void eachChunk(Fn&& fn);
+	template <typename... Cs, typename Fn>
+	void each(Fn&& fn);
+	template <typename... Cs, typename Fn>
+	void parallelEachChunk(Fn&& fn);
+	template <typename... Cs, typename Fn>
+	void parallelEach(Fn&& fn);
+
+	// применить отложенные изменения по порядку записи (не во время обхода); буфер очищается
+	void flush(EcsCommandBuffer& cmd);
+	// все сущности и чанки (чанки уходят в запас и переиспользуются)
+	void clear();
+
+	uint32_t entityCount() const { return alive_; }
+	uint32_t archetypeCount() const { return (uint32_t)archetypes_.size(); }
+	uint32_t chunkCount() const;
+
+private:
+	struct Record {
+		Archetype* archetype = nullptr;
+		uint32_t row = 0;
+		uint32_t generation = 0;
+	};
+	struct ChunkRef {
+		Archetype* archetype;
+		uint32_t chunk;
+	};
+
+	Entity createWithMask(ComponentMask mask);
+	void* addComponent(Entity e, ComponentId id);
+	void removeComponent(Entity e, ComponentId id);
+	void* componentPtr(Entity e, ComponentId id) const;
+
+	Archetype* archetype(ComponentMask mask);
+	uint32_t pushRow(Archetype* a, Entity e);
+	void eraseRow(Archetype* a, uint32_t row);
+	void moveEntity(Record& r, Archetype* to);
+	void collectChunks(ComponentMask mask, std::vector<ChunkRef>& out) const;
+
+	EcsChunk* allocChunk();
+
+	std::vector<std::unique_ptr<Archetype>> archetypes_;
+	std::unordered_map<ComponentMask, Archetype*> byMask_;
+	std::vector<Record> records_; // по Entity::index
+	std::vector<uint32_t> freeIndices_;
+	std::vector<EcsChunk*> freeChunks_;
+	uint32_t alive_ = 0;
+};
+
+// Отложенные структурные изменения: можно писать из обхода, в т.ч. из нескольких потоков
+// (запись под мьютексом), World::flush() применяет. Создание отложенное -> Entity становится известна
+// только после flush().
+class EcsCommandBuffer {
+public:
+	template <typename... Cs>
+	void create(const Cs&... cs);
+	void destroy(Entity e);
+	template <typename T>
+	void add(Entity e, const T& value);
+	template <typename T>
+	void remove(Entity e);
+
+	bool empty() const { return commands_.empty(); }
+	size_t size() const { return commands_.size(); }
+	void clear();
+
+private:
+	friend class World;
+
+	enum Op : uint32_t { Create, Destroy, Add, Remove };
+	struct Command {
+		Op op = Destroy;
+		Entity entity;
+		ComponentMask mask = 0; // Create: набор; Remove: один бит
+		uint32_t first = 0;     // первый payload
+		uint32_t count = 0;
+	};
+	struct Payload {
+		ComponentId id;
+		uint32_t offset; // в bytes_
+	};
+
+	void pushPayload(ComponentId id, const void* src, uint32_t size);
+
+	std::vector<Command> commands_;
+	std::vector<Payload> payloads_;
+	std::vector<unsigned char> bytes_;
+	std::mutex mutex_;
+};
+
+template <typename... Cs>
+Entity World::create(const Cs&... cs) {
+	Entity e = createWithMask(componentMask<Cs...>());
+	(std::memcpy(componentPtr(e, componentId<Cs>()), &cs, sizeof(Cs)), ...);
+	return e;
+}
+
+template <typename T>
+void World::add(Entity e, const T& value) {
+	if (void* p = addComponent(e, componentId<T>())) std::memcpy(p, &value, sizeof(T));
+}
+
+template <typename... Cs, typename Fn>
+void World::eachChunk(Fn&& fn) {
+	const ComponentMask mask = componentMask<Cs...>();
+	for (const std::unique_ptr<Archetype>& a : archetypes_) {
+		if ((a->mask & mask) != mask) continue;
+		for (uint32_t c = 0; c < (uint32_t)a->chunks.size(); ++c) {
+			EcsChunk* ch = a->chunks[c];
+			fn(a->chunkSize(c), (const Entity*)a->entities(ch), a->template data<Cs>(ch)...);
+		}
+	}
+}
+
+template <typename... Cs, typename Fn>
+void World::each(Fn&& fn) {
+	eachChunk<Cs...>([&fn](uint32_t n, const Entity*, Cs*... arrays) {
+		for (uint32_t i = 0; i < n; ++i) fn(arrays[i]...);
+	});
+}
+
+template <typename... Cs, typename Fn>
+void World::parallelEachChunk(Fn&& fn) {
+	std::vector<ChunkRef> chunks;
+	collectChunks(componentMask<Cs...>(), chunks);
+	jobSystem().parallelFor((uint32_t)chunks.size(), 1, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			Archetype* a = chunks[i].archetype;
+			EcsChunk* ch = a->chunks[chunks[i].chunk];
+			fn(a->chunkSize(chunks[i].chunk), (const Entity*)a->entities(ch), a->template data<Cs>(ch)...);
+		}
+	});
+}
+
+template <typename... Cs, typename Fn>
+void World::parallelEach(Fn&& fn) {
+	parallelEachChunk<Cs...>([&fn](uint32_t n, const Entity*, Cs*... arrays) {
+		for (uint32_t i = 0; i < n; ++i) fn(arrays[i]...);
+	});
+}
+
+template <typename... Cs>
+void EcsCommandBuffer::create(const Cs&... cs) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	Command c;
+	c.op = Create;
+	c.mask = componentMask<Cs...>();
+	c.first = (uint32_t)payloads_.size();
+	c.count = (uint32_t)sizeof...(Cs);
+	(pushPayload(componentId<Cs>(), &cs, (uint32_t)sizeof(Cs)), ...);
+	commands_.push_back(c);
+}
+
+template <typename T>
+void EcsCommandBuffer::add(Entity e, const T& value) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	Command c;
+	c.op = Add;
+	c.entity = e;
+	c.first = (uint32_t)payloads_.size();
+	c.count = 1;
+	pushPayload(componentId<T>(), &value, (uint32_t)sizeof(T));
+	commands_.push_back(c);
+}
+
+template <typename T>
+void EcsCommandBuffer::remove(Entity e) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	Command c;
+	c.op = Remove;
+	c.entity = e;
+	c.mask = ComponentMask(1) << componentId<T>();
+	commands_.push_back(c);
+}
@@ -0,0 +1,89 @@
+#include "core/FrameArena.h"
+#include <algorithm>
+#include <new>
+
+namespace {
+
+size_t alignUp(size_t v, size_t align) {
+    return (v + align - 1) & ~(align - 1);
+}
+
+} // namespace
+
+FrameArena& frameArena() {
+    thread_local FrameArena arena;
+    return arena;
+}
+
+FrameArena::~FrameArena() {
+    releaseOverflow(0);
+    ::operator delete(base_);
+}
+
+void* FrameArena::alloc(size_t size, size_t align) {
+    if (!base_) base_ = static_cast<unsigned char*>(::operator new(capacity_));
+
+    // выравниваем адрес, а не смещение: блок выровнен только на max_align_t
+    const uintptr_t start = reinterpret_cast<uintptr_t>(base_);
+    const size_t offset = alignUp(start + offset_, align) - start;
+    if (offset + size <= capacity_ && overflow_.empty()) {
+        offset_ = offset + size;
+        highWater_ = std::max(highWater_, offset_ + overflowBytes_);
+        return base_ + offset;
+    }
+    return allocOverflow(size, align);
+}
+
+void* FrameArena::allocOverflow(size_t size, size_t align) {
+    // хвост основного блока уже не используем: после первого overflow всё идёт в отдельные блоки
+    const size_t bytes = size + (align > alignof(std::max_align_t) ? align : 0);
+    Block b{ ::operator new(bytes), bytes };
+    overflow_.push_back(b);
+    overflowBytes_ += bytes;
+    overflowPeak_ = std::max(overflowPeak_, offset_ + overflowBytes_);
+    overflowCount_++;
+    highWater_ = std::max(highWater_, offset_ + overflowBytes_);
+
+    const uintptr_t p = reinterpret_cast<uintptr_t>(b.ptr);
+    return reinterpret_cast<void*>(alignUp(p, align));
+}
+
+void FrameArena::releaseOverflow(size_t keep) {
+    while (overflow_.size() > keep) {
+        overflowBytes_ -= overflow_.back().size;
+        ::operator delete(overflow_.back().ptr);
+        overflow_.pop_back();
+    }
+}
+
+void FrameArena::reset() {
+    releaseOverflow(0);
+    offset_ = 0;
+    if (overflowPeak_ > capacity_) {
+        // кадр не поместился: основной блок — под пик, с запасом, чтобы не расти по чуть-чуть
+        ::operator delete(base_);
+        capacity_ = alignUp(overflowPeak_ + overflowPeak_ / 2, 4096);
+        base_ = static_cast<unsigned char*>(::operator new(capacity_));
+    }
+    overflowPeak_ = 0;
+    overflowCount_ = 0;
+}
+
+void FrameArena::rewind(const Marker& m) {
+    // внешний scope (арена снова пуста) — то же, что reset(): заодно вырастет основной блок
+    if (m.offset == 0 && m.overflowBlocks == 0) {
+        reset();
+        return;
+    }
+    releaseOverflow(m.overflowBlocks);
+    offset_ = std::min(offset_, m.offset);
+}
+
+FrameArenaStats FrameArena::stats() const {
+    FrameArenaStats s;
+    s.used = offset_ + overflowBytes_;
+    s.capacity = capacity_;
+    s.highWater = highWater_;
+    s.overflows = overflowCount_;
+    return s;
+}
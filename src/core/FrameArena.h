@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Линейный (bump) аллокатор на кадр: alloc() — сдвиг указателя, free нет, всё разом уходит в reset().
+// По арене на поток (frameArena()), без блокировок:
+//  - game-поток сбрасывает свою в начале кадра (Engine::run), render-поток — перед каждым пакетом;
+//  - в задачах JobSystem и во вспомогательных функциях — FrameArenaScope: что выделено внутри,
+//    отдаётся на выходе из scope (арена как стек), к границе кадра не привязано.
+// Блок не вместил -> дополнительный блок с кучи (overflow); на reset() арена вырастает
+// до пика одним блоком, и после разогрева кадры кучу не трогают.
+// Указатели из арены живут до reset()/выхода из scope — в члены классов их не сохраняют.
+
+struct FrameArenaStats {
+	size_t used = 0;      // сейчас (с overflow)
+	size_t capacity = 0;  // основной блок
+	size_t highWater = 0; // пик с запуска
+	uint32_t overflows = 0; // блоков с кучи с последнего reset()
+};
+
+class FrameArena {
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 1u << 20;
+
+	// точка отката (FrameArenaScope)
+	struct Marker {
+		size_t offset;
+		size_t overflowBlocks;
+	};
+
+	// блок выделяется при первом alloc(): поток, который арену не трогает, ничего не платит
+	explicit FrameArena(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
+	~FrameArena();
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// align — степень двойки
+	void* alloc(size_t size, size_t align = alignof(std::max_align_t));
+	template <typename T>
+	T* allocArray(size_t count) { return static_cast<T*>(alloc(count * sizeof(T), alignof(T))); }
+
+	void reset();
+	Marker mark() const { return { offset_, overflow_.size() }; }
+	void rewind(const Marker& m);
+
+	FrameArenaStats stats() const;
+
+private:
+	void* allocOverflow(size_t size, size_t align);
+	void releaseOverflow(size_t keep);
+
+	unsigned char* base_ = nullptr;
+	size_t capacity_ = 0;
+	size_t offset_ = 0;
+	size_t highWater_ = 0;
+
+	struct Block {
+		void* ptr;
+		size_t size;
+	};
+	std::vector<Block> overflow_;
+	size_t overflowBytes_ = 0;
+	size_t overflowPeak_ = 0; // пик с последнего reset(): до него вырастет основной блок
+	uint32_t overflowCount_ = 0;
+};
+
+// арена вызывающего потока
+FrameArena& frameArena();
+
+// всё, что выделено из арены внутри scope, освобождается на выходе
+class FrameArenaScope {
+public:
+	explicit FrameArenaScope(FrameArena& arena = frameArena()) : arena_(arena), marker_(arena.mark()) {}
+	~FrameArenaScope() { arena_.rewind(marker_); }
+	FrameArenaScope(const FrameArenaScope&) = delete;
+	FrameArenaScope& operator=(const FrameArenaScope&) = delete;
+
+private:
+	FrameArena& arena_;
+	FrameArena::Marker marker_;
+};
+
+// STL-аллокатор поверх арены (по умолчанию — арены вызывающего потока). deallocate ничего не делает:
+// рост вектора оставляет старый буфер в арене до отката, поэтому размер лучше резервировать сразу
+template <typename T>
+class ArenaAllocator {
+public:
+	using value_type = T;
+
+	ArenaAllocator() : arena_(&frameArena()) {}
+	explicit ArenaAllocator(FrameArena& arena) : arena_(&arena) {}
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& o) : arena_(o.arena()) {}
+
+	T* allocate(size_t n) { return arena_->allocArray<T>(n); }
+	void deallocate(T*, size_t) {}
+
+	FrameArena* arena() const { return arena_; }
+
+	template <typename U>
+	bool operator==(const ArenaAllocator<U>& o) const { return arena_ == o.arena(); }
+	template <typename U>
+	bool operator!=(const ArenaAllocator<U>& o) const { return arena_ != o.arena(); }
+
+private:
+	FrameArena* arena_;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,217 @@
+#include "core/FrameStats.h"
+#include "core/Profiler.h"
+#include <SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace {
+const double GAMMA = (1.0 + QuantileSketch::ACCURACY) / (1.0 - QuantileSketch::ACCURACY);
+const double LOG_GAMMA = std::log(GAMMA);
+
+const char* CHANNEL_NAMES[] = { "frame", "cpu", "gpu" };
+
+// границы корзин гистограммы времени кадра в JSON, мс
+const float HISTOGRAM_EDGES[] = { 0.0f, 2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f, 14.0f, 16.7f, 20.0f, 25.0f, 33.3f, 50.0f, 100.0f };
+}
+
+uint32_t QuantileSketch::bucket(float ms) {
+    if (!(ms > MIN_MS)) return 0;
+    double b = 1.0 + std::floor(std::log((double)ms / MIN_MS) / LOG_GAMMA);
+    return (uint32_t)std::min(b, (double)(BUCKETS - 1));
+}
+
+float QuantileSketch::bucketValue(uint32_t b) {
+    if (b == 0) return 0.0f; // <= MIN_MS, в основном "нет данных" (GPU без timestamp'ов)
+    // середина [MIN * g^(b-1), MIN * g^b): относительная ошибка <= ACCURACY
+    return (float)(MIN_MS * std::pow(GAMMA, (double)(b - 1)) * (1.0 + GAMMA) * 0.5);
+}
+
+float QuantileSketch::quantile(double q) const {
+    if (total_ == 0) return 0.0f;
+    const double rank = std::clamp(q, 0.0, 1.0) * (double)(total_ - 1);
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < BUCKETS; ++b) {
+        seen += counts_[b];
+        if ((double)seen > rank) return bucketValue(b);
+    }
+    return bucketValue(BUCKETS - 1);
+}
+
+uint64_t QuantileSketch::countBetween(float lo, float hi) const {
+    uint64_t n = 0;
+    const uint32_t b0 = bucket(lo);
+    const uint32_t b1 = hi > 0.0f ? bucket(hi) : BUCKETS;
+    for (uint32_t b = b0; b < b1 && b < BUCKETS; ++b) n += counts_[b];
+    return n;
+}
+
+void FrameStats::setOutput(const std::string& csvPath, const std::string& jsonPath, double period) {
+    csvPath_ = csvPath;
+    jsonPath_ = jsonPath;
+    period_ = period > 0.0 ? period : 5.0;
+    csvHeader_ = false;
+}
+
+void FrameStats::addFrame(double frameMs) {
+    if (totalFrames_ == 0 && frameMs <= 0.0) return;
+
+    Sample s;
+    s.ms[(size_t)FrameChannel::Frame] = (float)frameMs;
+    s.ms[(size_t)FrameChannel::Cpu] = pendingCpu_;
+    s.ms[(size_t)FrameChannel::Gpu] = pendingGpu_;
+
+    if (window_.size() < WINDOW) {
+        window_.push_back(s);
+    }
+    else {
+        // вытесняем самый старый кадр окна
+        const Sample& old = window_[next_];
+        for (size_t c = 0; c < (size_t)FrameChannel::Count; ++c) {
+            sketches_[c].remove(old.ms[c]);
+            sums_[c] -= old.ms[c];
+        }
+        window_[next_] = s;
+    }
+    next_ = (next_ + 1) % WINDOW;
+    for (size_t c = 0; c < (size_t)FrameChannel::Count; ++c) {
+        sketches_[c].add(s.ms[c]);
+        sums_[c] += s.ms[c];
+    }
+    totalFrames_++;
+    elapsed_ += frameMs * 0.001;
+
+    if (frameMs > hitchMs_) {
+        Hitch h;
+        h.frame = totalFrames_;
+        h.atSeconds = elapsed_;
+        h.frameMs = (float)frameMs;
+        h.cpuMs = pendingCpu_;
+        h.gpuMs = pendingGpu_;
+
+        // что выполнялось: сводка профайлера за этот же (только что закончившийся) кадр
+        const std::vector<ZoneSummary>& zones = profiler().frameSummary();
+        char buf[64];
+        for (size_t i = 0; i < zones.size() && i < 4; ++i) {
+            std::snprintf(buf, sizeof(buf), "%s%s=%.2f", i ? " " : "", zones[i].name, zones[i].totalMs);
+            h.running += buf;
+        }
+        if (h.running.empty()) h.running = "(no profiler zones)";
+
+        SDL_Log("hitch: %.2f ms (cpu %.2f gpu %.2f) frame %llu: %s", h.frameMs, h.cpuMs, h.gpuMs,
+            (unsigned long long)h.frame, h.running.c_str());
+
+        hitchCount_++;
+        if (hitches_.size() == MAX_HITCHES) hitches_.erase(hitches_.begin());
+        hitches_.push_back(std::move(h));
+    }
+
+    sinceOutput_ += frameMs * 0.001;
+    if (sinceOutput_ >= period_ && (!csvPath_.empty() || !jsonPath_.empty())) {
+        sinceOutput_ = 0.0;
+        writeOutputs(summary());
+    }
+}
+
+FrameStatsSummary FrameStats::summary() const {
+    FrameStatsSummary s;
+    s.frames = window_.size();
+    s.totalFrames = totalFrames_;
+    s.hitches = hitchCount_;
+    if (window_.empty()) return s;
+
+    for (size_t c = 0; c < (size_t)FrameChannel::Count; ++c) {
+        ChannelSummary& cs = s.channels[c];
+        const QuantileSketch& q = sketches_[c];
+        for (const Sample& smp : window_) cs.max = std::max(cs.max, smp.ms[c]);
+        cs.avg = (float)(sums_[c] / (double)window_.size());
+        // середина корзины может оказаться выше реального максимума
+        cs.p50 = std::min(q.quantile(0.50), cs.max);
+        cs.p95 = std::min(q.quantile(0.95), cs.max);
+        cs.p99 = std::min(q.quantile(0.99), cs.max);
+        cs.p999 = std::min(q.quantile(0.999), cs.max);
+    }
+    return s;
+}
+
+void FrameStats::flush() {
+    if (totalFrames_ == 0 || (csvPath_.empty() && jsonPath_.empty())) return;
+    sinceOutput_ = 0.0;
+    writeOutputs(summary());
+}
+
+void FrameStats::writeOutputs(const FrameStatsSummary& s) {
+    if (!csvPath_.empty()) {
+        std::ofstream f(csvPath_, csvHeader_ ? std::ios::app : std::ios::trunc);
+        if (!f) {
+            std::cerr << "frame stats: can't open " << csvPath_ << "\n";
+        }
+        else {
+            if (!csvHeader_) {
+                f << "time_s,frames";
+                for (const char* ch : CHANNEL_NAMES)
+                    f << "," << ch << "_avg," << ch << "_p50," << ch << "_p95," << ch << "_p99," << ch << "_p999," << ch << "_max";
+                f << ",low1_fps,low01_fps,hitches\n";
+                csvHeader_ = true;
+            }
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "%.3f,%llu", elapsed_, (unsigned long long)s.frames);
+            f << buf;
+            for (const ChannelSummary& c : s.channels) {
+                std::snprintf(buf, sizeof(buf), ",%.3f,%.3f,%.3f,%.3f,%.3f,%.3f", c.avg, c.p50, c.p95, c.p99, c.p999, c.max);
+                f << buf;
+            }
+            std::snprintf(buf, sizeof(buf), ",%.1f,%.1f,%llu\n", s.low1Fps(), s.low01Fps(), (unsigned long long)s.hitches);
+            f << buf;
+        }
+    }
+
+    if (!jsonPath_.empty()) {
+        std::ofstream f(jsonPath_, std::ios::trunc);
+        if (!f) {
+            std::cerr << "frame stats: can't open " << jsonPath_ << "\n";
+            return;
+        }
+        char buf[192];
+        std::snprintf(buf, sizeof(buf), "{\n  \"time_s\": %.3f,\n  \"frames\": %llu,\n  \"total_frames\": %llu,\n",
+            elapsed_, (unsigned long long)s.frames, (unsigned long long)s.totalFrames);
+        f << buf;
+        for (size_t c = 0; c < (size_t)FrameChannel::Count; ++c) {
+            const ChannelSummary& cs = s.channels[c];
+            std::snprintf(buf, sizeof(buf),
+                "  \"%s\": { \"avg\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"p999\": %.3f, \"max\": %.3f },\n",
+                CHANNEL_NAMES[c], cs.avg, cs.p50, cs.p95, cs.p99, cs.p999, cs.max);
+            f << buf;
+        }
+        std::snprintf(buf, sizeof(buf), "  \"low1_fps\": %.1f,\n  \"low01_fps\": %.1f,\n", s.low1Fps(), s.low01Fps());
+        f << buf;
+
+        // гистограмма окна по времени кадра
+        const QuantileSketch& frame = sketches_[(size_t)FrameChannel::Frame];
+        const size_t edges = sizeof(HISTOGRAM_EDGES) / sizeof(HISTOGRAM_EDGES[0]);
+        f << "  \"histogram\": [";
+        for (size_t i = 0; i < edges; ++i) {
+            float lo = HISTOGRAM_EDGES[i];
+            float hi = i + 1 < edges ? HISTOGRAM_EDGES[i + 1] : 0.0f; // 0 = до бесконечности
+            char to[16] = "null";
+            if (hi > 0.0f) std::snprintf(to, sizeof(to), "%.1f", hi);
+            std::snprintf(buf, sizeof(buf), "%s{ \"from_ms\": %.1f, \"to_ms\": %s, \"frames\": %llu }",
+                i ? ", " : "", lo, to, (unsigned long long)frame.countBetween(lo, hi));
+            f << buf;
+        }
+        f << "],\n";
+
+        std::snprintf(buf, sizeof(buf), "  \"hitch_threshold_ms\": %.1f,\n  \"hitches\": %llu,\n  \"recent_hitches\": [",
+            hitchMs_, (unsigned long long)s.hitches);
+        f << buf;
+        for (size_t i = 0; i < hitches_.size(); ++i) {
+            const Hitch& h = hitches_[i];
+            std::snprintf(buf, sizeof(buf), "%s\n    { \"frame\": %llu, \"at_s\": %.3f, \"frame_ms\": %.2f, \"cpu_ms\": %.2f, \"gpu_ms\": %.2f, \"running\": \"",
+                i ? "," : "", (unsigned long long)h.frame, h.atSeconds, h.frameMs, h.cpuMs, h.gpuMs);
+            f << buf << h.running << "\" }";
+        }
+        f << "\n  ]\n}\n";
+    }
+}
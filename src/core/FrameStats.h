@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Гистограмма с логарифмическими корзинами (как DDSketch): квантиль с относительной ошибкой ~1%
+// при фиксированной памяти. Значения можно и убирать — так считается скользящее окно.
+class QuantileSketch {
+public:
+	static constexpr float MIN_MS = 0.01f;     // меньше — в первую корзину
+	static constexpr float MAX_MS = 10000.0f;  // больше — в последнюю
+	static constexpr float ACCURACY = 0.01f;   // относительная ошибка квантиля
+	static constexpr uint32_t BUCKETS = 700;   // log(MAX/MIN) / log((1+a)/(1-a))
+
+	void add(float ms) { counts_[bucket(ms)]++; total_++; }
+	void remove(float ms) { counts_[bucket(ms)]--; total_--; }
+	void clear() { counts_.fill(0); total_ = 0; }
+
+	uint64_t count() const { return total_; }
+	// q в [0, 1]; 0 при пустом окне
+	float quantile(double q) const;
+	// сколько значений в [lo, hi) (с точностью до корзины)
+	uint64_t countBetween(float lo, float hi) const;
+
+private:
+	static uint32_t bucket(float ms);
+	static float bucketValue(uint32_t b);
+
+	std::array<uint32_t, BUCKETS> counts_{};
+	uint64_t total_ = 0;
+};
+
+// Каналы времени кадра
+enum class FrameChannel : uint32_t { Frame, Cpu, Gpu, Count };
+
+struct ChannelSummary {
+	float avg = 0.0f;
+	float p50 = 0.0f;
+	float p95 = 0.0f;
+	float p99 = 0.0f;
+	float p999 = 0.0f;
+	float max = 0.0f;
+};
+
+struct FrameStatsSummary {
+	uint64_t frames = 0;  // в окне
+	uint64_t totalFrames = 0;
+	uint64_t hitches = 0; // за всё время
+	std::array<ChannelSummary, (size_t)FrameChannel::Count> channels{};
+
+	const ChannelSummary& frame() const { return channels[(size_t)FrameChannel::Frame]; }
+	const ChannelSummary& cpu() const { return channels[(size_t)FrameChannel::Cpu]; }
+	const ChannelSummary& gpu() const { return channels[(size_t)FrameChannel::Gpu]; }
+	// "1% low" / "0.1% low" в FPS — по p99 / p99.9 времени кадра
+	float low1Fps() const { return frame().p99 > 0.0f ? 1000.0f / frame().p99 : 0.0f; }
+	float low01Fps() const { return frame().p999 > 0.0f ? 1000.0f / frame().p999 : 0.0f; }
+};
+
+// Кадр дольше порога: когда и что выполнялось (самые дорогие зоны профайлера в этом кадре)
+struct Hitch {
+	uint64_t frame = 0;
+	double atSeconds = 0.0;
+	float frameMs = 0.0f;
+	float cpuMs = 0.0f;
+	float gpuMs = 0.0f;
+	std::string running;
+};
+
+// Статистика времени кадров: скользящее окно WINDOW кадров по трём каналам (кадр целиком,
+// CPU, GPU), квантили по QuantileSketch, зависания. Время кадра приходит из Time::tick();
+// CPU/GPU кадра сообщает движок по ходу кадра (reportCpu/reportGpu) — tick() следующего кадра
+// закрывает сэмпл. Раз в period секунд — строка в CSV и снимок в JSON (если заданы пути).
+class FrameStats {
+public:
+	static constexpr uint32_t WINDOW = 2048;   // кадров в окне (~8 с на 240 Гц)
+	static constexpr uint32_t MAX_HITCHES = 64; // последние, для JSON
+
+	void setHitchThreshold(float ms) { hitchMs_ = ms; }
+	float hitchThreshold() const { return hitchMs_; }
+	// пути пустые -> файлов нет; period — секунды реального времени
+	void setOutput(const std::string& csvPath, const std::string& jsonPath, double period);
+
+	void reportCpu(float ms) { pendingCpu_ = ms; }
+	void reportGpu(float ms) { pendingGpu_ = ms; }
+
+	// Time::tick(): длительность прошлого кадра (без ограничения dt)
+	void addFrame(double frameMs);
+
+	FrameStatsSummary summary() const;
+	// записать CSV/JSON сейчас (в конце запуска), не дожидаясь периода
+	void flush();
+	const std::vector<Hitch>& hitches() const { return hitches_; }
+	uint64_t hitchCount() const { return hitchCount_; }
+
+private:
+	void writeOutputs(const FrameStatsSummary& s);
+
+	struct Sample {
+		float ms[(size_t)FrameChannel::Count];
+	};
+	std::vector<Sample> window_;  // кольцо
+	uint32_t next_ = 0;
+	std::array<QuantileSketch, (size_t)FrameChannel::Count> sketches_;
+	std::array<double, (size_t)FrameChannel::Count> sums_{};
+
+	float pendingCpu_ = 0.0f;
+	float pendingGpu_ = 0.0f;
+	uint64_t totalFrames_ = 0;
+	double elapsed_ = 0.0; // секунд, сумма кадров
+
+	float hitchMs_ = 33.3f;
+	uint64_t hitchCount_ = 0;
+	std::vector<Hitch> hitches_;
+
+	std::string csvPath_;
+	std::string jsonPath_;
+	double period_ = 5.0;
+	double sinceOutput_ = 0.0;
+	bool csvHeader_ = false;
+};
@@ -0,0 +1,53 @@
+#include "core/InputQueue.h"
+
+void InputQueue::install() {
+    if (installed_) return;
+    SDL_AddEventWatch(&InputQueue::watch, this);
+    installed_ = true;
+}
+
+void InputQueue::uninstall() {
+    if (!installed_) return;
+    SDL_DelEventWatch(&InputQueue::watch, this);
+    installed_ = false;
+}
+
+bool InputQueue::push(const InputEvent& e) {
+    uint32_t h = head_.load(std::memory_order_relaxed);
+    if (h - tail_.load(std::memory_order_acquire) >= CAPACITY) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ring_[h & (CAPACITY - 1)] = e;
+    head_.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+int SDLCALL InputQueue::watch(void* user, SDL_Event* e) {
+    InputEvent ev;
+    switch (e->type) {
+    case SDL_MOUSEMOTION:
+        ev.type = InputEvent::MouseMove;
+        ev.dx = (float)e->motion.xrel;
+        ev.dy = (float)e->motion.yrel;
+        break;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        if (e->key.repeat) return 1; // автоповтор — не новое нажатие
+        ev.type = InputEvent::Key;
+        ev.down = (e->type == SDL_KEYDOWN);
+        ev.code = (uint16_t)e->key.keysym.scancode;
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        ev.type = InputEvent::MouseButton;
+        ev.down = (e->type == SDL_MOUSEBUTTONDOWN);
+        ev.code = e->button.button;
+        break;
+    default:
+        return 1;
+    }
+    ev.time = (uint64_t)SDL_GetPerformanceCounter();
+    static_cast<InputQueue*>(user)->push(ev);
+    return 1; // для watch значение не используется
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <SDL.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Событие ввода с моментом прихода (SDL_GetPerformanceCounter)
+struct InputEvent {
+	enum Type : uint8_t { MouseMove, Key, MouseButton };
+
+	uint64_t time = 0;
+	Type type = MouseMove;
+	bool down = false;  // Key / MouseButton
+	uint16_t code = 0;  // SDL_Scancode или номер кнопки мыши
+	float dx = 0.0f;    // MouseMove: относительное движение в отсчётах мыши
+	float dy = 0.0f;
+};
+
+// Lock-free очередь ввода (один писатель, один читатель).
+// Писатель — SDL event watch: вызывается в момент, когда SDL кладёт событие в свою очередь
+// (SDL_PumpEvents), там же ставится штамп времени. Читатель — симуляция (UserCmdBuilder): разбирает
+// события по sim-тикам, в порядке прихода. Переполнение -> событие теряется (считается в dropped()).
+// Точность штампа — частота SDL_PumpEvents (каждый кадр + late latch), SDL2 точнее время не отдаёт.
+class InputQueue {
+public:
+	static constexpr uint32_t CAPACITY = 4096; // степень двойки; ~0.5 с мыши на 8 кГц
+
+	// подписка на события SDL (до первого SDL_PumpEvents) и отписка
+	void install();
+	void uninstall();
+
+	// писатель
+	bool push(const InputEvent& e);
+
+	// читатель: i-е непрочитанное событие (i < size()), pop() — снять первое
+	uint32_t size() const {
+		return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+	}
+	const InputEvent& peek(uint32_t i) const {
+		return ring_[(tail_.load(std::memory_order_relaxed) + i) & (CAPACITY - 1)];
+	}
+	void pop() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+	uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+	static int SDLCALL watch(void* user, SDL_Event* e);
+
+	alignas(64) std::atomic<uint32_t> head_{ 0 }; // пишет писатель
+	alignas(64) std::atomic<uint32_t> tail_{ 0 }; // пишет читатель
+	std::atomic<uint64_t> dropped_{ 0 };
+	std::array<InputEvent, CAPACITY> ring_;
+	bool installed_ = false;
+};
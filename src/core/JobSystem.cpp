@@ -0,0 +1,284 @@
+#include "core/JobSystem.h"
+#include <cstdio>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define DW_CPU_PAUSE() _mm_pause()
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DW_CPU_PAUSE() _mm_pause()
+#else
+#define DW_CPU_PAUSE() std::this_thread::yield()
+#endif
+
+namespace {
+// индекс worker'а текущего потока, -1 = поток не из системы
+thread_local int t_worker = -1;
+}
+
+// Chase-Lev дека фиксированного размера (Lê et al. 2013). Вместо seq_cst-барьеров — seq_cst операции
+// над top/bottom (то же упорядочивание, но понятно TSAN). push/pop — только владелец, steal — кто угодно.
+class JobSystem::WorkDeque {
+public:
+    bool push(Job* job) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= (int64_t)QUEUE_SIZE) return false;
+        buffer_[b & (QUEUE_SIZE - 1)].store(job, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release); // публикует и слот, и содержимое задачи
+        return true;
+    }
+
+    Job* pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_seq_cst);
+
+        if (t > b) {
+            // пусто
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job* job = buffer_[b & (QUEUE_SIZE - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            // последний элемент: гонка с вором за top
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job* steal() {
+        int64_t t = top_.load(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_seq_cst);
+        if (t >= b) return nullptr;
+
+        Job* job = buffer_[t & (QUEUE_SIZE - 1)].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr; // проиграли другому вору или владельцу
+        return job;
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> top_{ 0 };
+    alignas(64) std::atomic<int64_t> bottom_{ 0 };
+    std::atomic<Job*> buffer_[QUEUE_SIZE];
+};
+
+struct JobSystem::Worker {
+    WorkDeque deque;
+    Job pool[JOB_POOL];
+    uint32_t poolNext = 0;
+    uint32_t rng = 0;            // xorshift для выбора жертвы
+    std::atomic<uint64_t> executed{ 0 };
+    std::atomic<uint64_t> stolen{ 0 };
+    std::thread thread;
+};
+
+JobSystem& jobSystem() {
+    static JobSystem js;
+    return js;
+}
+
+bool JobSystem::init(uint32_t workers) {
+    if (running()) return true;
+
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, MAX_WORKERS);
+
+    quit_ = false;
+    externalPool_ = std::make_unique<Job[]>(JOB_POOL);
+    workers_.reserve(workers);
+    for (uint32_t i = 0; i < workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+        workers_[i]->rng = 0x9E3779B9u * (i + 1);
+    }
+
+    t_worker = 0;
+    for (uint32_t i = 1; i < workers; ++i)
+        workers_[i]->thread = std::thread([this, i]() { workerLoop(i); });
+
+    return true;
+}
+
+void JobSystem::shutdown() {
+    if (!running()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        quit_ = true;
+    }
+    sleepCv_.notify_all();
+    for (auto& w : workers_)
+        if (w->thread.joinable()) w->thread.join();
+
+    workers_.clear();
+    t_worker = -1;
+
+    // то, что никто не забрал (не должно быть: перед shutdown все ждут свои счётчики)
+    std::lock_guard<std::mutex> lock(sharedMutex_);
+    for (Job* j : shared_)
+        if (j->heap) delete j;
+    shared_.clear();
+    sharedCount_ = 0;
+    externalPool_.reset();
+}
+
+Job* JobSystem::allocJob() {
+    if (t_worker < 0) {
+        // потоков не из системы может быть несколько: слот берём CAS'ом
+        for (uint32_t n = 0; n < JOB_POOL; ++n) {
+            Job& j = externalPool_[externalNext_.fetch_add(1, std::memory_order_relaxed) & (JOB_POOL - 1)];
+            uint32_t expected = 0;
+            if (j.busy.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                j.heap = 0;
+                return &j;
+            }
+        }
+        Job* j = new Job();
+        j->heap = 1;
+        return j;
+    }
+
+    // ищем свободный слот с курсора; обычно первый же свободен
+    Worker& w = *workers_[t_worker];
+    for (uint32_t n = 0; n < JOB_POOL; ++n) {
+        Job& j = w.pool[w.poolNext++ & (JOB_POOL - 1)];
+        if (j.busy.load(std::memory_order_acquire) == 0) {
+            j.busy.store(1, std::memory_order_relaxed);
+            j.heap = 0;
+            return &j;
+        }
+    }
+    Job* j = new Job();
+    j->heap = 1;
+    return j;
+}
+
+void JobSystem::submit(Job* job) {
+    bool queued = false;
+    if (t_worker >= 0) {
+        queued = workers_[t_worker]->deque.push(job);
+    } else {
+        std::lock_guard<std::mutex> lock(sharedMutex_);
+        shared_.push_back(job);
+        sharedCount_.fetch_add(1, std::memory_order_release);
+        queued = true;
+    }
+
+    if (!queued) {
+        // дека полна: работы и так с запасом, выполняем сами
+        execute(job);
+        return;
+    }
+
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        sleepCv_.notify_one();
+    }
+}
+
+Job* JobSystem::findJob(int self) {
+    if (self >= 0) {
+        if (Job* j = workers_[self]->deque.pop()) return j;
+    }
+
+    if (sharedCount_.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(sharedMutex_);
+        if (!shared_.empty()) {
+            Job* j = shared_.back();
+            shared_.pop_back();
+            sharedCount_.fetch_sub(1, std::memory_order_relaxed);
+            return j;
+        }
+    }
+
+    // воруем, начиная со случайной жертвы
+    uint32_t n = (uint32_t)workers_.size();
+    uint32_t start = 0;
+    if (self >= 0) {
+        uint32_t& x = workers_[self]->rng;
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        start = x % n;
+    }
+    for (uint32_t k = 0; k < n; ++k) {
+        uint32_t v = (start + k) % n;
+        if ((int)v == self) continue;
+        if (Job* j = workers_[v]->deque.steal()) {
+            if (self >= 0) workers_[self]->stolen.fetch_add(1, std::memory_order_relaxed);
+            return j;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job* job) {
+    JobCounter* counter = job->counter;
+    {
+        MemTagScope tag(job->memTag);
+        job->invoke(*job);
+    }
+
+    if (t_worker >= 0) workers_[t_worker]->executed.fetch_add(1, std::memory_order_relaxed);
+
+    // слот освобождаем до счётчика: после него ждущий может уничтожить всё, что захвачено
+    if (job->heap) delete job;
+    else job->busy.store(0, std::memory_order_release);
+    counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.done()) {
+        if (Job* j = findJob(t_worker)) execute(j);
+        else DW_CPU_PAUSE();
+    }
+}
+
+void JobSystem::workerLoop(uint32_t index) {
+    t_worker = (int)index;
+    char name[24];
+    std::snprintf(name, sizeof(name), "worker %u", index);
+    setMemThreadName(name);
+
+    while (!quit_.load(std::memory_order_relaxed)) {
+        uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+
+        Job* job = nullptr;
+        for (uint32_t spin = 0; spin < SPIN_ROUNDS && !job; ++spin) {
+            job = findJob((int)index);
+            if (!job) DW_CPU_PAUSE();
+        }
+        if (job) {
+            execute(job);
+            continue;
+        }
+
+        // работы нет: спим, пока кто-нибудь не сделает submit (epoch сменится)
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        sleepCv_.wait(lock, [&]() {
+            return quit_.load(std::memory_order_relaxed) || epoch_.load(std::memory_order_seq_cst) != epoch;
+        });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    t_worker = -1;
+}
+
+JobStats JobSystem::stats() const {
+    JobStats s;
+    for (const auto& w : workers_) {
+        s.executed += w->executed.load(std::memory_order_relaxed);
+        s.stolen += w->stolen.load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+void JobSystem::resetStats() {
+    for (auto& w : workers_) {
+        w->executed.store(0, std::memory_order_relaxed);
+        w->stolen.store(0, std::memory_order_relaxed);
+    }
+}
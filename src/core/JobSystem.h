@@ -0,0 +1,162 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "core/MemoryTracker.h"
+
+// Job system: по worker'у на ядро, у каждого своя Chase-Lev дека.
+//  - владелец кладёт/берёт задачи с низа деки (LIFO, горячий кэш), остальные воруют сверху;
+//  - поток, вызвавший init(), — worker 0: его задачи тоже воруют, а в wait() он сам выполняет чужие;
+//  - задача = указатель на функцию + захват до Job::PAYLOAD байт (без аллокаций);
+//  - JobCounter — handle группы задач и зависимость: wait(counter) возвращается, когда все выполнены;
+//  - задача выполняется с тегом памяти (MemTagScope) того, кто её поставил.
+// Потоки не из системы (рендер и т.п.) тоже могут run()/wait(): их задачи идут в общую очередь,
+// слоты задач — из общего пула (на кучу — только если и он кончился).
+
+struct JobCounter {
+	std::atomic<uint32_t> pending{ 0 };
+	bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+struct alignas(64) Job {
+	static constexpr size_t PAYLOAD = 40;
+
+	void (*invoke)(Job&) = nullptr;
+	JobCounter* counter = nullptr;
+	std::atomic<uint32_t> busy{ 0 }; // слот пула занят (снимает выполнивший поток)
+	uint8_t heap = 0;                // выделена через new (поток не из системы или пул кончился)
+	MemTag memTag = MemTag::Other;   // тег памяти поставившего: задача выполняется с ним же
+	alignas(8) unsigned char payload[PAYLOAD];
+};
+
+struct JobStats {
+	uint64_t executed = 0;
+	uint64_t stolen = 0;
+};
+
+class JobSystem {
+public:
+	static constexpr uint32_t MAX_WORKERS = 64;
+	static constexpr uint32_t QUEUE_SIZE = 4096; // задач в деке (степень двойки); переполнение -> выполняем сразу
+	static constexpr uint32_t JOB_POOL = 8192;   // слотов задач на поток (степень двойки)
+	static constexpr uint32_t SPIN_ROUNDS = 256; // попыток найти работу перед сном
+
+	// workers = 0 -> по числу ядер; вызывающий поток становится worker 0
+	bool init(uint32_t workers = 0);
+	void shutdown();
+
+	bool running() const { return !workers_.empty(); }
+	uint32_t workerCount() const { return running() ? (uint32_t)workers_.size() : 1; }
+
+	// f() в какой-нибудь worker'е; counter += 1 сейчас, -= 1 по завершении.
+	// Без init() выполняется сразу в вызывающем потоке.
+	template <typename F>
+	void run(JobCounter& counter, F&& f);
+
+	// ждёт counter == 0, выполняя задачи (свои и краденые), а не засыпая
+	void wait(JobCounter& counter);
+
+	// [0, count) режется пополам, пока кусок больше grain; правые половины уходят в деку и их воруют.
+	// grain адаптивный: ~8 кусков на worker, но не мельче minGrain. fn(begin, end) из разных потоков.
+	template <typename F>
+	void parallelFor(uint32_t count, uint32_t minGrain, const F& fn);
+
+	JobStats stats() const;
+	void resetStats();
+
+private:
+	class WorkDeque;
+	struct Worker;
+
+	Job* allocJob();
+	void submit(Job* job);
+	Job* findJob(int self);
+	void execute(Job* job);
+	void workerLoop(uint32_t index);
+
+	template <typename F>
+	void forRange(const F* fn, uint32_t grain, JobCounter* counter, uint32_t begin, uint32_t end);
+
+	std::vector<std::unique_ptr<Worker>> workers_;
+
+	// задачи от потоков не из системы
+	std::unique_ptr<Job[]> externalPool_; // JOB_POOL слотов, занимаются CAS'ом по busy
+	std::atomic<uint32_t> externalNext_{ 0 };
+	std::mutex sharedMutex_;
+	std::vector<Job*> shared_;
+	std::atomic<uint32_t> sharedCount_{ 0 };
+
+	// сон без работы: epoch растёт на каждый submit, worker спит, пока он не сменится
+	std::mutex sleepMutex_;
+	std::condition_variable sleepCv_;
+	std::atomic<uint32_t> sleepers_{ 0 };
+	std::atomic<uint32_t> epoch_{ 0 };
+	std::atomic<bool> quit_{ false };
+};
+
+// общий экземпляр: init/shutdown делает Engine (или тул), parallelFor ниже ходит сюда
+JobSystem& jobSystem();
+
+template <typename F>
+void JobSystem::run(JobCounter& counter, F&& f) {
+	using Fn = std::decay_t<F>;
+	static_assert(sizeof(Fn) <= Job::PAYLOAD, "job capture is too large, capture a pointer to the data instead");
+	static_assert(alignof(Fn) <= 8, "job capture is over-aligned");
+	static_assert(std::is_trivially_copyable_v<Fn> && std::is_trivially_destructible_v<Fn>,
+		"job capture must be trivially copyable (capture by reference or pointer)");
+
+	if (!running()) {
+		f();
+		return;
+	}
+
+	Job* job = allocJob();
+	new (job->payload) Fn(std::forward<F>(f));
+	job->invoke = [](Job& j) { (*std::launder(reinterpret_cast<Fn*>(j.payload)))(); };
+	job->counter = &counter;
+	job->memTag = currentMemTag();
+	counter.pending.fetch_add(1, std::memory_order_relaxed);
+	submit(job);
+}
+
+template <typename F>
+void JobSystem::forRange(const F* fn, uint32_t grain, JobCounter* counter, uint32_t begin, uint32_t end) {
+	while (end - begin > grain) {
+		uint32_t mid = begin + (end - begin) / 2;
+		run(*counter, [this, fn, grain, counter, mid, end]() { forRange(fn, grain, counter, mid, end); });
+		end = mid;
+	}
+	(*fn)(begin, end);
+}
+
+template <typename F>
+void JobSystem::parallelFor(uint32_t count, uint32_t minGrain, const F& fn) {
+	if (count == 0) return;
+	uint32_t workers = workerCount();
+	uint32_t grain = std::max(std::max(minGrain, 1u), count / (workers * 8));
+	if (workers <= 1 || count <= grain) {
+		fn(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	forRange(&fn, grain, &counter, 0, count);
+	wait(counter);
+}
+
+// совместимость с прежним core/Parallel: всё идёт через общий JobSystem
+template <typename F>
+void parallelFor(uint32_t count, uint32_t minGrain, const F& fn) {
+	jobSystem().parallelFor(count, minGrain, fn);
+}
+
+// сколько потоков (включая вызывающий) делят работу parallelFor
+inline uint32_t parallelWorkerCount() { return jobSystem().workerCount(); }
@@ -0,0 +1,200 @@
+#include "core/MemoryTracker.h"
+#include "core/AllocCounter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <ostream>
+
+namespace {
+
+constexpr size_t TAGS = (size_t)MemTag::Count;
+constexpr uint32_t MAX_THREADS = 256; // слот 0 — общий для потоков сверх лимита
+
+const char* const TAG_NAMES[TAGS] = { "other", "game", "renderer", "assets", "physics", "net" };
+
+// Счётчики потока. Свой слот поток меняет load + store (без RMW), отчёт читает relaxed:
+// значения могут отставать на несколько выделений, но не рвутся. Общий слот 0 — fetch_add.
+struct alignas(64) ThreadMem {
+    std::atomic<int64_t> live[TAGS] = {};
+    std::atomic<uint64_t> total[TAGS] = {};
+    std::atomic<uint64_t> allocs[TAGS] = {};
+    std::atomic<uint64_t> frees[TAGS] = {};
+    std::atomic<int64_t> liveAll{ 0 };
+    std::atomic<int64_t> peak{ 0 }; // пик liveAll (для потока, который сам же и освобождает)
+    char name[32] = {};
+};
+
+ThreadMem g_threads[MAX_THREADS];
+std::atomic<uint32_t> g_threadCount{ 0 };
+
+// пики по снимкам: пишет memorySample()
+std::mutex g_sampleMutex;
+int64_t g_peak[TAGS] = {};
+int64_t g_peakAll = 0;
+
+// тривиальные типы: доступны и при разрушении потока, когда его thread_local-объекты уже ушли
+thread_local ThreadMem* t_mem = nullptr;
+thread_local MemTag t_tag = MemTag::Other;
+
+ThreadMem& threadMem() {
+    if (!t_mem) {
+        uint32_t i = g_threadCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        t_mem = i < MAX_THREADS ? &g_threads[i] : &g_threads[0];
+    }
+    return *t_mem;
+}
+
+template <typename T>
+void bump(std::atomic<T>& a, T v, bool shared) {
+    if (shared) a.fetch_add(v, std::memory_order_relaxed);
+    else a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+uint32_t usedSlots() {
+    return std::min(g_threadCount.load(std::memory_order_relaxed) + 1, MAX_THREADS);
+}
+
+double mb(int64_t bytes) {
+    return (double)bytes / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+const char* memTagName(MemTag tag) {
+    return (size_t)tag < TAGS ? TAG_NAMES[(size_t)tag] : "?";
+}
+
+MemTag currentMemTag() {
+    return t_tag;
+}
+
+void setCurrentMemTag(MemTag tag) {
+    t_tag = tag;
+}
+
+void setMemThreadName(const char* name) {
+    ThreadMem& t = threadMem();
+    if (&t == &g_threads[0]) return; // общий слот не переименовываем
+    std::snprintf(t.name, sizeof(t.name), "%s", name);
+}
+
+void memTrackAlloc(MemTag tag, size_t bytes) {
+    ThreadMem& t = threadMem();
+    const bool shared = &t == &g_threads[0];
+    const size_t i = (size_t)tag;
+    bump(t.live[i], (int64_t)bytes, shared);
+    bump(t.total[i], (uint64_t)bytes, shared);
+    bump(t.allocs[i], (uint64_t)1, shared);
+    bump(t.liveAll, (int64_t)bytes, shared);
+    if (!shared) {
+        const int64_t live = t.liveAll.load(std::memory_order_relaxed);
+        if (live > t.peak.load(std::memory_order_relaxed)) t.peak.store(live, std::memory_order_relaxed);
+    }
+}
+
+void memTrackFree(MemTag tag, size_t bytes) {
+    ThreadMem& t = threadMem();
+    const bool shared = &t == &g_threads[0];
+    const size_t i = (size_t)tag;
+    bump(t.live[i], -(int64_t)bytes, shared);
+    bump(t.frees[i], (uint64_t)1, shared);
+    bump(t.liveAll, -(int64_t)bytes, shared);
+}
+
+void memorySample() {
+    int64_t live[TAGS] = {};
+    const uint32_t slots = usedSlots();
+    for (uint32_t s = 0; s < slots; ++s)
+        for (size_t i = 0; i < TAGS; ++i) live[i] += g_threads[s].live[i].load(std::memory_order_relaxed);
+
+    int64_t all = 0;
+    std::lock_guard<std::mutex> lock(g_sampleMutex);
+    for (size_t i = 0; i < TAGS; ++i) {
+        g_peak[i] = std::max(g_peak[i], live[i]);
+        all += live[i];
+    }
+    g_peakAll = std::max(g_peakAll, all);
+}
+
+MemoryStats memoryStats() {
+    memorySample();
+
+    MemoryStats st;
+    const uint32_t slots = usedSlots();
+    for (uint32_t s = 0; s < slots; ++s) {
+        const ThreadMem& t = g_threads[s];
+        for (size_t i = 0; i < TAGS; ++i) {
+            MemTagStats& ts = st.tags[i];
+            ts.liveBytes += t.live[i].load(std::memory_order_relaxed);
+            ts.totalBytes += t.total[i].load(std::memory_order_relaxed);
+            ts.allocs += t.allocs[i].load(std::memory_order_relaxed);
+            ts.frees += t.frees[i].load(std::memory_order_relaxed);
+        }
+    }
+    for (size_t i = 0; i < TAGS; ++i) st.liveBytes += st.tags[i].liveBytes;
+
+    std::lock_guard<std::mutex> lock(g_sampleMutex);
+    for (size_t i = 0; i < TAGS; ++i) st.tags[i].peakBytes = std::max(g_peak[i], st.tags[i].liveBytes);
+    st.peakBytes = std::max(g_peakAll, st.liveBytes);
+    st.threads = g_threadCount.load(std::memory_order_relaxed);
+    return st;
+}
+
+void printMemoryReport(std::ostream& out) {
+    if (!DW_MEM_TRACKING) {
+        out << "memory: tracking is off (build with DW_MEM_TRACKING=ON)\n";
+        return;
+    }
+
+    // снимок до форматирования: сам отчёт тоже выделяет (ostream)
+    const MemoryStats st = memoryStats();
+    char line[160];
+    out << "memory (CPU heap):\n";
+    std::snprintf(line, sizeof(line), "  %-10s %10s %10s %11s %12s %12s\n", "tag", "live MB", "peak MB", "total MB",
+        "allocs", "frees");
+    out << line;
+    for (size_t i = 0; i < TAGS; ++i) {
+        const MemTagStats& t = st.tags[i];
+        if (t.allocs == 0 && t.frees == 0) continue;
+        std::snprintf(line, sizeof(line), "  %-10s %10.2f %10.2f %11.1f %12llu %12llu\n", TAG_NAMES[i], mb(t.liveBytes),
+            mb(t.peakBytes), mb((int64_t)t.totalBytes), (unsigned long long)t.allocs, (unsigned long long)t.frees);
+        out << line;
+    }
+    std::snprintf(line, sizeof(line), "  %-10s %10.2f %10.2f %11s %12llu\n", "all", mb(st.liveBytes), mb(st.peakBytes),
+        "", (unsigned long long)heapAllocCount());
+    out << line;
+
+    // по потокам: что поток выделил минус что он же освободил (память, отданная другому потоку, —
+    // в минусе у освободившего)
+    out << "  threads:\n";
+    const uint32_t slots = usedSlots();
+    for (uint32_t s = 0; s < slots; ++s) {
+        const ThreadMem& t = g_threads[s];
+        uint64_t allocs = 0;
+        for (size_t i = 0; i < TAGS; ++i) allocs += t.allocs[i].load(std::memory_order_relaxed);
+        if (allocs == 0) continue;
+
+        char name[40];
+        if (s == 0) std::snprintf(name, sizeof(name), "(shared)");
+        else if (t.name[0]) std::snprintf(name, sizeof(name), "%s", t.name);
+        else std::snprintf(name, sizeof(name), "thread %u", s);
+        std::snprintf(line, sizeof(line), "  %-16s live %9.2f MB  peak %9.2f MB  %12llu allocs\n", name,
+            mb(t.liveAll.load(std::memory_order_relaxed)), mb(t.peak.load(std::memory_order_relaxed)),
+            (unsigned long long)allocs);
+        out << line;
+    }
+}
+
+void* memAlloc(size_t size, MemTag tag, size_t align) {
+    MemTagScope scope(tag);
+    if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(size, std::align_val_t(align));
+    return ::operator new(size);
+}
+
+void memFree(void* p, size_t align) {
+    if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(p, std::align_val_t(align));
+    else ::operator delete(p);
+}
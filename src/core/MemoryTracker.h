@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Учёт памяти CPU по подсистемам. DW_MEM_TRACKING=1 (CMake-опция): подмена operator new/delete
+// (AllocCounter.cpp) кладёт перед каждым блоком размер и тег — текущий тег потока (MemTagScope).
+// Задачи JobSystem выполняются с тегом того, кто их поставил.
+// Счётчики у каждого потока свои (пишет только владелец — без блокировок и общих кэш-линий),
+// отчёт их суммирует. Освобождение списывается со счёта освободившего потока: у отдельного потока
+// "живых" байт бывает меньше нуля, сумма по потокам точная.
+// Без DW_MEM_TRACKING теги почти ничего не стоят, счётчики пустые.
+
+#ifndef DW_MEM_TRACKING
+#define DW_MEM_TRACKING 0
+#endif
+
+enum class MemTag : uint8_t {
+	Other,    // вне scope'ов: старт, потоки библиотек
+	Game,     // игровой кадр, сцена, ECS
+	Renderer,
+	Assets,   // загрузка и генерация мешей, уровень
+	Physics,  // движение и коллизии
+	Net,
+	Count
+};
+const char* memTagName(MemTag tag);
+
+MemTag currentMemTag();
+void setCurrentMemTag(MemTag tag);
+
+// тег потока на время scope'а (вложенные восстанавливают прежний)
+class MemTagScope {
+public:
+	explicit MemTagScope(MemTag tag) : prev_(currentMemTag()) { setCurrentMemTag(tag); }
+	~MemTagScope() { setCurrentMemTag(prev_); }
+	MemTagScope(const MemTagScope&) = delete;
+	MemTagScope& operator=(const MemTagScope&) = delete;
+
+private:
+	MemTag prev_;
+};
+
+// имя вызывающего потока в отчёте (иначе "thread N"); строка копируется
+void setMemThreadName(const char* name);
+
+struct MemTagStats {
+	int64_t liveBytes = 0;
+	int64_t peakBytes = 0;   // по снимкам memorySample() (раз в кадр) и на момент запроса
+	uint64_t totalBytes = 0; // выделено с запуска
+	uint64_t allocs = 0;
+	uint64_t frees = 0;
+};
+
+struct MemoryStats {
+	MemTagStats tags[(size_t)MemTag::Count];
+	int64_t liveBytes = 0;
+	int64_t peakBytes = 0;
+	uint32_t threads = 0; // потоков, которые выделяли
+};
+
+MemoryStats memoryStats();
+// снимок пиков по тегам; зовёт game-поток раз в кадр (или сервер раз в тик)
+void memorySample();
+// по тегам и по потокам
+void printMemoryReport(std::ostream& out);
+
+// Явные выделения под конкретный тег (буферы подсистемы, которые живут дольше scope'а).
+// Без DW_MEM_TRACKING — обычные operator new/delete.
+void* memAlloc(size_t size, MemTag tag, size_t align = alignof(std::max_align_t));
+void memFree(void* p, size_t align = alignof(std::max_align_t));
+
+// STL-аллокатор: все выделения контейнера — на счёт Tag, где бы он ни рос
+template <typename T, MemTag Tag>
+class TaggedAllocator {
+public:
+	using value_type = T;
+	template <typename U>
+	struct rebind { using other = TaggedAllocator<U, Tag>; };
+
+	TaggedAllocator() = default;
+	template <typename U>
+	TaggedAllocator(const TaggedAllocator<U, Tag>&) {}
+
+	T* allocate(size_t n) { return static_cast<T*>(memAlloc(n * sizeof(T), Tag, alignof(T))); }
+	void deallocate(T* p, size_t) { memFree(p, alignof(T)); }
+
+	template <typename U>
+	bool operator==(const TaggedAllocator<U, Tag>&) const { return true; }
+	template <typename U>
+	bool operator!=(const TaggedAllocator<U, Tag>&) const { return false; }
+};
+
+// для подмены operator new/delete (AllocCounter.cpp)
+void memTrackAlloc(MemTag tag, size_t bytes);
+void memTrackFree(MemTag tag, size_t bytes);
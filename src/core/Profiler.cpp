@@ -0,0 +1,249 @@
+#include "core/Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+struct Profiler::ThreadBuffer {
+    alignas(64) std::atomic<uint32_t> head{ 0 }; // пишет поток-владелец
+    alignas(64) std::atomic<uint32_t> tail{ 0 }; // пишет frameMark()
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<bool> released{ false };         // поток-владелец завершился, буфер можно отдать новому
+    uint32_t index = 0;
+    std::string name;                            // под registryMutex_
+    ProfileEvent ring[RING_SIZE];
+};
+
+namespace {
+thread_local Profiler::ThreadBuffer* t_buffer = nullptr;
+thread_local bool t_exited = false;
+
+// при выходе потока отдаёт его кольцо обратно: перезапуск потоков (F12 — рендер) не плодит буферы.
+// Недобранные события остаются в кольце, frameMark() заберёт их как обычно.
+struct ThreadRelease {
+    Profiler::ThreadBuffer* buffer = nullptr;
+    ~ThreadRelease() {
+        if (!buffer) return;
+        t_buffer = nullptr;
+        t_exited = true; // зоны из деструкторов других thread_local этого потока больше не пишутся
+        buffer->released.store(true, std::memory_order_release);
+    }
+};
+thread_local ThreadRelease t_release;
+
+// имена зон — литералы из кода, но кавычку/обратный слэш всё равно экранируем
+void writeJsonString(std::ofstream& f, const char* s) {
+    f << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') f << '\\';
+        f << *s;
+    }
+    f << '"';
+}
+}
+
+Profiler& profiler() {
+    static Profiler p;
+    return p;
+}
+
+void Profiler::init() {
+    setThreadName("main");
+
+    baseTime_ = std::chrono::steady_clock::now();
+    baseTicks_ = profilerTicks();
+#ifdef DW_PROFILE_RDTSC
+    // частота TSC: 10 мс на старте, дальше ticksToUs() берёт всё прошедшее время
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - baseTime_).count();
+    usPerTick_ = us / (double)std::max<uint64_t>(1, profilerTicks() - baseTicks_);
+#endif
+}
+
+double Profiler::ticksToUs() const {
+#ifdef DW_PROFILE_RDTSC
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - baseTime_).count();
+    if (us > 1e6) return us / (double)(profilerTicks() - baseTicks_);
+#endif
+    return usPerTick_;
+}
+
+Profiler::ThreadBuffer* Profiler::threadBuffer() {
+    if (t_buffer) return t_buffer;
+    if (t_exited) return nullptr;
+
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    ThreadBuffer* buffer = nullptr;
+    for (const auto& b : threads_) {
+        if (b->released.load(std::memory_order_acquire)) {
+            // head/tail не трогаем: frameMark() дочитает то, что оставил прошлый владелец
+            b->released.store(false, std::memory_order_relaxed);
+            buffer = b.get();
+            break;
+        }
+    }
+    if (!buffer) {
+        threads_.push_back(std::make_unique<ThreadBuffer>());
+        buffer = threads_.back().get();
+        buffer->index = (uint32_t)threads_.size() - 1;
+    }
+    buffer->name = "thread " + std::to_string(buffer->index);
+    t_buffer = buffer;
+    t_release.buffer = buffer;
+    return t_buffer;
+}
+
+void Profiler::push(const ProfileEvent& e) {
+    ThreadBuffer* b = t_buffer ? t_buffer : profiler().threadBuffer();
+    if (!b) return;
+    uint32_t h = b->head.load(std::memory_order_relaxed);
+    if (h - b->tail.load(std::memory_order_acquire) >= RING_SIZE) {
+        // frameMark() давно не забирал (поток без кадров, или кадр с тысячами зон)
+        b->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    b->ring[h & (RING_SIZE - 1)] = e;
+    b->head.store(h + 1, std::memory_order_release);
+}
+
+void Profiler::counter(const char* name, double value) {
+    ProfileEvent e;
+    e.kind = ProfileEvent::Counter;
+    e.name = name;
+    e.start = profilerTicks();
+    static_assert(sizeof(double) == sizeof(uint64_t), "counter value is stored in ProfileEvent::end");
+    std::memcpy(&e.end, &value, sizeof(value));
+    push(e);
+}
+
+void Profiler::setThreadName(const char* name) {
+    ThreadBuffer* b = threadBuffer();
+    if (!b) return;
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    b->name = name;
+}
+
+uint64_t Profiler::droppedEvents() const {
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    uint64_t n = 0;
+    for (const auto& b : threads_) n += b->dropped.load(std::memory_order_relaxed);
+    return n;
+}
+
+void Profiler::frameMark() {
+    const uint64_t now = profilerTicks();
+    const double msPerTick = ticksToUs() * 0.001;
+    frameMs_ = lastMark_ ? (float)((double)(now - lastMark_) * msPerTick) : 0.0f;
+    lastMark_ = now;
+
+    // потоки регистрируются редко: под мьютексом только копируем список
+    // (буферы завершившихся потоков переиспользуются, так что он не растёт)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        draining_.clear();
+        for (const auto& b : threads_) draining_.push_back(b.get());
+    }
+
+    summary_.clear();
+    for (ThreadBuffer* buffer : draining_) {
+        ThreadBuffer& b = *buffer;
+        const uint32_t h = b.head.load(std::memory_order_acquire);
+        const uint32_t t = b.tail.load(std::memory_order_relaxed);
+        for (uint32_t k = t; k != h; ++k) {
+            const ProfileEvent& e = b.ring[k & (RING_SIZE - 1)];
+
+            if (e.kind == ProfileEvent::Zone) {
+                float ms = (float)((double)(e.end - e.start) * msPerTick);
+                auto it = std::find_if(summary_.begin(), summary_.end(),
+                    [&](const ZoneSummary& z) { return z.name == e.name; });
+                if (it == summary_.end()) {
+                    summary_.push_back({ e.name, 0, 0.0f, 0.0f });
+                    it = summary_.end() - 1;
+                }
+                it->calls++;
+                it->totalMs += ms;
+                it->maxMs = std::max(it->maxMs, ms);
+            }
+
+            if (capturing_ && capture_.size() < MAX_CAPTURE && e.start >= captureStart_) {
+                capture_.push_back(e);
+                captureThread_.push_back(b.index);
+            }
+        }
+        b.tail.store(h, std::memory_order_release);
+    }
+
+    std::sort(summary_.begin(), summary_.end(),
+        [](const ZoneSummary& a, const ZoneSummary& b) { return a.totalMs > b.totalMs; });
+
+    if (capturing_) marks_.push_back(now);
+}
+
+void Profiler::beginCapture() {
+    capture_.clear();
+    captureThread_.clear();
+    marks_.clear();
+    captureStart_ = profilerTicks();
+    capturing_ = true;
+}
+
+bool Profiler::endCapture(const std::string& path) {
+    capturing_ = false;
+
+    std::ofstream f(path);
+    if (!f) {
+        std::cerr << "profiler: can't open " << path << "\n";
+        return false;
+    }
+
+    const double usPerTick = ticksToUs();
+    auto ts = [&](uint64_t t) { return (double)(int64_t)(t - captureStart_) * usPerTick; };
+    char buf[128];
+    // запятая перед каждой записью, кроме первой: список может быть пустым в любой части
+    bool first = true;
+    auto next = [&]() -> std::ofstream& {
+        if (!first) f << ",\n";
+        first = false;
+        return f;
+    };
+
+    f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        for (const auto& b : threads_) {
+            next() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->index << ",\"args\":{\"name\":";
+            writeJsonString(f, b->name.c_str());
+            f << "}}";
+        }
+    }
+    for (uint64_t m : marks_) {
+        std::snprintf(buf, sizeof(buf), "%.3f", ts(m));
+        next() << "{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":" << buf << "}";
+    }
+    for (size_t i = 0; i < capture_.size(); ++i) {
+        const ProfileEvent& e = capture_[i];
+        next() << "{\"name\":";
+        writeJsonString(f, e.name);
+        if (e.kind == ProfileEvent::Zone) {
+            std::snprintf(buf, sizeof(buf), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", ts(e.start),
+                (double)(e.end - e.start) * usPerTick);
+            f << buf;
+        }
+        else {
+            double value;
+            std::memcpy(&value, &e.end, sizeof(value));
+            std::snprintf(buf, sizeof(buf), ",\"ph\":\"C\",\"ts\":%.3f,\"args\":{\"value\":%g}", ts(e.start), value);
+            f << buf;
+        }
+        f << ",\"pid\":1,\"tid\":" << captureThread_[i] << "}";
+    }
+    f << "\n]}\n";
+
+    if (!f) {
+        std::cerr << "profiler: write failed " << path << "\n";
+        return false;
+    }
+    return true;
+}
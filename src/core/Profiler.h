@@ -0,0 +1,155 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define DW_PROFILE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define DW_PROFILE_RDTSC 1
+#endif
+
+// CPU-профайлер: зоны (PROFILE_SCOPE), счётчики, границы кадров.
+//  - зона пишет событие в кольцо своего потока (SPSC, без блокировок): два rdtsc, thread_local
+//    указатель на кольцо и запись 32 байт (замер — darkwave_profbench);
+//  - PROFILE_FRAME() на главном потоке раз в кадр забирает кольца всех потоков: сводка по зонам
+//    за кадр (frameSummary) и, если идёт запись, — в буфер trace'а;
+//  - endCapture() пишет Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Имена зон и счётчиков — строковые литералы (хранится указатель).
+// DW_PROFILE=0 (CMake-опция) убирает все макросы; сам Profiler остаётся, но ничего не получает.
+
+#ifndef DW_PROFILE
+#define DW_PROFILE 1
+#endif
+
+// штамп времени в тиках профайлера (rdtsc или steady_clock в нс)
+inline uint64_t profilerTicks() {
+#ifdef DW_PROFILE_RDTSC
+	return __rdtsc();
+#else
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct ProfileEvent {
+	enum Kind : uint32_t { Zone, Counter };
+
+	const char* name = nullptr;
+	uint64_t start = 0;
+	uint64_t end = 0;     // Counter: значение (биты double)
+	Kind kind = Zone;
+	uint32_t depth = 0;   // вложенность зоны в своём потоке
+};
+
+// сводка одной зоны за кадр (включая вложенные)
+struct ZoneSummary {
+	const char* name = nullptr;
+	uint32_t calls = 0;
+	float totalMs = 0.0f;
+	float maxMs = 0.0f;
+};
+
+class Profiler {
+public:
+	static constexpr uint32_t RING_SIZE = 8192;       // событий на поток между двумя PROFILE_FRAME
+	static constexpr uint32_t MAX_CAPTURE = 4u << 20; // событий в одном trace'е
+
+	// вызывающий поток (главный) делает frameMark(); калибрует тики относительно steady_clock
+	void init();
+
+	// поток: пишет событие в своё кольцо (регистрирует поток при первом вызове).
+	// static: горячий путь ProfileZone не проходит проверку инициализации profiler()
+	static void push(const ProfileEvent& e);
+	void counter(const char* name, double value);
+	void setThreadName(const char* name);
+
+	// главный поток, раз в кадр
+	void frameMark();
+
+	// сводка по зонам прошлого кадра, по убыванию времени
+	const std::vector<ZoneSummary>& frameSummary() const { return summary_; }
+	float frameMs() const { return frameMs_; }
+	uint64_t droppedEvents() const;
+
+	// запись trace'а: с beginCapture() до endCapture() (главный поток)
+	void beginCapture();
+	bool endCapture(const std::string& path);
+	bool capturing() const { return capturing_; }
+
+	// вложенность зон текущего потока (ProfileZone)
+	static uint32_t& threadDepth() {
+		thread_local uint32_t depth = 0;
+		return depth;
+	}
+
+	struct ThreadBuffer; // кольцо потока (Profiler.cpp)
+
+private:
+	ThreadBuffer* threadBuffer();
+	double ticksToUs() const;
+
+	mutable std::mutex registryMutex_;
+	std::vector<std::unique_ptr<ThreadBuffer>> threads_;
+	std::vector<ThreadBuffer*> draining_; // frameMark(): копия threads_ без аллокаций в установившемся режиме
+
+	// калибровка тиков: короткий замер в init(), потом уточняется по всему времени работы
+	uint64_t baseTicks_ = 0;
+	std::chrono::steady_clock::time_point baseTime_;
+	double usPerTick_ = 0.001;
+
+	uint64_t lastMark_ = 0;
+	std::vector<uint64_t> marks_; // границы кадров в trace'е
+	std::vector<ZoneSummary> summary_;
+	float frameMs_ = 0.0f;
+
+	bool capturing_ = false;
+	std::vector<ProfileEvent> capture_;
+	std::vector<uint32_t> captureThread_; // индекс потока на событие
+	uint64_t captureStart_ = 0;
+};
+
+Profiler& profiler();
+
+// RAII-зона: штамп в конструкторе, событие в деструкторе
+class ProfileZone {
+public:
+	explicit ProfileZone(const char* name) : name_(name), depth_(Profiler::threadDepth()++), start_(profilerTicks()) {}
+	~ProfileZone() {
+		uint64_t end = profilerTicks();
+		--Profiler::threadDepth();
+		ProfileEvent e;
+		e.name = name_;
+		e.start = start_;
+		e.end = end;
+		e.depth = depth_;
+		Profiler::push(e);
+	}
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	const char* name_;
+	uint32_t depth_;
+	uint64_t start_;
+};
+
+#if DW_PROFILE
+#define DW_PROFILE_CONCAT2(a, b) a##b
+#define DW_PROFILE_CONCAT(a, b) DW_PROFILE_CONCAT2(a, b)
+#define PROFILE_SCOPE(name) ProfileZone DW_PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FRAME() profiler().frameMark()
+#define PROFILE_COUNTER(name, value) profiler().counter(name, (double)(value))
+#define PROFILE_THREAD(name) profiler().setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
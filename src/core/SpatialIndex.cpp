@@ -0,0 +1,290 @@
+#include "core/SpatialIndex.h"
+#include "core/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int32_t GRID_BIAS = 1 << 20;     // индекс ячейки сетки -> 21 бит без знака
+    constexpr uint64_t UNCHANGED = ~0ull - 1;  // батч: ячейка не сменилась
+    constexpr uint32_t OCTREE_MAX_DEPTH = 15;  // уровень в ключе octree — 4 бита
+
+    bool overlaps(const Vec3& amin, const Vec3& amax, const Vec3& bmin, const Vec3& bmax) {
+        return amin.x <= bmax.x && amax.x >= bmin.x &&
+            amin.y <= bmax.y && amax.y >= bmin.y &&
+            amin.z <= bmax.z && amax.z >= bmin.z;
+    }
+
+    float distance2(const Vec3& p, const Vec3& bmin, const Vec3& bmax) {
+        float dx = std::max(std::max(bmin.x - p.x, 0.0f), p.x - bmax.x);
+        float dy = std::max(std::max(bmin.y - p.y, 0.0f), p.y - bmax.y);
+        float dz = std::max(std::max(bmin.z - p.z, 0.0f), p.z - bmax.z);
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    float maxExtent(const Vec3& bmin, const Vec3& bmax) {
+        return std::max(bmax.x - bmin.x, std::max(bmax.y - bmin.y, bmax.z - bmin.z));
+    }
+
+    uint64_t gridKey(int32_t x, int32_t y, int32_t z) {
+        auto c = [](int32_t v) { return (uint64_t)(std::clamp(v, -GRID_BIAS, GRID_BIAS - 1) + GRID_BIAS); };
+        return (c(x) << 42) | (c(y) << 21) | c(z);
+    }
+
+    uint64_t octreeKey(uint32_t level, uint32_t x, uint32_t y, uint32_t z) {
+        return ((uint64_t)level << 60) | ((uint64_t)x << 40) | ((uint64_t)y << 20) | z;
+    }
+}
+
+void SpatialIndex::configure(const SpatialIndexConfig& config) {
+    config_ = config;
+    config_.cellSize = std::max(config_.cellSize, 1e-3f);
+    config_.worldSize = std::max(config_.worldSize, 1e-3f);
+    config_.maxDepth = std::clamp(config_.maxDepth, 1u, OCTREE_MAX_DEPTH);
+    clear();
+}
+
+void SpatialIndex::clear() {
+    proxies_.clear();
+    freeProxies_.clear();
+    cells_.clear();
+    cellOf_.clear();
+    roots_.clear();
+    large_.clear();
+    relinked_ = 0;
+    if (config_.type == SpatialIndexType::LooseOctree) cellFor(octreeKey(0, 0, 0, 0)); // корень
+}
+
+uint64_t SpatialIndex::keyFor(const Vec3& bmin, const Vec3& bmax) const {
+    const Vec3 c = (bmin + bmax) * 0.5f;
+    const float ext = maxExtent(bmin, bmax);
+    if (config_.type == SpatialIndexType::HashedGrid) {
+        const float cs = config_.cellSize;
+        if (!(ext <= cs)) return LARGE_KEY;
+        return gridKey((int32_t)std::floor(c.x / cs), (int32_t)std::floor(c.y / cs), (int32_t)std::floor(c.z / cs));
+    }
+
+    const float inv = 1.0f / config_.worldSize;
+    const float rx = (c.x - config_.origin.x) * inv, ry = (c.y - config_.origin.y) * inv, rz = (c.z - config_.origin.z) * inv;
+    if (!(rx >= 0.0f && rx < 1.0f && ry >= 0.0f && ry < 1.0f && rz >= 0.0f && rz < 1.0f) || !(ext <= config_.worldSize))
+        return LARGE_KEY;
+    // самый глубокий уровень, где объект не больше узла (тогда он внутри рыхлых границ узла центра)
+    uint32_t level = config_.maxDepth;
+    float size = config_.worldSize / (float)(1u << level);
+    while (level > 0 && ext > size) {
+        level--;
+        size *= 2.0f;
+    }
+    const uint32_t n = 1u << level;
+    return octreeKey(level, std::min(n - 1, (uint32_t)(rx * n)), std::min(n - 1, (uint32_t)(ry * n)), std::min(n - 1, (uint32_t)(rz * n)));
+}
+
+uint32_t SpatialIndex::cellFor(uint64_t key) {
+    auto it = cellOf_.find(key);
+    if (it != cellOf_.end()) return it->second;
+
+    Cell cell;
+    cell.key = key;
+    if (config_.type == SpatialIndexType::HashedGrid) {
+        // ячейка или блок 8x8x8 ячеек (рыхлый край тот же — пол-ячейки)
+        const bool block = (key & BLOCK_BIT) != 0;
+        const float cs = config_.cellSize;
+        const float span = block ? cs * 8.0f : cs;
+        const uint64_t x = (key >> 42) & 0x1FFFFF, y = (key >> 21) & 0x1FFFFF, z = key & 0x1FFFFF;
+        auto origin = [&](uint64_t v) { return (float)((int64_t)(block ? v << 3 : v) - GRID_BIAS) * cs; };
+        const Vec3 lo{ origin(x), origin(y), origin(z) };
+        cell.looseMin = lo - Vec3{ cs, cs, cs } * 0.5f;
+        cell.looseMax = lo + Vec3{ span, span, span } + Vec3{ cs, cs, cs } * 0.5f;
+        if (!block) cell.parent = cellFor(BLOCK_BIT | ((x >> 3) << 42) | ((y >> 3) << 21) | (z >> 3));
+    }
+    else {
+        const uint32_t level = (uint32_t)(key >> 60);
+        const uint32_t x = (uint32_t)(key >> 40) & 0xFFFFF, y = (uint32_t)(key >> 20) & 0xFFFFF, z = (uint32_t)key & 0xFFFFF;
+        const float s = config_.worldSize / (float)(1u << level);
+        const Vec3 lo = config_.origin + Vec3{ x * s, y * s, z * s };
+        cell.looseMin = lo - Vec3{ s, s, s } * 0.5f;
+        cell.looseMax = lo + Vec3{ s, s, s } * 1.5f;
+        if (level > 0) cell.parent = cellFor(octreeKey(level - 1, x >> 1, y >> 1, z >> 1));
+    }
+
+    const uint32_t index = (uint32_t)cells_.size();
+    const uint32_t parent = cell.parent;
+    cells_.push_back(std::move(cell));
+    cellOf_.emplace(key, index);
+    if (parent != SPATIAL_NONE) cells_[parent].children.push_back(index);
+    else roots_.push_back(index);
+    return index;
+}
+
+void SpatialIndex::link(uint32_t proxy, uint64_t key) {
+    Proxy& p = proxies_[proxy];
+    if (key == LARGE_KEY) {
+        p.cell = SPATIAL_NONE;
+        p.slot = (uint32_t)large_.size();
+        large_.push_back(proxy);
+        return;
+    }
+    const uint32_t c = cellFor(key);
+    p.cell = c;
+    p.slot = (uint32_t)cells_[c].items.size();
+    cells_[c].items.push_back(proxy);
+    for (uint32_t n = c; n != SPATIAL_NONE; n = cells_[n].parent) cells_[n].subtree++;
+}
+
+void SpatialIndex::unlink(uint32_t proxy) {
+    const Proxy& p = proxies_[proxy];
+    std::vector<uint32_t>& list = p.cell == SPATIAL_NONE ? large_ : cells_[p.cell].items;
+    const uint32_t last = list.back();
+    list[p.slot] = last;
+    proxies_[last].slot = p.slot;
+    list.pop_back();
+    for (uint32_t n = p.cell; n != SPATIAL_NONE; n = cells_[n].parent) cells_[n].subtree--;
+}
+
+uint32_t SpatialIndex::insert(uint32_t userId, const Vec3& bmin, const Vec3& bmax) {
+    uint32_t proxy;
+    if (!freeProxies_.empty()) {
+        proxy = freeProxies_.back();
+        freeProxies_.pop_back();
+    }
+    else {
+        proxy = (uint32_t)proxies_.size();
+        proxies_.push_back({});
+    }
+    Proxy& p = proxies_[proxy];
+    p.min = bmin;
+    p.max = bmax;
+    p.userId = userId;
+    link(proxy, keyFor(bmin, bmax));
+    return proxy;
+}
+
+void SpatialIndex::update(uint32_t proxy, const Vec3& bmin, const Vec3& bmax) {
+    Proxy& p = proxies_[proxy];
+    p.min = bmin;
+    p.max = bmax;
+    const uint64_t key = keyFor(bmin, bmax);
+    const uint64_t current = p.cell == SPATIAL_NONE ? LARGE_KEY : cells_[p.cell].key;
+    if (key == current) return;
+    unlink(proxy);
+    link(proxy, key);
+}
+
+void SpatialIndex::remove(uint32_t proxy) {
+    unlink(proxy);
+    proxies_[proxy].userId = SPATIAL_NONE;
+    freeProxies_.push_back(proxy);
+}
+
+void SpatialIndex::update(const SpatialMove* moves, uint32_t count) {
+    batchKeys_.resize(count);
+    // границы и ключи: у каждого перемещения свой proxy -> пишем без синхронизации
+    auto computeKeys = [this, moves](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            Proxy& p = proxies_[moves[i].proxy];
+            p.min = moves[i].min;
+            p.max = moves[i].max;
+            const uint64_t key = keyFor(p.min, p.max);
+            const uint64_t current = p.cell == SPATIAL_NONE ? LARGE_KEY : cells_[p.cell].key;
+            batchKeys_[i] = key == current ? UNCHANGED : key;
+        }
+    };
+    if (count >= PARALLEL_MIN) parallelFor(count, 1024, computeKeys);
+    else computeKeys(0, count);
+
+    relinked_ = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (batchKeys_[i] == UNCHANGED) continue;
+        unlink(moves[i].proxy);
+        link(moves[i].proxy, batchKeys_[i]);
+        relinked_++;
+    }
+}
+
+void SpatialIndex::apply(SpatialUpdateBuffer& buffer) {
+    update(buffer.moves_.data(), (uint32_t)buffer.moves_.size());
+    buffer.moves_.clear();
+}
+
+template <typename CellTest, typename ObjectTest>
+void SpatialIndex::queryNode(uint32_t cell, const CellTest& cellTest, const ObjectTest& objectTest, std::vector<uint32_t>& out) const {
+    const Cell& c = cells_[cell];
+    if (c.subtree == 0 || !cellTest(c)) return;
+    for (uint32_t proxy : c.items) {
+        const Proxy& p = proxies_[proxy];
+        if (objectTest(p)) out.push_back(p.userId);
+    }
+    for (uint32_t child : c.children) queryNode(child, cellTest, objectTest, out);
+}
+
+template <typename CellTest, typename ObjectTest>
+void SpatialIndex::query(const Vec3& bmin, const Vec3& bmax, bool ranged, const CellTest& cellTest,
+    const ObjectTest& objectTest, std::vector<uint32_t>& out) const {
+    out.clear();
+    for (uint32_t proxy : large_) {
+        const Proxy& p = proxies_[proxy];
+        if (objectTest(p)) out.push_back(p.userId);
+    }
+
+    // octree — от корня; сетка — ячейки, чьи рыхлые границы [i - 1/2, i + 3/2] * cs задевают объём,
+    // а если их больше, чем есть ячеек (или объём не коробка), — через блоки
+    const float inv = 1.0f / config_.cellSize;
+    double lo[3] = {}, hi[3] = {}, volume = 1.0;
+    const float qmin[3] = { bmin.x, bmin.y, bmin.z }, qmax[3] = { bmax.x, bmax.y, bmax.z };
+    for (int a = 0; a < 3 && ranged; ++a) {
+        lo[a] = std::ceil((double)qmin[a] * inv - 1.5);
+        hi[a] = std::floor((double)qmax[a] * inv + 0.5);
+        volume *= std::max(0.0, hi[a] - lo[a] + 1.0);
+    }
+    if (config_.type == SpatialIndexType::LooseOctree || !ranged || volume > (double)cells_.size()) {
+        for (uint32_t root : roots_) queryNode(root, cellTest, objectTest, out);
+        return;
+    }
+
+    auto visit = [&](const Cell& c) {
+        if (c.items.empty() || !cellTest(c)) return;
+        for (uint32_t proxy : c.items) {
+            const Proxy& p = proxies_[proxy];
+            if (objectTest(p)) out.push_back(p.userId);
+        }
+    };
+    for (int32_t x = (int32_t)lo[0]; x <= (int32_t)hi[0]; ++x)
+        for (int32_t y = (int32_t)lo[1]; y <= (int32_t)hi[1]; ++y)
+            for (int32_t z = (int32_t)lo[2]; z <= (int32_t)hi[2]; ++z) {
+                auto it = cellOf_.find(gridKey(x, y, z));
+                if (it != cellOf_.end()) visit(cells_[it->second]);
+            }
+}
+
+void SpatialIndex::queryAabb(const Vec3& bmin, const Vec3& bmax, std::vector<uint32_t>& out) const {
+    query(bmin, bmax, true,
+        [&](const Cell& c) { return overlaps(c.looseMin, c.looseMax, bmin, bmax); },
+        [&](const Proxy& p) { return overlaps(p.min, p.max, bmin, bmax); }, out);
+}
+
+void SpatialIndex::querySphere(const Vec3& center, float radius, std::vector<uint32_t>& out) const {
+    const float r2 = radius * radius;
+    const Vec3 r{ radius, radius, radius };
+    query(center - r, center + r, true,
+        [&](const Cell& c) { return distance2(center, c.looseMin, c.looseMax) <= r2; },
+        [&](const Proxy& p) { return distance2(center, p.min, p.max) <= r2; }, out);
+}
+
+void SpatialIndex::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const {
+    query({}, {}, false,
+        [&](const Cell& c) { return frustum.aabbVisible(c.looseMin, c.looseMax); },
+        [&](const Proxy& p) { return frustum.aabbVisible(p.min, p.max); }, out);
+}
+
+SpatialStats SpatialIndex::stats() const {
+    SpatialStats s;
+    s.proxies = size();
+    s.cells = (uint32_t)cells_.size();
+    s.large = (uint32_t)large_.size();
+    s.relinked = relinked_;
+    return s;
+}
+
+void SpatialUpdateBuffer::push(uint32_t proxy, const Vec3& bmin, const Vec3& bmax) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    moves_.push_back({ proxy, bmin, bmax });
+}
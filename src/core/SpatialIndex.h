@@ -0,0 +1,130 @@
+#pragma once
+#include "math/Frustum.h"
+#include "math/Vec3.h"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Пространственный индекс динамических объектов (AABB): "что рядом с X", "что пересекает объём".
+// Две раскладки на выбор (SpatialIndexConfig::type), интерфейс один:
+//  - HashedGrid:  равномерная сетка в хэш-таблице (мир не ограничен); объект — в ячейке своего центра.
+//                 Ячейка рыхлая (loose): её объекты не выходят за ячейку + cellSize/2 с каждой стороны;
+//                 объекты крупнее ячейки — в общем списке, который проверяется всегда. Ячейки сгруппированы
+//                 в блоки 8x8x8: большой объём (frustum) сначала проверяет блоки;
+//  - LooseOctree: рыхлое (k = 2) октодерево в кубе [origin, origin + worldSize]; объект — в узле
+//                 самого глубокого уровня, куда он помещается по размеру, по центру. Узлы создаются
+//                 по требованию; пустые поддеревья запрос пропускает по счётчику объектов в поддереве.
+// Перемещение — update(): новые границы, ячейка меняется, только если центр/размер ушли из неё (без перестроек).
+// Запросы заполняют компактный список userId объектов, чьи AABB пересекают объём (порядок не задан).
+// Сам индекс не потокобезопасен: из worker'ов — SpatialUpdateBuffer + apply(), или батч update(moves).
+
+constexpr uint32_t SPATIAL_NONE = ~0u;
+
+enum class SpatialIndexType { HashedGrid, LooseOctree };
+
+struct SpatialIndexConfig {
+	SpatialIndexType type = SpatialIndexType::HashedGrid;
+	float cellSize = 4.0f;                   // grid: размер ячейки
+	Vec3 origin{ -512.0f, -512.0f, -512.0f }; // octree: угол корневого куба
+	float worldSize = 1024.0f;               // octree: ребро корневого куба
+	uint32_t maxDepth = 8;                   // octree: глубина листьев (1..15)
+};
+
+struct SpatialMove {
+	uint32_t proxy;
+	Vec3 min, max;
+};
+
+struct SpatialStats {
+	uint32_t proxies = 0;
+	uint32_t cells = 0;   // ячеек / узлов (включая пустые: они остаются до clear())
+	uint32_t large = 0;   // объектов вне ячеек (крупные или вне корня octree)
+	uint32_t relinked = 0; // в последнем батче update() сменили ячейку
+};
+
+class SpatialUpdateBuffer;
+
+class SpatialIndex {
+public:
+	static constexpr uint32_t PARALLEL_MIN = 4096; // перемещений в батче, чтобы считать ключи в потоках
+
+	SpatialIndex() { configure({}); }
+	// сбрасывает содержимое
+	void configure(const SpatialIndexConfig& config);
+	const SpatialIndexConfig& config() const { return config_; }
+	void clear();
+
+	// userId — что вернут запросы (индекс сущности и т.п.); результат — proxy для update/remove
+	uint32_t insert(uint32_t userId, const Vec3& bmin, const Vec3& bmax);
+	void update(uint32_t proxy, const Vec3& bmin, const Vec3& bmax);
+	void remove(uint32_t proxy);
+	// батч: границы пишутся и ключи считаются параллельно (proxy в батче не повторяются),
+	// перевязка по ячейкам — последовательно и только у сменивших ячейку
+	void update(const SpatialMove* moves, uint32_t count);
+	void apply(SpatialUpdateBuffer& buffer);
+
+	void queryAabb(const Vec3& bmin, const Vec3& bmax, std::vector<uint32_t>& out) const;
+	void querySphere(const Vec3& center, float radius, std::vector<uint32_t>& out) const;
+	void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const;
+
+	uint32_t size() const { return (uint32_t)(proxies_.size() - freeProxies_.size()); }
+	SpatialStats stats() const;
+
+private:
+	struct Proxy {
+		Vec3 min;
+		uint32_t userId;
+		Vec3 max;
+		uint32_t cell; // SPATIAL_NONE — в large_ (или proxy свободен)
+		uint32_t slot; // индекс в items ячейки / в large_
+	};
+
+	struct Cell {
+		uint64_t key;
+		Vec3 looseMin, looseMax;
+		uint32_t parent = SPATIAL_NONE;   // узел octree / блок сетки
+		uint32_t subtree = 0;             // объектов в узле и ниже
+		std::vector<uint32_t> children;   // дети узла octree / ячейки блока
+		std::vector<uint32_t> items;      // proxy
+	};
+
+	static constexpr uint64_t LARGE_KEY = ~0ull;
+	static constexpr uint64_t BLOCK_BIT = 1ull << 63; // ключ блока сетки
+
+	uint64_t keyFor(const Vec3& bmin, const Vec3& bmax) const;
+	uint32_t cellFor(uint64_t key);
+	void link(uint32_t proxy, uint64_t key);
+	void unlink(uint32_t proxy);
+	template <typename CellTest, typename ObjectTest>
+	void query(const Vec3& bmin, const Vec3& bmax, bool ranged, const CellTest& cellTest,
+		const ObjectTest& objectTest, std::vector<uint32_t>& out) const;
+	template <typename CellTest, typename ObjectTest>
+	void queryNode(uint32_t cell, const CellTest& cellTest, const ObjectTest& objectTest, std::vector<uint32_t>& out) const;
+
+	SpatialIndexConfig config_;
+	std::vector<Proxy> proxies_;
+	std::vector<uint32_t> freeProxies_;
+	std::vector<Cell> cells_;
+	std::unordered_map<uint64_t, uint32_t> cellOf_;
+	std::vector<uint32_t> roots_; // корень octree / блоки сетки
+	std::vector<uint32_t> large_;
+
+	// батч update(): новый ключ на перемещение (или "ячейка не сменилась")
+	std::vector<uint64_t> batchKeys_;
+	uint32_t relinked_ = 0;
+};
+
+// Перемещения из параллельного кода: push() под мьютексом, SpatialIndex::apply() — в одном потоке
+class SpatialUpdateBuffer {
+public:
+	void push(uint32_t proxy, const Vec3& bmin, const Vec3& bmax);
+	bool empty() const { return moves_.empty(); }
+	size_t size() const { return moves_.size(); }
+	void clear() { moves_.clear(); }
+
+private:
+	friend class SpatialIndex;
+	std::mutex mutex_;
+	std::vector<SpatialMove> moves_;
+};
@@ -1,12 +1,17 @@
 #include "core/Time.h"
+#include "core/FrameStats.h"
 #include <SDL.h>
 #include <algorithm>
+#include <cmath>
 
 void Time::start() {
 	freq_ = (uint64_t)SDL_GetPerformanceFrequency();
 	last_ = (uint64_t)SDL_GetPerformanceCounter();
 	dt_ = 0.0f;
 	total_ = 0.0;
+	accumulator_ = 0.0;
+	simTicks_ = 0;
+	droppedTicks_ = 0;
 }
 
 void Time::tick() {
@@ -15,8 +20,132 @@ void Time::tick() {
 	last_ = now;
 
 	double dt = (double)diff / (double)freq_;
+	if (frameStats_) frameStats_->addFrame(dt * 1000.0);
 	//    (alt-tab, breakpoint)
-	dt = std::clamp(dt, 0.0, 0.1);
+	advance(std::clamp(dt, 0.0, 0.1));
+}
+
+void Time::tickReplay(double dt) {
+	const uint64_t now = (uint64_t)SDL_GetPerformanceCounter();
+	if (frameStats_ && last_ != 0) frameStats_->addFrame((double)(now - last_) / (double)freq_ * 1000.0);
+	last_ = now;
+	advance(dt);
+}
+
+void Time::advance(double dt) {
+	dtExact_ = dt;
 	dt_ = (float)dt;
 	total_ += dt;
+	accumulator_ += dt;
+}
+
+void Time::setTickRate(uint32_t hz) {
+	if (hz == 0) return;
+	tickRate_ = hz;
+	step_ = 1.0 / (double)hz;
+	accumulator_ = 0.0;
+}
+
+uint32_t Time::consumeSimTicks() {
+	uint32_t n = (uint32_t)(accumulator_ / step_);
+	accumulator_ -= (double)n * step_;
+
+	// spiral of death:      ,    
+	if (n > MAX_SIM_TICKS_PER_FRAME) {
+		droppedTicks_ += n - MAX_SIM_TICKS_PER_FRAME;
+		n = MAX_SIM_TICKS_PER_FRAME;
+	}
+	simTicks_ += n;
+
+	//     ,    accumulator'
+	batchTicks_ = n;
+	batchEnd_ = last_ - (uint64_t)(accumulator_ * (double)freq_);
+	return n;
+}
+
+uint64_t Time::simTickEnd(uint32_t i) const {
+	const uint32_t back = batchTicks_ > i ? batchTicks_ - 1 - i : 0;
+	return batchEnd_ - (uint64_t)((double)back * step_ * (double)freq_);
+}
+
+void FramePacer::setTargetFrameTime(double seconds) {
+	period_ = seconds > 0.0 ? seconds : 0.0;
+	deadline_ = 0; //     
+}
+
+uint64_t FramePacer::now() const {
+	return (uint64_t)SDL_GetPerformanceCounter();
+}
+
+void FramePacer::waitUntil(uint64_t target) {
+	const double toSec = 1.0 / (double)freq_;
+	double slept = 0.0, spun = 0.0;
+
+	for (;;) {
+		uint64_t t = now();
+		if (t >= target) break;
+		double remaining = (double)(target - t) * toSec;
+
+		const double spinThreshold = std::clamp(sleepErr_ + 2.0 * sleepDev_, 0.0002, 0.004) + 0.001;
+		stats_.spinThresholdMs = (float)(spinThreshold * 1000.0);
+
+		if (remaining > spinThreshold) {
+			// SDL_Delay(1)  1  +  ;    
+			SDL_Delay(1);
+			uint64_t t1 = now();
+			double actual = (double)(t1 - t) * toSec;
+			double err = std::max(0.0, actual - 0.001);
+			sleepErr_ += (err - sleepErr_) * 0.1;
+			sleepDev_ += (std::fabs(err - sleepErr_) - sleepDev_) * 0.1;
+			slept += actual;
+		}
+		else {
+			//    spin  
+			while (now() < target) {}
+			spun += remaining;
+			break;
+		}
+	}
+
+	uint64_t woke = now();
+	stats_.overshootUs = woke > target ? (float)((double)(woke - target) * toSec * 1e6) : 0.0f;
+	stats_.maxOvershootUs = std::max(stats_.maxOvershootUs, stats_.overshootUs);
+	stats_.sleptMs = (float)(slept * 1000.0);
+	stats_.spunMs = (float)(spun * 1000.0);
+}
+
+void FramePacer::beginFrame() {
+	if (freq_ == 0) freq_ = (uint64_t)SDL_GetPerformanceFrequency();
+
+	stats_.sleptMs = stats_.spunMs = stats_.overshootUs = 0.0f;
+	if (period_ <= 0.0) {
+		frameStart_ = now();
+		return;
+	}
+
+	const uint64_t period = (uint64_t)(period_ * (double)freq_);
+	const uint64_t t = now();
+
+	//   ;      ->   ,    
+	if (deadline_ == 0 || t > deadline_ + period) deadline_ = t + period;
+	else deadline_ += period;
+
+	//  lateInput      (=  );
+	//  lateInput       
+	double lead = period_;
+	if (lateInput_) lead = std::min(period_, workEstimate_ + LATE_INPUT_MARGIN);
+	uint64_t leadTicks = (uint64_t)(lead * (double)freq_);
+
+	waitUntil(deadline_ > leadTicks ? deadline_ - leadTicks : 0);
+	frameStart_ = now();
+}
+
+void FramePacer::endFrame() {
+	if (freq_ == 0) return;
+	double work = (double)(now() - frameStart_) / (double)freq_;
+
+	//    (  ,   ),   
+	if (work > workEstimate_) workEstimate_ = work;
+	else workEstimate_ += (work - workEstimate_) * 0.05;
+	stats_.workMs = (float)(workEstimate_ * 1000.0);
 }
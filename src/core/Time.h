@@ -1,17 +1,119 @@
 #pragma once
 #include <cstdint>
 
+class FrameStats;
+
+
+//    +   .
+//   tick()  dt  accumulator, consumeSimTicks()     
+// (  MAX_SIM_TICKS_PER_FRAME        ),
+//  /  = simAlpha()         sim-.
 class Time {
 public:
+	static constexpr uint32_t DEFAULT_TICK_RATE = 64;
+	static constexpr uint32_t MAX_SIM_TICKS_PER_FRAME = 8;
+
 	void start();
 	void tick();
+	//    dt ( ):     alpha,   
+	void advance(double dt);
+	// advance(dt),        
+	void tickReplay(double dt);
+
+	//   (FrameStats): tick()       
+	void setFrameStats(FrameStats* stats) { frameStats_ = stats; }
+
 
 	float deltaSeconds() const { return dt_; }
+	double exactDeltaSeconds() const { return dtExact_; } // ,    accumulator
 	double totalSeconds() const { return total_; }
 
+	//   (64  128  );  accumulator
+	void setTickRate(uint32_t hz);
+	uint32_t tickRate() const { return tickRate_; }
+	float simStep() const { return (float)step_; }
+
+	//  sim-    ;      tick()
+	uint32_t consumeSimTicks();
+	float simAlpha() const { return (float)(accumulator_ / step_); }
+	//    i-    consumeSimTicks() ( SDL_GetPerformanceCounter):
+	//     (UserCmdBuilder)
+	uint64_t simTickEnd(uint32_t i) const;
+
+	uint64_t simTicks() const { return simTicks_; }           //  
+	double simSeconds() const { return (double)simTicks_ * step_; }
+	uint64_t droppedSimTicks() const { return droppedTicks_; } //  - 
+
 private:
 	uint64_t freq_{ 0 };
 	uint64_t last_{ 0 };
 	float dt_{ 0.0f };
+	double dtExact_{ 0.0 };
 	double total_{ 0.0 };
+
+	uint32_t tickRate_{ DEFAULT_TICK_RATE };
+	double step_{ 1.0 / DEFAULT_TICK_RATE };
+	double accumulator_{ 0.0 };
+	uint64_t simTicks_{ 0 };
+	uint64_t droppedTicks_{ 0 };
+	uint32_t batchTicks_{ 0 };
+	uint64_t batchEnd_{ 0 };   //    
+
+	FrameStats* frameStats_{ nullptr };
+};
+
+struct PacerStats {
+	float overshootUs = 0.0f;    //  :     
+	float maxOvershootUs = 0.0f; //    resetStats()
+	float sleptMs = 0.0f;        //  :  sleep
+	float spunMs = 0.0f;         //  :  spin-wait
+	float workMs = 0.0f;         //    (  )
+	float spinThresholdMs = 0.0f;
+};
+
+//  :     sleep',     spin'.
+//    spin     SDL_Delay(1) ( + 2 ),
+//   < 100       .
+// lateInput:     ,      ,   
+// (    + )    ->     .
+class FramePacer {
+public:
+	static constexpr double LATE_INPUT_MARGIN = 0.0005; //      
+
+	// 0 =  
+	void setTargetFps(double fps) { setTargetFrameTime(fps > 0.0 ? 1.0 / fps : 0.0); }
+	void setTargetFrameTime(double seconds);
+	double targetFrameTime() const { return period_; }
+	//    ,     (   )
+	void setNextFrameTime(double seconds) { period_ = seconds > 0.0 ? seconds : 0.0; }
+	bool enabled() const { return period_ > 0.0; }
+
+	void setLateInput(bool e) { lateInput_ = e; }
+	bool lateInput() const { return lateInput_; }
+
+	//    (  ):   
+	void beginFrame();
+	//  ,    :    lateInput
+	void endFrame();
+
+	const PacerStats& stats() const { return stats_; }
+	void resetStats() { stats_.maxOvershootUs = 0.0f; }
+
+private:
+	uint64_t now() const;
+	void waitUntil(uint64_t target);
+
+	uint64_t freq_{ 0 };
+	double period_{ 0.0 };
+	bool lateInput_{ false };
+
+	uint64_t deadline_{ 0 };   //    (counter)
+	uint64_t frameStart_{ 0 };
+	double workEstimate_{ 0.0 }; // , EMA   
+
+	//  sleep: EMA  SDL_Delay(1)   , 
+	double sleepErr_{ 0.001 };
+	double sleepDev_{ 0.0005 };
+
+	PacerStats stats_;
 };
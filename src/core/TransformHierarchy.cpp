@@ -0,0 +1,354 @@
+#include "core/TransformHierarchy.h"
+#include "core/FrameArena.h"
+#include "core/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define DW_TRANSFORM_SIMD 1
+#endif
+
+namespace {
+const Mat4 IDENTITY = Mat4::identity();
+
+template <typename T, typename Order>
+void permute(std::vector<T>& v, const Order& order, std::vector<T>& tmp) {
+    tmp.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) tmp[i] = v[order[i]];
+    v.swap(tmp);
+}
+}
+
+uint32_t TransformHierarchy::newSlot(uint32_t handle, uint32_t parentSlot) {
+    const uint32_t s = (uint32_t)handleOf_.size();
+    handleOf_.push_back(handle);
+    parent_.push_back(parentSlot);
+    firstChild_.push_back(0);
+    childCount_.push_back(0);
+    tx_.push_back(0.0f); ty_.push_back(0.0f); tz_.push_back(0.0f);
+    qx_.push_back(0.0f); qy_.push_back(0.0f); qz_.push_back(0.0f); qw_.push_back(1.0f);
+    sx_.push_back(1.0f); sy_.push_back(1.0f); sz_.push_back(1.0f);
+    world_.push_back(IDENTITY);
+    dirty_.push_back(0);
+    changed_.push_back(0);
+    dead_.push_back(0);
+    return s;
+}
+
+TransformHandle TransformHierarchy::create(TransformHandle parent, const Vec3& t, const Quat& r, const Vec3& s) {
+    uint32_t index;
+    if (!freeHandles_.empty()) {
+        index = freeHandles_.back();
+        freeHandles_.pop_back();
+    }
+    else {
+        index = (uint32_t)slotOf_.size();
+        slotOf_.push_back(NONE);
+        generation_.push_back(1);
+    }
+
+    // родитель не жив -> корень
+    const uint32_t parentSlot = alive(parent) ? slotOf_[parent.index] : NONE;
+    const uint32_t slot = newSlot(index, parentSlot);
+    slotOf_[index] = slot;
+
+    TransformHandle h{ index, generation_[index] };
+    setLocal(h, t, r, s);
+    structureDirty_ = true; // новый узел в конце массивов: место по уровню получит в rebuild()
+    return h;
+}
+
+void TransformHierarchy::destroy(TransformHandle h) {
+    if (!alive(h)) return;
+    const uint32_t s = slotOf_[h.index];
+    dead_[s] = 1;
+    // handle перестаёт быть живым сразу; индекс освобождается в rebuild()
+    if (++generation_[h.index] == 0) generation_[h.index] = 1;
+    structureDirty_ = true;
+}
+
+void TransformHierarchy::clear() {
+    for (uint32_t s = 0; s < (uint32_t)handleOf_.size(); ++s) {
+        if (!dead_[s] && ++generation_[handleOf_[s]] == 0) generation_[handleOf_[s]] = 1;
+        freeHandles_.push_back(handleOf_[s]);
+        slotOf_[handleOf_[s]] = NONE;
+    }
+    handleOf_.clear(); parent_.clear(); firstChild_.clear(); childCount_.clear();
+    tx_.clear(); ty_.clear(); tz_.clear(); qx_.clear(); qy_.clear(); qz_.clear(); qw_.clear();
+    sx_.clear(); sy_.clear(); sz_.clear();
+    world_.clear(); dirty_.clear(); changed_.clear(); dead_.clear();
+    levelStart_.clear();
+    dirtyList_.clear();
+    updated_.clear();
+    structureDirty_ = false;
+}
+
+bool TransformHierarchy::setParent(TransformHandle h, TransformHandle parent) {
+    if (!alive(h)) return false;
+    const uint32_t s = slotOf_[h.index];
+    const uint32_t ps = alive(parent) ? slotOf_[parent.index] : NONE;
+
+    // цикл: новый родитель — сам узел или его потомок
+    for (uint32_t p = ps; p != NONE; p = parent_[p])
+        if (p == s) return false;
+
+    if (parent_[s] == ps) return true;
+    parent_[s] = ps;
+    markDirty(s);
+    structureDirty_ = true;
+    return true;
+}
+
+void TransformHierarchy::markDirty(uint32_t slot) {
+    if (dirty_[slot]) return;
+    dirty_[slot] = 1;
+    dirtyList_.push_back(slot);
+}
+
+void TransformHierarchy::setLocal(TransformHandle h, const Vec3& t, const Quat& r, const Vec3& s) {
+    if (!alive(h)) return;
+    const uint32_t i = slotOf_[h.index];
+    tx_[i] = t.x; ty_[i] = t.y; tz_[i] = t.z;
+    qx_[i] = r.x; qy_[i] = r.y; qz_[i] = r.z; qw_[i] = r.w;
+    sx_[i] = s.x; sy_[i] = s.y; sz_[i] = s.z;
+    markDirty(i);
+}
+
+void TransformHierarchy::setTranslation(TransformHandle h, const Vec3& t) {
+    if (!alive(h)) return;
+    const uint32_t i = slotOf_[h.index];
+    tx_[i] = t.x; ty_[i] = t.y; tz_[i] = t.z;
+    markDirty(i);
+}
+
+void TransformHierarchy::setRotation(TransformHandle h, const Quat& r) {
+    if (!alive(h)) return;
+    const uint32_t i = slotOf_[h.index];
+    qx_[i] = r.x; qy_[i] = r.y; qz_[i] = r.z; qw_[i] = r.w;
+    markDirty(i);
+}
+
+void TransformHierarchy::setScale(TransformHandle h, const Vec3& s) {
+    if (!alive(h)) return;
+    const uint32_t i = slotOf_[h.index];
+    sx_[i] = s.x; sy_[i] = s.y; sz_[i] = s.z;
+    markDirty(i);
+}
+
+Vec3 TransformHierarchy::translation(TransformHandle h) const {
+    const uint32_t i = slotOf_[h.index];
+    return { tx_[i], ty_[i], tz_[i] };
+}
+
+Quat TransformHierarchy::rotation(TransformHandle h) const {
+    const uint32_t i = slotOf_[h.index];
+    return { qx_[i], qy_[i], qz_[i], qw_[i] };
+}
+
+Vec3 TransformHierarchy::scale(TransformHandle h) const {
+    const uint32_t i = slotOf_[h.index];
+    return { sx_[i], sy_[i], sz_[i] };
+}
+
+void TransformHierarchy::invalidateAll() {
+    for (uint32_t s = 0; s < (uint32_t)handleOf_.size(); ++s) markDirty(s);
+}
+
+void TransformHierarchy::rebuild() {
+    const uint32_t n = (uint32_t)handleOf_.size();
+    FrameArenaScope scratch; // временные массивы пересборки — из арены потока
+
+    // дети каждого узла (по старым slot'ам, в порядке slot'ов — порядок братьев сохраняется)
+    FrameVector<uint32_t> childStart(n + 1, 0), children(n);
+    for (uint32_t s = 0; s < n; ++s)
+        if (parent_[s] != NONE) childStart[parent_[s] + 1]++;
+    for (uint32_t s = 0; s < n; ++s) childStart[s + 1] += childStart[s];
+    {
+        FrameVector<uint32_t> cursor(childStart.begin(), childStart.end() - 1);
+        for (uint32_t s = 0; s < n; ++s)
+            if (parent_[s] != NONE) children[cursor[parent_[s]]++] = s;
+    }
+
+    // обход в ширину от живых корней; мёртвые узлы не заходят, их поддеревья тоже
+    FrameVector<uint32_t> order;
+    order.reserve(n);
+    for (uint32_t s = 0; s < n; ++s)
+        if (parent_[s] == NONE && !dead_[s]) order.push_back(s);
+    levelStart_.assign(1, 0);
+    for (size_t begin = 0; begin < order.size();) {
+        const size_t end = order.size();
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t s = order[i];
+            for (uint32_t c = childStart[s]; c < childStart[s + 1]; ++c)
+                if (!dead_[children[c]]) order.push_back(children[c]);
+        }
+        levelStart_.push_back((uint32_t)end);
+        begin = end;
+    }
+
+    FrameVector<uint32_t> newOf(n, NONE);
+    for (uint32_t i = 0; i < (uint32_t)order.size(); ++i) newOf[order[i]] = i;
+
+    // не попавшие в обход: удалённые и их потомки -> handle свободен
+    for (uint32_t s = 0; s < n; ++s) {
+        if (newOf[s] != NONE) continue;
+        const uint32_t h = handleOf_[s];
+        if (!dead_[s] && ++generation_[h] == 0) generation_[h] = 1;
+        slotOf_[h] = NONE;
+        freeHandles_.push_back(h);
+    }
+
+    std::vector<uint32_t> tmpU;
+    std::vector<float> tmpF;
+    std::vector<uint8_t> tmpB;
+    std::vector<Mat4> tmpM;
+    permute(handleOf_, order, tmpU);
+    permute(parent_, order, tmpU);
+    for (uint32_t& p : parent_) p = p == NONE ? NONE : newOf[p];
+    for (std::vector<float>* a : { &tx_, &ty_, &tz_, &qx_, &qy_, &qz_, &qw_, &sx_, &sy_, &sz_ }) permute(*a, order, tmpF);
+    permute(world_, order, tmpM);
+    permute(dirty_, order, tmpB);
+    const uint32_t m = (uint32_t)order.size();
+    changed_.assign(m, 0);
+    dead_.assign(m, 0);
+
+    // в обходе в ширину дети родителя идут подряд
+    firstChild_.assign(m, 0);
+    childCount_.assign(m, 0);
+    for (uint32_t i = 0; i < m; ++i) {
+        const uint32_t p = parent_[i];
+        if (p == NONE) continue;
+        if (childCount_[p] == 0) firstChild_[p] = i;
+        childCount_[p]++;
+    }
+    for (uint32_t i = 0; i < m; ++i) slotOf_[handleOf_[i]] = i;
+
+    size_t kept = 0;
+    for (uint32_t s : dirtyList_)
+        if (newOf[s] != NONE) dirtyList_[kept++] = newOf[s];
+    dirtyList_.resize(kept);
+
+    structureDirty_ = false;
+}
+
+void TransformHierarchy::computeWorld(const uint32_t* slots, uint32_t count) {
+#if DW_TRANSFORM_SIMD
+    const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+    for (uint32_t i = 0; i < count; i += 4) {
+        // 4 узла одного уровня в дорожках; хвост добиваем повтором последнего (не сохраняется)
+        const uint32_t n = std::min(4u, count - i);
+        uint32_t s[4];
+        for (uint32_t j = 0; j < 4; ++j) s[j] = slots[i + std::min(j, n - 1)];
+        auto gather = [&](const std::vector<float>& a) { return _mm_setr_ps(a[s[0]], a[s[1]], a[s[2]], a[s[3]]); };
+
+        const __m128 qx = gather(qx_), qy = gather(qy_), qz = gather(qz_), qw = gather(qw_);
+        const __m128 sx = gather(sx_), sy = gather(sy_), sz = gather(sz_);
+        const __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+        const __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+        const __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+        // локальная матрица: L[c][r] — столбец c, строка r (строка 3 = 0 0 0 1)
+        __m128 L[4][3];
+        L[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+        L[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+        L[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+        L[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+        L[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+        L[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+        L[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+        L[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+        L[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+        L[3][0] = gather(tx_);
+        L[3][1] = gather(ty_);
+        L[3][2] = gather(tz_);
+
+        // родители: столбцы 4 матриц -> транспонированием в дорожки, P[c][r]
+        const float* pm[4];
+        for (uint32_t j = 0; j < 4; ++j) pm[j] = parent_[s[j]] == NONE ? IDENTITY.m : world_[parent_[s[j]]].m;
+        __m128 P[4][4];
+        for (int c = 0; c < 4; ++c) {
+            __m128 a0 = _mm_loadu_ps(pm[0] + 4 * c), a1 = _mm_loadu_ps(pm[1] + 4 * c);
+            __m128 a2 = _mm_loadu_ps(pm[2] + 4 * c), a3 = _mm_loadu_ps(pm[3] + 4 * c);
+            _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+            P[c][0] = a0; P[c][1] = a1; P[c][2] = a2; P[c][3] = a3;
+        }
+
+        // W = P * L (аффинные): W[c][r] = sum_k P[k][r] * L[c][k] (+ P[3][r] для переноса)
+        for (int c = 0; c < 4; ++c) {
+            __m128 w[4];
+            for (int r = 0; r < 3; ++r) {
+                __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(P[0][r], L[c][0]), _mm_mul_ps(P[1][r], L[c][1])),
+                    _mm_mul_ps(P[2][r], L[c][2]));
+                w[r] = c == 3 ? _mm_add_ps(v, P[3][r]) : v;
+            }
+            w[3] = c == 3 ? one : zero;
+            _MM_TRANSPOSE4_PS(w[0], w[1], w[2], w[3]);
+            for (uint32_t j = 0; j < n; ++j) _mm_storeu_ps(world_[s[j]].m + 4 * c, w[j]);
+        }
+    }
+#else
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t s = slots[i];
+        const Mat4 local = Mat4::fromTRS({ tx_[s], ty_[s], tz_[s] }, qx_[s], qy_[s], qz_[s], qw_[s], { sx_[s], sy_[s], sz_[s] });
+        world_[s] = parent_[s] == NONE ? local : Mat4::mul(world_[parent_[s]], local);
+    }
+#endif
+}
+
+uint32_t TransformHierarchy::update() {
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (uint32_t s : updated_) changed_[s] = 0;
+    updated_.clear();
+
+    stats_.rebuilt = structureDirty_;
+    if (structureDirty_) rebuild();
+
+    // по уровням: пересчитать = dirty этого уровня + дети пересчитанных на прошлом
+    std::sort(dirtyList_.begin(), dirtyList_.end());
+    size_t di = 0, prevBegin = 0, prevEnd = 0;
+    const uint32_t levels = levelStart_.empty() ? 0 : (uint32_t)levelStart_.size() - 1;
+    for (uint32_t level = 0; level < levels; ++level) {
+        if (prevBegin == prevEnd && di == dirtyList_.size()) break;
+
+        const size_t begin = updated_.size();
+        for (size_t i = prevBegin; i < prevEnd; ++i) {
+            const uint32_t p = updated_[i];
+            for (uint32_t c = firstChild_[p]; c < firstChild_[p] + childCount_[p]; ++c) {
+                changed_[c] = 1;
+                updated_.push_back(c);
+            }
+        }
+        const uint32_t levelEnd = levelStart_[level + 1];
+        while (di < dirtyList_.size() && dirtyList_[di] < levelEnd) {
+            const uint32_t s = dirtyList_[di++];
+            dirty_[s] = 0;
+            if (changed_[s]) continue;
+            changed_[s] = 1;
+            updated_.push_back(s);
+        }
+
+        const uint32_t count = (uint32_t)(updated_.size() - begin);
+        if (threaded_ && count >= PARALLEL_MIN && parallelWorkerCount() > 1) {
+            // узлы уровня независимы: куски кратны 4, чтобы SSE-пачки не дробились
+            const uint32_t* slots = updated_.data() + begin;
+            parallelFor((count + 3) / 4, 64, [this, slots, count](uint32_t b, uint32_t e) {
+                const uint32_t first = b * 4, last = std::min(count, e * 4);
+                computeWorld(slots + first, last - first);
+            });
+        }
+        else if (count > 0) {
+            computeWorld(updated_.data() + begin, count);
+        }
+        prevBegin = begin;
+        prevEnd = updated_.size();
+    }
+    dirtyList_.clear();
+
+    stats_.nodes = size();
+    stats_.levels = levels;
+    stats_.updated = (uint32_t)updated_.size();
+    stats_.ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return stats_.updated;
+}
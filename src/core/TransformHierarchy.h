@@ -0,0 +1,105 @@
+#pragma once
+#include "math/Mat4.h"
+#include "math/Quat.h"
+#include "math/Vec3.h"
+#include <cstdint>
+#include <vector>
+
+// Иерархия трансформов (оружие на игроке, дверь на петле, пропы на платформе).
+// Узел: локальный TRS относительно родителя, мировая матрица = parent.world * T * R * S.
+//  - узлы лежат SoA в порядке обхода в ширину: уровень за уровнем, дети одного родителя подряд,
+//    родитель всегда раньше детей. Порядок пересобирается в update() после структурных изменений;
+//  - сеттеры только ставят dirty; update() пересчитывает dirty-узлы и их поддеревья (и только их),
+//    уровень за уровнем, пачками по 4 узла в SSE-дорожках (большой уровень — ещё и по потокам);
+//  - родители считаются аффинными (нижняя строка 0 0 0 1).
+// Handle стабилен при пересборке порядка; destroy() убирает узел вместе с поддеревом на ближайшем update().
+
+struct TransformHandle {
+	uint32_t index = 0;
+	uint32_t generation = 0; // 0 = пустой handle
+
+	bool valid() const { return generation != 0; }
+	bool operator==(const TransformHandle& o) const { return index == o.index && generation == o.generation; }
+	bool operator!=(const TransformHandle& o) const { return !(*this == o); }
+};
+
+struct TransformStats {
+	uint32_t nodes = 0;
+	uint32_t levels = 0;  // глубина дерева
+	uint32_t updated = 0; // мировых матриц пересчитано в последнем update()
+	float ms = 0.0f;      // последний update()
+	bool rebuilt = false; // в последнем update() пересобирался порядок
+};
+
+class TransformHierarchy {
+public:
+	static constexpr uint32_t PARALLEL_MIN = 8192; // узлов на уровне, чтобы раздать уровень потокам
+
+	// parent пустой -> корень
+	TransformHandle create(TransformHandle parent = {}, const Vec3& t = {}, const Quat& r = {},
+		const Vec3& s = { 1.0f, 1.0f, 1.0f });
+	void destroy(TransformHandle h);
+	bool alive(TransformHandle h) const {
+		return h.index < slotOf_.size() && h.generation != 0 && generation_[h.index] == h.generation;
+	}
+	void clear();
+
+	// локальный TRS сохраняется (мировое положение меняется вместе с новым родителем);
+	// false — parent лежит в поддереве h (цикл)
+	bool setParent(TransformHandle h, TransformHandle parent);
+
+	void setLocal(TransformHandle h, const Vec3& t, const Quat& r, const Vec3& s);
+	void setTranslation(TransformHandle h, const Vec3& t);
+	void setRotation(TransformHandle h, const Quat& r);
+	void setScale(TransformHandle h, const Vec3& s);
+	Vec3 translation(TransformHandle h) const;
+	Quat rotation(TransformHandle h) const;
+	Vec3 scale(TransformHandle h) const;
+
+	// мировая матрица на момент последнего update()
+	const Mat4& world(TransformHandle h) const { return world_[slotOf_[h.index]]; }
+	// пересчитана ли мировая матрица в последнем update() (для копирования в рендер и т.п.)
+	bool changed(TransformHandle h) const { return changed_[slotOf_[h.index]] != 0; }
+
+	// всё пересчитать на следующем update() (после загрузки, для замеров)
+	void invalidateAll();
+
+	// пересборка порядка (если нужна) + пересчёт dirty-поддеревьев; возвращает число пересчитанных
+	uint32_t update();
+
+	void setThreaded(bool e) { threaded_ = e; }
+	uint32_t size() const { return (uint32_t)handleOf_.size(); }
+	const TransformStats& stats() const { return stats_; }
+
+private:
+	static constexpr uint32_t NONE = ~0u;
+
+	uint32_t newSlot(uint32_t handle, uint32_t parentSlot);
+	void markDirty(uint32_t slot);
+	void rebuild();
+	void computeWorld(const uint32_t* slots, uint32_t count);
+
+	// handle -> slot
+	std::vector<uint32_t> slotOf_;
+	std::vector<uint32_t> generation_;
+	std::vector<uint32_t> freeHandles_;
+
+	// по slot'ам (порядок обхода в ширину после rebuild(); новые — в конце до rebuild())
+	std::vector<uint32_t> handleOf_;
+	std::vector<uint32_t> parent_;     // slot родителя или NONE
+	std::vector<uint32_t> firstChild_; // дети — [firstChild, firstChild + childCount) (после rebuild())
+	std::vector<uint32_t> childCount_;
+	std::vector<float> tx_, ty_, tz_, qx_, qy_, qz_, qw_, sx_, sy_, sz_;
+	std::vector<Mat4> world_;
+	std::vector<uint8_t> dirty_;   // свой TRS/родитель изменился
+	std::vector<uint8_t> changed_; // world пересчитана в последнем update()
+	std::vector<uint8_t> dead_;    // destroy(), убирается в rebuild()
+	std::vector<uint32_t> levelStart_; // slot начала уровня d; последний элемент = size
+
+	std::vector<uint32_t> dirtyList_;
+	std::vector<uint32_t> updated_; // slot'ы, пересчитанные в последнем update(), по уровням
+
+	bool structureDirty_ = false;
+	bool threaded_ = true;
+	TransformStats stats_;
+};
@@ -2,20 +2,213 @@
 #include <iostream>
 #include "math/Mat4.h"
 #include <cmath>
+#include <random>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include "asset/MeshGen.h"
+#include "asset/MeshletBuilder.h"
+#include "asset/Simplifier.h"
+#include "core/JobSystem.h"
+#include "core/FrameArena.h"
+#include "core/MemoryTracker.h"
+#include "renderer/VkUtils.h"
+#include "core/Profiler.h"
 
-bool Engine::init() {
-    bool fullscreen = false; // стартуем в окне
-    if (!window_.create("cs_like", 1280, 720, fullscreen)) return false;
+namespace {
+// F4: количество источников в бенчмарке освещения
+const uint32_t LIGHT_COUNTS[] = { 0, 1024, 2048, 4096 };
+}
+
+namespace {
+    // меш уровня: cooked-файл; карту и камень арены без файла генерим (то же, что печёт darkwave_meshcook)
+    bool loadLevelMesh(const std::string& path, MeshData& out) {
+        if (path == LEVEL_MESH_CUBE) return true; // встроенный в рендер
+        if (std::filesystem::exists(path) && loadMesh(path, out)) return true;
+        if (path == LEVEL_MESH_ARENA) {
+            out = generateArena(20.0f, 0.25f);
+            buildMeshlets(out);
+            return true;
+        }
+        if (path == LEVEL_MESH_ROCK) {
+            out = generateRock(1u, 4);
+            buildLodChain(out, 6, 0.5f, SimplifyOptions{});
+            return true;
+        }
+        return false;
+    }
+}
+
+bool Engine::init(const EngineOptions& opts) {
+    opts_ = opts;
+    profiler().init();
+    setMemThreadName("main");
+    MemTagScope memTag(MemTag::Game);
+    if (opts_.headless && opts_.replayPath.empty()) {
+        std::cerr << "headless mode needs a replay (--replay FILE)\n";
+        return false;
+    }
+    if (opts_.headless) opts_.fast = true;
+
+    if (!opts_.replayPath.empty()) {
+        if (!inputRecording_.load(opts_.replayPath)) return false;
+        replaying_ = true;
+        std::cout << "Replay: " << opts_.replayPath << ", " << inputRecording_.frames.size() << " frames, "
+            << inputRecording_.cmds.size() << " ticks" << (opts_.headless ? ", headless" : "")
+            << (opts_.fast ? ", fast" : "") << "\n";
+    }
+    else if (!opts_.recordPath.empty()) {
+        recording_ = true;
+    }
+
+    if (!opts_.headless) {
+        bool fullscreen = false; // стартуем в окне
+        if (!window_.create("cs_like", 1280, 720, fullscreen)) return false;
+        input_.setRelativeMouse(true); // как в шутере сразу
+        inputQueue_.install();
+    }
 
     time_.start();
-    input_.setRelativeMouse(true); // как в шутере сразу
+    time_.setTickRate(Time::DEFAULT_TICK_RATE);
+    time_.setFrameStats(&frameStats_);
+    frameStats_.setHitchThreshold(opts_.hitchMs);
+    if (!opts_.frameStatsPath.empty())
+        frameStats_.setOutput(opts_.frameStatsPath + ".csv", opts_.frameStatsPath + ".json", 5.0);
     player_.position = { 0.0f, 0.0f, 3.0f }; // старт на полу
+    prevPlayerPos_ = player_.position;
     cam_.setPosition({ player_.position.x, player_.position.y + player_.eyeHeight, player_.position.z });
     cam_.setMoveSpeed(4.0f);
     cam_.setMouseSensitivity(0.0025f);
+    cmds_.setSensitivity(0.0025f);
+    cmds_.setAngles(cam_.yaw(), cam_.pitch());
+
+    jobSystem().init();
+    std::cout << "Jobs: " << jobSystem().workerCount() << " workers\n";
+
+    // уровень: cooked-файл (`darkwave_levelcook --arena`) отображается в память и читается на месте;
+    // без файла та же арена собирается в памяти, когда загрузятся её меши
+    const std::string levelPath = opts_.levelPath.empty() ? "levels/arena.dwlevel" : opts_.levelPath;
+    if (!opts_.levelPath.empty() || std::filesystem::exists(levelPath)) {
+        MemTagScope assets(MemTag::Assets);
+        auto t0 = std::chrono::steady_clock::now();
+        if (!level_.open(levelPath)) return false;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::printf("Level: %s, %.1f KB, hash %016llx, open %.3f ms\n", levelPath.c_str(), level_.size() / 1024.0,
+            (unsigned long long)level_.header().contentHash, ms);
+    }
 
-    if (!vk_.init(window_.sdl())) return false;
-    if (!renderer_.init(vk_, window_.width(), window_.height())) return false;
+    // меши уровня грузятся/генерятся на worker'ах, пока main-поток поднимает Vulkan
+    //  - cooked .dwmesh по пути из уровня; для карты и камня арены есть fallback (генерим тут же)
+    //  - без файла уровня — меши арены в порядке makeArenaLevel(): карта, куб, камень
+    std::vector<std::string> meshPaths;
+    if (level_.isOpen()) {
+        for (const LevelMesh& m : level_.header().meshes) meshPaths.push_back(m.path.data());
+    }
+    else {
+        meshPaths = { LEVEL_MESH_ARENA, LEVEL_MESH_CUBE, LEVEL_MESH_ROCK };
+    }
+    std::vector<MeshData> meshes(meshPaths.size());
+    std::vector<uint8_t> meshLoaded(meshPaths.size(), 0);
+    JobCounter meshesLoaded;
+    {
+        MemTagScope assets(MemTag::Assets); // задачи наследуют тег
+        for (size_t i = 0; i < meshPaths.size(); ++i) {
+            jobSystem().run(meshesLoaded, [&meshPaths, &meshes, &meshLoaded, i]() {
+                meshLoaded[i] = loadLevelMesh(meshPaths[i], meshes[i]) ? 1 : 0;
+            });
+        }
+    }
+
+    bool ok = true;
+    if (!opts_.headless) {
+        MemTagScope renderer(MemTag::Renderer);
+        ok = vk_.init(window_.sdl()) && renderer_.init(vk_, window_.width(), window_.height());
+    }
+    jobSystem().wait(meshesLoaded); // даже при ошибке: задачи пишут в локальные meshes
+    if (!ok) return false;
+
+    if (!level_.isOpen()) {
+        MemTagScope assets(MemTag::Assets);
+        if (!level_.openMemory(makeArenaLevel(meshes[0], meshes[2]).build())) return false;
+    }
+    const LevelHeader& level = level_.header();
+
+    // индекс меша уровня -> меш рендера; карта рисуется отдельно, куб — встроенный prop-меш 0.
+    // headless: без GPU пропы нужны только как содержимое пакета, номера условные
+    std::vector<uint32_t> meshIds(meshPaths.size(), LEVEL_NONE);
+    uint32_t headlessMesh = 1;
+    for (size_t i = 0; i < meshPaths.size(); ++i) {
+        MemTagScope renderer(MemTag::Renderer); // меши -> GPU-буферы рендера
+        if (!meshLoaded[i]) {
+            std::cerr << "Level: can't load mesh " << meshPaths[i] << "\n";
+            if (i == level.mapMesh && !opts_.headless) return false;
+            continue;
+        }
+        if (i == level.mapMesh) {
+            if (opts_.headless) continue;
+            if (!renderer_.setMapMesh(vk_, meshes[i])) return false;
+            std::cout << "Map: " << meshes[i].indices.size() / 3 << " triangles, " << meshes[i].meshlets.size() << " meshlets\n";
+        }
+        else if (meshPaths[i] == LEVEL_MESH_CUBE) {
+            meshIds[i] = 0;
+        }
+        else {
+            meshIds[i] = opts_.headless ? headlessMesh++ : renderer_.addPropMesh(vk_, meshes[i]);
+        }
+    }
+    buildLevel(meshIds);
+    std::cout << "Level: " << level.entities.count << " entities (" << world_.entityCount() << " drawn), "
+        << level.meshes.count << " meshes, " << level.colliders.count << " colliders, " << level.spawns.count << " spawns\n";
+
+    // спавн и коллизия из уровня
+    if (level.spawns.count > 0) {
+        const LevelSpawn& sp = level.spawns[0];
+        player_.position = { sp.position[0], sp.position[1], sp.position[2] };
+        prevPlayerPos_ = player_.position;
+        cam_.setPosition({ player_.position.x, player_.position.y + player_.eyeHeight, player_.position.z });
+        cam_.setAngles(sp.yaw, cam_.pitch());
+        cmds_.setAngles(cam_.yaw(), cam_.pitch());
+    }
+    {
+        MemTagScope physics(MemTag::Physics);
+        std::vector<AABB> colliders(level.colliders.count);
+        for (uint32_t i = 0; i < level.colliders.count; ++i) {
+            const LevelCollider& c = level.colliders[i];
+            colliders[i] = { { c.min[0], c.min[1], c.min[2] }, { c.max[0], c.max[1], c.max[2] } };
+        }
+        // треугольники: LOD 0 карты (стены, колонны, ящики) и пол y = 0 под ней с запасом
+        std::vector<CollisionTriangle> triangles;
+        float floorHalf = 50.0f;
+        if (level.mapMesh != LEVEL_NONE && meshLoaded[level.mapMesh]) {
+            const MeshData& map = meshes[level.mapMesh];
+            const MeshLod lod = meshLod(map, 0);
+            triangles.reserve(lod.indexCount / 3 + 2);
+            auto vertex = [&map](uint32_t i) {
+                const float* p = map.vertices[i].pos;
+                return Vec3{ p[0], p[1], p[2] };
+            };
+            for (uint32_t i = lod.indexOffset; i + 2 < lod.indexOffset + lod.indexCount; i += 3)
+                triangles.push_back({ vertex(map.indices[i]), vertex(map.indices[i + 1]), vertex(map.indices[i + 2]) });
+            for (int a : { 0, 2 })
+                floorHalf = std::max({ floorHalf, std::fabs(map.boundsMin[a]) + 10.0f, std::fabs(map.boundsMax[a]) + 10.0f });
+        }
+        const float f = floorHalf;
+        triangles.push_back({ { -f, 0.0f, -f }, { -f, 0.0f, f }, { f, 0.0f, f } });
+        triangles.push_back({ { -f, 0.0f, -f }, { f, 0.0f, f }, { f, 0.0f, -f } });
+
+        collision_.build(colliders.data(), (uint32_t)colliders.size(), triangles.data(), (uint32_t)triangles.size());
+        player_.world = &collision_;
+        const CollisionWorldStats& cs = collision_.stats();
+        std::printf("Collision: %u boxes (%u nodes, depth %u), %u triangles (%u nodes, depth %u), build %.3f ms\n",
+            cs.boxes, cs.nodes, cs.depth, cs.triangles, cs.triangleNodes, cs.triangleDepth, cs.buildMs);
+    }
+
+    if (opts_.headless) {
+        running_ = true;
+        std::cout << "Engine started (headless)\n";
+        return true;
+    }
 
     running_ = true;
     std::cout << "Engine started\n";
@@ -23,105 +216,532 @@ bool Engine::init() {
 }
 
 void Engine::run() {
+    MemTagScope memTag(MemTag::Game);
+    // рендер дальше живёт в своём потоке: renderer_/vk_ из game-потока больше не трогаем
+    renderSettings_ = renderer_.settings();
+    lookLatch_.attach(&cmds_, &inputQueue_);
+    renderer_.setCameraLatch(&lookLatch_);
+    if (!opts_.headless) renderThread_.start(renderer_, vk_, true);
+
+    if (replaying_) {
+        applyInitialState(inputRecording_.initial);
+        frameMs_.reserve(inputRecording_.frames.size());
+    }
+    if (recording_) captureInitialState(inputRecording_.initial);
+    auto lastFrame = std::chrono::steady_clock::now();
+#if DW_PROFILE
+    if (!opts_.profilePath.empty()) profiler().beginCapture();
+#endif
+    // запись растит массивы кадров, --frame-stats периодически пишет файлы — кадры не "стабильные"
+    allocCheck_.setEnabled(!recording_ && opts_.frameStatsPath.empty());
+    allocState_ = allocState();
+
     while (running_) {
-        time_.tick();
+        // граница кадра: профайлер забирает зоны всех потоков
+        PROFILE_FRAME();
+        // всё, что game-поток брал из арены в прошлом кадре, больше не нужно
+        frameArena().reset();
+        allocCheck_.beginFrame();
+
+        // кадр записи: его dt задаёт и симуляцию, и (без --fast) темп проигрывания
+        const ReplayFrame* replayFrame = nullptr;
+        if (replaying_) {
+            if (replayFrame_ >= inputRecording_.frames.size()) break;
+            replayFrame = &inputRecording_.frames[replayFrame_++];
+            if (!opts_.fast) pacer_.setNextFrameTime(replayFrame->dt);
+        }
+
+        // лимитер: ждём до начала кадра (с lateInput — впритык к дедлайну), потом уже ввод
+        if (!opts_.fast) {
+            PROFILE_SCOPE("pacer");
+            pacer_.beginFrame();
+        }
+
         input_.beginFrame();
+        auto simStart = std::chrono::steady_clock::now();
 
-        window_.pollEvents(running_, [&](const SDL_Event& e) {
-            input_.handleEvent(e);
-            });
+        // события ещё и попадают в inputQueue_ (event watch) со штампом времени — из неё sim-тики
+        if (!opts_.headless) {
+            PROFILE_SCOPE("pollEvents");
+            window_.pollEvents(running_, [&](const SDL_Event& e) {
+                input_.handleEvent(e);
+                });
+        }
+        const uint64_t inputTime = LookLatch::now();
+        // время кадра — после опроса: ввод этого опроса уже принадлежит прошедшим тикам
+        // заодно закрывает сэмпл прошлого кадра в frameStats_
+        if (replayFrame) time_.tickReplay(replayFrame->dt);
+        else time_.tick();
+
+        // swapchain пересоздаёт render-поток по флагу в пакете
+        bool recreateSwapchain = false;
 
         // F11 fullscreen toggle (как раньше)
         if (window_.consumeToggleFullscreenRequested()) {
             window_.toggleFullscreen();
-            renderer_.recreateSwapchain(vk_, window_.width(), window_.height());
             window_.resetResizedFlag();
+            recreateSwapchain = true;
+        }
+        if (window_.wasResized()) {
+            window_.resetResizedFlag();
+            recreateSwapchain = true;
         }
 
-        if (input_.keyPressed(SDL_SCANCODE_F6)) {
-            renderer_.setPreferredPresentMode(Swapchain::PresentMode::FIFO);
-            renderer_.recreateSwapchain(vk_, window_.width(), window_.height());
+        if (input_.keyPressed(SDL_SCANCODE_F6)) renderSettings_.presentMode = Swapchain::PresentMode::FIFO;
+        if (input_.keyPressed(SDL_SCANCODE_F7)) renderSettings_.presentMode = Swapchain::PresentMode::MAILBOX;
+        if (input_.keyPressed(SDL_SCANCODE_F8)) renderSettings_.presentMode = Swapchain::PresentMode::IMMEDIATE;
+        // F9: Hi-Z occlusion culling вкл/выкл (для сравнения)
+        if (input_.keyPressed(SDL_SCANCODE_F9)) {
+            renderSettings_.occlusionCulling = !renderSettings_.occlusionCulling;
+            SDL_Log("occlusion culling: %s", renderSettings_.occlusionCulling ? "on" : "off");
+        }
+        // F1: LOD пропов вкл/выкл (выкл = всё в LOD 0, для сравнения треугольников)
+        if (input_.keyPressed(SDL_SCANCODE_F1)) {
+            renderSettings_.lod = !renderSettings_.lod;
+            SDL_Log("prop LOD: %s", renderSettings_.lod ? "on" : "off");
+        }
+        // F5: CPU frustum culling объектов вкл/выкл
+        if (input_.keyPressed(SDL_SCANCODE_F5)) {
+            renderSettings_.cpuCulling = !renderSettings_.cpuCulling;
+            SDL_Log("cpu frustum culling: %s", renderSettings_.cpuCulling ? "on" : "off");
+        }
+        // F2: culling meshlet'ов карты вкл/выкл (выкл = весь меш одним draw)
+        if (input_.keyPressed(SDL_SCANCODE_F2)) {
+            renderSettings_.meshletCulling = !renderSettings_.meshletCulling;
+            SDL_Log("meshlet culling: %s", renderSettings_.meshletCulling ? "on" : "off");
+        }
+        // F4: бенчмарк освещения 0 -> 1024 -> 2048 -> 4096 источников
+        if (input_.keyPressed(SDL_SCANCODE_F4)) {
+            lightLevel_ = (lightLevel_ + 1) % 4;
+            buildLightBenchmark(LIGHT_COUNTS[lightLevel_]);
+            SDL_Log("light benchmark: %u point lights", LIGHT_COUNTS[lightLevel_]);
+        }
+        // F3: движение солнца вкл/выкл (дальние каскады теней перерисовываются каждый кадр)
+        if (input_.keyPressed(SDL_SCANCODE_F3)) {
+            sunMoving_ = !sunMoving_;
+            SDL_Log("sun motion: %s", sunMoving_ ? "on" : "off");
+        }
+        // F10: назначение источников кластерам на GPU (compute) или на CPU (потоки)
+        if (input_.keyPressed(SDL_SCANCODE_F10)) {
+            renderSettings_.gpuLightAssign = !renderSettings_.gpuLightAssign;
+            SDL_Log("light assignment: %s", renderSettings_.gpuLightAssign ? "gpu" : "cpu");
+        }
+        // L: лимит кадров off -> 60 -> 120 -> 144 -> 240; K: поздний опрос ввода под лимитером
+        if (input_.keyPressed(SDL_SCANCODE_L)) {
+            static const double fpsLevels[] = { 0.0, 60.0, 120.0, 144.0, 240.0 };
+            fpsLevel_ = (fpsLevel_ + 1) % 5;
+            pacer_.setTargetFps(fpsLevels[fpsLevel_]);
+            pacer_.resetStats();
+            SDL_Log("frame limit: %s%.0f", fpsLevel_ == 0 ? "off " : "", fpsLevels[fpsLevel_]);
+        }
+        if (input_.keyPressed(SDL_SCANCODE_K)) {
+            pacer_.setLateInput(!pacer_.lateInput());
+            SDL_Log("late input: %s", pacer_.lateInput() ? "on" : "off");
+        }
+        // J: late latch камеры (поворот по вводу, опрошенному прямо перед записью UBO)
+        if (input_.keyPressed(SDL_SCANCODE_J)) {
+            renderSettings_.lateLatch = !renderSettings_.lateLatch;
+            SDL_Log("late latch: %s", renderSettings_.lateLatch ? "on" : "off");
+        }
+#if DW_PROFILE
+        // P: запись Chrome trace (chrome://tracing, ui.perfetto.dev) старт/стоп
+        if (input_.keyPressed(SDL_SCANCODE_P)) {
+            if (!profiler().capturing()) {
+                profiler().beginCapture();
+                SDL_Log("profiler: capturing");
+            }
+            else {
+                char path[64];
+                std::snprintf(path, sizeof(path), "profile_%llu.json", (unsigned long long)frameIndex_);
+                if (profiler().endCapture(path)) SDL_Log("profiler: trace written to %s", path);
+            }
         }
-        if (input_.keyPressed(SDL_SCANCODE_F7)) {
-            renderer_.setPreferredPresentMode(Swapchain::PresentMode::MAILBOX);
-            renderer_.recreateSwapchain(vk_, window_.width(), window_.height());
+#endif
+        // M: память по подсистемам (CPU по тегам, GPU по кучам) в stdout
+        if (input_.keyPressed(SDL_SCANCODE_M)) {
+            reportMemory();
+            allocCheck_.disturb(); // отчёт сам выделяет
         }
-        if (input_.keyPressed(SDL_SCANCODE_F8)) {
-            renderer_.setPreferredPresentMode(Swapchain::PresentMode::IMMEDIATE);
-            renderer_.recreateSwapchain(vk_, window_.width(), window_.height());
+        // F12: рендер в своём потоке (конвейер) или последовательно после симуляции
+        if (input_.keyPressed(SDL_SCANCODE_F12)) {
+            renderThread_.setThreaded(!renderThread_.threaded());
+            SDL_Log("render thread: %s", renderThread_.threaded() ? "on" : "off");
         }
 
 
-// Look (мышь крутит взгляд)
-        cam_.updateLook(input_.mouse().dx, input_.mouse().dy);
+        // проигрывание: переключатели — из записи (живые F-клавиши рабочую нагрузку не меняют)
+        if (replayFrame) applyReplayFrame(*replayFrame);
 
-        // Сбор wishDir в мировых координатах (движение по XZ)
-        Vec3 wish{ 0.0f, 0.0f, 0.0f };
+        // Симуляция фиксированным шагом: результат не зависит от FPS.
+        // Каждый тик получает свою UserCmd — ввод, пришедший за его отрезок времени
+        // (остальное ждёт в очереди следующих тиков, даже если в кадре тиков нет).
+        // При проигрывании команды — из записи (тиков выходит столько же: те же dt в accumulator).
+        const uint32_t ticks = time_.consumeSimTicks();
+        const float step = time_.simStep();
+        if (replayFrame && ticks != replayFrame->ticks) replayDesyncs_++;
+        PROFILE_COUNTER("sim ticks", ticks);
+        for (uint32_t t = 0; t < ticks; ++t) {
+            PROFILE_SCOPE("simTick");
+            UserCmd cmd;
+            if (!replayFrame) cmd = cmds_.build(inputQueue_, time_.simTickEnd(t));
+            else if (replayCmd_ < inputRecording_.cmds.size()) cmd = inputRecording_.cmds[replayCmd_++];
 
-        Vec3 fwd = cam_.forward();
-        fwd.y = 0.0f;
-        fwd = normalize(fwd);
+            prevPlayerPos_ = player_.position;
+            player_.update(step, cmd.wishDir(), cmd.wasPressed(UserCmd::Jump));
 
-        Vec3 rig = cam_.right();
-        rig.y = 0.0f;
-        rig = normalize(rig);
+            if (sunMoving_) sunAngle_ += 0.1f * step;
 
-        if (input_.keyDown(SDL_SCANCODE_W)) wish += fwd;
-        if (input_.keyDown(SDL_SCANCODE_S)) wish += (fwd * -1.0f);
-        if (input_.keyDown(SDL_SCANCODE_D)) wish += rig;
-        if (input_.keyDown(SDL_SCANCODE_A)) wish += (rig * -1.0f);
+            simHash_ = hashBytes(simHash_, &player_.position, sizeof(Vec3));
+            simHash_ = hashBytes(simHash_, &player_.velocity, sizeof(Vec3));
+            if (recording_) inputRecording_.cmds.push_back(cmd);
+        }
 
-        // Прыжок — строго по нажатию в этом кадре
-        bool jumpPressed = input_.keyPressed(SDL_SCANCODE_SPACE);
+        // Рендер между двумя последними sim-состояниями: alpha = остаток accumulator'а / шаг
+        const float alpha = time_.simAlpha();
+        Vec3 renderPos = prevPlayerPos_ + (player_.position - prevPlayerPos_) * alpha;
+        const float renderSunAngle = sunAngle_ + (sunMoving_ ? 0.1f * step * alpha : 0.0f);
 
-        // Обновляем игрока
-        player_.update((float)time_.deltaSeconds(), wish, jumpPressed);
+        // Камера сидит в "голове"; взгляд — с учётом ещё не разобранной тиками мыши (без интерполяции)
+        float lookYaw, lookPitch;
+        if (replayFrame) {
+            lookYaw = replayFrame->lookYaw;
+            lookPitch = replayFrame->lookPitch;
+            while (inputQueue_.size() > 0) inputQueue_.pop(); // живой ввод не нужен
+        }
+        else {
+            cmds_.previewLook(inputQueue_, lookYaw, lookPitch);
+        }
+        cam_.setAngles(lookYaw, lookPitch);
+        cam_.setPosition({ renderPos.x, renderPos.y + player_.eyeHeight, renderPos.z });
+        lookLatch_.publish(lookYaw, lookPitch, inputTime);
 
-        // Камера сидит в "голове"
-        cam_.setPosition({ player_.position.x, player_.position.y + player_.eyeHeight, player_.position.z });
+        // источники — функция времени: берём sim-время на момент рендера
+        updateLightBenchmark((float)(time_.simSeconds() + (double)alpha * step));
 
+        float simMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - simStart).count();
+
+        if (recording_) {
+            ReplayFrame f;
+            f.dt = time_.exactDeltaSeconds();
+            f.lookYaw = lookYaw;
+            f.lookPitch = lookPitch;
+            f.settings = packReplaySettings(renderSettings_, sunMoving_);
+            f.lightLevel = (uint8_t)lightLevel_;
+            f.ticks = (uint8_t)ticks;
+            inputRecording_.frames.push_back(f);
+        }
 
         static double acc = 0.0;
         acc += time_.deltaSeconds();
-        if (acc > 0.2) {
+        if (acc > 0.2 && !opts_.fast) {
             acc = 0.0;
             auto p = cam_.position();
             SDL_Log("pos: %.2f %.2f %.2f yaw=%.2f pitch=%.2f", p.x, p.y, p.z, cam_.yaw(), cam_.pitch());
+
+            // статистика — с последнего кадра, который render-поток уже закончил
+            const RenderStats rs = renderThread_.stats();
+            const PipelineStats ps = renderThread_.pipelineStats();
+            SDL_Log("sim: %u Hz, %u ticks this frame, alpha=%.2f, dropped=%llu, input queued=%u lost=%llu",
+                time_.tickRate(), ticks, alpha, (unsigned long long)time_.droppedSimTicks(),
+                inputQueue_.size(), (unsigned long long)inputQueue_.dropped());
+            if (pacer_.enabled()) {
+                const PacerStats& pst = pacer_.stats();
+                SDL_Log("pacer: target=%.2f ms late input=%s work=%.2f ms slept=%.2f spun=%.2f ms overshoot=%.0f us (max %.0f) spin threshold=%.2f ms",
+                    pacer_.targetFrameTime() * 1000.0, pacer_.lateInput() ? "on" : "off", pst.workMs,
+                    pst.sleptMs, pst.spunMs, pst.overshootUs, pst.maxOvershootUs, pst.spinThresholdMs);
+            }
+#if DW_PROFILE
+            // зоны прошлого кадра (всех потоков, включая вложенные), самые дорогие
+            const std::vector<ZoneSummary>& zones = profiler().frameSummary();
+            char zoneLine[512];
+            int len = std::snprintf(zoneLine, sizeof(zoneLine), "zones (%.2f ms frame):", profiler().frameMs());
+            for (size_t i = 0; i < zones.size() && i < 8 && len > 0 && len < (int)sizeof(zoneLine); ++i) {
+                len += std::snprintf(zoneLine + len, sizeof(zoneLine) - len, " %s=%.3f/%u", zones[i].name,
+                    zones[i].totalMs, zones[i].calls);
+            }
+            SDL_Log("%s", zoneLine);
+#endif
+            SDL_Log("pipeline: %s sim=%.2f ms render=%.2f ms game wait=%.2f ms frame=%.2f ms",
+                renderThread_.threaded() ? "threaded" : "serial", simMs, ps.renderMs, ps.gameWaitMs,
+                time_.deltaSeconds() * 1000.0);
+
+            const FrameStatsSummary fs = frameStats_.summary();
+            SDL_Log("frames (last %llu): p50=%.2f p99=%.2f p99.9=%.2f max=%.2f ms, 1%% low=%.0f 0.1%% low=%.0f fps, cpu p99=%.2f gpu p99=%.2f ms, hitches=%llu",
+                (unsigned long long)fs.frames, fs.frame().p50, fs.frame().p99, fs.frame().p999, fs.frame().max,
+                fs.low1Fps(), fs.low01Fps(), fs.cpu().p99, fs.gpu().p99, (unsigned long long)fs.hitches);
+
+            const LatencyStats& lat = rs.latency;
+            SDL_Log("input latency (to UBO write): packet=%.2f ms latched=%.2f ms saved=%.2f ms (%s, %llu/%llu frames latched)",
+                lat.packetMs, lat.latchedMs, lat.savedMs(), renderSettings_.lateLatch ? "on" : "off",
+                (unsigned long long)lat.latchedFrames, (unsigned long long)lat.frames);
+
+            const CullStats& cs = rs.cull;
+            SDL_Log("draws: %u culled=%u (frustum=%u occlusion=%u) early=%u late=%u",
+                cs.total, cs.culled(), cs.frustumCulled, cs.occlusionCulled, cs.earlyDrawn, cs.lateDrawn);
+
+            const MeshletStats& ms = rs.meshlets;
+            if (ms.meshlets > 0) {
+                SDL_Log("meshlets: %u frustum=%u cone=%u occlusion=%u early=%u late=%u tris=%u/%u",
+                    ms.meshlets, ms.frustumCulled, ms.coneCulled, ms.occlusionCulled,
+                    ms.earlyDrawn, ms.lateDrawn, ms.triangles, ms.totalTriangles);
+            }
+
+            const CpuCullStats& ccs = rs.cpuCull;
+            SDL_Log("cpu cull: visible=%u/%u %.3f ms", ccs.visible, ccs.objects, ccs.ms);
+
+            const LodStats& lds = rs.lod;
+            SDL_Log("lod: objects=%u tris submitted=%u / available=%u (lod0..3: %u %u %u %u)",
+                lds.objects, lds.trianglesSubmitted, lds.trianglesAvailable,
+                lds.perLevel[0], lds.perLevel[1], lds.perLevel[2], lds.perLevel[3]);
+
+            const ShadowStats& ss = rs.shadows;
+            SDL_Log("shadows: cascades redrawn=%u casters=%u", ss.cascadesRendered, ss.casters);
+
+            const LightingStats& ls = rs.lighting;
+            if (ls.lights > 0) {
+                SDL_Log("lights: %u clusters=%u assign=%s cpu=%.3f ms (%u indices) frame=%.2f ms",
+                    ls.lights, ls.clusters, ls.gpuAssign ? "gpu" : "cpu", ls.cpuAssignMs, ls.cpuIndices,
+                    time_.deltaSeconds() * 1000.0);
+            }
         }
 
+        // пакет кадра для render-потока (ждёт, пока освободится слот: не больше кадра вперёд)
+        RenderPacket& packet = opts_.headless ? headlessPacket_ : renderThread_.beginPacket();
+        PROFILE_SCOPE("packetAndSubmit"); // до конца кадра: в serial-режиме сюда входит и рендер
+        packet.frame = frameIndex_++;
+
         Vec3 eye = cam_.position();
         Vec3 center = eye + cam_.forward();
-        Mat4 view = Mat4::lookAtRH(eye, center, { 0,1,0 });
+        packet.view = Mat4::lookAtRH(eye, center, { 0,1,0 });
 
-        float aspect = (float)window_.width() / (float)window_.height();
-        Mat4 proj = Mat4::perspectiveRH_ZO(70.0f * 3.1415926f / 180.0f, aspect, 0.1f, 100.0f);
+        float aspect = opts_.headless ? 16.0f / 9.0f : (float)window_.width() / (float)window_.height();
+        packet.proj = Mat4::perspectiveRH_ZO(70.0f * 3.1415926f / 180.0f, aspect, 0.1f, 100.0f);
 
         // Vulkan: обычно нужно инвертировать Y в projection
-        proj.m[5] *= -1.0f;
+        packet.proj.m[5] *= -1.0f;
 
-        renderer_.setViewProj(view, proj);
+        // всё, что рисуется, — сущности с RenderObject: копируем чанками
+        syncTransforms();
+        packet.objects.clear();
+        packet.objects.reserve(world_.entityCount());
+        world_.eachChunk<const RenderObject>([&](uint32_t n, const Entity*, const RenderObject* objects) {
+            packet.objects.insert(packet.objects.end(), objects, objects + n);
+            });
 
-        Mat4 cubeModel = Mat4::translation( 0.0f, 0.5f, 0.0f );
-        renderer_.setCubeModel(cubeModel);
+        packet.lights.assign(lights_.begin(), lights_.end());
+        packet.inputTime = inputTime;
+        packet.sunDir = { 0.36f * std::cos(renderSunAngle), 1.0f, 0.36f * std::sin(renderSunAngle) };
 
-        // Коллайдер вокруг куба (куб 1x1x1, центр в (0,0.5,0))
-        player_.wallBox.min = { -0.6f, 0.0f, -0.6f };
-        player_.wallBox.max = { 0.6f, 1.2f,  0.6f };
+        packet.settings = renderSettings_;
+        packet.width = window_.width();
+        packet.height = window_.height();
+        packet.recreateSwapchain = recreateSwapchain;
 
-        // Рендер
-        bool ok = renderer_.drawFrame(vk_);
-        if (!ok || window_.wasResized()) {
-            window_.resetResizedFlag();
-            renderer_.recreateSwapchain(vk_, window_.width(), window_.height());
+        if (!opts_.headless) renderThread_.submitPacket();
+        if (!opts_.fast) pacer_.endFrame();
+
+        // CPU кадра: что дольше — game-поток (без лимитера и ожидания слота) или render-поток
+        // (в serial-режиме рендер уже внутри);
+        // GPU — timestamp'ы кадра, который render-поток закончил последним
+        if (!opts_.headless) {
+            const PipelineStats pipe = renderThread_.pipelineStats();
+            float gameMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - simStart).count();
+            frameStats_.reportCpu(std::max(gameMs - pipe.gameWaitMs, pipe.renderMs));
+            frameStats_.reportGpu(renderThread_.stats().gpuMs);
+        }
+        else {
+            frameStats_.reportCpu(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - simStart).count());
         }
+
+        auto frameEnd = std::chrono::steady_clock::now();
+        if (replaying_) frameMs_.push_back(std::chrono::duration<float, std::milli>(frameEnd - lastFrame).count());
+        lastFrame = frameEnd;
+
+        memorySample();
+        const AllocState state = allocState();
+        if (recreateSwapchain || !(state == allocState_)) allocCheck_.disturb();
+        allocState_ = state;
+        PROFILE_COUNTER("heap allocs", allocCheck_.endFrame(frameIndex_));
     }
 
+    if (!opts_.headless) renderThread_.stop();
+    if (DW_MEM_TRACKING) reportMemory();
 
+#if DW_PROFILE
+    if (profiler().capturing()) {
+        PROFILE_FRAME(); // забрать хвост
+        const std::string path = opts_.profilePath.empty() ? "profile_exit.json" : opts_.profilePath;
+        if (profiler().endCapture(path)) std::cout << "Profile trace written to " << path << "\n";
+    }
+#endif
 
+    frameStats_.flush();
+    if (replaying_) reportReplay();
+    if (recording_) {
+        inputRecording_.stateHash = simHash_;
+        if (inputRecording_.save(opts_.recordPath)) {
+            std::cout << "Recorded " << inputRecording_.frames.size() << " frames, " << inputRecording_.cmds.size()
+                << " ticks to " << opts_.recordPath << "\n";
+        }
+    }
 }
 
 void Engine::shutdown() {
-    renderer_.shutdown(vk_);
-    vk_.shutdown();
-    window_.destroy();
+    if (!opts_.headless) {
+        inputQueue_.uninstall();
+        renderer_.shutdown(vk_);
+        vk_.shutdown();
+        window_.destroy();
+    }
+    jobSystem().shutdown();
+}
+
+void Engine::reportMemory() const {
+    printMemoryReport(std::cout);
+    if (!opts_.headless) printDeviceMemoryReport(std::cout);
+}
+
+Engine::AllocState Engine::allocState() const {
+    AllocState s;
+    s.settings = renderSettings_;
+    s.fpsLevel = fpsLevel_;
+    s.lightLevel = lightLevel_;
+    s.lateInput = pacer_.lateInput();
+    s.threaded = renderThread_.threaded();
+    s.capturing = profiler().capturing();
+    s.hitches = frameStats_.hitchCount();
+    return s;
+}
+
+void Engine::captureInitialState(ReplayInitialState& s) const {
+    s.tickRate = time_.tickRate();
+    s.playerPos = player_.position;
+    s.playerVel = player_.velocity;
+    s.grounded = player_.grounded;
+    s.yaw = cmds_.yaw();
+    s.pitch = cmds_.pitch();
+    s.sunAngle = sunAngle_;
+}
+
+void Engine::applyInitialState(const ReplayInitialState& s) {
+    time_.setTickRate(s.tickRate);
+    player_.position = s.playerPos;
+    player_.velocity = s.playerVel;
+    player_.grounded = s.grounded;
+    prevPlayerPos_ = player_.position;
+    cmds_.setAngles(s.yaw, s.pitch);
+    sunAngle_ = s.sunAngle;
+}
+
+void Engine::applyReplayFrame(const ReplayFrame& f) {
+    unpackReplaySettings(f.settings, renderSettings_, sunMoving_);
+    if (f.lightLevel != lightLevel_ && f.lightLevel < 4) {
+        lightLevel_ = f.lightLevel;
+        buildLightBenchmark(LIGHT_COUNTS[lightLevel_]);
+    }
+}
+
+void Engine::reportReplay() const {
+    if (frameMs_.empty()) return;
+
+    std::vector<float> ms = frameMs_;
+    std::sort(ms.begin(), ms.end());
+    auto pct = [&](double p) { return ms[std::min(ms.size() - 1, (size_t)(p * (double)(ms.size() - 1) + 0.5))]; };
+
+    double wall = 0.0, recorded = 0.0;
+    for (float v : frameMs_) wall += v;
+    for (size_t i = 0; i < replayFrame_; ++i) recorded += inputRecording_.frames[i].dt * 1000.0;
+
+    const bool match = replayFrame_ == inputRecording_.frames.size() && replayDesyncs_ == 0 &&
+        simHash_ == inputRecording_.stateHash;
+
+    std::printf("replay: %zu/%zu frames, %.1f ms wall for %.1f ms recorded (x%.2f)\n",
+        replayFrame_, inputRecording_.frames.size(), wall, recorded, wall > 0.0 ? recorded / wall : 0.0);
+    std::printf("frame ms: avg %.3f min %.3f p50 %.3f p95 %.3f p99 %.3f max %.3f\n",
+        wall / (double)frameMs_.size(), ms.front(), pct(0.50), pct(0.95), pct(0.99), ms.back());
+    std::printf("simulation: %s (hash %016llx, recorded %016llx, desynced frames %llu)\n",
+        match ? "identical to recording" : "DIVERGED",
+        (unsigned long long)simHash_, (unsigned long long)inputRecording_.stateHash,
+        (unsigned long long)replayDesyncs_);
+}
+
+void Engine::buildLightBenchmark(uint32_t count) {
+    lights_.resize(count);
+    lightBase_.resize(count);
+    lightOrbit_.resize((size_t)count * 3);
+
+    // фиксированный seed: одинаковая сцена от запуска к запуску (сравнимые замеры)
+    std::mt19937 rng(1234u);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        lightBase_[i] = { -19.0f + 38.0f * u01(rng), 0.3f + 2.5f * u01(rng), -19.0f + 38.0f * u01(rng) };
+        lightOrbit_[i * 3 + 0] = 0.5f + 2.0f * u01(rng);         // радиус орбиты
+        lightOrbit_[i * 3 + 1] = (0.3f + 1.2f * u01(rng)) * (u01(rng) < 0.5f ? -1.0f : 1.0f); // рад/с
+        lightOrbit_[i * 3 + 2] = 6.2831853f * u01(rng);          // фаза
+
+        PointLight& l = lights_[i];
+        l.radius = 1.5f + 2.5f * u01(rng);
+        l.color = { 0.2f + 0.8f * u01(rng), 0.2f + 0.8f * u01(rng), 0.2f + 0.8f * u01(rng) };
+        l.intensity = 0.6f + 0.8f * u01(rng);
+    }
+}
+
+void Engine::updateLightBenchmark(float t) {
+    for (size_t i = 0; i < lights_.size(); ++i) {
+        float r = lightOrbit_[i * 3 + 0];
+        float a = lightOrbit_[i * 3 + 1] * t + lightOrbit_[i * 3 + 2];
+        lights_[i].position = { lightBase_[i].x + std::cos(a) * r, lightBase_[i].y, lightBase_[i].z + std::sin(a) * r };
+    }
+}
+
+void Engine::buildLevel(const std::vector<uint32_t>& meshIds) {
+    world_.clear();
+    transforms_.clear();
+    spatial_.clear();
+
+    // записи читаются прямо из отображения файла; индексы проверяем здесь (validate() смотрит только границы)
+    const LevelHeader& level = level_.header();
+    std::vector<TransformHandle> nodes(level.entities.count);
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < level.entities.count; ++i) {
+        const LevelEntity& e = level.entities[i];
+        TransformHandle parent;
+        if (e.parent != LEVEL_NONE) {
+            if (e.parent < i) parent = nodes[e.parent];
+            else bad++;
+        }
+        nodes[i] = transforms_.create(parent, { e.position[0], e.position[1], e.position[2] },
+            { e.rotation[0], e.rotation[1], e.rotation[2], e.rotation[3] }, { e.scale[0], e.scale[1], e.scale[2] });
+
+        if (e.mesh == LEVEL_NONE) continue; // только узел (к нему цепляются дети)
+        if (e.mesh >= meshIds.size() || meshIds[e.mesh] == LEVEL_NONE) {
+            bad++;
+            continue;
+        }
+        const LevelMesh& m = level.meshes[e.mesh];
+        RenderObject o;
+        o.isStatic = (e.flags & LEVEL_ENTITY_STATIC) != 0;
+        o.mesh = meshIds[e.mesh];
+        world_.create(o, SceneNode{ nodes[i], { m.boundsMin[0], m.boundsMin[1], m.boundsMin[2] },
+            { m.boundsMax[0], m.boundsMax[1], m.boundsMax[2] } });
+    }
+    if (bad > 0) std::cerr << "Level: " << bad << " entities with bad mesh/parent index\n";
+    syncTransforms();
+}
+
+void Engine::syncTransforms() {
+    PROFILE_SCOPE("transforms");
+    if (transforms_.update() == 0) return;
+    world_.eachChunk<SceneNode, RenderObject>([&](uint32_t n, const Entity* entities, SceneNode* nodes, RenderObject* objects) {
+        for (uint32_t i = 0; i < n; ++i) {
+            SceneNode& node = nodes[i];
+            if (!transforms_.changed(node.node)) continue;
+            RenderObject& o = objects[i];
+            o.model = transforms_.world(node.node);
+            transformAabb(o.model, node.localMin, node.localMax, o.boundsMin, o.boundsMax);
+            if (node.spatial == SPATIAL_NONE) node.spatial = spatial_.insert(entities[i].index, o.boundsMin, o.boundsMax);
+            else spatial_.update(node.spatial, o.boundsMin, o.boundsMax);
+        }
+        });
 }
@@ -2,29 +2,129 @@
 #include "platform/WindowSDL.h"
 #include "renderer/VulkanContext.h"
 #include "renderer/Renderer.h"
+#include "engine/RenderThread.h"
+#include "engine/LookLatch.h"
+#include "engine/InputReplay.h"
+#include "asset/Level.h"
 
 #include "core/Time.h"
 #include "core/Input.h"
+#include "core/InputQueue.h"
+#include "core/FrameStats.h"
+#include "core/AllocCounter.h"
+#include "core/Ecs.h"
+#include "core/TransformHierarchy.h"
+#include "core/SpatialIndex.h"
 
 #include "game/CameraFPS.h"
 #include "game/Player.h"
+#include "game/CollisionWorld.h"
+#include "game/UserCmd.h"
+
+#include <string>
+#include <vector>
+
+// компонент сущности сцены: узел в иерархии трансформов и локальный AABB меша;
+// после update() иерархии world-матрица и AABB копируются в RenderObject, AABB — ещё и в spatial_
+struct SceneNode {
+	TransformHandle node;
+	Vec3 localMin, localMax;
+	uint32_t spatial = SPATIAL_NONE; // proxy в spatial_ (userId = Entity::index)
+};
+
+// режим запуска (аргументы командной строки, см. main.cpp)
+struct EngineOptions {
+	std::string recordPath; // --record FILE: писать ввод в файл (сохраняется при выходе)
+	std::string replayPath; // --replay FILE: проигрывать запись вместо живого ввода
+	bool headless = false;  // --headless: без окна и рендера (только с --replay)
+	bool fast = false;      // --fast: не ждать реального времени записи (headless — всегда)
+	std::string profilePath; // --profile FILE: Chrome trace всего запуска (если собрано с DW_PROFILE)
+	std::string frameStatsPath; // --frame-stats PREFIX: PREFIX.csv (строка раз в 5 с) и PREFIX.json (снимок)
+	float hitchMs = 33.3f;      // --hitch-ms MS: кадр дольше — зависание (лог + JSON)
+	std::string levelPath;      // --level FILE: cooked-уровень (по умолчанию levels/arena.dwlevel, если есть)
+};
 
 class Engine {
 public:
-	bool init();
+	bool init(const EngineOptions& opts = {});
 	void run();
 	void shutdown();
 
 private:
+	// сцена-бенчмарк для clustered lighting: N точечных источников, летающих над полом
+	void buildLightBenchmark(uint32_t count);
+	void updateLightBenchmark(float t);
+	// сущности уровня -> узлы трансформов + World; meshIds: индекс меша уровня -> меш рендера (LEVEL_NONE — нет)
+	void buildLevel(const std::vector<uint32_t>& meshIds);
+	// пересчёт изменившихся трансформов -> model и bounds в RenderObject
+	void syncTransforms();
+	// запись/проигрывание ввода
+	void captureInitialState(ReplayInitialState& s) const;
+	void applyInitialState(const ReplayInitialState& s);
+	void applyReplayFrame(const ReplayFrame& f);
+	void reportReplay() const;
+	void reportMemory() const; // M, и на выходе с DW_MEM_TRACKING
+
 	bool running_{ false };
 
 	WindowSDL window_;
 	VulkanContext vk_;
 	Renderer renderer_;
+	RenderThread renderThread_;
+	RenderSettings renderSettings_; // F-клавиши меняют здесь, рендер получает с пакетом
+	uint64_t frameIndex_ = 0;
+	RenderPacket headlessPacket_; // headless: пакет собирается (та же работа), но не рендерится
+
+	EngineOptions opts_;
+	bool recording_ = false;
+	bool replaying_ = false;
+	InputRecording inputRecording_; // пишется (--record) или проигрывается (--replay)
+	size_t replayFrame_ = 0;
+	size_t replayCmd_ = 0;
+	uint64_t replayDesyncs_ = 0;     // кадров, где тиков вышло не столько, сколько при записи
+	std::vector<float> frameMs_;     // реальное время кадров проигрывания
+	uint64_t simHash_ = HASH_SEED;   // хэш sim-состояния по тикам (сверяется с записью)
 
 
 	Time time_;
-	Input input_;
+	FramePacer pacer_;
+	FrameStats frameStats_;  // окно кадров: квантили frame/cpu/gpu, зависания
+	uint32_t fpsLevel_ = 0; // индекс в таблице лимитов (L)
+
+	// DW_ALLOC_CHECK: смена любого из этих переключателей законно аллоцирует (новые буферы,
+	// пайплайны, trace) -> проверка начинает разогрев заново
+	struct AllocState {
+		RenderSettings settings;
+		uint32_t fpsLevel = 0;
+		uint32_t lightLevel = 0;
+		bool lateInput = false;
+		bool threaded = false;
+		bool capturing = false;
+		uint64_t hitches = 0; // зависание пишет отчёт со строками
+		bool operator==(const AllocState&) const = default;
+	};
+	AllocState allocState() const;
+	SteadyAllocCheck allocCheck_;
+	AllocState allocState_;
+	Input input_;            // клавиши-переключатели (снимок клавиатуры на кадр)
+	InputQueue inputQueue_;  // ввод игрока со штампами времени -> UserCmd на каждый тик
+	UserCmdBuilder cmds_;
 	CameraFPS cam_;
+	LookLatch lookLatch_; // свежий поворот камеры для рендера (late latch)
 	Player player_;
+	CollisionWorld collision_; // коллайдеры уровня; по нему ходит player_
+	Vec3 prevPlayerPos_;      // позиция на предыдущем sim-тике (для интерполяции камеры)
+
+	std::vector<PointLight> lights_;
+	std::vector<Vec3> lightBase_;    // центр орбиты
+	std::vector<float> lightOrbit_;  // радиус, скорость, фаза (по 3 на источник)
+	uint32_t lightLevel_ = 0;        // индекс в таблице количеств (F4)
+
+	LevelFile level_; // отображение .dwlevel (или собранная в памяти арена); живёт, пока идёт игра
+	World world_; // сущности сцены; всё с RenderObject уходит в пакет кадра
+	TransformHierarchy transforms_; // TRS сущностей сцены (SceneNode -> RenderObject)
+	SpatialIndex spatial_;          // AABB сущностей сцены для запросов "что рядом / что в объёме"
+
+	bool sunMoving_ = false;         // F3: солнце медленно ходит по кругу (инвалидирует кэш теней)
+	float sunAngle_ = 0.588f;        // atan2(0.2, 0.3) — стартовое направление как в шейдере
 };
@@ -0,0 +1,191 @@
+#include "engine/InputReplay.h"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+namespace {
+    constexpr char REPLAY_MAGIC[4] = { 'D', 'W', 'I', 'R' };
+    constexpr uint32_t REPLAY_VERSION = 1;
+
+    struct ReplayFileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t tickRate;
+        uint32_t frameCount;
+        uint32_t cmdCount;
+        uint32_t grounded;
+        float playerPos[3];
+        float playerVel[3];
+        float yaw;
+        float pitch;
+        float sunAngle;
+        uint32_t pad;
+        uint64_t stateHash;
+    };
+
+    // кадр и команда на диске: без выравнивания внутри, 24 и 12 байт
+    struct FileFrame {
+        double dt;
+        float lookYaw;
+        float lookPitch;
+        uint16_t settings;
+        uint8_t lightLevel;
+        uint8_t ticks;
+        uint32_t pad;
+    };
+    static_assert(sizeof(FileFrame) == 24, "FileFrame layout");
+
+    struct FileCmd {
+        float yaw;
+        float pitch;
+        uint8_t buttons;
+        uint8_t pressed;
+        uint16_t pad;
+    };
+    static_assert(sizeof(FileCmd) == 12, "FileCmd layout");
+
+    enum SettingBit : uint16_t {
+        OcclusionBit = 1u << 0,
+        MeshletBit = 1u << 1,
+        LodBit = 1u << 2,
+        CpuCullBit = 1u << 3,
+        GpuLightBit = 1u << 4,
+        LateLatchBit = 1u << 5,
+        SunMovingBit = 1u << 6,
+        PresentShift = 8, // 2 бита
+    };
+}
+
+uint16_t packReplaySettings(const RenderSettings& s, bool sunMoving) {
+    uint16_t bits = 0;
+    if (s.occlusionCulling) bits |= OcclusionBit;
+    if (s.meshletCulling) bits |= MeshletBit;
+    if (s.lod) bits |= LodBit;
+    if (s.cpuCulling) bits |= CpuCullBit;
+    if (s.gpuLightAssign) bits |= GpuLightBit;
+    if (s.lateLatch) bits |= LateLatchBit;
+    if (sunMoving) bits |= SunMovingBit;
+    bits |= (uint16_t)(((uint16_t)s.presentMode & 3u) << PresentShift);
+    return bits;
+}
+
+void unpackReplaySettings(uint16_t bits, RenderSettings& s, bool& sunMoving) {
+    s.occlusionCulling = (bits & OcclusionBit) != 0;
+    s.meshletCulling = (bits & MeshletBit) != 0;
+    s.lod = (bits & LodBit) != 0;
+    s.cpuCulling = (bits & CpuCullBit) != 0;
+    s.gpuLightAssign = (bits & GpuLightBit) != 0;
+    s.lateLatch = (bits & LateLatchBit) != 0;
+    sunMoving = (bits & SunMovingBit) != 0;
+    s.presentMode = (Swapchain::PresentMode)((bits >> PresentShift) & 3u);
+}
+
+void InputRecording::clear() {
+    initial = ReplayInitialState{};
+    frames.clear();
+    cmds.clear();
+    stateHash = 0;
+}
+
+bool InputRecording::save(const std::string& path) const {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) {
+        std::cerr << "saveRecording: can't open " << path << "\n";
+        return false;
+    }
+
+    ReplayFileHeader h{};
+    std::memcpy(h.magic, REPLAY_MAGIC, 4);
+    h.version = REPLAY_VERSION;
+    h.tickRate = initial.tickRate;
+    h.frameCount = (uint32_t)frames.size();
+    h.cmdCount = (uint32_t)cmds.size();
+    h.grounded = initial.grounded ? 1u : 0u;
+    h.playerPos[0] = initial.playerPos.x; h.playerPos[1] = initial.playerPos.y; h.playerPos[2] = initial.playerPos.z;
+    h.playerVel[0] = initial.playerVel.x; h.playerVel[1] = initial.playerVel.y; h.playerVel[2] = initial.playerVel.z;
+    h.yaw = initial.yaw;
+    h.pitch = initial.pitch;
+    h.sunAngle = initial.sunAngle;
+    h.stateHash = stateHash;
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+    std::vector<FileFrame> ff(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const ReplayFrame& s = frames[i];
+        ff[i] = { s.dt, s.lookYaw, s.lookPitch, s.settings, s.lightLevel, s.ticks, 0 };
+    }
+    std::vector<FileCmd> fc(cmds.size());
+    for (size_t i = 0; i < cmds.size(); ++i) {
+        const UserCmd& c = cmds[i];
+        fc[i] = { c.yaw, c.pitch, (uint8_t)c.buttons, (uint8_t)c.pressed, 0 };
+    }
+    if (!ff.empty()) f.write(reinterpret_cast<const char*>(ff.data()), (std::streamsize)(sizeof(FileFrame) * ff.size()));
+    if (!fc.empty()) f.write(reinterpret_cast<const char*>(fc.data()), (std::streamsize)(sizeof(FileCmd) * fc.size()));
+
+    if (!f) {
+        std::cerr << "saveRecording: write failed " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool InputRecording::load(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        std::cerr << "loadRecording: can't open " << path << "\n";
+        return false;
+    }
+
+    ReplayFileHeader h{};
+    f.read(reinterpret_cast<char*>(&h), sizeof(h));
+    if (!f || std::memcmp(h.magic, REPLAY_MAGIC, 4) != 0) {
+        std::cerr << "loadRecording: not an input recording " << path << "\n";
+        return false;
+    }
+    if (h.version != REPLAY_VERSION) {
+        std::cerr << "loadRecording: unsupported version " << h.version << " in " << path << "\n";
+        return false;
+    }
+
+    std::vector<FileFrame> ff(h.frameCount);
+    std::vector<FileCmd> fc(h.cmdCount);
+    if (!ff.empty()) f.read(reinterpret_cast<char*>(ff.data()), (std::streamsize)(sizeof(FileFrame) * ff.size()));
+    if (!fc.empty()) f.read(reinterpret_cast<char*>(fc.data()), (std::streamsize)(sizeof(FileCmd) * fc.size()));
+    if (!f) {
+        std::cerr << "loadRecording: truncated file " << path << "\n";
+        return false;
+    }
+
+    uint64_t ticks = 0;
+    for (const FileFrame& s : ff) ticks += s.ticks;
+    if (ticks != h.cmdCount) {
+        std::cerr << "loadRecording: frame ticks don't match command count in " << path << "\n";
+        return false;
+    }
+
+    clear();
+    initial.tickRate = h.tickRate;
+    initial.playerPos = { h.playerPos[0], h.playerPos[1], h.playerPos[2] };
+    initial.playerVel = { h.playerVel[0], h.playerVel[1], h.playerVel[2] };
+    initial.grounded = h.grounded != 0;
+    initial.yaw = h.yaw;
+    initial.pitch = h.pitch;
+    initial.sunAngle = h.sunAngle;
+    stateHash = h.stateHash;
+
+    frames.resize(ff.size());
+    for (size_t i = 0; i < ff.size(); ++i) {
+        const FileFrame& s = ff[i];
+        frames[i] = { s.dt, s.lookYaw, s.lookPitch, s.settings, s.lightLevel, s.ticks };
+    }
+    cmds.resize(fc.size());
+    for (size_t i = 0; i < fc.size(); ++i) {
+        UserCmd& c = cmds[i];
+        c.tick = i;
+        c.yaw = fc[i].yaw;
+        c.pitch = fc[i].pitch;
+        c.buttons = fc[i].buttons;
+        c.pressed = fc[i].pressed;
+    }
+    return true;
+}
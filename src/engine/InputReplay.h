@@ -0,0 +1,58 @@
+#pragma once
+#include "renderer/RenderPacket.h"
+#include "game/UserCmd.h"
+#include "math/Vec3.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Запись ввода для повторяемых бенчмарков (.dwinput).
+// Пишется не сырой SDL-ввод, а то, что из него получила игра: по кадру — dt (ровно то, что ушло
+// в accumulator), взгляд камеры и переключатели рендера; по sim-тику — UserCmd.
+// Проигрывание с тем же начальным состоянием даёт ту же симуляцию тик в тик и те же кадры рендеру
+// (камера, объекты, настройки) — нагрузка одинакова от запуска к запуску, какой бы ни был живой FPS.
+
+struct ReplayInitialState {
+	uint32_t tickRate = 0;
+	Vec3 playerPos;
+	Vec3 playerVel;
+	bool grounded = true;
+	float yaw = 0.0f;   // UserCmdBuilder
+	float pitch = 0.0f;
+	float sunAngle = 0.0f;
+};
+
+struct ReplayFrame {
+	double dt = 0.0;
+	float lookYaw = 0.0f;   // взгляд камеры рендера (с неразобранной тиками мышью)
+	float lookPitch = 0.0f;
+	uint16_t settings = 0;  // packReplaySettings
+	uint8_t lightLevel = 0; // F4
+	uint8_t ticks = 0;      // сколько UserCmd у кадра (для проверки рассинхрона)
+};
+
+// переключатели кадра в 16 бит: флаги RenderSettings, движение солнца, present mode
+uint16_t packReplaySettings(const RenderSettings& s, bool sunMoving);
+void unpackReplaySettings(uint16_t bits, RenderSettings& s, bool& sunMoving);
+
+struct InputRecording {
+	ReplayInitialState initial;
+	std::vector<ReplayFrame> frames;
+	std::vector<UserCmd> cmds;  // подряд, по frames[i].ticks на кадр
+	uint64_t stateHash = 0;     // хэш sim-состояния после последнего тика (проверка детерминизма)
+
+	void clear();
+	bool save(const std::string& path) const;
+	bool load(const std::string& path);
+};
+
+// FNV-1a: накопительный хэш sim-состояния по тикам
+inline uint64_t hashBytes(uint64_t h, const void* data, size_t size) {
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		h ^= p[i];
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+constexpr uint64_t HASH_SEED = 14695981039346656037ull;
@@ -0,0 +1,47 @@
+#include "engine/LookLatch.h"
+#include <SDL.h>
+#include <chrono>
+
+void LookLatch::attach(const UserCmdBuilder* cmds, const InputQueue* queue) {
+    cmds_ = cmds;
+    queue_ = queue;
+    mainThread_ = std::this_thread::get_id();
+}
+
+void LookLatch::publish(float yaw, float pitch, uint64_t inputTime) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    yaw_ = yaw;
+    pitch_ = pitch;
+    time_ = inputTime;
+}
+
+bool LookLatch::latch(const Vec3& eye, Mat4& view, uint64_t& inputTime) {
+    if (!cmds_) return false;
+
+    if (std::this_thread::get_id() == mainThread_) {
+        // последовательный рендер: докачиваем события, пришедшие после опроса в начале кадра
+        const uint32_t before = queue_->size();
+        SDL_PumpEvents();
+        if (queue_->size() != before) {
+            float yaw, pitch;
+            cmds_->previewLook(*queue_, yaw, pitch);
+            publish(yaw, pitch, now());
+        }
+    }
+
+    CameraFPS look;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (time_ <= inputTime) return false;
+        look.setAngles(yaw_, pitch_);
+        inputTime = time_;
+    }
+
+    view = Mat4::lookAtRH(eye, eye + look.forward(), { 0,1,0 });
+    return true;
+}
+
+uint64_t LookLatch::now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
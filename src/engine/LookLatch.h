@@ -0,0 +1,37 @@
+#pragma once
+#include "renderer/RenderPacket.h"
+#include "core/InputQueue.h"
+#include "game/UserCmd.h"
+#include "game/CameraFPS.h"
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Late latch мыши для рендера (см. CameraLatch).
+// Game-поток после каждого опроса ввода публикует поворот камеры; рендер перед записью UBO берёт
+// самый свежий. В конвейере это ввод следующего кадра, опрошенный, пока рендер ждал fence/acquire.
+// Без render-потока latch() зовётся на главном потоке и сам докачивает события SDL: они попадают
+// в InputQueue как обычно (их потом разберут sim-тики), а поворот берётся с учётом неразобранных.
+class LookLatch : public CameraLatch {
+public:
+	// источник поворота; поток, вызвавший attach, считается главным (только он качает события SDL)
+	void attach(const UserCmdBuilder* cmds, const InputQueue* queue);
+
+	// game-поток: поворот камеры по вводу, опрошенному в момент inputTime
+	void publish(float yaw, float pitch, uint64_t inputTime);
+
+	bool latch(const Vec3& eye, Mat4& view, uint64_t& inputTime) override;
+
+	// steady_clock в нс — общая шкала для inputTime
+	static uint64_t now();
+
+private:
+	const UserCmdBuilder* cmds_ = nullptr;
+	const InputQueue* queue_ = nullptr;
+	std::thread::id mainThread_;
+
+	std::mutex mutex_;
+	float yaw_ = 0.0f;
+	float pitch_ = 0.0f;
+	uint64_t time_ = 0;
+};
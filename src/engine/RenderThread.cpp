@@ -0,0 +1,132 @@
+#include "engine/RenderThread.h"
+#include "core/Profiler.h"
+#include "core/FrameArena.h"
+#include "core/MemoryTracker.h"
+#include <chrono>
+
+namespace {
+float msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+}
+
+void RenderThread::start(Renderer& renderer, VulkanContext& vk, bool threaded) {
+    renderer_ = &renderer;
+    vk_ = &vk;
+    threaded_ = false;
+    setThreaded(threaded);
+}
+
+void RenderThread::stop() {
+    setThreaded(false);
+}
+
+void RenderThread::setThreaded(bool threaded) {
+    if (threaded == threaded_) return;
+
+    if (threaded) {
+        quit_ = false;
+        threaded_ = true;
+        thread_ = std::thread([this]() { loop(); });
+        return;
+    }
+
+    // поток дорисует то, что уже в очереди, и выйдет
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+    threaded_ = false;
+}
+
+RenderPacket& RenderThread::beginPacket() {
+    PROFILE_SCOPE("waitRenderSlot");
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto freeSlot = [&]() {
+        for (int i = 0; i < (int)SLOTS; ++i)
+            if (i != pending_ && i != rendering_) return i;
+        return -1;
+    };
+    cv_.wait(lock, [&]() { return freeSlot() >= 0; });
+
+    writing_ = freeSlot();
+    pipeline_.gameWaitMs = msSince(t0);
+    return packets_[writing_];
+}
+
+void RenderThread::submitPacket() {
+    if (!threaded_) {
+        int slot = writing_;
+        writing_ = -1;
+        render(packets_[slot]);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = writing_;
+        writing_ = -1;
+    }
+    cv_.notify_all();
+}
+
+void RenderThread::loop() {
+    PROFILE_THREAD("render");
+    setMemThreadName("render");
+    for (;;) {
+        int slot = -1;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&]() { return quit_ || pending_ >= 0; });
+            if (pending_ < 0) break; // quit и очередь пуста
+            rendering_ = pending_;
+            pending_ = -1;
+            slot = rendering_;
+        }
+
+        // арена render-потока живёт один пакет (в serial-режиме рендер идёт на арене game-потока)
+        frameArena().reset();
+        render(packets_[slot]);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rendering_ = -1;
+        }
+        cv_.notify_all();
+    }
+}
+
+void RenderThread::render(RenderPacket& packet) {
+    PROFILE_SCOPE("renderFrame");
+    MemTagScope memTag(MemTag::Renderer); // и в serial-режиме, на game-потоке
+    auto t0 = std::chrono::steady_clock::now();
+
+    bool recreate = renderer_->applyPacket(packet) || packet.recreateSwapchain;
+    if (recreate) renderer_->recreateSwapchain(*vk_, packet.width, packet.height);
+
+    if (!renderer_->drawFrame(*vk_)) {
+        renderer_->recreateSwapchain(*vk_, packet.width, packet.height);
+    }
+
+    RenderStats s = renderer_->stats();
+    float ms = msSince(t0);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = s;
+    pipeline_.renderMs = ms;
+    pipeline_.framesRendered++;
+}
+
+RenderStats RenderThread::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+PipelineStats RenderThread::pipelineStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pipeline_;
+}
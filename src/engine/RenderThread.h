@@ -0,0 +1,63 @@
+#pragma once
+#include "renderer/Renderer.h"
+#include "renderer/RenderPacket.h"
+#include "renderer/VulkanContext.h"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Рендер в отдельном потоке: game-поток симулирует кадр N+1, пока render-поток пишет и сабмитит кадр N.
+// Общение — через два RenderPacket'а (double buffer):
+//   beginPacket() отдаёт свободный слот (ждёт, если один ещё рендерится, а второй уже ждёт рендера);
+//   submitPacket() ставит его в очередь. В очереди максимум один пакет -> game-поток
+//   убегает вперёд не больше чем на кадр, лишней задержки тоже не больше кадра.
+// Без потока (threaded = false) submitPacket() рендерит сразу — для сравнения и отладки.
+
+struct PipelineStats {
+	float renderMs = 0.0f;   // render-поток: applyPacket + drawFrame последнего кадра
+	float gameWaitMs = 0.0f; // game-поток ждал свободный слот в последнем beginPacket()
+	uint64_t framesRendered = 0;
+};
+
+class RenderThread {
+public:
+	static constexpr uint32_t SLOTS = 2;
+
+	// renderer и vk с этого момента трогает только render-поток (до stop())
+	void start(Renderer& renderer, VulkanContext& vk, bool threaded);
+	void stop();
+
+	bool threaded() const { return threaded_; }
+	// переключение на ходу: дорисовывает очередь и запускает/останавливает поток
+	void setThreaded(bool threaded);
+
+	RenderPacket& beginPacket();
+	void submitPacket();
+
+	// снимок статистики последнего отрендеренного кадра
+	RenderStats stats() const;
+	PipelineStats pipelineStats() const;
+
+private:
+	void loop();
+	void render(RenderPacket& packet);
+
+	Renderer* renderer_ = nullptr;
+	VulkanContext* vk_ = nullptr;
+	bool threaded_ = false;
+
+	std::array<RenderPacket, SLOTS> packets_;
+	int writing_ = -1;   // слот, который заполняет game-поток
+	int pending_ = -1;   // готов, ждёт render-поток
+	int rendering_ = -1; // рендерится сейчас
+
+	std::thread thread_;
+	mutable std::mutex mutex_;
+	std::condition_variable cv_;
+	bool quit_ = false;
+
+	RenderStats stats_;
+	PipelineStats pipeline_;
+};
@@ -8,6 +8,7 @@ public:
 
     float yaw() const { return yaw_; }     // radians
     float pitch() const { return pitch_; } // radians
+    void setAngles(float yaw, float pitch) { yaw_ = yaw; pitch_ = pitch; }
 
     void setMouseSensitivity(float s) { sens_ = s; } // radians per pixel
     void setMoveSpeed(float s) { speed_ = s; }
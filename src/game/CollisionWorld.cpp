@@ -0,0 +1,661 @@
+#include "game/CollisionWorld.h"
+#include "core/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <numeric>
+
+namespace {
+
+float comp(const Vec3& v, int axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+Vec3 vmin(const Vec3& a, const Vec3& b) {
+    return { std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) };
+}
+
+Vec3 vmax(const Vec3& a, const Vec3& b) {
+    return { std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z) };
+}
+
+// половина площади поверхности: для SAH важны только отношения
+float halfArea(const Vec3& bmin, const Vec3& bmax) {
+    const Vec3 d = bmax - bmin;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+float distance2(const Vec3& p, const Vec3& bmin, const Vec3& bmax) {
+    const float dx = std::max(std::max(bmin.x - p.x, 0.0f), p.x - bmax.x);
+    const float dy = std::max(std::max(bmin.y - p.y, 0.0f), p.y - bmax.y);
+    const float dz = std::max(std::max(bmin.z - p.z, 0.0f), p.z - bmax.z);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// центр движущегося бокса по лучу против боксов, раздутых на его полуразмер (сумма Минковского)
+struct SweepRay {
+    float origin[3];
+    float dir[3];
+    float inv[3];
+    float extent[3];
+};
+
+// [tNear, tFar] на луче внутри раздутого бокса; axis — ось входа (-1: начало внутри по всем осям).
+// Скольжение вдоль грани (луч параллелен оси и лежит на границе) — мимо
+bool slab(const SweepRay& r, const Vec3& bmin, const Vec3& bmax, float& tNear, float& tFar, int& axis) {
+    tNear = -FLT_MAX;
+    tFar = FLT_MAX;
+    axis = -1;
+    for (int a = 0; a < 3; ++a) {
+        const float lo = comp(bmin, a) - r.extent[a];
+        const float hi = comp(bmax, a) + r.extent[a];
+        if (r.dir[a] == 0.0f) {
+            if (r.origin[a] <= lo || r.origin[a] >= hi) return false;
+            continue;
+        }
+        float t1 = (lo - r.origin[a]) * r.inv[a];
+        float t2 = (hi - r.origin[a]) * r.inv[a];
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > tNear) {
+            tNear = t1;
+            axis = a;
+        }
+        tFar = std::min(tFar, t2);
+    }
+    return tNear < tFar;
+}
+
+// Ближайшая точка треугольника (Ericson, Real-Time Collision Detection 5.1.5)
+Vec3 closestPointTriangle(const Vec3& p, const Vec3& a, const Vec3& b, const Vec3& c) {
+    const Vec3 ab = b - a, ac = c - a, ap = p - a;
+    const float d1 = dot(ab, ap), d2 = dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    const Vec3 bp = p - b;
+    const float d3 = dot(ab, bp), d4 = dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+    const Vec3 cp = p - c;
+    const float d5 = dot(ab, cp), d6 = dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    const float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// ближайшие точки двух отрезков (там же, 5.1.9)
+void closestSegmentSegment(const Vec3& p1, const Vec3& q1, const Vec3& p2, const Vec3& q2, Vec3& c1, Vec3& c2) {
+    const Vec3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+    const float a = dot(d1, d1), e = dot(d2, d2), f = dot(d2, r);
+    float s = 0.0f, t = 0.0f;
+    if (a <= 1e-12f && e <= 1e-12f) {
+        c1 = p1;
+        c2 = p2;
+        return;
+    }
+    if (a <= 1e-12f) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    }
+    else {
+        const float c = dot(d1, r);
+        if (e <= 1e-12f) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        }
+        else {
+            const float b = dot(d1, d2);
+            const float denom = a * e - b * b;
+            s = denom > 0.0f ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            }
+            else if (t > 1.0f) {
+                t = 1.0f;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    c1 = p1 + d1 * s;
+    c2 = p2 + d2 * t;
+}
+
+AABB capsuleBounds(const Capsule& c, float margin) {
+    const float r = c.radius + margin;
+    return { vmin(c.a, c.b) - Vec3{ r, r, r }, vmax(c.a, c.b) + Vec3{ r, r, r } };
+}
+
+} // namespace
+
+float segmentTriangleDistance(const Vec3& p, const Vec3& q, const CollisionTriangle& tri, Vec3& onTriangle,
+    Vec3& normal) {
+    const Vec3 n = cross(tri.b - tri.a, tri.c - tri.a);
+    const float dp = dot(p - tri.a, n), dq = dot(q - tri.a, n);
+
+    // отрезок протыкает плоскость внутри треугольника — расстояние 0
+    if ((dp <= 0.0f && dq >= 0.0f) || (dp >= 0.0f && dq <= 0.0f)) {
+        if (dp != dq) {
+            const Vec3 x = p + (q - p) * (dp / (dp - dq));
+            const Vec3 onTri = closestPointTriangle(x, tri.a, tri.b, tri.c);
+            const Vec3 diff = x - onTri;
+            if (dot(diff, diff) <= 1e-10f) {
+                onTriangle = onTri;
+                normal = normalize(dp + dq >= 0.0f ? n : n * -1.0f);
+                return 0.0f;
+            }
+        }
+    }
+
+    // иначе ближайшая пара — конец отрезка и треугольник или отрезок и ребро
+    float best = FLT_MAX;
+    Vec3 onSeg;
+    auto consider = [&](const Vec3& s, const Vec3& t) {
+        const Vec3 d = s - t;
+        const float d2 = dot(d, d);
+        if (d2 < best) {
+            best = d2;
+            onSeg = s;
+            onTriangle = t;
+        }
+    };
+    consider(p, closestPointTriangle(p, tri.a, tri.b, tri.c));
+    consider(q, closestPointTriangle(q, tri.a, tri.b, tri.c));
+    const Vec3* verts[3] = { &tri.a, &tri.b, &tri.c };
+    for (int e = 0; e < 3; ++e) {
+        Vec3 s, t;
+        closestSegmentSegment(p, q, *verts[e], *verts[(e + 1) % 3], s, t);
+        consider(s, t);
+    }
+
+    const float dist = std::sqrt(best);
+    if (dist > 1e-6f) normal = (onSeg - onTriangle) * (1.0f / dist);
+    else normal = normalize(dp + dq >= 0.0f ? n : n * -1.0f);
+    return dist;
+}
+
+bool sweepCapsuleTriangle(const Capsule& capsule, const Vec3& delta, const CollisionTriangle& tri, float skin,
+    CapsuleHit& hit) {
+    // D(t) — расстояние оси до треугольника при сдвиге t * delta: выпукла, производная -dot(delta, normal).
+    // Шаг t += (D - target) / скорость сближения — по касательной, она не выше D: цель не перескакиваем
+    const float target = capsule.radius + skin;
+    const float tolerance = skin * 0.1f;
+    const bool hasHit = dot(hit.normal, hit.normal) > 0.0f;
+    const float limit = hasHit ? hit.t + CollisionWorld::TOI_TIE : hit.t;
+    float t = 0.0f;
+    Vec3 onTri, normal;
+    for (uint32_t i = 0; i < CollisionWorld::TOI_ITERATIONS; ++i) {
+        const Vec3 shift = delta * t;
+        const float gap = segmentTriangleDistance(capsule.a + shift, capsule.b + shift, tri, onTri, normal) - target;
+        const float approach = -dot(delta, normal);
+        if (gap <= tolerance) {
+            if (approach <= 0.0f) return false; // в зазоре, но расходимся или скользим вдоль
+            break;
+        }
+        if (approach <= 1e-9f) return false;
+        t += gap / approach;
+        if (t > limit) return false;
+    }
+    // шаги кончились — t всё равно безопасна (зазор ещё не выбран)
+    if (t > limit) return false;
+    Vec3 face = normalize(cross(tri.b - tri.a, tri.c - tri.a));
+    if (dot(face, normal) < 0.0f) face = face * -1.0f;
+
+    // одновременные касания (стоим на полу у стены): остаётся то, что сильнее против движения;
+    // одно и то же ребро двух граней (угол ящика) — грань, сильнее встречная движению
+    if (hasHit && t >= hit.t - CollisionWorld::TOI_TIE) {
+        const float into = dot(normal, delta), hitInto = dot(hit.normal, delta);
+        if (into > hitInto + 1e-6f) return false;
+        if (into >= hitInto - 1e-6f && dot(face, delta) >= dot(hit.faceNormal, delta)) return false;
+    }
+    hit.t = hasHit ? std::min(t, hit.t) : t;
+    hit.normal = normal;
+    hit.faceNormal = face;
+    hit.point = onTri;
+    return true;
+}
+
+struct CollisionWorld::Builder {
+    const AABB* bounds = nullptr;
+    std::vector<uint32_t> order;
+    std::vector<Vec3> centers;
+    NodePair* pairs = nullptr;
+    std::atomic<uint32_t> pairCount{ 0 };
+    std::atomic<uint32_t> leaves{ 0 };
+    std::atomic<uint32_t> depth{ 0 };
+    JobCounter counter;
+
+    void build(Node& node, uint32_t begin, uint32_t end, uint32_t level);
+    void leaf(Node& node, uint32_t begin, uint32_t end) {
+        node.first = begin;
+        node.count = end - begin;
+        leaves.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+void CollisionWorld::Builder::build(Node& node, uint32_t begin, uint32_t end, uint32_t level) {
+    Vec3 bmin{ FLT_MAX, FLT_MAX, FLT_MAX }, bmax{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    Vec3 cmin = bmin, cmax = bmax;
+    for (uint32_t i = begin; i < end; ++i) {
+        const AABB& b = bounds[order[i]];
+        bmin = vmin(bmin, b.min);
+        bmax = vmax(bmax, b.max);
+        cmin = vmin(cmin, centers[order[i]]);
+        cmax = vmax(cmax, centers[order[i]]);
+    }
+    node.min = bmin;
+    node.max = bmax;
+
+    uint32_t prevDepth = depth.load(std::memory_order_relaxed);
+    while (level > prevDepth && !depth.compare_exchange_weak(prevDepth, level, std::memory_order_relaxed)) {}
+
+    const uint32_t count = end - begin;
+    if (count <= MAX_LEAF || level >= MAX_DEPTH) {
+        leaf(node, begin, end);
+        return;
+    }
+
+    // ось — наибольший разброс центров
+    const Vec3 ext = cmax - cmin;
+    const int axis = ext.x >= ext.y && ext.x >= ext.z ? 0 : (ext.y >= ext.z ? 1 : 2);
+    const float lo = comp(cmin, axis);
+    const float extent = comp(ext, axis);
+
+    uint32_t mid = begin;
+    if (extent > 1e-6f) {
+        struct Bin {
+            Vec3 min{ FLT_MAX, FLT_MAX, FLT_MAX };
+            Vec3 max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+            uint32_t count = 0;
+        };
+        Bin bins[BINS];
+        const float scale = (float)BINS / extent;
+        auto binOf = [&](uint32_t id) {
+            return std::min(BINS - 1, (uint32_t)((comp(centers[id], axis) - lo) * scale));
+        };
+        for (uint32_t i = begin; i < end; ++i) {
+            Bin& bin = bins[binOf(order[i])];
+            const AABB& b = bounds[order[i]];
+            bin.min = vmin(bin.min, b.min);
+            bin.max = vmax(bin.max, b.max);
+            bin.count++;
+        }
+
+        // справа налево — площади и количества правых частей, слева направо — стоимость разреза после bin i
+        float rightArea[BINS];
+        uint32_t rightCount[BINS];
+        Bin acc;
+        for (uint32_t i = BINS - 1; i > 0; --i) {
+            acc.min = vmin(acc.min, bins[i].min);
+            acc.max = vmax(acc.max, bins[i].max);
+            acc.count += bins[i].count;
+            rightArea[i - 1] = acc.count ? halfArea(acc.min, acc.max) : 0.0f;
+            rightCount[i - 1] = acc.count;
+        }
+        float bestCost = FLT_MAX;
+        uint32_t bestSplit = 0;
+        acc = Bin{};
+        for (uint32_t i = 0; i + 1 < BINS; ++i) {
+            acc.min = vmin(acc.min, bins[i].min);
+            acc.max = vmax(acc.max, bins[i].max);
+            acc.count += bins[i].count;
+            if (acc.count == 0 || rightCount[i] == 0) continue;
+            const float cost = (float)acc.count * halfArea(acc.min, acc.max) + (float)rightCount[i] * rightArea[i];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplit = i;
+            }
+        }
+
+        // лист: count проверок бокса; разрез: обход + дети пропорционально площади
+        const float nodeArea = halfArea(bmin, bmax);
+        const float splitCost = 1.0f + (nodeArea > 0.0f ? bestCost / nodeArea : 0.0f);
+        if (count <= MAX_SAH_LEAF && (float)count <= splitCost) {
+            leaf(node, begin, end);
+            return;
+        }
+        if (bestCost < FLT_MAX) {
+            mid = (uint32_t)(std::partition(order.begin() + begin, order.begin() + end,
+                [&](uint32_t id) { return binOf(id) <= bestSplit; }) - order.begin());
+        }
+    }
+    if (mid == begin || mid == end) {
+        // центры совпали (или SAH не нашёл разреза): пополам
+        if (count <= MAX_SAH_LEAF) {
+            leaf(node, begin, end);
+            return;
+        }
+        mid = begin + count / 2;
+    }
+
+    const uint32_t p = pairCount.fetch_add(1, std::memory_order_relaxed);
+    node.first = p;
+    node.count = 0;
+    Node* left = &pairs[p].child[0];
+    Node* right = &pairs[p].child[1];
+    if (end - mid >= PARALLEL_MIN && jobSystem().running()) {
+        jobSystem().run(counter, [this, right, mid, end, level]() { build(*right, mid, end, level + 1); });
+    }
+    else {
+        build(*right, mid, end, level + 1);
+    }
+    build(*left, begin, mid, level + 1);
+}
+
+void CollisionWorld::buildTree(const AABB* bounds, uint32_t count, Tree& tree, std::vector<uint32_t>& order) {
+    tree = Tree{};
+    order.clear();
+    if (count == 0) return;
+
+    Builder b;
+    b.bounds = bounds;
+    b.order.resize(count);
+    std::iota(b.order.begin(), b.order.end(), 0u);
+    b.centers.resize(count);
+    parallelFor(count, PARALLEL_MIN, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) b.centers[i] = (bounds[i].min + bounds[i].max) * 0.5f;
+    });
+
+    // внутренних узлов (и пар детей) меньше, чем примитивов
+    tree.pairs.resize(count);
+    b.pairs = tree.pairs.data();
+    b.build(tree.root, 0, count, 0);
+    jobSystem().wait(b.counter);
+    tree.pairs.resize(b.pairCount.load());
+    tree.pairs.shrink_to_fit();
+    tree.leaves = b.leaves.load();
+    tree.depth = b.depth.load();
+    order = std::move(b.order);
+}
+
+void CollisionWorld::build(const AABB* boxes, uint32_t boxCount, const CollisionTriangle* triangles,
+    uint32_t triangleCount) {
+    clear();
+    const auto t0 = std::chrono::steady_clock::now();
+
+    if (boxCount > 0) {
+        buildTree(boxes, boxCount, boxTree_, ids_);
+        boxes_.resize(boxCount);
+        for (uint32_t i = 0; i < boxCount; ++i) boxes_[i] = boxes[ids_[i]];
+    }
+
+    // треугольники: свои, потом 12 на бокс (грани CCW снаружи, как у мешей)
+    std::vector<CollisionTriangle> tris;
+    std::vector<uint32_t> triIds;
+    tris.reserve(triangleCount + (size_t)boxCount * 12);
+    triIds.reserve(tris.capacity());
+    auto add = [&](const CollisionTriangle& tri, uint32_t id) {
+        const Vec3 n = cross(tri.b - tri.a, tri.c - tri.a);
+        if (dot(n, n) < 1e-12f) return;
+        tris.push_back(tri);
+        triIds.push_back(id);
+    };
+    for (uint32_t i = 0; i < triangleCount; ++i) add(triangles[i], i);
+    for (uint32_t i = 0; i < boxCount; ++i) {
+        const Vec3 lo = boxes[i].min, hi = boxes[i].max;
+        const Vec3 v[8] = {
+            { lo.x, lo.y, lo.z }, { hi.x, lo.y, lo.z }, { hi.x, hi.y, lo.z }, { lo.x, hi.y, lo.z },
+            { lo.x, lo.y, hi.z }, { hi.x, lo.y, hi.z }, { hi.x, hi.y, hi.z }, { lo.x, hi.y, hi.z },
+        };
+        static const uint8_t faces[6][4] = {
+            { 0, 3, 2, 1 }, { 4, 5, 6, 7 }, { 0, 4, 7, 3 }, { 1, 2, 6, 5 }, { 0, 1, 5, 4 }, { 3, 7, 6, 2 },
+        };
+        const uint32_t base = triangleCount + i * 12;
+        for (uint32_t f = 0; f < 6; ++f) {
+            add({ v[faces[f][0]], v[faces[f][1]], v[faces[f][2]] }, base + f * 2);
+            add({ v[faces[f][0]], v[faces[f][2]], v[faces[f][3]] }, base + f * 2 + 1);
+        }
+    }
+    if (!tris.empty()) {
+        std::vector<AABB> bounds(tris.size());
+        parallelFor((uint32_t)tris.size(), PARALLEL_MIN, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+                bounds[i] = { vmin(vmin(tris[i].a, tris[i].b), tris[i].c), vmax(vmax(tris[i].a, tris[i].b), tris[i].c) };
+        });
+        std::vector<uint32_t> order;
+        buildTree(bounds.data(), (uint32_t)tris.size(), triTree_, order);
+        tris_.resize(tris.size());
+        triIds_.resize(tris.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            tris_[i] = tris[order[i]];
+            triIds_[i] = triIds[order[i]];
+        }
+    }
+
+    stats_.boxes = boxCount;
+    stats_.nodes = boxCount ? 1 + 2 * (uint32_t)boxTree_.pairs.size() : 0;
+    stats_.leaves = boxTree_.leaves;
+    stats_.depth = boxTree_.depth;
+    stats_.triangles = (uint32_t)tris_.size();
+    stats_.triangleNodes = tris_.empty() ? 0 : 1 + 2 * (uint32_t)triTree_.pairs.size();
+    stats_.triangleDepth = triTree_.depth;
+    stats_.buildMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void CollisionWorld::clear() {
+    boxTree_ = Tree{};
+    boxes_.clear();
+    ids_.clear();
+    triTree_ = Tree{};
+    tris_.clear();
+    triIds_.clear();
+    stats_ = {};
+}
+
+void CollisionWorld::overlap(const AABB& query, std::vector<uint32_t>& out) const {
+    out.clear();
+    forEachOverlap(query, [&out](uint32_t id, const AABB&) { out.push_back(id); });
+}
+
+bool CollisionWorld::closestPoint(const Vec3& p, float maxDistance, ClosestHit& hit) const {
+    if (boxes_.empty()) return false;
+
+    // ветви и границы: ближний ребёнок первым, узлы дальше лучшего найденного отбрасываются
+    struct Entry {
+        const Node* node;
+        float d2;
+    };
+    Entry stack[MAX_DEPTH + 4];
+    uint32_t sp = 0;
+    float best = maxDistance * maxDistance;
+    uint32_t bestSlot = COLLISION_NONE;
+
+    const float rootD2 = distance2(p, boxTree_.root.min, boxTree_.root.max);
+    if (rootD2 > best) return false;
+    stack[sp++] = { &boxTree_.root, rootD2 };
+    while (sp) {
+        const Entry e = stack[--sp];
+        if (e.d2 > best) continue;
+        const Node& node = *e.node;
+        if (node.count) {
+            for (uint32_t i = node.first, end = node.first + node.count; i < end; ++i) {
+                const float d2 = distance2(p, boxes_[i].min, boxes_[i].max);
+                if (d2 < best || (bestSlot == COLLISION_NONE && d2 <= best)) {
+                    best = d2;
+                    bestSlot = i;
+                }
+            }
+            continue;
+        }
+        const NodePair& pair = boxTree_.pairs[node.first];
+        const float d0 = distance2(p, pair.child[0].min, pair.child[0].max);
+        const float d1 = distance2(p, pair.child[1].min, pair.child[1].max);
+        const bool firstNear = d0 <= d1;
+        const Entry nearE = firstNear ? Entry{ &pair.child[0], d0 } : Entry{ &pair.child[1], d1 };
+        const Entry farE = firstNear ? Entry{ &pair.child[1], d1 } : Entry{ &pair.child[0], d0 };
+        if (farE.d2 <= best) stack[sp++] = farE;
+        if (nearE.d2 <= best) stack[sp++] = nearE;
+    }
+    if (bestSlot == COLLISION_NONE) return false;
+
+    const AABB& b = boxes_[bestSlot];
+    hit.point = vmin(vmax(p, b.min), b.max);
+    hit.distance = std::sqrt(best);
+    hit.box = ids_[bestSlot];
+    return true;
+}
+
+bool CollisionWorld::sweep(const AABB& box, const Vec3& delta, SweepHit& hit) const {
+    hit = SweepHit{};
+    if (boxes_.empty()) return false;
+
+    const Vec3 c = (box.min + box.max) * 0.5f;
+    const Vec3 e = (box.max - box.min) * 0.5f;
+    SweepRay r;
+    for (int a = 0; a < 3; ++a) {
+        r.origin[a] = comp(c, a);
+        r.dir[a] = comp(delta, a);
+        r.inv[a] = r.dir[a] != 0.0f ? 1.0f / r.dir[a] : 0.0f;
+        r.extent[a] = comp(e, a);
+    }
+
+    struct Entry {
+        const Node* node;
+        float tNear;
+    };
+    Entry stack[MAX_DEPTH + 4];
+    uint32_t sp = 0;
+    uint32_t hitSlot = COLLISION_NONE;
+    int hitAxis = -1;
+
+    float tNear, tFar;
+    int axis;
+    if (!slab(r, boxTree_.root.min, boxTree_.root.max, tNear, tFar, axis) || tFar <= 0.0f || tNear > hit.t)
+        return false;
+    stack[sp++] = { &boxTree_.root, tNear };
+    while (sp) {
+        const Entry en = stack[--sp];
+        if (en.tNear > hit.t) continue;
+        const Node& node = *en.node;
+        if (node.count) {
+            for (uint32_t i = node.first, end = node.first + node.count; i < end; ++i) {
+                // tNear < 0 — пересекались уже в начале: пропускаем
+                if (!slab(r, boxes_[i].min, boxes_[i].max, tNear, tFar, axis) || axis < 0 || tNear < 0.0f || tFar <= 0.0f)
+                    continue;
+                if (tNear < hit.t || (hitSlot == COLLISION_NONE && tNear <= hit.t)) {
+                    hit.t = tNear;
+                    hitSlot = i;
+                    hitAxis = axis;
+                }
+            }
+            continue;
+        }
+        const NodePair& pair = boxTree_.pairs[node.first];
+        Entry children[2];
+        uint32_t n = 0;
+        for (const Node& child : pair.child) {
+            if (slab(r, child.min, child.max, tNear, tFar, axis) && tFar > 0.0f && tNear <= hit.t)
+                children[n++] = { &child, tNear };
+        }
+        // ближний — последним в стек (первым из стека)
+        if (n == 2 && children[0].tNear < children[1].tNear) std::swap(children[0], children[1]);
+        for (uint32_t k = 0; k < n; ++k) stack[sp++] = children[k];
+    }
+    if (hitSlot == COLLISION_NONE) return false;
+
+    hit.box = ids_[hitSlot];
+    hit.bounds = boxes_[hitSlot];
+    hit.normal = { 0.0f, 0.0f, 0.0f };
+    const float n = r.dir[hitAxis] > 0.0f ? -1.0f : 1.0f;
+    if (hitAxis == 0) hit.normal.x = n;
+    else if (hitAxis == 1) hit.normal.y = n;
+    else hit.normal.z = n;
+    return true;
+}
+
+bool CollisionWorld::sweepCapsule(const Capsule& capsule, const Vec3& delta, float skin, CapsuleHit& hit) const {
+    hit = CapsuleHit{};
+    if (tris_.empty()) return false;
+
+    // обход как у sweep(): центр AABB капсулы лучом против узлов, раздутых на её полуразмер + зазор
+    const AABB cb = capsuleBounds(capsule, 2.0f * skin);
+    const Vec3 c = (cb.min + cb.max) * 0.5f;
+    const Vec3 e = (cb.max - cb.min) * 0.5f;
+    SweepRay r;
+    for (int a = 0; a < 3; ++a) {
+        r.origin[a] = comp(c, a);
+        r.dir[a] = comp(delta, a);
+        r.inv[a] = r.dir[a] != 0.0f ? 1.0f / r.dir[a] : 0.0f;
+        r.extent[a] = comp(e, a);
+    }
+
+    struct Entry {
+        const Node* node;
+        float tNear;
+    };
+    Entry stack[MAX_DEPTH + 4];
+    uint32_t sp = 0;
+    uint32_t hitSlot = COLLISION_NONE;
+
+    float tNear, tFar;
+    int axis;
+    if (!slab(r, triTree_.root.min, triTree_.root.max, tNear, tFar, axis) || tFar < 0.0f || tNear > hit.t)
+        return false;
+    // узлы и треугольники — с допуском TOI_TIE: касание в то же t может оказаться встречнее
+    stack[sp++] = { &triTree_.root, tNear };
+    while (sp) {
+        const Entry en = stack[--sp];
+        if (en.tNear > hit.t + TOI_TIE) continue;
+        const Node& node = *en.node;
+        if (node.count) {
+            for (uint32_t i = node.first, end = node.first + node.count; i < end; ++i) {
+                const CollisionTriangle& tri = tris_[i];
+                if (!slab(r, vmin(vmin(tri.a, tri.b), tri.c), vmax(vmax(tri.a, tri.b), tri.c), tNear, tFar, axis) ||
+                    tFar < 0.0f || tNear > hit.t + TOI_TIE)
+                    continue;
+                if (sweepCapsuleTriangle(capsule, delta, tri, skin, hit)) hitSlot = i;
+            }
+            continue;
+        }
+        const NodePair& pair = triTree_.pairs[node.first];
+        Entry children[2];
+        uint32_t n = 0;
+        for (const Node& child : pair.child) {
+            if (slab(r, child.min, child.max, tNear, tFar, axis) && tFar >= 0.0f && tNear <= hit.t + TOI_TIE)
+                children[n++] = { &child, tNear };
+        }
+        if (n == 2 && children[0].tNear < children[1].tNear) std::swap(children[0], children[1]);
+        for (uint32_t k = 0; k < n; ++k) stack[sp++] = children[k];
+    }
+    if (hitSlot == COLLISION_NONE) return false;
+    hit.triangle = triIds_[hitSlot];
+    return true;
+}
+
+bool CollisionWorld::depenetrate(const Capsule& capsule, float skin, Vec3& push) const {
+    push = { 0.0f, 0.0f, 0.0f };
+    if (tris_.empty()) return false;
+
+    Capsule cur = capsule;
+    bool moved = false;
+    for (uint32_t iter = 0; iter < DEPENETRATE_ITERATIONS; ++iter) {
+        float deepest = 0.0f;
+        Vec3 dir;
+        visitLeaves(triTree_, capsuleBounds(cur, 0.0f), [&](uint32_t first, uint32_t count) {
+            for (uint32_t i = first, end = first + count; i < end; ++i) {
+                Vec3 onTri, normal;
+                const float depth = cur.radius - segmentTriangleDistance(cur.a, cur.b, tris_[i], onTri, normal);
+                if (depth > deepest) {
+                    deepest = depth;
+                    dir = normal;
+                }
+            }
+        });
+        if (deepest <= 0.0f) break;
+        const Vec3 step = dir * (deepest + skin);
+        cur.a += step;
+        cur.b += step;
+        push += step;
+        moved = true;
+    }
+    return moved;
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include "game/Collision.h"
+#include "math/Vec3.h"
+#include <cstdint>
+#include <vector>
+
+// Статическая геометрия коллизий уровня: боксы (браши) и треугольники (меш карты), у каждых свой BVH.
+// Строится один раз при загрузке, дальше только читается — запросы из любых потоков одновременно.
+//  - построение: binned SAH (BINS корзин по оси с наибольшим разбросом центров); поддеревья
+//    крупнее PARALLEL_MIN строятся задачами JobSystem;
+//  - раскладка: узел 32 байта, дети узла — пара в одной 64-байтной линии (NodePair): спуск
+//    проверяет обоих одним промахом кэша; примитивы переложены в порядке листьев, лист — непрерывный отрезок;
+//  - запросы по боксам: overlap (боксы, пересекающие AABB), closestPoint (ближайшая точка),
+//    sweep (AABB, сдвинутый на вектор: первое касание, доля пути и нормаль);
+//  - запросы капсулы (контроллер игрока) — по треугольникам: sweepCapsule (время первого касания),
+//    depenetrate (выталкивание). Боксы для них тоже режутся на треугольники, геометрия одна.
+// Касание гранью пересечением не считается. id бокса — индекс во входном массиве build().
+
+constexpr uint32_t COLLISION_NONE = ~0u;
+
+struct SweepHit {
+	float t = 1.0f;                  // доля пути до касания [0, 1]
+	Vec3 normal{ 0.0f, 0.0f, 0.0f }; // нормаль грани, в которую упёрлись (против движения)
+	uint32_t box = COLLISION_NONE;
+	AABB bounds{};                   // бокс, в который упёрлись
+};
+
+struct CollisionTriangle {
+	Vec3 a, b, c;
+};
+
+// отрезок оси a-b, раздутый на radius
+struct Capsule {
+	Vec3 a, b;
+	float radius = 0.0f;
+};
+
+struct CapsuleHit {
+	float t = 1.0f;                  // доля пути до касания [0, 1]
+	Vec3 normal{ 0.0f, 0.0f, 0.0f }; // от треугольника к оси капсулы в точке касания
+	Vec3 faceNormal{ 0.0f, 0.0f, 0.0f }; // нормаль грани треугольника, в сторону капсулы
+	Vec3 point{ 0.0f, 0.0f, 0.0f };  // ближайшая точка треугольника
+	uint32_t triangle = COLLISION_NONE;
+};
+
+struct ClosestHit {
+	Vec3 point;          // на поверхности бокса (или сама точка, если она внутри)
+	float distance = 0.0f;
+	uint32_t box = COLLISION_NONE;
+};
+
+struct CollisionWorldStats {
+	uint32_t boxes = 0;
+	uint32_t nodes = 0;
+	uint32_t leaves = 0;
+	uint32_t depth = 0;
+	uint32_t triangles = 0;
+	uint32_t triangleNodes = 0;
+	uint32_t triangleDepth = 0;
+	float buildMs = 0.0f;
+};
+
+// Расстояние между отрезком p-q и треугольником. onTriangle — ближайшая точка треугольника,
+// normal — единичный вектор от неё к отрезку (отрезок пересекает треугольник: нормаль грани
+// в сторону середины отрезка).
+float segmentTriangleDistance(const Vec3& p, const Vec3& q, const CollisionTriangle& tri, Vec3& onTriangle,
+	Vec3& normal);
+
+// Капсула, сдвинутая на delta: когда зазор до треугольника сократится до skin. Консервативное
+// продвижение: расстояние при сдвиге выпуклых тел выпукло по t, шаг Ньютона его не перескакивает,
+// туннелирования нет при любой скорости. Не больше TOI_ITERATIONS шагов.
+// hit.t на входе — граница: касания дальше не ищутся; при равном t (до TOI_TIE) остаётся касание,
+// сильнее встречное движению (на общем ребре — по нормали грани). Уже в зазоре и не приближается — не касание.
+bool sweepCapsuleTriangle(const Capsule& capsule, const Vec3& delta, const CollisionTriangle& tri, float skin,
+	CapsuleHit& hit);
+
+class CollisionWorld {
+public:
+	static constexpr uint32_t BINS = 16;
+	static constexpr uint32_t MAX_LEAF = 4;        // столько и меньше — всегда лист
+	static constexpr uint32_t MAX_SAH_LEAF = 16;   // до стольких — лист, если SAH считает его дешевле разреза
+	static constexpr uint32_t MAX_DEPTH = 60;      // глубже — лист любого размера (стек запросов фиксированный)
+	static constexpr uint32_t PARALLEL_MIN = 8192; // примитивов в поддереве, чтобы строить его отдельной задачей
+	static constexpr uint32_t TOI_ITERATIONS = 16;   // шагов продвижения капсулы к одному треугольнику
+	static constexpr float TOI_TIE = 1e-4f;          // касания ближе по t — одновременные
+	static constexpr uint32_t DEPENETRATE_ITERATIONS = 4;
+
+	// заменяет содержимое; каждый бокс добавляется и 12 треугольниками (вырожденные выбрасываются)
+	void build(const AABB* boxes, uint32_t boxCount, const CollisionTriangle* triangles = nullptr,
+		uint32_t triangleCount = 0);
+	void clear();
+
+	bool empty() const { return boxes_.empty() && tris_.empty(); }
+	uint32_t size() const { return (uint32_t)boxes_.size(); }
+	uint32_t triangleCount() const { return (uint32_t)tris_.size(); }
+
+	// fn(id, const AABB&) для каждого бокса, пересекающего query; порядок не задан
+	template <typename F>
+	void forEachOverlap(const AABB& query, F&& fn) const;
+	void overlap(const AABB& query, std::vector<uint32_t>& out) const;
+
+	// ближайший бокс не дальше maxDistance от p
+	bool closestPoint(const Vec3& p, float maxDistance, ClosestHit& hit) const;
+
+	// box, сдвинутый на delta: первое касание. Боксы, с которыми box пересекается уже в начале,
+	// пропускаются (их разводит выталкивание, а не sweep)
+	bool sweep(const AABB& box, const Vec3& delta, SweepHit& hit) const;
+
+	// капсула, сдвинутая на delta: первое сближение с треугольниками до зазора skin.
+	// Треугольники, в которые капсула уже вошла и от которых не движется, останавливают сразу (t = 0)
+	bool sweepCapsule(const Capsule& capsule, const Vec3& delta, float skin, CapsuleHit& hit) const;
+
+	// капсула вошла в треугольники глубже radius: сдвиг, выводящий её на зазор skin
+	// (самое глубокое проникновение за шаг, не больше DEPENETRATE_ITERATIONS шагов)
+	bool depenetrate(const Capsule& capsule, float skin, Vec3& push) const;
+
+	const CollisionWorldStats& stats() const { return stats_; }
+
+private:
+	struct Node {
+		Vec3 min;
+		uint32_t first; // лист: первый бокс; узел: индекс пары детей
+		Vec3 max;
+		uint32_t count; // боксов в листе; 0 — внутренний узел
+	};
+	struct alignas(64) NodePair {
+		Node child[2];
+	};
+	struct Tree {
+		Node root{};
+		std::vector<NodePair> pairs;
+		uint32_t leaves = 0;
+		uint32_t depth = 0;
+	};
+	struct Builder;
+
+	// tree по bounds; order — индексы bounds в порядке листьев
+	static void buildTree(const AABB* bounds, uint32_t count, Tree& tree, std::vector<uint32_t>& order);
+	// fn(first, count) для каждого листа, пересекающего query
+	template <typename F>
+	static void visitLeaves(const Tree& tree, const AABB& query, F&& fn);
+
+	static bool overlaps(const Vec3& amin, const Vec3& amax, const AABB& b) {
+		return amin.x < b.max.x && b.min.x < amax.x && amin.y < b.max.y && b.min.y < amax.y &&
+			amin.z < b.max.z && b.min.z < amax.z;
+	}
+
+	Tree boxTree_;
+	std::vector<AABB> boxes_;   // в порядке листьев
+	std::vector<uint32_t> ids_; // порядок листьев -> id
+	Tree triTree_;
+	std::vector<CollisionTriangle> tris_; // в порядке листьев
+	std::vector<uint32_t> triIds_;        // порядок листьев -> индекс (треугольники build(), потом боксов)
+	CollisionWorldStats stats_;
+};
+
+template <typename F>
+void CollisionWorld::visitLeaves(const Tree& tree, const AABB& query, F&& fn) {
+	if (tree.pairs.empty() && tree.root.count == 0) return;
+	if (!overlaps(tree.root.min, tree.root.max, query)) return;
+
+	const Node* stack[MAX_DEPTH + 4];
+	uint32_t sp = 0;
+	const Node* node = &tree.root;
+	for (;;) {
+		if (node->count) {
+			fn(node->first, node->count);
+		}
+		else {
+			const NodePair& pair = tree.pairs[node->first];
+			const bool a = overlaps(pair.child[0].min, pair.child[0].max, query);
+			const bool b = overlaps(pair.child[1].min, pair.child[1].max, query);
+			if (a || b) {
+				if (a && b) stack[sp++] = &pair.child[1];
+				node = a ? &pair.child[0] : &pair.child[1];
+				continue;
+			}
+		}
+		if (sp == 0) break;
+		node = stack[--sp];
+	}
+}
+
+template <typename F>
+void CollisionWorld::forEachOverlap(const AABB& query, F&& fn) const {
+	visitLeaves(boxTree_, query, [&](uint32_t first, uint32_t count) {
+		for (uint32_t i = first, end = first + count; i < end; ++i)
+			if (overlaps(boxes_[i].min, boxes_[i].max, query)) fn(ids_[i], boxes_[i]);
+	});
+}
@@ -1,6 +1,19 @@
 #include "game/Player.h"
+#include "game/CollisionWorld.h"
+#include "core/MemoryTracker.h"
 #include <cmath>
 
+//     Quake (PM_SlideMove / PM_StepSlideMove): sweep  ,
+//    ,   ,  .
+//   :  (DEPENETRATE_ITERATIONS) +  MAX_BUMPS sweep' ,
+//      (+   ) +  sweep .
+
+static const float SKIN = 0.01f;         //   :     
+static const float OVERCLIP = 1.001f;    //           float'
+static const int MAX_BUMPS = 4;
+static const int MAX_CLIP_PLANES = 5;
+static const float GROUND_LEAVE_SPEED = 0.25f; //       (),     OVERCLIP
+
 static Vec3 normalizeXZ(const Vec3& v)
 {
     float len = std::sqrt(v.x * v.x + v.z * v.z);
@@ -8,8 +21,146 @@ static Vec3 normalizeXZ(const Vec3& v)
     return { 0.0f, 0.0f, 0.0f };
 }
 
+static Capsule capsuleAt(const Player& p, const Vec3& feet)
+{
+    return { { feet.x, feet.y + p.radius, feet.z }, { feet.x, feet.y + p.height - p.radius, feet.z }, p.radius };
+}
+
+//       (Quake PM_ClipVelocity)
+static Vec3 clipVelocity(const Vec3& v, const Vec3& n, float overbounce)
+{
+    float backoff = dot(v, n);
+    backoff = backoff < 0.0f ? backoff * overbounce : backoff / overbounce;
+    return v - n * backoff;
+}
+
+static float distXZ2(const Vec3& a, const Vec3& b)
+{
+    const float dx = a.x - b.x, dz = a.z - b.z;
+    return dx * dx + dz * dz;
+}
+
+//  pos  vel * dt  ; true   - 
+static bool slideMove(const Player& p, Vec3& pos, Vec3& vel, float dt, bool onGround)
+{
+    Vec3 planes[MAX_CLIP_PLANES];
+    int numPlanes = 0;
+    if (onGround) planes[numPlanes++] = p.groundNormal; //       
+
+    float timeLeft = dt;
+    bool blocked = false;
+    for (int bump = 0; bump < MAX_BUMPS; ++bump)
+    {
+        const Vec3 move = vel * timeLeft;
+        if (dot(move, move) < 1e-10f) break;
+
+        CapsuleHit hit;
+        if (!p.world->sweepCapsule(capsuleAt(p, pos), move, SKIN, hit))
+        {
+            pos += move;
+            break;
+        }
+        pos += move * hit.t;
+        timeLeft -= timeLeft * hit.t;
+        blocked = true;
+
+        //          (     wishDir
+        //       );      
+        Vec3 normal = hit.normal;
+        if (normal.y > 0.0f && normal.y < p.minGroundNormalY &&
+            clipVelocity(vel, normal, OVERCLIP).y > std::fmax(vel.y, 0.0f) + 1e-4f)
+            normal = normalize(Vec3{ normal.x, 0.0f, normal.z });
+
+        if (numPlanes >= MAX_CLIP_PLANES)
+        {
+            vel = { 0.0f, 0.0f, 0.0f };
+            break;
+        }
+
+        //          ( )
+        bool same = false;
+        for (int i = 0; i < numPlanes; ++i)
+        {
+            if (dot(normal, planes[i]) > 0.99f)
+            {
+                vel += normal * 0.1f;
+                same = true;
+                break;
+            }
+        }
+        if (same) continue;
+        planes[numPlanes++] = normal;
+
+        // ,       :  ,     
+        for (int i = 0; i < numPlanes; ++i)
+        {
+            if (dot(vel, planes[i]) >= 1e-3f) continue;
+            Vec3 clipped = clipVelocity(vel, planes[i], OVERCLIP);
+            for (int j = 0; j < numPlanes; ++j)
+            {
+                if (j == i || dot(clipped, planes[j]) >= 1e-3f) continue;
+                clipped = clipVelocity(clipped, planes[j], OVERCLIP);
+                if (dot(clipped, planes[i]) >= 0.0f) continue;
+
+                //       
+                const Vec3 dir = normalize(cross(planes[i], planes[j]));
+                clipped = dir * dot(dir, vel);
+                for (int k = 0; k < numPlanes; ++k)
+                {
+                    if (k == i || k == j || dot(clipped, planes[k]) >= 1e-3f) continue;
+                    vel = { 0.0f, 0.0f, 0.0f }; //    
+                    return true;
+                }
+            }
+            vel = clipped;
+            break;
+        }
+    }
+    return blocked;
+}
+
+// slideMove +        stepHeight:  ,     XZ
+static void stepSlideMove(const Player& p, Vec3& pos, Vec3& vel, float dt, bool onGround)
+{
+    const Vec3 start = pos;
+    const Vec3 startVel = vel;
+    if (!slideMove(p, pos, vel, dt, onGround) || !onGround) return;
+
+    const Vec3 downPos = pos;
+    const Vec3 downVel = vel;
+
+    CapsuleHit hit;
+    const Vec3 up{ 0.0f, p.stepHeight, 0.0f };
+    Vec3 stepPos = start;
+    p.world->sweepCapsule(capsuleAt(p, stepPos), up, SKIN, hit);
+    const float raised = p.stepHeight * hit.t;
+    if (raised <= SKIN) return; //    
+    stepPos.y += raised;
+
+    Vec3 stepVel = startVel;
+    slideMove(p, stepPos, stepVel, dt, false);
+
+    const Vec3 down{ 0.0f, -raised, 0.0f };
+    if (p.world->sweepCapsule(capsuleAt(p, stepPos), down, SKIN, hit))
+    {
+        stepPos += down * hit.t;
+        if (hit.faceNormal.y < p.minGroundNormalY) return; //       
+    }
+    else
+    {
+        stepPos += down;
+    }
+
+    if (distXZ2(stepPos, start) <= distXZ2(downPos, start) + 1e-6f) return;
+    pos = stepPos;
+    vel = stepVel;
+    vel.y = downVel.y;
+}
+
 void Player::update(float dt, const Vec3& wishDir, bool jumpPressed)
 {
+    MemTagScope memTag(MemTag::Physics);
+    const bool wasGrounded = grounded;
     grounded = false;
 
     //   (  CS-  )
@@ -17,76 +168,55 @@ void Player::update(float dt, const Vec3& wishDir, bool jumpPressed)
     velocity.x = dir.x * moveSpeed;
     velocity.z = dir.z * moveSpeed;
 
-    // 
-    velocity.y -= gravity * dt;
-
-    // 
-    // ----    (XZ) ----
-    Vec3 oldPos = position;
-    Vec3 newPos = position + (velocity * dt);
-
-    // 1)   
-    position = newPos;
-
-    // ---     ---
-    const float cubeTop = wallBox.max.y;
-
-    //   
-    if (velocity.y <= 0.0f)
+    if (world)
     {
-        float feetY = position.y;          //  
-        float prevFeetY = position.y - velocity.y * dt;
-
-        //        
-        bool crossedTop =
-            prevFeetY >= cubeTop &&
-            feetY <= cubeTop;
-
-        //  XZ   
-        bool overCubeXZ =
-            position.x > wallBox.min.x - radius &&
-            position.x < wallBox.max.x + radius &&
-            position.z > wallBox.min.z - radius &&
-            position.z < wallBox.max.z + radius;
-
-        if (crossedTop && overCubeXZ)
+        // ----     ----
+        Vec3 push;
+        if (world->depenetrate(capsuleAt(*this, position), SKIN, push)) position += push;
+
+        const bool onGround = wasGrounded && velocity.y <= 0.0f;
+        if (onGround)
         {
-            position.y = cubeTop;
+            //  :      ,   
             velocity.y = 0.0f;
-            grounded = true;
+            const float speed = length(velocity);
+            velocity = normalize(clipVelocity(velocity, groundNormal, OVERCLIP)) * speed;
         }
-    }
-
-    // -    ""   
-    if (position.y < cubeTop - 1e-3f)
-    {
-        if (resolveCircleAabbXZ(position, radius, wallBox))
+        else
         {
-            Vec3 attempted = newPos - oldPos;
-            Vec3 corrected = position - oldPos;
-
-            if (fabsf(corrected.x - attempted.x) > 1e-4f) velocity.x = 0.0f;
-            if (fabsf(corrected.z - attempted.z) > 1e-4f) velocity.z = 0.0f;
+            velocity.y -= gravity * dt;
         }
-    }
 
-    //      ( ),  grounded=true
-    const bool overCubeXZ =
-        (position.x >= wallBox.min.x) && (position.x <= wallBox.max.x) &&
-        (position.z >= wallBox.min.z) && (position.z <= wallBox.max.z);
+        stepSlideMove(*this, position, velocity, dt, onGround);
 
-    if (overCubeXZ && fabsf(position.y - cubeTop) < 1e-3f && velocity.y <= 0.0f)
+        // :         (,  ),    .
+        //       : ,    ,    
+        groundNormal = { 0.0f, 1.0f, 0.0f };
+        if (onGround || velocity.y < GROUND_LEAVE_SPEED)
+        {
+            const Vec3 probe{ 0.0f, onGround ? -stepHeight : -2.0f * SKIN, 0.0f };
+            CapsuleHit hit;
+            if (world->sweepCapsule(capsuleAt(*this, position), probe, SKIN, hit) && hit.faceNormal.y >= minGroundNormalY)
+            {
+                position += probe * hit.t;
+                groundNormal = hit.faceNormal;
+                velocity.y = 0.0f;
+                grounded = true;
+            }
+        }
+    }
+    else
     {
-        position.y = cubeTop;   //   
-        velocity.y = 0.0f;
-        grounded = true;
+        // 
+        velocity.y -= gravity * dt;
+        position += velocity * dt;
     }
 
-
     // : y >= 0
     if (position.y < 0.0f) {
         position.y = 0.0f;
         velocity.y = 0.0f;
+        groundNormal = { 0.0f, 1.0f, 0.0f };
         grounded = true;
     }
 
@@ -2,12 +2,13 @@
 #include "math/Vec3.h"
 #include "game/Collision.h"
 
+class CollisionWorld;
+
 struct Player
 {
-    AABB wallBox{
-    { -1.0f, 0.0f, -1.0f },
-    {  1.0f, 2.0f,  1.0f }
-    };
+    //   :  (radius, height)    ;
+    // nullptr    y = 0
+    const CollisionWorld* world = nullptr;
 
     Vec3 position{ 0.0f, 0.0f, 0.0f };
     Vec3 velocity{ 0.0f, 0.0f, 0.0f };
@@ -21,7 +22,11 @@ struct Player
     float jumpSpeed = 5.0f;
     float gravity = 9.81f;
 
+    float stepHeight = 0.4f;       // ,     
+    float minGroundNormalY = 0.7f; //  ~45   ,  
+
     bool grounded = true;
+    Vec3 groundNormal{ 0.0f, 1.0f, 0.0f };
 
     // wishDir       (XZ),   
     void update(float dt, const Vec3& wishDir, bool jumpPressed);
@@ -0,0 +1,75 @@
+#include "game/UserCmd.h"
+#include <algorithm>
+#include <cmath>
+
+Vec3 UserCmd::wishDir() const {
+    // forward/right по yaw, как у CameraFPS, но без pitch
+    Vec3 f{ std::sin(yaw), 0.0f, -std::cos(yaw) };
+    Vec3 r{ std::cos(yaw), 0.0f, std::sin(yaw) };
+
+    Vec3 wish{ 0.0f, 0.0f, 0.0f };
+    if (down(Forward)) wish += f;
+    if (down(Back)) wish += f * -1.0f;
+    if (down(Right)) wish += r;
+    if (down(Left)) wish += r * -1.0f;
+    return wish;
+}
+
+void UserCmdBuilder::look(float dx, float dy, float& yaw, float& pitch) const {
+    yaw += dx * sens_;
+    pitch -= dy * sens_; // инверсия Y: мышь вверх -> смотреть вверх
+    pitch = std::clamp(pitch, -PITCH_LIMIT, PITCH_LIMIT);
+}
+
+uint32_t UserCmdBuilder::buttonFor(const InputEvent& e) {
+    if (e.type == InputEvent::MouseButton)
+        return e.code == SDL_BUTTON_LEFT ? (uint32_t)UserCmd::Attack : 0u;
+
+    switch ((SDL_Scancode)e.code) {
+    case SDL_SCANCODE_W: return UserCmd::Forward;
+    case SDL_SCANCODE_S: return UserCmd::Back;
+    case SDL_SCANCODE_A: return UserCmd::Left;
+    case SDL_SCANCODE_D: return UserCmd::Right;
+    case SDL_SCANCODE_SPACE: return UserCmd::Jump;
+    default: return 0;
+    }
+}
+
+UserCmd UserCmdBuilder::build(InputQueue& queue, uint64_t tickEnd) {
+    UserCmd cmd;
+    cmd.tick = tick_++;
+
+    while (queue.size() > 0) {
+        const InputEvent& e = queue.peek(0);
+        if (e.time > tickEnd) break; // это уже ввод следующих тиков
+
+        if (e.type == InputEvent::MouseMove) {
+            look(e.dx, e.dy, yaw_, pitch_);
+        }
+        else if (uint32_t b = buttonFor(e)) {
+            if (e.down) {
+                buttons_ |= b;
+                cmd.pressed |= b;
+            }
+            else {
+                buttons_ &= ~b;
+            }
+        }
+        queue.pop();
+    }
+
+    cmd.yaw = yaw_;
+    cmd.pitch = pitch_;
+    cmd.buttons = buttons_;
+    return cmd;
+}
+
+void UserCmdBuilder::previewLook(const InputQueue& queue, float& yaw, float& pitch) const {
+    yaw = yaw_;
+    pitch = pitch_;
+    const uint32_t n = queue.size();
+    for (uint32_t i = 0; i < n; ++i) {
+        const InputEvent& e = queue.peek(i);
+        if (e.type == InputEvent::MouseMove) look(e.dx, e.dy, yaw, pitch);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "core/InputQueue.h"
+#include "math/Vec3.h"
+#include <cstdint>
+
+// Команда игрока на один sim-тик: куда смотрит и что нажато — ровно по вводу,
+// который пришёл за время этого тика.
+struct UserCmd {
+    enum Button : uint32_t {
+        Forward = 1u << 0,
+        Back = 1u << 1,
+        Left = 1u << 2,
+        Right = 1u << 3,
+        Jump = 1u << 4,
+        Attack = 1u << 5,
+    };
+
+    uint64_t tick = 0;
+    float yaw = 0.0f;       // radians, на конец тика
+    float pitch = 0.0f;
+    uint32_t buttons = 0;   // зажато на конец тика
+    uint32_t pressed = 0;   // нажималось за тик (даже если уже отпущено: короткий тап не теряется)
+
+    bool down(Button b) const { return (buttons & b) != 0; }
+    bool wasPressed(Button b) const { return (pressed & b) != 0; }
+
+    // направление движения по XZ в мировых координатах (не нормализовано)
+    Vec3 wishDir() const;
+};
+
+// Собирает UserCmd из InputQueue: на каждый тик забирает события, пришедшие до конца его
+// временного отрезка, и применяет их по порядку. Углы копятся во float, так что дробные
+// отсчёты мыши (и малая чувствительность) не теряются на округлении.
+class UserCmdBuilder {
+public:
+    static constexpr float PITCH_LIMIT = 1.553343f; // ~89 degrees in radians
+
+    void setSensitivity(float s) { sens_ = s; } // radians per count
+    void setAngles(float yaw, float pitch) { yaw_ = yaw; pitch_ = pitch; }
+    float yaw() const { return yaw_; }
+    float pitch() const { return pitch_; }
+
+    // команда тика, чей отрезок кончается в tickEnd (SDL_GetPerformanceCounter)
+    UserCmd build(InputQueue& queue, uint64_t tickEnd);
+
+    // углы с учётом ещё не разобранного ввода (для камеры рендера), очередь не трогает
+    void previewLook(const InputQueue& queue, float& yaw, float& pitch) const;
+
+private:
+    void look(float dx, float dy, float& yaw, float& pitch) const;
+    static uint32_t buttonFor(const InputEvent& e);
+
+    float yaw_ = 0.0f;
+    float pitch_ = 0.0f;
+    float sens_ = 0.0025f;
+    uint32_t buttons_ = 0;
+    uint64_t tick_ = 0;
+};
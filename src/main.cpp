@@ -1,8 +1,29 @@
 #include "engine/Engine.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
 
+// cs_like [--record FILE | --replay FILE [--headless] [--fast]] [--profile FILE] [--frame-stats PREFIX] [--hitch-ms MS] [--level FILE]
 int main(int argc, char** argv) {
+	EngineOptions opts;
+	for (int i = 1; i < argc; ++i) {
+		std::string a = argv[i];
+		if (a == "--record" && i + 1 < argc) opts.recordPath = argv[++i];
+		else if (a == "--replay" && i + 1 < argc) opts.replayPath = argv[++i];
+		else if (a == "--headless") opts.headless = true;
+		else if (a == "--fast") opts.fast = true;
+		else if (a == "--profile" && i + 1 < argc) opts.profilePath = argv[++i];
+		else if (a == "--frame-stats" && i + 1 < argc) opts.frameStatsPath = argv[++i];
+		else if (a == "--hitch-ms" && i + 1 < argc) opts.hitchMs = (float)std::atof(argv[++i]);
+		else if (a == "--level" && i + 1 < argc) opts.levelPath = argv[++i];
+		else {
+			std::cerr << "usage: cs_like [--record FILE | --replay FILE [--headless] [--fast]] [--profile FILE] [--frame-stats PREFIX] [--hitch-ms MS] [--level FILE]\n";
+			return 1;
+		}
+	}
+
 	Engine engine;
-	if (!engine.init()) return 1;
+	if (!engine.init(opts)) return 1;
 	engine.run();
 	engine.shutdown();
 	return 0;
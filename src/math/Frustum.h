@@ -0,0 +1,58 @@
+#pragma once
+#include "math/Mat4.h"
+#include "math/Vec3.h"
+
+// Плоскость n·p + d = 0, нормаль смотрит внутрь frustum (внутри: n·p + d >= 0)
+struct Plane {
+	float nx = 0, ny = 0, nz = 0, d = 0;
+};
+
+// 6 плоскостей frustum из view-projection (Gribb/Hartmann).
+// Depth 0..1 (perspectiveRH_ZO / orthoRH_ZO): ближняя плоскость = строка 2, а не r3 + r2.
+struct Frustum {
+	// без NEAR/FAR: windows.h определяет их макросами
+	enum { Left, Right, Bottom, Top, Near, Far, Count };
+	Plane planes[Count];
+
+	static Frustum fromViewProj(const Mat4& vp) {
+		// строка i column-major матрицы: (m[i], m[4 + i], m[8 + i], m[12 + i])
+		auto row = [&](int i, float s, Plane& p) {
+			p.nx += s * vp.m[i]; p.ny += s * vp.m[4 + i]; p.nz += s * vp.m[8 + i]; p.d += s * vp.m[12 + i];
+		};
+
+		Frustum f;
+		row(3, 1, f.planes[Left]);   row(0, 1, f.planes[Left]);
+		row(3, 1, f.planes[Right]);  row(0, -1, f.planes[Right]);
+		row(3, 1, f.planes[Bottom]); row(1, 1, f.planes[Bottom]);
+		row(3, 1, f.planes[Top]);    row(1, -1, f.planes[Top]);
+		row(2, 1, f.planes[Near]);
+		row(3, 1, f.planes[Far]);    row(2, -1, f.planes[Far]);
+
+		// нормируем, чтобы d и радиусы сфер были в метрах
+		for (Plane& p : f.planes) {
+			float len = std::sqrt(p.nx * p.nx + p.ny * p.ny + p.nz * p.nz);
+			if (len > 1e-12f) {
+				float inv = 1.0f / len;
+				p.nx *= inv; p.ny *= inv; p.nz *= inv; p.d *= inv;
+			}
+		}
+		return f;
+	}
+
+	bool sphereVisible(const Vec3& c, float r) const {
+		for (const Plane& p : planes)
+			if (p.nx * c.x + p.ny * c.y + p.nz * c.z + p.d < -r) return false;
+		return true;
+	}
+
+	bool aabbVisible(const Vec3& bmin, const Vec3& bmax) const {
+		Vec3 c = (bmin + bmax) * 0.5f;
+		Vec3 e = (bmax - bmin) * 0.5f;
+		for (const Plane& p : planes) {
+			float dist = p.nx * c.x + p.ny * c.y + p.nz * c.z + p.d;
+			float ext = std::fabs(p.nx) * e.x + std::fabs(p.ny) * e.y + std::fabs(p.nz) * e.z;
+			if (dist < -ext) return false;
+		}
+		return true;
+	}
+};
@@ -58,6 +58,19 @@ struct Mat4 {
         return r;
     }
 
+    // Orthographic RH, depth 0..1 (near -> 0, far -> 1)
+    static Mat4 orthoRH_ZO(float left, float right, float bottom, float top, float zNear, float zFar) {
+        Mat4 r{};
+        r.m[0] = 2.0f / (right - left);
+        r.m[5] = 2.0f / (top - bottom);
+        r.m[10] = -1.0f / (zFar - zNear);
+        r.m[12] = -(right + left) / (right - left);
+        r.m[13] = -(top + bottom) / (top - bottom);
+        r.m[14] = -zNear / (zFar - zNear);
+        r.m[15] = 1.0f;
+        return r;
+    }
+
     static Mat4 translation(float x, float y, float z) {
         Mat4 r = identity();
         r.m[12] = x; r.m[13] = y; r.m[14] = z;
@@ -85,4 +98,34 @@ struct Mat4 {
         r.m[6] = s;  r.m[10] = c;
         return r;
     }
+
+    // model = T * R * S (R    x, y, z, w)
+    static Mat4 fromTRS(const Vec3& t, float qx, float qy, float qz, float qw, const Vec3& s) {
+        float xx = qx * qx, yy = qy * qy, zz = qz * qz;
+        float xy = qx * qy, xz = qx * qz, yz = qy * qz;
+        float wx = qw * qx, wy = qw * qy, wz = qw * qz;
+
+        Mat4 r;
+        r.m[0] = (1.0f - 2.0f * (yy + zz)) * s.x; r.m[1] = 2.0f * (xy + wz) * s.x;          r.m[2] = 2.0f * (xz - wy) * s.x;
+        r.m[4] = 2.0f * (xy - wz) * s.y;          r.m[5] = (1.0f - 2.0f * (xx + zz)) * s.y; r.m[6] = 2.0f * (yz + wx) * s.y;
+        r.m[8] = 2.0f * (xz + wy) * s.z;          r.m[9] = 2.0f * (yz - wx) * s.z;          r.m[10] = (1.0f - 2.0f * (xx + yy)) * s.z;
+        r.m[12] = t.x; r.m[13] = t.y; r.m[14] = t.z; r.m[15] = 1.0f;
+        return r;
+    }
 };
+
+// AABB    (Arvo):  ,     |M|
+inline void transformAabb(const Mat4& m, const Vec3& bmin, const Vec3& bmax, Vec3& outMin, Vec3& outMax) {
+    Vec3 c = (bmin + bmax) * 0.5f;
+    Vec3 e = (bmax - bmin) * 0.5f;
+    Vec3 wc{
+        m.m[0] * c.x + m.m[4] * c.y + m.m[8] * c.z + m.m[12],
+        m.m[1] * c.x + m.m[5] * c.y + m.m[9] * c.z + m.m[13],
+        m.m[2] * c.x + m.m[6] * c.y + m.m[10] * c.z + m.m[14] };
+    Vec3 we{
+        std::fabs(m.m[0]) * e.x + std::fabs(m.m[4]) * e.y + std::fabs(m.m[8]) * e.z,
+        std::fabs(m.m[1]) * e.x + std::fabs(m.m[5]) * e.y + std::fabs(m.m[9]) * e.z,
+        std::fabs(m.m[2]) * e.x + std::fabs(m.m[6]) * e.y + std::fabs(m.m[10]) * e.z };
+    outMin = wc - we;
+    outMax = wc + we;
+}
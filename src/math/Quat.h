@@ -0,0 +1,45 @@
+#pragma once
+#include <cmath>
+#include "math/Vec3.h"
+
+// Единичный кватернион поворота (x, y, z — вектор, w — скаляр)
+struct Quat {
+	float x = 0, y = 0, z = 0, w = 1;
+
+	Quat() = default;
+	Quat(float X, float Y, float Z, float W) : x(X), y(Y), z(Z), w(W) {}
+
+	static Quat identity() { return {}; }
+
+	// axis — единичный
+	static Quat fromAxisAngle(const Vec3& axis, float angle) {
+		float s = std::sin(angle * 0.5f);
+		return { axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f) };
+	}
+
+	static Quat rotationY(float angle) { return fromAxisAngle({ 0.0f, 1.0f, 0.0f }, angle); }
+
+	// a * b: сначала b, потом a
+	static Quat mul(const Quat& a, const Quat& b) {
+		return {
+			a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+			a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+			a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+		};
+	}
+};
+
+inline Quat normalize(const Quat& q) {
+	float len = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+	if (len <= 1e-12f) return {};
+	float inv = 1.0f / len;
+	return { q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+}
+
+inline Vec3 rotate(const Quat& q, const Vec3& v) {
+	// v + 2w(q x v) + 2 q x (q x v)
+	Vec3 u{ q.x, q.y, q.z };
+	Vec3 t = cross(u, v) * 2.0f;
+	return v + t * q.w + cross(u, t);
+}
@@ -121,21 +121,16 @@ bool WindowSDL::toggleFullscreen() {
     }
 }
 
-void WindowSDL::pollEvents(bool& running, const std::function<void(const SDL_Event&)>& onEvent) {
-    SDL_Event e;
-    while (SDL_PollEvent(&e)) {
-        onEvent(e);
+void WindowSDL::handleEvent(const SDL_Event& e, bool& running) {
+    if (e.type == SDL_QUIT) running = false;
 
-        if (e.type == SDL_QUIT) running = false;
-
-        if (e.type == SDL_KEYDOWN && e.key.repeat == 0) {
-            if (e.key.keysym.sym == SDLK_F11) toggleFsRequested_ = true;
-            if (e.key.keysym.sym == SDLK_ESCAPE) running = false; //   
-        }
+    if (e.type == SDL_KEYDOWN && e.key.repeat == 0) {
+        if (e.key.keysym.sym == SDLK_F11) toggleFsRequested_ = true;
+        if (e.key.keysym.sym == SDLK_ESCAPE) running = false; //   
+    }
 
-        if (e.type == SDL_WINDOWEVENT) {
-            if (e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) updateSizeFromWindow();
-            if (e.window.event == SDL_WINDOWEVENT_CLOSE) running = false;
-        }
+    if (e.type == SDL_WINDOWEVENT) {
+        if (e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) updateSizeFromWindow();
+        if (e.window.event == SDL_WINDOWEVENT_CLOSE) running = false;
     }
 }
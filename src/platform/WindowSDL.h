@@ -1,7 +1,6 @@
 #pragma once
 #include <SDL.h>
 #include <string>
-#include <functional>
 
 class WindowSDL {
 public:
@@ -21,9 +20,18 @@ public:
 	bool toggleFullscreen();
 	bool isFullscreen() const { return fullscreen_; }
 
-	void pollEvents(bool& running, const std::function<void(const SDL_Event&)>& onEvent);
+	// onEvent(const SDL_Event&)   ; ,   std::function     
+	template <typename F>
+	void pollEvents(bool& running, F&& onEvent) {
+		SDL_Event e;
+		while (SDL_PollEvent(&e)) {
+			onEvent(e);
+			handleEvent(e, running);
+		}
+	}
 
 private:
+	void handleEvent(const SDL_Event& e, bool& running);
 	void updateSizeFromWindow();
 
 	SDL_Window* window_{ nullptr };
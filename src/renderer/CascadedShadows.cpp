@@ -0,0 +1,408 @@
+#include "renderer/CascadedShadows.h"
+#include "renderer/VkUtils.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+static Vec3 transformPoint(const Mat4& m, const Vec3& p) {
+    return {
+        m.m[0] * p.x + m.m[4] * p.y + m.m[8] * p.z + m.m[12],
+        m.m[1] * p.x + m.m[5] * p.y + m.m[9] * p.z + m.m[13],
+        m.m[2] * p.x + m.m[6] * p.y + m.m[10] * p.z + m.m[14]
+    };
+}
+
+bool CascadedShadows::init(VulkanContext& vk, const VkVertexInputBindingDescription& binding,
+    const VkVertexInputAttributeDescription& posAttr) {
+    if (!createImage(vk)) return false;
+    if (!createRenderPass(vk)) return false;
+
+    for (uint32_t c = 0; c < CASCADES; ++c) {
+        VkFramebufferCreateInfo fi{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+        fi.renderPass = renderPass_;
+        fi.attachmentCount = 1;
+        fi.pAttachments = &layerViews_[c];
+        fi.width = RESOLUTION;
+        fi.height = RESOLUTION;
+        fi.layers = 1;
+        if (!vk_ok(vkCreateFramebuffer(vk.device(), &fi, nullptr, &framebuffers_[c]), "vkCreateFramebuffer (shadow) failed"))
+            return false;
+    }
+
+    if (!createPipeline(vk, binding, posAttr)) return false;
+
+    setSunDirection(sunDir_);
+    return true;
+}
+
+bool CascadedShadows::createImage(VulkanContext& vk) {
+    // depth + сэмплирование со сравнением (PCF)
+    const VkFormat candidates[] = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM };
+    const VkFormatFeatureFlags need = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    for (VkFormat f : candidates) {
+        VkFormatProperties props{};
+        vkGetPhysicalDeviceFormatProperties(vk.physicalDevice(), f, &props);
+        if ((props.optimalTilingFeatures & need) == need) { format_ = f; break; }
+    }
+    if (format_ == VK_FORMAT_UNDEFINED) {
+        std::cerr << "No depth format for shadow maps\n";
+        return false;
+    }
+
+    VkImageCreateInfo img{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    img.imageType = VK_IMAGE_TYPE_2D;
+    img.extent = { RESOLUTION, RESOLUTION, 1 };
+    img.mipLevels = 1;
+    img.arrayLayers = CASCADES;
+    img.format = format_;
+    img.tiling = VK_IMAGE_TILING_OPTIMAL;
+    img.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    img.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    img.samples = VK_SAMPLE_COUNT_1_BIT;
+    img.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (!vk_ok(vkCreateImage(vk.device(), &img, nullptr, &image_), "vkCreateImage (shadow) failed")) return false;
+
+    VkMemoryRequirements req{};
+    vkGetImageMemoryRequirements(vk.device(), image_, &req);
+
+    memory_ = allocateDeviceMemory(vk, req, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "shadow cascades");
+    if (!memory_) {
+        std::cerr << "vkAllocateMemory (shadow) failed\n";
+        return false;
+    }
+    if (!vk_ok(vkBindImageMemory(vk.device(), image_, memory_, 0), "vkBindImageMemory (shadow) failed")) return false;
+
+    VkImageViewCreateInfo vi{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    vi.image = image_;
+    vi.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    vi.format = format_;
+    vi.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    vi.subresourceRange.baseMipLevel = 0;
+    vi.subresourceRange.levelCount = 1;
+    vi.subresourceRange.baseArrayLayer = 0;
+    vi.subresourceRange.layerCount = CASCADES;
+    if (!vk_ok(vkCreateImageView(vk.device(), &vi, nullptr, &arrayView_), "vkCreateImageView (shadow array) failed"))
+        return false;
+
+    vi.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    vi.subresourceRange.layerCount = 1;
+    for (uint32_t c = 0; c < CASCADES; ++c) {
+        vi.subresourceRange.baseArrayLayer = c;
+        if (!vk_ok(vkCreateImageView(vk.device(), &vi, nullptr, &layerViews_[c]), "vkCreateImageView (shadow layer) failed"))
+            return false;
+    }
+
+    // за пределами карты = освещено (белый бордер), линейная фильтрация сравнения = 2x2 PCF бесплатно
+    VkSamplerCreateInfo si{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    si.magFilter = VK_FILTER_LINEAR;
+    si.minFilter = VK_FILTER_LINEAR;
+    si.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    si.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    si.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    si.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    si.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    si.compareEnable = VK_TRUE;
+    si.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    si.minLod = 0.0f;
+    si.maxLod = 0.0f;
+    return vk_ok(vkCreateSampler(vk.device(), &si, nullptr, &sampler_), "vkCreateSampler (shadow) failed");
+}
+
+bool CascadedShadows::createRenderPass(VulkanContext& vk) {
+    VkAttachmentDescription depth{};
+    depth.format = format_;
+    depth.samples = VK_SAMPLE_COUNT_1_BIT;
+    depth.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depth.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depth.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // слой всё равно очищаем
+    depth.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    VkAttachmentReference depthRef{};
+    depthRef.attachment = 0;
+    depthRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    VkSubpassDependency deps[2]{};
+    // вход: предыдущие кадры могли ещё читать этот слой во фрагментном шейдере (WAR)
+    deps[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    deps[0].dstSubpass = 0;
+    deps[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    deps[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    deps[0].srcAccessMask = 0;
+    deps[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // выход: depth -> сэмплирование в основном проходе
+    deps[1].srcSubpass = 0;
+    deps[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    deps[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    deps[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    deps[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    deps[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    VkRenderPassCreateInfo rp{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+    rp.attachmentCount = 1;
+    rp.pAttachments = &depth;
+    rp.subpassCount = 1;
+    rp.pSubpasses = &subpass;
+    rp.dependencyCount = 2;
+    rp.pDependencies = deps;
+    return vk_ok(vkCreateRenderPass(vk.device(), &rp, nullptr, &renderPass_), "vkCreateRenderPass (shadow) failed");
+}
+
+bool CascadedShadows::createPipeline(VulkanContext& vk, const VkVertexInputBindingDescription& binding,
+    const VkVertexInputAttributeDescription& posAttr) {
+    auto vert = readFile("shaders/shadow.vert.spv");
+    VkShaderModule vertMod = createShaderModule(vk.device(), vert);
+    if (!vertMod) return false;
+
+    // depth-only: фрагментного шейдера нет
+    VkPipelineShaderStageCreateInfo stage{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+    stage.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stage.module = vertMod;
+    stage.pName = "main";
+
+    VkPipelineVertexInputStateCreateInfo vi{ VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+    vi.vertexBindingDescriptionCount = 1;
+    vi.pVertexBindingDescriptions = &binding;
+    vi.vertexAttributeDescriptionCount = 1;
+    vi.pVertexAttributeDescriptions = &posAttr;
+
+    VkPipelineInputAssemblyStateCreateInfo ia{ VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+    ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo vp{ VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+    vp.viewportCount = 1;
+    vp.scissorCount = 1;
+
+    // slope-scaled bias против "shadow acne"
+    VkPipelineRasterizationStateCreateInfo rs{ VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+    rs.polygonMode = VK_POLYGON_MODE_FILL;
+    rs.cullMode = VK_CULL_MODE_NONE;
+    rs.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    rs.lineWidth = 1.0f;
+    rs.depthBiasEnable = VK_TRUE;
+    rs.depthBiasConstantFactor = 1.25f;
+    rs.depthBiasSlopeFactor = 1.75f;
+
+    VkPipelineMultisampleStateCreateInfo ms{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+    ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo ds{ VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
+    ds.depthTestEnable = VK_TRUE;
+    ds.depthWriteEnable = VK_TRUE;
+    ds.depthCompareOp = VK_COMPARE_OP_LESS;
+
+    VkPipelineColorBlendStateCreateInfo cb{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+    cb.attachmentCount = 0;
+
+    VkDynamicState dynStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dyn{ VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+    dyn.dynamicStateCount = 2;
+    dyn.pDynamicStates = dynStates;
+
+    // push: mvp (lightViewProj * model)
+    VkPushConstantRange pcr{};
+    pcr.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pcr.offset = 0;
+    pcr.size = sizeof(Mat4);
+
+    VkPipelineLayoutCreateInfo pli{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    pli.pushConstantRangeCount = 1;
+    pli.pPushConstantRanges = &pcr;
+    if (vkCreatePipelineLayout(vk.device(), &pli, nullptr, &pipelineLayout_) != VK_SUCCESS) {
+        vkDestroyShaderModule(vk.device(), vertMod, nullptr);
+        return false;
+    }
+
+    VkGraphicsPipelineCreateInfo pi{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+    pi.stageCount = 1;
+    pi.pStages = &stage;
+    pi.pVertexInputState = &vi;
+    pi.pInputAssemblyState = &ia;
+    pi.pViewportState = &vp;
+    pi.pRasterizationState = &rs;
+    pi.pMultisampleState = &ms;
+    pi.pDepthStencilState = &ds;
+    pi.pColorBlendState = &cb;
+    pi.pDynamicState = &dyn;
+    pi.layout = pipelineLayout_;
+    pi.renderPass = renderPass_;
+    pi.subpass = 0;
+
+    VkResult r = vkCreateGraphicsPipelines(vk.device(), VK_NULL_HANDLE, 1, &pi, nullptr, &pipeline_);
+    vkDestroyShaderModule(vk.device(), vertMod, nullptr);
+    return vk_ok(r, "vkCreateGraphicsPipelines (shadow) failed");
+}
+
+void CascadedShadows::shutdown(VulkanContext& vk) {
+    if (pipeline_) { vkDestroyPipeline(vk.device(), pipeline_, nullptr); pipeline_ = VK_NULL_HANDLE; }
+    if (pipelineLayout_) { vkDestroyPipelineLayout(vk.device(), pipelineLayout_, nullptr); pipelineLayout_ = VK_NULL_HANDLE; }
+
+    for (uint32_t c = 0; c < CASCADES; ++c) {
+        if (framebuffers_[c]) { vkDestroyFramebuffer(vk.device(), framebuffers_[c], nullptr); framebuffers_[c] = VK_NULL_HANDLE; }
+        if (layerViews_[c]) { vkDestroyImageView(vk.device(), layerViews_[c], nullptr); layerViews_[c] = VK_NULL_HANDLE; }
+    }
+    if (renderPass_) { vkDestroyRenderPass(vk.device(), renderPass_, nullptr); renderPass_ = VK_NULL_HANDLE; }
+    if (sampler_) { vkDestroySampler(vk.device(), sampler_, nullptr); sampler_ = VK_NULL_HANDLE; }
+    if (arrayView_) { vkDestroyImageView(vk.device(), arrayView_, nullptr); arrayView_ = VK_NULL_HANDLE; }
+    if (image_) { vkDestroyImage(vk.device(), image_, nullptr); image_ = VK_NULL_HANDLE; }
+    freeDeviceMemory(vk.device(), memory_);
+
+    for (auto& c : cascades_) c.valid = false;
+}
+
+void CascadedShadows::setSunDirection(const Vec3& toSun) {
+    Vec3 d = normalize(toSun);
+    if (length(d) < 0.5f) return;
+
+    // солнце сдвинулось -> кэш дальних каскадов недействителен
+    if (dot(d, sunDir_) < 0.999999f) invalidateStatic();
+    sunDir_ = d;
+
+    // поворот world -> light space (свет смотрит вдоль -sunDir); позиция задаётся в ортопроекции
+    Vec3 up = std::fabs(d.y) > 0.99f ? Vec3{ 0.0f, 0.0f, 1.0f } : Vec3{ 0.0f, 1.0f, 0.0f };
+    lightView_ = Mat4::lookAtRH({ 0.0f, 0.0f, 0.0f }, d * -1.0f, up);
+
+    params_.sunDir[0] = d.x;
+    params_.sunDir[1] = d.y;
+    params_.sunDir[2] = d.z;
+}
+
+void CascadedShadows::invalidateStatic() {
+    for (auto& c : cascades_) c.valid = false;
+}
+
+Mat4 CascadedShadows::fitCascade(const Vec3& center, float radius, Vec3& snappedCenter) const {
+    Vec3 lc = transformPoint(lightView_, center);
+
+    // центр двигается только целыми текселями -> растеризация статики не "плавает"
+    float texel = 2.0f * radius / (float)RESOLUTION;
+    lc.x = std::floor(lc.x / texel) * texel;
+    lc.y = std::floor(lc.y / texel) * texel;
+
+    // обратно в world (lightView_ — чистый поворот, обратный = транспонированный)
+    const Mat4& m = lightView_;
+    snappedCenter = {
+        m.m[0] * lc.x + m.m[1] * lc.y + m.m[2] * lc.z,
+        m.m[4] * lc.x + m.m[5] * lc.y + m.m[6] * lc.z,
+        m.m[8] * lc.x + m.m[9] * lc.y + m.m[10] * lc.z
+    };
+
+    // по глубине: сфера + CASTER_DISTANCE в сторону солнца (высокие объекты за краем сферы)
+    Mat4 ortho = Mat4::orthoRH_ZO(
+        lc.x - radius, lc.x + radius,
+        lc.y - radius, lc.y + radius,
+        -lc.z - radius - CASTER_DISTANCE, -lc.z + radius);
+    return Mat4::mul(ortho, lightView_);
+}
+
+void CascadedShadows::update(const Mat4& view, const Mat4& proj) {
+    params_.sunDir[3] = enabled_ ? 1.0f : 0.0f;
+    for (uint32_t c = 0; c < CASCADES; ++c) needsRender_[c] = false;
+    if (!enabled_) return;
+
+    // камера из view (lookAt): строки поворота = right, up, back
+    Vec3 right{ view.m[0], view.m[4], view.m[8] };
+    Vec3 up{ view.m[1], view.m[5], view.m[9] };
+    Vec3 back{ view.m[2], view.m[6], view.m[10] };
+    Vec3 eye = (right * view.m[12] + up * view.m[13] + back * view.m[14]) * -1.0f;
+    Vec3 fwd = back * -1.0f;
+
+    float tanX = 1.0f / proj.m[0];
+    float tanY = 1.0f / std::fabs(proj.m[5]);
+    float k2 = tanX * tanX + tanY * tanY;
+
+    float zNear = proj.m[14] / proj.m[10];
+    float zFar = std::min(SHADOW_DISTANCE, proj.m[14] / (proj.m[10] + 1.0f));
+
+    // practical split scheme: смесь логарифмического и равномерного разбиения
+    for (uint32_t c = 0; c < CASCADES; ++c) {
+        float t = (float)(c + 1) / (float)CASCADES;
+        float logSplit = zNear * std::pow(zFar / zNear, t);
+        float uniSplit = zNear + (zFar - zNear) * t;
+        params_.splits[c] = SPLIT_LAMBDA * logSplit + (1.0f - SPLIT_LAMBDA) * uniSplit;
+    }
+
+    for (uint32_t c = 0; c < CASCADES; ++c) {
+        float n = (c == 0) ? zNear : params_.splits[c - 1];
+        float f = params_.splits[c];
+
+        // минимальная сфера вокруг куска frustum [n, f]: центр на оси на расстоянии t.
+        // Зависит только от n, f и fov -> при повороте камеры размер каскада не меняется.
+        float t = std::min(f, 0.5f * (f + n) * (1.0f + k2));
+        float r = std::sqrt((f - t) * (f - t) + f * f * k2);
+        r = std::ceil(r * 16.0f) / 16.0f;
+        Vec3 center = eye + fwd * t;
+
+        Cascade& cc = cascades_[c];
+        if (!staticOnly(c)) {
+            params_.matrices[c] = fitCascade(center, r, cc.center);
+            cc.radius = r;
+            cc.sliceRadius = r;
+            cc.valid = true;
+            needsRender_[c] = true;
+            continue;
+        }
+
+        // кэшированный каскад: нужный кусок ещё целиком внутри отрисованной области?
+        bool inside = cc.valid && std::fabs(cc.sliceRadius - r) < 1e-3f &&
+            length(center - cc.center) + r <= cc.radius;
+        if (inside) continue;
+
+        cc.radius = r * CACHE_PADDING;
+        cc.sliceRadius = r;
+        params_.matrices[c] = fitCascade(center, cc.radius, cc.center);
+        cc.valid = true;
+        needsRender_[c] = true;
+    }
+}
+
+bool CascadedShadows::casterVisible(uint32_t c, const Vec3& bmin, const Vec3& bmax) const {
+    const Mat4& m = params_.matrices[c];
+    bool allLeft = true, allRight = true, allBelow = true, allAbove = true;
+    for (int i = 0; i < 8; ++i) {
+        Vec3 p{ (i & 1) ? bmax.x : bmin.x, (i & 2) ? bmax.y : bmin.y, (i & 4) ? bmax.z : bmin.z };
+        Vec3 q = transformPoint(m, p); // ортопроекция: w = 1
+        allLeft = allLeft && q.x < -1.0f;
+        allRight = allRight && q.x > 1.0f;
+        allBelow = allBelow && q.y < -1.0f;
+        allAbove = allAbove && q.y > 1.0f;
+    }
+    return !(allLeft || allRight || allBelow || allAbove);
+}
+
+void CascadedShadows::beginCascade(VkCommandBuffer cmd, uint32_t c) {
+    VkClearValue clear{};
+    clear.depthStencil.depth = 1.0f;
+
+    VkRenderPassBeginInfo rbi{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+    rbi.renderPass = renderPass_;
+    rbi.framebuffer = framebuffers_[c];
+    rbi.renderArea.offset = { 0, 0 };
+    rbi.renderArea.extent = { RESOLUTION, RESOLUTION };
+    rbi.clearValueCount = 1;
+    rbi.pClearValues = &clear;
+    vkCmdBeginRenderPass(cmd, &rbi, VK_SUBPASS_CONTENTS_INLINE);
+
+    VkViewport viewport{};
+    viewport.width = (float)RESOLUTION;
+    viewport.height = (float)RESOLUTION;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    VkRect2D scissor{};
+    scissor.extent = { RESOLUTION, RESOLUTION };
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+}
+
+void CascadedShadows::endCascade(VkCommandBuffer cmd, uint32_t c) {
+    vkCmdEndRenderPass(cmd);
+    needsRender_[c] = false;
+}
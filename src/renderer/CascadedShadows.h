@@ -0,0 +1,103 @@
+#pragma once
+#include "renderer/VulkanContext.h"
+#include "math/Mat4.h"
+#include "math/Vec3.h"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+
+// Тени от солнца: CASCADES каскадов в одном depth-массиве.
+//  - каждый каскад = ортопроекция вокруг описанной сферы своего куска frustum камеры
+//    (радиус не зависит от поворота камеры) + привязка центра к текселю -> без дрожания;
+//  - каскад 0 (ближний) перерисовывается каждый кадр, со всей геометрией;
+//  - дальние каскады содержат только статику и кэшируются: область берётся с запасом
+//    (CACHE_PADDING) и перерисовывается, только когда камера из неё вышла или сдвинулось солнце.
+
+struct ShadowStats {
+	uint32_t cascadesRendered = 0; // сколько каскадов перерисовано в этом кадре
+	uint32_t casters = 0;          // draw call'ов в shadow-проходах
+};
+
+class CascadedShadows {
+public:
+	static constexpr uint32_t CASCADES = 4;
+	static constexpr uint32_t RESOLUTION = 2048;
+	static constexpr float SHADOW_DISTANCE = 80.0f; // дальше теней нет
+	static constexpr float SPLIT_LAMBDA = 0.75f;    // 0 = равномерно, 1 = логарифмически
+	static constexpr float CACHE_PADDING = 1.5f;    // радиус кэшированной области / радиус куска
+	static constexpr float CASTER_DISTANCE = 50.0f; // насколько дальше к солнцу ловим отбрасывающих
+
+	// часть UBO кадра (std140): матрицы world -> shadow clip, дальняя граница каскадов, солнце
+	struct GpuParams {
+		Mat4 matrices[CASCADES];
+		float splits[CASCADES];
+		float sunDir[4]; // xyz = направление НА солнце (world), w = 1 если тени включены
+	};
+
+	bool init(VulkanContext& vk, const VkVertexInputBindingDescription& binding,
+		const VkVertexInputAttributeDescription& posAttr);
+	void shutdown(VulkanContext& vk);
+
+	void setSunDirection(const Vec3& toSun);
+	const Vec3& sunDirection() const { return sunDir_; }
+	void setEnabled(bool e) { enabled_ = e; }
+	bool enabled() const { return enabled_; }
+
+	// статическая геометрия поменялась -> все кэшированные каскады устарели
+	void invalidateStatic();
+
+	// подгонка каскадов под камеру и решение, что перерисовывать в этом кадре
+	void update(const Mat4& view, const Mat4& proj);
+	const GpuParams& params() const { return params_; }
+
+	bool needsRender(uint32_t c) const { return enabled_ && needsRender_[c]; }
+	// дальние каскады: только статика
+	static bool staticOnly(uint32_t c) { return c > 0; }
+	const Mat4& cascadeViewProj(uint32_t c) const { return params_.matrices[c]; }
+	// грубый тест AABB против прямоугольника каскада (по z не режем: тень могут бросать и из-за края)
+	bool casterVisible(uint32_t c, const Vec3& bmin, const Vec3& bmax) const;
+
+	// shadow-проход каскада: render pass + pipeline + viewport; mvp кладёт вызывающий (push constants)
+	void beginCascade(VkCommandBuffer cmd, uint32_t c);
+	void endCascade(VkCommandBuffer cmd, uint32_t c);
+	VkPipelineLayout pipelineLayout() const { return pipelineLayout_; }
+
+	VkImageView arrayView() const { return arrayView_; }
+	VkSampler sampler() const { return sampler_; }
+
+private:
+	bool createImage(VulkanContext& vk);
+	bool createRenderPass(VulkanContext& vk);
+	bool createPipeline(VulkanContext& vk, const VkVertexInputBindingDescription& binding,
+		const VkVertexInputAttributeDescription& posAttr);
+
+	struct Cascade {
+		Vec3 center;           // центр области (world), привязан к текселю
+		float radius = 0.0f;   // половина стороны ортопроекции
+		float sliceRadius = 0.0f; // радиус куска frustum, под который строили
+		bool valid = false;
+	};
+
+	// ортопроекция вокруг сферы (center, radius) с привязкой центра к текселю
+	Mat4 fitCascade(const Vec3& center, float radius, Vec3& snappedCenter) const;
+
+	VkFormat format_{ VK_FORMAT_UNDEFINED };
+	VkImage image_{ VK_NULL_HANDLE };
+	VkDeviceMemory memory_{ VK_NULL_HANDLE };
+	VkImageView arrayView_{ VK_NULL_HANDLE };
+	std::array<VkImageView, CASCADES> layerViews_{};
+	std::array<VkFramebuffer, CASCADES> framebuffers_{};
+	VkSampler sampler_{ VK_NULL_HANDLE };
+
+	VkRenderPass renderPass_{ VK_NULL_HANDLE };
+	VkPipelineLayout pipelineLayout_{ VK_NULL_HANDLE };
+	VkPipeline pipeline_{ VK_NULL_HANDLE };
+
+	std::array<Cascade, CASCADES> cascades_{};
+	std::array<bool, CASCADES> needsRender_{};
+	GpuParams params_{};
+
+	Vec3 sunDir_{ 0.3f, 1.0f, 0.2f };
+	Mat4 lightView_ = Mat4::identity(); // только поворот: world -> light space
+	bool enabled_ = true;
+};
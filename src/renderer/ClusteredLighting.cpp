@@ -0,0 +1,409 @@
+#include "renderer/ClusteredLighting.h"
+#include "renderer/VkUtils.h"
+#include "core/JobSystem.h"
+#include <SDL.h>
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+static uint32_t divUp(uint32_t a, uint32_t b) { return (a + b - 1) / b; }
+
+// push constants cluster_lights.comp
+struct AssignPush {
+    uint32_t clusterCount;
+    uint32_t lightCount;
+    uint32_t maxIndices;
+    uint32_t maxPerCluster;
+};
+
+bool ClusteredLighting::init(VulkanContext& vk) {
+    if (!createDescriptors(vk)) return false;
+    if (!createPipeline(vk)) return false;
+    if (!createBuffers(vk)) return false;
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        VkDescriptorBufferInfo bufs[4]{};
+        bufs[0] = { lightsBuf_[i], 0, VK_WHOLE_SIZE };
+        bufs[1] = { aabbBuf_[i], 0, VK_WHOLE_SIZE };
+        bufs[2] = { gridBuf_[i], 0, VK_WHOLE_SIZE };
+        bufs[3] = { indexBuf_[i], 0, VK_WHOLE_SIZE };
+
+        VkWriteDescriptorSet w[4]{};
+        for (uint32_t b = 0; b < 4; ++b) {
+            w[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[b].dstSet = sets_[i];
+            w[b].dstBinding = b;
+            w[b].descriptorCount = 1;
+            w[b].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            w[b].pBufferInfo = &bufs[b];
+        }
+        vkUpdateDescriptorSets(vk.device(), 4, w, 0, nullptr);
+    }
+    return true;
+}
+
+bool ClusteredLighting::createDescriptors(VulkanContext& vk) {
+    // lights, cluster aabbs, grid, indices
+    VkDescriptorSetLayoutBinding b[4]{};
+    for (uint32_t i = 0; i < 4; ++i) {
+        b[i].binding = i;
+        b[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        b[i].descriptorCount = 1;
+        b[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo li{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    li.bindingCount = 4;
+    li.pBindings = b;
+    if (vkCreateDescriptorSetLayout(vk.device(), &li, nullptr, &setLayout_) != VK_SUCCESS) return false;
+
+    VkDescriptorPoolSize ps{};
+    ps.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    ps.descriptorCount = MAX_FRAMES * 4;
+
+    VkDescriptorPoolCreateInfo pi{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    pi.poolSizeCount = 1;
+    pi.pPoolSizes = &ps;
+    pi.maxSets = MAX_FRAMES;
+    if (!vk_ok(vkCreateDescriptorPool(vk.device(), &pi, nullptr, &pool_), "vkCreateDescriptorPool (lights) failed"))
+        return false;
+
+    std::array<VkDescriptorSetLayout, MAX_FRAMES> layouts{};
+    layouts.fill(setLayout_);
+
+    VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    ai.descriptorPool = pool_;
+    ai.descriptorSetCount = MAX_FRAMES;
+    ai.pSetLayouts = layouts.data();
+    return vk_ok(vkAllocateDescriptorSets(vk.device(), &ai, sets_.data()), "vkAllocateDescriptorSets (lights) failed");
+}
+
+bool ClusteredLighting::createPipeline(VulkanContext& vk) {
+    VkPushConstantRange pcr{};
+    pcr.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pcr.offset = 0;
+    pcr.size = sizeof(AssignPush);
+
+    VkPipelineLayoutCreateInfo pli{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    pli.setLayoutCount = 1;
+    pli.pSetLayouts = &setLayout_;
+    pli.pushConstantRangeCount = 1;
+    pli.pPushConstantRanges = &pcr;
+    if (vkCreatePipelineLayout(vk.device(), &pli, nullptr, &pipelineLayout_) != VK_SUCCESS) return false;
+
+    pipeline_ = createComputePipeline(vk.device(), "shaders/cluster_lights.comp.spv", pipelineLayout_);
+    return pipeline_ != VK_NULL_HANDLE;
+}
+
+bool ClusteredLighting::createBuffers(VulkanContext& vk) {
+    const VkMemoryPropertyFlags hostMem = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    const VkDeviceSize lightsSize = sizeof(GpuLight) * MAX_LIGHTS;
+    const VkDeviceSize aabbSize = sizeof(ClusterAabb) * MAX_CLUSTERS;
+    const VkDeviceSize gridSize = sizeof(uint32_t) * 2 * MAX_CLUSTERS;
+    const VkDeviceSize indexSize = sizeof(uint32_t) * (1 + MAX_LIGHT_INDICES);
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        if (!createBuffer(vk, lightsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem,
+            lightsBuf_[i], lightsMem_[i], "clustered lighting")) return false;
+        if (vkMapMemory(vk.device(), lightsMem_[i], 0, lightsSize, 0, (void**)&lightsMapped_[i]) != VK_SUCCESS)
+            return false;
+
+        if (!createBuffer(vk, aabbSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem,
+            aabbBuf_[i], aabbMem_[i], "clustered lighting")) return false;
+        if (vkMapMemory(vk.device(), aabbMem_[i], 0, aabbSize, 0, (void**)&aabbMapped_[i]) != VK_SUCCESS)
+            return false;
+
+        if (!createBuffer(vk, gridSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, gridBuf_[i], gridMem_[i], "clustered lighting")) return false;
+        if (!createBuffer(vk, indexSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuf_[i], indexMem_[i], "clustered lighting")) return false;
+
+        if (!createBuffer(vk, gridSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, hostMem,
+            gridStagingBuf_[i], gridStagingMem_[i], "clustered lighting")) return false;
+        if (vkMapMemory(vk.device(), gridStagingMem_[i], 0, gridSize, 0, (void**)&gridStagingMapped_[i]) != VK_SUCCESS)
+            return false;
+
+        if (!createBuffer(vk, indexSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, hostMem,
+            indexStagingBuf_[i], indexStagingMem_[i], "clustered lighting")) return false;
+        if (vkMapMemory(vk.device(), indexStagingMem_[i], 0, indexSize, 0, (void**)&indexStagingMapped_[i]) != VK_SUCCESS)
+            return false;
+
+        aabbVersion_[i] = 0;
+        frameLights_[i] = 0;
+        frameCpuIndices_[i] = 0;
+        frameGpu_[i] = true;
+    }
+    return true;
+}
+
+void ClusteredLighting::shutdown(VulkanContext& vk) {
+    if (pool_) { vkDestroyDescriptorPool(vk.device(), pool_, nullptr); pool_ = VK_NULL_HANDLE; }
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        if (lightsMapped_[i]) { vkUnmapMemory(vk.device(), lightsMem_[i]); lightsMapped_[i] = nullptr; }
+        if (aabbMapped_[i]) { vkUnmapMemory(vk.device(), aabbMem_[i]); aabbMapped_[i] = nullptr; }
+        if (gridStagingMapped_[i]) { vkUnmapMemory(vk.device(), gridStagingMem_[i]); gridStagingMapped_[i] = nullptr; }
+        if (indexStagingMapped_[i]) { vkUnmapMemory(vk.device(), indexStagingMem_[i]); indexStagingMapped_[i] = nullptr; }
+
+        destroyBuffer(vk, lightsBuf_[i], lightsMem_[i]);
+        destroyBuffer(vk, aabbBuf_[i], aabbMem_[i]);
+        destroyBuffer(vk, gridBuf_[i], gridMem_[i]);
+        destroyBuffer(vk, indexBuf_[i], indexMem_[i]);
+        destroyBuffer(vk, gridStagingBuf_[i], gridStagingMem_[i]);
+        destroyBuffer(vk, indexStagingBuf_[i], indexStagingMem_[i]);
+    }
+
+    if (pipeline_) { vkDestroyPipeline(vk.device(), pipeline_, nullptr); pipeline_ = VK_NULL_HANDLE; }
+    if (pipelineLayout_) { vkDestroyPipelineLayout(vk.device(), pipelineLayout_, nullptr); pipelineLayout_ = VK_NULL_HANDLE; }
+    if (setLayout_) { vkDestroyDescriptorSetLayout(vk.device(), setLayout_, nullptr); setLayout_ = VK_NULL_HANDLE; }
+}
+
+void ClusteredLighting::configure(VkExtent2D extent, const Mat4& proj) {
+    // perspectiveRH_ZO: m10 = f/(n-f), m14 = f*n/(n-f)  ->  n = m14/m10, f = m14/(m10+1)
+    float zNear = proj.m[14] / proj.m[10];
+    float zFar = proj.m[14] / (proj.m[10] + 1.0f);
+
+    if (extent.width == extent_.width && extent.height == extent_.height &&
+        proj.m[0] == projX_ && proj.m[5] == projY_ &&
+        zNear == grid_.clusterZ[0] && zFar == grid_.clusterZ[1])
+        return;
+
+    extent_ = extent;
+    projX_ = proj.m[0];
+    projY_ = proj.m[5];
+
+    uint32_t w = std::max(1u, extent.width);
+    uint32_t h = std::max(1u, extent.height);
+    uint32_t tile = TILE_SIZE;
+    while (divUp(w, tile) * divUp(h, tile) * Z_SLICES > MAX_CLUSTERS) tile *= 2;
+
+    // срез s = floor(log(z) * scale + bias), z = расстояние вдоль взгляда
+    float logRatio = std::log(zFar / zNear);
+    grid_.clusterZ[0] = zNear;
+    grid_.clusterZ[1] = zFar;
+    grid_.clusterZ[2] = (float)Z_SLICES / logRatio;
+    grid_.clusterZ[3] = -(float)Z_SLICES * std::log(zNear) / logRatio;
+    grid_.clusterDims[0] = divUp(w, tile);
+    grid_.clusterDims[1] = divUp(h, tile);
+    grid_.clusterDims[2] = Z_SLICES;
+    grid_.clusterDims[3] = tile;
+
+    buildClusterAabbs();
+    ++gridVersion_;
+}
+
+void ClusteredLighting::buildClusterAabbs() {
+    const uint32_t X = grid_.clusterDims[0], Y = grid_.clusterDims[1], Z = grid_.clusterDims[2];
+    const uint32_t tile = grid_.clusterDims[3];
+    const float w = (float)std::max(1u, extent_.width);
+    const float h = (float)std::max(1u, extent_.height);
+    const float zNear = grid_.clusterZ[0], zFar = grid_.clusterZ[1];
+
+    aabbs_.resize((size_t)X * Y * Z);
+
+    // точка view space на расстоянии d: ndc.x = projX * x / d  ->  x = ndc.x * d / projX
+    for (uint32_t z = 0; z < Z; ++z) {
+        float d0 = zNear * std::pow(zFar / zNear, (float)z / (float)Z);
+        float d1 = zNear * std::pow(zFar / zNear, (float)(z + 1) / (float)Z);
+
+        for (uint32_t y = 0; y < Y; ++y) {
+            float ny0 = (float)(y * tile) / h * 2.0f - 1.0f;
+            float ny1 = (float)std::min((y + 1) * tile, (uint32_t)h) / h * 2.0f - 1.0f;
+
+            for (uint32_t x = 0; x < X; ++x) {
+                float nx0 = (float)(x * tile) / w * 2.0f - 1.0f;
+                float nx1 = (float)std::min((x + 1) * tile, (uint32_t)w) / w * 2.0f - 1.0f;
+
+                float xs[4] = { nx0 * d0 / projX_, nx1 * d0 / projX_, nx0 * d1 / projX_, nx1 * d1 / projX_ };
+                float ys[4] = { ny0 * d0 / projY_, ny1 * d0 / projY_, ny0 * d1 / projY_, ny1 * d1 / projY_ };
+
+                ClusterAabb& b = aabbs_[x + X * (y + Y * z)];
+                b.minP[0] = *std::min_element(xs, xs + 4);
+                b.maxP[0] = *std::max_element(xs, xs + 4);
+                b.minP[1] = *std::min_element(ys, ys + 4);
+                b.maxP[1] = *std::max_element(ys, ys + 4);
+                b.minP[2] = -d1;
+                b.maxP[2] = -d0;
+                b.minP[3] = 0.0f;
+                b.maxP[3] = 0.0f;
+            }
+        }
+    }
+}
+
+void ClusteredLighting::update(uint32_t frame, const std::vector<PointLight>& lights, const Mat4& view) {
+    uint32_t n = (uint32_t)std::min<size_t>(lights.size(), MAX_LIGHTS);
+
+    viewLights_.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        const PointLight& l = lights[i];
+        const Vec3& p = l.position;
+        GpuLight& g = viewLights_[i];
+        g.posRadius[0] = view.m[0] * p.x + view.m[4] * p.y + view.m[8] * p.z + view.m[12];
+        g.posRadius[1] = view.m[1] * p.x + view.m[5] * p.y + view.m[9] * p.z + view.m[13];
+        g.posRadius[2] = view.m[2] * p.x + view.m[6] * p.y + view.m[10] * p.z + view.m[14];
+        g.posRadius[3] = l.radius;
+        g.colorIntensity[0] = l.color.x;
+        g.colorIntensity[1] = l.color.y;
+        g.colorIntensity[2] = l.color.z;
+        g.colorIntensity[3] = l.intensity;
+    }
+    if (n > 0) std::memcpy(lightsMapped_[frame], viewLights_.data(), sizeof(GpuLight) * n);
+
+    if (aabbVersion_[frame] != gridVersion_) {
+        std::memcpy(aabbMapped_[frame], aabbs_.data(), sizeof(ClusterAabb) * aabbs_.size());
+        aabbVersion_[frame] = gridVersion_;
+    }
+
+    frameLights_[frame] = n;
+    frameGpu_[frame] = gpuAssign_;
+
+    stats_.lights = n;
+    stats_.clusters = clusterCount();
+    stats_.gpuAssign = gpuAssign_;
+    stats_.cpuIndices = 0;
+    stats_.cpuAssignMs = 0.0f;
+
+    if (!gpuAssign_) {
+        uint64_t t0 = SDL_GetPerformanceCounter();
+        frameCpuIndices_[frame] = assignCpu(frame);
+        uint64_t t1 = SDL_GetPerformanceCounter();
+        stats_.cpuIndices = frameCpuIndices_[frame];
+        stats_.cpuAssignMs = (float)((double)(t1 - t0) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+    }
+}
+
+uint32_t ClusteredLighting::assignCpu(uint32_t frame) {
+    const uint32_t X = grid_.clusterDims[0], Y = grid_.clusterDims[1], Z = grid_.clusterDims[2];
+    const uint32_t tile = grid_.clusterDims[3];
+    const uint32_t count = clusterCount();
+    const uint32_t nLights = frameLights_[frame];
+    const float w = (float)std::max(1u, extent_.width);
+    const float h = (float)std::max(1u, extent_.height);
+    const float zNear = grid_.clusterZ[0], zFar = grid_.clusterZ[1];
+    const float sliceScale = grid_.clusterZ[2], sliceBias = grid_.clusterZ[3];
+
+    cpuCounts_.assign(count, 0);
+    cpuSlots_.resize((size_t)count * MAX_LIGHTS_PER_CLUSTER);
+
+    // Потоки делят срезы по глубине: каждый кластер пишет ровно один поток -> без атомиков.
+    // Для каждого источника перебираем только кластеры его экранного/глубинного bbox.
+    parallelFor(Z, 1, [&](uint32_t zBegin, uint32_t zEnd) {
+        for (uint32_t li = 0; li < nLights; ++li) {
+            const GpuLight& l = viewLights_[li];
+            const float cx = l.posRadius[0], cy = l.posRadius[1], cz = l.posRadius[2], r = l.posRadius[3];
+
+            float dMin = -cz - r;
+            float dMax = -cz + r;
+            if (dMax <= zNear || dMin >= zFar) continue;
+
+            int s0 = dMin <= zNear ? 0 : (int)(std::log(dMin) * sliceScale + sliceBias);
+            int s1 = (int)(std::log(std::min(dMax, zFar)) * sliceScale + sliceBias);
+            s0 = std::max(s0, (int)zBegin);
+            s1 = std::min(s1, (int)zEnd - 1);
+            if (s0 > s1) continue;
+
+            int tx0 = 0, tx1 = (int)X - 1, ty0 = 0, ty1 = (int)Y - 1;
+            if (dMin > zNear) {
+                // сфера целиком перед near: проецируем её AABB (консервативно)
+                float minX = 1e30f, maxX = -1e30f, minY = 1e30f, maxY = -1e30f;
+                for (int c = 0; c < 8; ++c) {
+                    float px = cx + ((c & 1) ? r : -r);
+                    float py = cy + ((c & 2) ? r : -r);
+                    float d = -(cz + ((c & 4) ? r : -r));
+                    float nx = projX_ * px / d;
+                    float ny = projY_ * py / d;
+                    minX = std::min(minX, nx); maxX = std::max(maxX, nx);
+                    minY = std::min(minY, ny); maxY = std::max(maxY, ny);
+                }
+                if (minX > 1.0f || maxX < -1.0f || minY > 1.0f || maxY < -1.0f) continue;
+
+                tx0 = std::max(tx0, (int)std::floor((minX * 0.5f + 0.5f) * w / (float)tile));
+                tx1 = std::min(tx1, (int)std::floor((maxX * 0.5f + 0.5f) * w / (float)tile));
+                ty0 = std::max(ty0, (int)std::floor((minY * 0.5f + 0.5f) * h / (float)tile));
+                ty1 = std::min(ty1, (int)std::floor((maxY * 0.5f + 0.5f) * h / (float)tile));
+            }
+
+            for (int s = s0; s <= s1; ++s) {
+                for (int ty = ty0; ty <= ty1; ++ty) {
+                    for (int tx = tx0; tx <= tx1; ++tx) {
+                        uint32_t ci = (uint32_t)tx + X * ((uint32_t)ty + Y * (uint32_t)s);
+                        const ClusterAabb& b = aabbs_[ci];
+
+                        float qx = std::clamp(cx, b.minP[0], b.maxP[0]) - cx;
+                        float qy = std::clamp(cy, b.minP[1], b.maxP[1]) - cy;
+                        float qz = std::clamp(cz, b.minP[2], b.maxP[2]) - cz;
+                        if (qx * qx + qy * qy + qz * qz > r * r) continue;
+
+                        uint32_t& c = cpuCounts_[ci];
+                        if (c < MAX_LIGHTS_PER_CLUSTER) cpuSlots_[(size_t)ci * MAX_LIGHTS_PER_CLUSTER + c++] = li;
+                    }
+                }
+            }
+        }
+    });
+
+    // компактизация: uvec2(offset, count) + сплошной список индексов (первый uint = счётчик)
+    uint32_t* grid = gridStagingMapped_[frame];
+    uint32_t* indices = indexStagingMapped_[frame];
+    uint32_t total = 0;
+    for (uint32_t ci = 0; ci < count; ++ci) {
+        uint32_t n = std::min(cpuCounts_[ci], MAX_LIGHT_INDICES - total);
+        grid[ci * 2 + 0] = total;
+        grid[ci * 2 + 1] = n;
+        if (n > 0) std::memcpy(indices + 1 + total, &cpuSlots_[(size_t)ci * MAX_LIGHTS_PER_CLUSTER], sizeof(uint32_t) * n);
+        total += n;
+    }
+    indices[0] = total;
+    return total;
+}
+
+void ClusteredLighting::recordAssign(VkCommandBuffer cmd, uint32_t frame) {
+    const uint32_t count = clusterCount();
+    if (count == 0) return;
+
+    VkMemoryBarrier post{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    post.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    if (frameGpu_[frame]) {
+        // сброс глобального счётчика индексов
+        vkCmdFillBuffer(cmd, indexBuf_[frame], 0, sizeof(uint32_t), 0);
+
+        VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        mb.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &mb, 0, nullptr, 0, nullptr);
+
+        AssignPush pc{};
+        pc.clusterCount = count;
+        pc.lightCount = frameLights_[frame];
+        pc.maxIndices = MAX_LIGHT_INDICES;
+        pc.maxPerCluster = MAX_LIGHTS_PER_CLUSTER;
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout_, 0, 1, &sets_[frame], 0, nullptr);
+        vkCmdPushConstants(cmd, pipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), &pc);
+        vkCmdDispatch(cmd, divUp(count, 128), 1, 1);
+
+        post.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0, 1, &post, 0, nullptr, 0, nullptr);
+        return;
+    }
+
+    // CPU-путь: списки уже в staging, копируем только реально записанное
+    VkBufferCopy gridCopy{ 0, 0, sizeof(uint32_t) * 2 * count };
+    vkCmdCopyBuffer(cmd, gridStagingBuf_[frame], gridBuf_[frame], 1, &gridCopy);
+
+    VkBufferCopy indexCopy{ 0, 0, sizeof(uint32_t) * (1 + frameCpuIndices_[frame]) };
+    vkCmdCopyBuffer(cmd, indexStagingBuf_[frame], indexBuf_[frame], 1, &indexCopy);
+
+    post.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0, 1, &post, 0, nullptr, 0, nullptr);
+}
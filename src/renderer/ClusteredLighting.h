@@ -0,0 +1,141 @@
+#pragma once
+#include "renderer/VulkanContext.h"
+#include "math/Mat4.h"
+#include "math/Vec3.h"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <vector>
+#include <cstdint>
+
+// Clustered forward lighting:
+//  view frustum режется на 3D-кластеры (тайлы экрана TILE_SIZE px x экспоненциальные срезы по глубине),
+//  для каждого кластера строится компактный список индексов точечных источников,
+//  фрагментный шейдер находит свой кластер и проходит только по его списку.
+// Назначение источников: compute-шейдер (по умолчанию) или многопоточный CPU fallback.
+
+struct PointLight {
+	Vec3 position;     // world space
+	float radius = 1.0f;
+	Vec3 color{ 1.0f, 1.0f, 1.0f };
+	float intensity = 1.0f;
+};
+
+struct LightingStats {
+	uint32_t lights = 0;
+	uint32_t clusters = 0;
+	bool gpuAssign = true;
+	uint32_t cpuIndices = 0;   // сколько индексов записал CPU-путь
+	float cpuAssignMs = 0.0f;  // время CPU-назначения (0 на GPU-пути)
+};
+
+class ClusteredLighting {
+public:
+	static constexpr uint32_t MAX_FRAMES = 2;
+	static constexpr uint32_t MAX_LIGHTS = 4096;
+	static constexpr uint32_t MAX_CLUSTERS = 65536;
+	static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 128;
+	static constexpr uint32_t MAX_LIGHT_INDICES = 1u << 20;
+	static constexpr uint32_t TILE_SIZE = 64;   // px, увеличивается если кластеров не хватает
+	static constexpr uint32_t Z_SLICES = 24;
+
+	// layout совпадает с Light в шейдерах (std430, 32 байта), позиция в view space
+	struct GpuLight {
+		float posRadius[4];
+		float colorIntensity[4];
+	};
+
+	// параметры сетки для фрагментного шейдера (кладутся в UBO кадра)
+	struct GridParams {
+		float clusterZ[4];      // near, far, sliceScale, sliceBias
+		uint32_t clusterDims[4]; // x, y, z, tileSize
+	};
+
+	bool init(VulkanContext& vk);
+	void shutdown(VulkanContext& vk);
+
+	// сетка зависит от размера экрана и проекции; пересчёт только если что-то изменилось
+	void configure(VkExtent2D extent, const Mat4& proj);
+	const GridParams& gridParams() const { return grid_; }
+
+	// CPU: источники -> view space; на CPU-пути здесь же считаются списки (после fence этого слота)
+	void update(uint32_t frame, const std::vector<PointLight>& lights, const Mat4& view);
+
+	// до render pass: compute-назначение или копия CPU-результата в device-local буферы
+	void recordAssign(VkCommandBuffer cmd, uint32_t frame);
+
+	// буферы для descriptor set основного прохода (fragment)
+	VkBuffer lightsBuffer(uint32_t frame) const { return lightsBuf_[frame]; }
+	VkBuffer clusterBuffer(uint32_t frame) const { return gridBuf_[frame]; }
+	VkBuffer indexBuffer(uint32_t frame) const { return indexBuf_[frame]; }
+
+	void setGpuAssign(bool e) { gpuAssign_ = e; }
+	bool gpuAssign() const { return gpuAssign_; }
+	const LightingStats& stats() const { return stats_; }
+
+private:
+	bool createDescriptors(VulkanContext& vk);
+	bool createPipeline(VulkanContext& vk);
+	bool createBuffers(VulkanContext& vk);
+
+	void buildClusterAabbs();
+	uint32_t assignCpu(uint32_t frame);
+
+	// layout совпадает с ClusterAabb в cluster_lights.comp (view space)
+	struct ClusterAabb {
+		float minP[4];
+		float maxP[4];
+	};
+
+	uint32_t clusterCount() const { return grid_.clusterDims[0] * grid_.clusterDims[1] * grid_.clusterDims[2]; }
+
+	// ---- compute ----
+	VkDescriptorSetLayout setLayout_{ VK_NULL_HANDLE };
+	VkPipelineLayout pipelineLayout_{ VK_NULL_HANDLE };
+	VkPipeline pipeline_{ VK_NULL_HANDLE };
+	VkDescriptorPool pool_{ VK_NULL_HANDLE };
+	std::array<VkDescriptorSet, MAX_FRAMES> sets_{};
+
+	// ---- per-frame buffers ----
+	std::array<VkBuffer, MAX_FRAMES> lightsBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> lightsMem_{};
+	std::array<GpuLight*, MAX_FRAMES> lightsMapped_{};
+
+	std::array<VkBuffer, MAX_FRAMES> aabbBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> aabbMem_{};
+	std::array<ClusterAabb*, MAX_FRAMES> aabbMapped_{};
+	std::array<uint32_t, MAX_FRAMES> aabbVersion_{};
+
+	// device-local: uvec2(offset, count) на кластер + [counter, indices...]
+	std::array<VkBuffer, MAX_FRAMES> gridBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> gridMem_{};
+	std::array<VkBuffer, MAX_FRAMES> indexBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> indexMem_{};
+
+	// host-visible staging для CPU-пути
+	std::array<VkBuffer, MAX_FRAMES> gridStagingBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> gridStagingMem_{};
+	std::array<uint32_t*, MAX_FRAMES> gridStagingMapped_{};
+	std::array<VkBuffer, MAX_FRAMES> indexStagingBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> indexStagingMem_{};
+	std::array<uint32_t*, MAX_FRAMES> indexStagingMapped_{};
+
+	// что записано в слот кадра (recordAssign идёт после update)
+	std::array<uint32_t, MAX_FRAMES> frameLights_{};
+	std::array<uint32_t, MAX_FRAMES> frameCpuIndices_{};
+	std::array<bool, MAX_FRAMES> frameGpu_{};
+
+	// ---- сетка ----
+	GridParams grid_{};
+	VkExtent2D extent_{ 0, 0 };
+	float projX_ = 0.0f, projY_ = 0.0f; // proj.m[0], proj.m[5]
+	std::vector<ClusterAabb> aabbs_;
+	std::vector<GpuLight> viewLights_; // CPU-копия (mapped память может быть write-combined)
+	uint32_t gridVersion_ = 0;
+
+	// CPU-путь: фиксированные слоты на кластер, потом компактизация
+	std::vector<uint32_t> cpuCounts_;
+	std::vector<uint32_t> cpuSlots_;
+
+	bool gpuAssign_ = true;
+	LightingStats stats_;
+};
@@ -0,0 +1,171 @@
+#include "renderer/FrustumCuller.h"
+#include "core/JobSystem.h"
+#include <algorithm>
+
+// ширина пачки выбирается флагами компиляции (DW_CULL_AVX в CMake -> /arch:AVX / -mavx)
+#if defined(__AVX__)
+#include <immintrin.h>
+#define DW_CULL_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DW_CULL_WIDTH 4
+#else
+#define DW_CULL_WIDTH 1
+#endif
+
+namespace {
+
+#if DW_CULL_WIDTH == 8
+using VFloat = __m256;
+inline VFloat vload(const float* p) { return _mm256_loadu_ps(p); }
+inline VFloat vset(float v) { return _mm256_set1_ps(v); }
+inline VFloat vadd(VFloat a, VFloat b) { return _mm256_add_ps(a, b); }
+inline VFloat vmul(VFloat a, VFloat b) { return _mm256_mul_ps(a, b); }
+inline VFloat vneg(VFloat a) { return _mm256_sub_ps(_mm256_setzero_ps(), a); }
+inline VFloat vge(VFloat a, VFloat b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+inline VFloat vand(VFloat a, VFloat b) { return _mm256_and_ps(a, b); }
+inline VFloat vtrue() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+inline uint32_t vmask(VFloat a) { return (uint32_t)_mm256_movemask_ps(a); }
+#elif DW_CULL_WIDTH == 4
+using VFloat = __m128;
+inline VFloat vload(const float* p) { return _mm_loadu_ps(p); }
+inline VFloat vset(float v) { return _mm_set1_ps(v); }
+inline VFloat vadd(VFloat a, VFloat b) { return _mm_add_ps(a, b); }
+inline VFloat vmul(VFloat a, VFloat b) { return _mm_mul_ps(a, b); }
+inline VFloat vneg(VFloat a) { return _mm_sub_ps(_mm_setzero_ps(), a); }
+inline VFloat vge(VFloat a, VFloat b) { return _mm_cmpge_ps(a, b); }
+inline VFloat vand(VFloat a, VFloat b) { return _mm_and_ps(a, b); }
+inline VFloat vtrue() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+inline uint32_t vmask(VFloat a) { return (uint32_t)_mm_movemask_ps(a); }
+#endif
+
+// индексы base + k для установленных бит маски; без ветвлений: пишем всегда, сдвигаем курсор по биту
+inline uint32_t emit(uint32_t mask, uint32_t base, uint32_t* out, uint32_t n) {
+    for (uint32_t k = 0; k < DW_CULL_WIDTH; ++k) {
+        out[n] = base + k;
+        n += (mask >> k) & 1u;
+    }
+    return n;
+}
+
+// [begin, end) -> out[0..n)
+uint32_t cullSpheresRange(const Frustum& f, const SphereSoA& s, uint32_t begin, uint32_t end, uint32_t* out) {
+    uint32_t n = 0;
+    uint32_t i = begin;
+
+#if DW_CULL_WIDTH > 1
+    VFloat nx[Frustum::Count], ny[Frustum::Count], nz[Frustum::Count], nd[Frustum::Count];
+    for (int p = 0; p < Frustum::Count; ++p) {
+        nx[p] = vset(f.planes[p].nx); ny[p] = vset(f.planes[p].ny);
+        nz[p] = vset(f.planes[p].nz); nd[p] = vset(f.planes[p].d);
+    }
+
+    for (; i + DW_CULL_WIDTH <= end; i += DW_CULL_WIDTH) {
+        VFloat x = vload(&s.x[i]), y = vload(&s.y[i]), z = vload(&s.z[i]);
+        VFloat negR = vneg(vload(&s.r[i]));
+
+        VFloat in = vtrue();
+        for (int p = 0; p < Frustum::Count; ++p) {
+            VFloat dist = vadd(vadd(vmul(nx[p], x), vmul(ny[p], y)), vadd(vmul(nz[p], z), nd[p]));
+            in = vand(in, vge(dist, negR));
+        }
+        n = emit(vmask(in), i, out, n);
+    }
+#endif
+
+    // хвост (и весь диапазон на сборке без SIMD)
+    for (; i < end; ++i) {
+        out[n] = i;
+        n += f.sphereVisible({ s.x[i], s.y[i], s.z[i] }, s.r[i]) ? 1u : 0u;
+    }
+    return n;
+}
+
+uint32_t cullAabbsRange(const Frustum& f, const AabbSoA& b, uint32_t begin, uint32_t end, uint32_t* out) {
+    uint32_t n = 0;
+    uint32_t i = begin;
+
+#if DW_CULL_WIDTH > 1
+    VFloat nx[Frustum::Count], ny[Frustum::Count], nz[Frustum::Count], nd[Frustum::Count];
+    VFloat ax[Frustum::Count], ay[Frustum::Count], az[Frustum::Count];
+    for (int p = 0; p < Frustum::Count; ++p) {
+        const Plane& pl = f.planes[p];
+        nx[p] = vset(pl.nx); ny[p] = vset(pl.ny); nz[p] = vset(pl.nz); nd[p] = vset(pl.d);
+        ax[p] = vset(std::fabs(pl.nx)); ay[p] = vset(std::fabs(pl.ny)); az[p] = vset(std::fabs(pl.nz));
+    }
+
+    const VFloat zero = vset(0.0f);
+    for (; i + DW_CULL_WIDTH <= end; i += DW_CULL_WIDTH) {
+        VFloat cx = vload(&b.cx[i]), cy = vload(&b.cy[i]), cz = vload(&b.cz[i]);
+        VFloat ex = vload(&b.ex[i]), ey = vload(&b.ey[i]), ez = vload(&b.ez[i]);
+
+        // снаружи, если центр дальше за плоскостью, чем проекция половины размера на нормаль
+        VFloat in = vtrue();
+        for (int p = 0; p < Frustum::Count; ++p) {
+            VFloat dist = vadd(vadd(vmul(nx[p], cx), vmul(ny[p], cy)), vadd(vmul(nz[p], cz), nd[p]));
+            VFloat ext = vadd(vadd(vmul(ax[p], ex), vmul(ay[p], ey)), vmul(az[p], ez));
+            in = vand(in, vge(vadd(dist, ext), zero));
+        }
+        n = emit(vmask(in), i, out, n);
+    }
+#endif
+
+    for (; i < end; ++i) {
+        Vec3 c{ b.cx[i], b.cy[i], b.cz[i] }, e{ b.ex[i], b.ey[i], b.ez[i] };
+        out[n] = i;
+        n += f.aabbVisible(c - e, c + e) ? 1u : 0u;
+    }
+    return n;
+}
+
+} // namespace
+
+uint32_t FrustumCuller::simdWidth() {
+    return DW_CULL_WIDTH;
+}
+
+template <typename Kernel>
+uint32_t FrustumCuller::run(uint32_t count, std::vector<uint32_t>& visible, const Kernel& kernel) {
+    // emit() пишет out[n] при n <= числа уже проверенных -> запись не выходит за свой диапазон
+    visible.resize(count);
+    if (count == 0) return 0;
+
+    uint32_t n = 0;
+    if (!threaded_ || count < PARALLEL_MIN) {
+        n = kernel(0, count, visible.data());
+    } else {
+        // кусок c пишет видимые в visible[c * CHUNK ...] — места хватает, видимых не больше объектов
+        uint32_t chunks = (count + CHUNK - 1) / CHUNK;
+        chunkCounts_.resize(chunks);
+
+        parallelFor(chunks, 1, [&](uint32_t cb, uint32_t ce) {
+            for (uint32_t c = cb; c < ce; ++c) {
+                uint32_t b = c * CHUNK;
+                uint32_t e = std::min(count, b + CHUNK);
+                chunkCounts_[c] = kernel(b, e, visible.data() + b);
+            }
+        });
+
+        // сдвигаем куски к началу (влево — можно на месте)
+        for (uint32_t c = 0; c < chunks; ++c) {
+            uint32_t b = c * CHUNK;
+            if (n != b) std::copy(visible.begin() + b, visible.begin() + b + chunkCounts_[c], visible.begin() + n);
+            n += chunkCounts_[c];
+        }
+    }
+
+    visible.resize(n);
+    return n;
+}
+
+uint32_t FrustumCuller::cullSpheres(const Frustum& f, const SphereSoA& s, std::vector<uint32_t>& visible) {
+    return run(s.size(), visible, [&](uint32_t b, uint32_t e, uint32_t* out) {
+        return cullSpheresRange(f, s, b, e, out);
+    });
+}
+
+uint32_t FrustumCuller::cullAabbs(const Frustum& f, const AabbSoA& b, std::vector<uint32_t>& visible) {
+    return run(b.size(), visible, [&](uint32_t begin, uint32_t end, uint32_t* out) {
+        return cullAabbsRange(f, b, begin, end, out);
+    });
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "math/Frustum.h"
+#include "math/Vec3.h"
+#include <vector>
+#include <cstdint>
+
+// CPU frustum culling, работает на любом железе (без GPU-culler'а тоже).
+// Объёмы лежат SoA: каждая компонента — свой массив, тест идёт пачками по 4 (SSE) или 8 (AVX)
+// объектов на 6 плоскостей. Большие наборы режутся на куски по CHUNK и раздаются потокам,
+// каждый кусок пишет индексы видимых в свой диапазон, потом диапазоны сдвигаются в один список.
+
+// сферы: центр + радиус
+struct SphereSoA {
+	std::vector<float> x, y, z, r;
+
+	uint32_t size() const { return (uint32_t)x.size(); }
+	void clear() { x.clear(); y.clear(); z.clear(); r.clear(); }
+	void reserve(size_t n) { x.reserve(n); y.reserve(n); z.reserve(n); r.reserve(n); }
+	void push(const Vec3& c, float radius) { x.push_back(c.x); y.push_back(c.y); z.push_back(c.z); r.push_back(radius); }
+};
+
+// AABB хранится как центр + половина размера: так тест — одно скалярное произведение с |n|
+struct AabbSoA {
+	std::vector<float> cx, cy, cz, ex, ey, ez;
+
+	uint32_t size() const { return (uint32_t)cx.size(); }
+	void clear() { cx.clear(); cy.clear(); cz.clear(); ex.clear(); ey.clear(); ez.clear(); }
+	void reserve(size_t n) { cx.reserve(n); cy.reserve(n); cz.reserve(n); ex.reserve(n); ey.reserve(n); ez.reserve(n); }
+	void push(const Vec3& bmin, const Vec3& bmax) {
+		cx.push_back((bmin.x + bmax.x) * 0.5f); ex.push_back((bmax.x - bmin.x) * 0.5f);
+		cy.push_back((bmin.y + bmax.y) * 0.5f); ey.push_back((bmax.y - bmin.y) * 0.5f);
+		cz.push_back((bmin.z + bmax.z) * 0.5f); ez.push_back((bmax.z - bmin.z) * 0.5f);
+	}
+};
+
+struct CpuCullStats {
+	uint32_t objects = 0;
+	uint32_t visible = 0;
+	float ms = 0.0f; // заливка SoA + тест
+};
+
+class FrustumCuller {
+public:
+	static constexpr uint32_t CHUNK = 4096;          // объектов на задачу потока
+	static constexpr uint32_t PARALLEL_MIN = 16384;  // меньше — один поток (раздача задач дороже теста)
+
+	// ширина SIMD-пачки, с которой собран модуль: 8 (AVX), 4 (SSE) или 1 (скаляр)
+	static uint32_t simdWidth();
+
+	// visible <- индексы видимых по возрастанию; возвращает их число
+	uint32_t cullSpheres(const Frustum& f, const SphereSoA& s, std::vector<uint32_t>& visible);
+	uint32_t cullAabbs(const Frustum& f, const AabbSoA& b, std::vector<uint32_t>& visible);
+
+	void setThreaded(bool e) { threaded_ = e; }
+	bool threaded() const { return threaded_; }
+
+private:
+	template <typename Kernel>
+	uint32_t run(uint32_t count, std::vector<uint32_t>& visible, const Kernel& kernel);
+
+	std::vector<uint32_t> chunkCounts_;
+	bool threaded_ = true;
+};
@@ -0,0 +1,221 @@
+#include "renderer/GpuResources.h"
+#include "renderer/VkUtils.h"
+#include <cstring>
+#include <iostream>
+
+uint32_t GpuResources::Garbage::count() const {
+    return (uint32_t)(pipelines.size() + layouts.size() + samplers.size() + views.size() + images.size() +
+        buffers.size() + memory.size());
+}
+
+bool GpuResources::init(VulkanContext& vk, uint32_t framesInFlight) {
+    vk_ = &vk;
+    garbage_.assign(framesInFlight, {});
+    frame_ = 0;
+    return true;
+}
+
+void GpuResources::shutdown() {
+    if (!vk_) return;
+    collectAll();
+
+    // всё, что осталось живым, — утечка: владелец не вызвал destroy()
+    for (const GpuBuffer& b : buffers_.values())
+        std::cerr << "GpuResources: leaked buffer '" << b.name << "' (" << b.size << " bytes)\n";
+    for (const GpuImage& i : images_.values())
+        std::cerr << "GpuResources: leaked image '" << i.name << "' (" << i.extent.width << "x" << i.extent.height << ")\n";
+    for (const GpuSampler& s : samplers_.values())
+        std::cerr << "GpuResources: leaked sampler '" << s.name << "'\n";
+    for (const GpuPipeline& p : pipelines_.values())
+        std::cerr << "GpuResources: leaked pipeline '" << p.name << "'\n";
+    const uint32_t leaked = buffers_.size() + images_.size() + samplers_.size() + pipelines_.size();
+    if (leaked) std::cerr << "GpuResources: " << leaked << " resource(s) leaked, destroying\n";
+
+    for (GpuPipeline& p : pipelines_.values()) retire(p);
+    for (GpuSampler& s : samplers_.values()) retire(s);
+    for (GpuImage& i : images_.values()) retire(i);
+    for (GpuBuffer& b : buffers_.values()) retire(b);
+    collectAll();
+
+    buffers_.clear();
+    images_.clear();
+    samplers_.clear();
+    pipelines_.clear();
+    garbage_.clear();
+    vk_ = nullptr;
+}
+
+void GpuResources::beginFrame(uint32_t frame) {
+    frame_ = frame % (uint32_t)garbage_.size();
+    collect(garbage_[frame_]);
+}
+
+void GpuResources::collectAll() {
+    for (Garbage& g : garbage_) collect(g);
+}
+
+void GpuResources::collect(Garbage& g) {
+    VkDevice dev = vk_->device();
+    for (VkPipeline p : g.pipelines) vkDestroyPipeline(dev, p, nullptr);
+    for (VkPipelineLayout l : g.layouts) vkDestroyPipelineLayout(dev, l, nullptr);
+    for (VkSampler s : g.samplers) vkDestroySampler(dev, s, nullptr);
+    for (VkImageView v : g.views) vkDestroyImageView(dev, v, nullptr);
+    for (VkImage i : g.images) vkDestroyImage(dev, i, nullptr);
+    for (VkBuffer b : g.buffers) vkDestroyBuffer(dev, b, nullptr);
+    for (VkDeviceMemory m : g.memory) freeDeviceMemory(dev, m);
+    g.pipelines.clear();
+    g.layouts.clear();
+    g.samplers.clear();
+    g.views.clear();
+    g.images.clear();
+    g.buffers.clear();
+    g.memory.clear();
+}
+
+void GpuResources::retire(GpuBuffer& b) {
+    Garbage& g = garbage_[frame_];
+    if (b.mapped) vkUnmapMemory(vk_->device(), b.memory); // unmap не трогает GPU -> сразу
+    if (b.buffer) g.buffers.push_back(b.buffer);
+    if (b.memory) g.memory.push_back(b.memory);
+    b = {};
+}
+
+void GpuResources::retire(GpuImage& i) {
+    Garbage& g = garbage_[frame_];
+    if (i.view) g.views.push_back(i.view);
+    if (i.image) g.images.push_back(i.image);
+    if (i.memory) g.memory.push_back(i.memory);
+    i = {};
+}
+
+void GpuResources::retire(GpuSampler& s) {
+    if (s.sampler) garbage_[frame_].samplers.push_back(s.sampler);
+    s = {};
+}
+
+void GpuResources::retire(GpuPipeline& p) {
+    Garbage& g = garbage_[frame_];
+    if (p.pipeline) g.pipelines.push_back(p.pipeline);
+    if (p.ownsLayout && p.layout) g.layouts.push_back(p.layout);
+    p = {};
+}
+
+VkDeviceMemory GpuResources::allocate(const VkMemoryRequirements& req, VkMemoryPropertyFlags memProps, const char* name) {
+    VkDeviceMemory mem = allocateDeviceMemory(*vk_, req, memProps, name);
+    if (!mem) std::cerr << "GpuResources: can't allocate " << req.size << " bytes for '" << name << "'\n";
+    return mem;
+}
+
+BufferHandle GpuResources::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memProps,
+    const char* name, const void* data, bool keepMapped) {
+    VkDevice dev = vk_->device();
+    GpuBuffer b;
+    b.size = size;
+    b.name = name;
+
+    VkBufferCreateInfo bi{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bi.size = size;
+    bi.usage = usage;
+    bi.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (!vk_ok(vkCreateBuffer(dev, &bi, nullptr, &b.buffer), "GpuResources: vkCreateBuffer failed")) return {};
+
+    VkMemoryRequirements req{};
+    vkGetBufferMemoryRequirements(dev, b.buffer, &req);
+    b.memory = allocate(req, memProps, name);
+    bool ok = b.memory && vkBindBufferMemory(dev, b.buffer, b.memory, 0) == VK_SUCCESS;
+
+    if (ok && (data || keepMapped)) {
+        void* p = nullptr;
+        ok = vkMapMemory(dev, b.memory, 0, size, 0, &p) == VK_SUCCESS;
+        if (ok && data) std::memcpy(p, data, (size_t)size);
+        if (ok && keepMapped) b.mapped = p;
+        else if (ok) vkUnmapMemory(dev, b.memory);
+    }
+    if (!ok) {
+        // ещё нигде не используется -> можно сразу
+        freeDeviceMemory(dev, b.memory);
+        vkDestroyBuffer(dev, b.buffer, nullptr);
+        std::cerr << "GpuResources: buffer '" << name << "' creation failed\n";
+        return {};
+    }
+    return buffers_.add(std::move(b));
+}
+
+ImageHandle GpuResources::createImage(const VkImageCreateInfo& info, VkMemoryPropertyFlags memProps,
+    VkImageAspectFlags aspect, const char* name) {
+    VkDevice dev = vk_->device();
+    GpuImage i;
+    i.format = info.format;
+    i.extent = info.extent;
+    i.name = name;
+    if (!vk_ok(vkCreateImage(dev, &info, nullptr, &i.image), "GpuResources: vkCreateImage failed")) return {};
+
+    VkMemoryRequirements req{};
+    vkGetImageMemoryRequirements(dev, i.image, &req);
+    i.size = req.size;
+    i.memory = allocate(req, memProps, name);
+    bool ok = i.memory && vkBindImageMemory(dev, i.image, i.memory, 0) == VK_SUCCESS;
+    if (ok) {
+        i.view = createImageView(dev, i.image, i.format, aspect, 0, info.mipLevels);
+        ok = i.view != VK_NULL_HANDLE;
+    }
+    if (!ok) {
+        freeDeviceMemory(dev, i.memory);
+        vkDestroyImage(dev, i.image, nullptr);
+        std::cerr << "GpuResources: image '" << name << "' creation failed\n";
+        return {};
+    }
+    return images_.add(std::move(i));
+}
+
+SamplerHandle GpuResources::createSampler(const VkSamplerCreateInfo& info, const char* name) {
+    GpuSampler s;
+    s.name = name;
+    if (!vk_ok(vkCreateSampler(vk_->device(), &info, nullptr, &s.sampler), "GpuResources: vkCreateSampler failed")) return {};
+    return samplers_.add(std::move(s));
+}
+
+PipelineHandle GpuResources::addPipeline(VkPipeline pipeline, VkPipelineLayout layout, bool ownsLayout, const char* name) {
+    GpuPipeline p;
+    p.pipeline = pipeline;
+    p.layout = layout;
+    p.ownsLayout = ownsLayout;
+    p.name = name;
+    return pipelines_.add(std::move(p));
+}
+
+void GpuResources::destroy(BufferHandle& h) {
+    GpuBuffer b;
+    if (buffers_.remove(h, b)) retire(b);
+    h = {};
+}
+
+void GpuResources::destroy(ImageHandle& h) {
+    GpuImage i;
+    if (images_.remove(h, i)) retire(i);
+    h = {};
+}
+
+void GpuResources::destroy(SamplerHandle& h) {
+    GpuSampler s;
+    if (samplers_.remove(h, s)) retire(s);
+    h = {};
+}
+
+void GpuResources::destroy(PipelineHandle& h) {
+    GpuPipeline p;
+    if (pipelines_.remove(h, p)) retire(p);
+    h = {};
+}
+
+GpuResourceStats GpuResources::stats() const {
+    GpuResourceStats s;
+    s.buffers = buffers_.size();
+    s.images = images_.size();
+    s.samplers = samplers_.size();
+    s.pipelines = pipelines_.size();
+    for (const Garbage& g : garbage_) s.pendingDestroy += g.count();
+    for (const GpuBuffer& b : buffers_.values()) s.bufferBytes += b.size;
+    for (const GpuImage& i : images_.values()) s.imageBytes += i.size;
+    return s;
+}
@@ -0,0 +1,207 @@
+#pragma once
+#include "renderer/VulkanContext.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// GPU-ресурсы рендера по handle'ам вместо сырых Vk-членов.
+// Handle = индекс слота + поколение: после destroy() слот уходит в free list с новым поколением,
+// и старый handle больше ничего не находит (get() -> nullptr), даже если слот уже занят снова.
+// Пул — slot map: данные лежат плотно (обход без дыр), slot -> dense и обратно — O(1).
+// destroy() сразу освобождает handle, а сами Vk-объекты уходят в очередь текущего frame-слота
+// и уничтожаются в beginFrame() этого же слота, т.е. после его fence: кадры в полёте дочитают спокойно.
+// shutdown() вызывается после vkDeviceWaitIdle: чистит очереди и печатает всё, что не удалили (утечки).
+
+template <typename Tag>
+struct GpuHandle {
+	uint32_t index = 0;
+	uint32_t generation = 0; // 0 — пустой handle
+
+	bool valid() const { return generation != 0; }
+	bool operator==(const GpuHandle& o) const { return index == o.index && generation == o.generation; }
+	bool operator!=(const GpuHandle& o) const { return !(*this == o); }
+};
+
+using BufferHandle = GpuHandle<struct GpuBufferTag>;
+using ImageHandle = GpuHandle<struct GpuImageTag>;
+using SamplerHandle = GpuHandle<struct GpuSamplerTag>;
+using PipelineHandle = GpuHandle<struct GpuPipelineTag>;
+
+struct GpuBuffer {
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	VkDeviceSize size = 0;
+	void* mapped = nullptr; // host-visible, созданный с keepMapped
+	std::string name;
+};
+
+struct GpuImage {
+	VkImage image = VK_NULL_HANDLE;
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	VkImageView view = VK_NULL_HANDLE; // весь image (все mip'ы, слой 0)
+	VkFormat format = VK_FORMAT_UNDEFINED;
+	VkExtent3D extent{};
+	VkDeviceSize size = 0;
+	std::string name;
+};
+
+struct GpuSampler {
+	VkSampler sampler = VK_NULL_HANDLE;
+	std::string name;
+};
+
+struct GpuPipeline {
+	VkPipeline pipeline = VK_NULL_HANDLE;
+	VkPipelineLayout layout = VK_NULL_HANDLE;
+	bool ownsLayout = false; // layout общий на несколько pipeline -> уничтожает только владелец
+	std::string name;
+};
+
+// slot map: dense_ — значения подряд, slots_ — поколение и позиция в dense_ на каждый выданный индекс
+template <typename T, typename Tag>
+class GpuPool {
+public:
+	using Handle = GpuHandle<Tag>;
+
+	Handle add(T&& value) {
+		uint32_t slot;
+		if (!freeSlots_.empty()) {
+			slot = freeSlots_.back();
+			freeSlots_.pop_back();
+		}
+		else {
+			slot = (uint32_t)slots_.size();
+			slots_.push_back({ 1, 0 });
+		}
+		slots_[slot].dense = (uint32_t)dense_.size();
+		dense_.push_back(std::move(value));
+		denseToSlot_.push_back(slot);
+		return { slot, slots_[slot].generation };
+	}
+
+	T* get(Handle h) {
+		if (h.index >= slots_.size() || slots_[h.index].generation != h.generation) return nullptr;
+		return &dense_[slots_[h.index].dense];
+	}
+	const T* get(Handle h) const { return const_cast<GpuPool*>(this)->get(h); }
+
+	// забирает значение; последний элемент встаёт на его место
+	bool remove(Handle h, T& out) {
+		T* v = get(h);
+		if (!v) return false;
+		const uint32_t d = slots_[h.index].dense;
+		out = std::move(*v);
+		if (d + 1 != dense_.size()) {
+			dense_[d] = std::move(dense_.back());
+			denseToSlot_[d] = denseToSlot_.back();
+			slots_[denseToSlot_[d]].dense = d;
+		}
+		dense_.pop_back();
+		denseToSlot_.pop_back();
+		if (++slots_[h.index].generation == 0) slots_[h.index].generation = 1;
+		freeSlots_.push_back(h.index);
+		return true;
+	}
+
+	uint32_t size() const { return (uint32_t)dense_.size(); }
+	std::vector<T>& values() { return dense_; }
+	const std::vector<T>& values() const { return dense_; }
+	void clear() {
+		dense_.clear();
+		denseToSlot_.clear();
+		slots_.clear();
+		freeSlots_.clear();
+	}
+
+private:
+	struct Slot {
+		uint32_t generation;
+		uint32_t dense;
+	};
+	std::vector<T> dense_;
+	std::vector<uint32_t> denseToSlot_;
+	std::vector<Slot> slots_;
+	std::vector<uint32_t> freeSlots_;
+};
+
+struct GpuResourceStats {
+	uint32_t buffers = 0;
+	uint32_t images = 0;
+	uint32_t samplers = 0;
+	uint32_t pipelines = 0;
+	uint32_t pendingDestroy = 0; // ждут fence своего frame-слота
+	VkDeviceSize bufferBytes = 0;
+	VkDeviceSize imageBytes = 0;
+};
+
+class GpuResources {
+public:
+	bool init(VulkanContext& vk, uint32_t framesInFlight);
+	// после vkDeviceWaitIdle: уничтожает отложенное, печатает и уничтожает утёкшее
+	void shutdown();
+
+	// fence этого frame-слота пройден: уничтожить то, что удалили, пока он был текущим
+	void beginFrame(uint32_t frame);
+	// устройство простаивает (vkDeviceWaitIdle): можно уничтожить все очереди сразу
+	void collectAll();
+
+	// data != nullptr -> буфер должен быть host-visible, данные копируются сразу (size байт)
+	BufferHandle createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memProps,
+		const char* name, const void* data = nullptr, bool keepMapped = false);
+	// view создаётся на все mip'ы слоя 0 (aspect — для view)
+	ImageHandle createImage(const VkImageCreateInfo& info, VkMemoryPropertyFlags memProps, VkImageAspectFlags aspect,
+		const char* name);
+	SamplerHandle createSampler(const VkSamplerCreateInfo& info, const char* name);
+	// pipeline создаётся снаружи (graphics/compute) — пул забирает владение
+	PipelineHandle addPipeline(VkPipeline pipeline, VkPipelineLayout layout, bool ownsLayout, const char* name);
+
+	void destroy(BufferHandle& h);
+	void destroy(ImageHandle& h);
+	void destroy(SamplerHandle& h);
+	void destroy(PipelineHandle& h);
+
+	const GpuBuffer* get(BufferHandle h) const { return buffers_.get(h); }
+	const GpuImage* get(ImageHandle h) const { return images_.get(h); }
+	const GpuSampler* get(SamplerHandle h) const { return samplers_.get(h); }
+	const GpuPipeline* get(PipelineHandle h) const { return pipelines_.get(h); }
+
+	// устаревший/пустой handle -> VK_NULL_HANDLE
+	VkBuffer buffer(BufferHandle h) const { const GpuBuffer* b = buffers_.get(h); return b ? b->buffer : VK_NULL_HANDLE; }
+	VkImageView view(ImageHandle h) const { const GpuImage* i = images_.get(h); return i ? i->view : VK_NULL_HANDLE; }
+	VkSampler sampler(SamplerHandle h) const { const GpuSampler* s = samplers_.get(h); return s ? s->sampler : VK_NULL_HANDLE; }
+	VkPipeline pipeline(PipelineHandle h) const { const GpuPipeline* p = pipelines_.get(h); return p ? p->pipeline : VK_NULL_HANDLE; }
+	VkPipelineLayout layout(PipelineHandle h) const { const GpuPipeline* p = pipelines_.get(h); return p ? p->layout : VK_NULL_HANDLE; }
+
+	GpuResourceStats stats() const;
+
+private:
+	// Vk-объекты, ждущие fence; уничтожаются по видам: сначала pipeline'ы, потом то, на что они ссылаются
+	struct Garbage {
+		std::vector<VkPipeline> pipelines;
+		std::vector<VkPipelineLayout> layouts;
+		std::vector<VkSampler> samplers;
+		std::vector<VkImageView> views;
+		std::vector<VkImage> images;
+		std::vector<VkBuffer> buffers;
+		std::vector<VkDeviceMemory> memory;
+
+		uint32_t count() const;
+	};
+
+	void retire(GpuBuffer& b);
+	void retire(GpuImage& i);
+	void retire(GpuSampler& s);
+	void retire(GpuPipeline& p);
+	void collect(Garbage& g);
+	VkDeviceMemory allocate(const VkMemoryRequirements& req, VkMemoryPropertyFlags memProps, const char* name);
+
+	VulkanContext* vk_ = nullptr;
+	std::vector<Garbage> garbage_; // по frame-слоту
+	uint32_t frame_ = 0;
+
+	GpuPool<GpuBuffer, GpuBufferTag> buffers_;
+	GpuPool<GpuImage, GpuImageTag> images_;
+	GpuPool<GpuSampler, GpuSamplerTag> samplers_;
+	GpuPool<GpuPipeline, GpuPipelineTag> pipelines_;
+};
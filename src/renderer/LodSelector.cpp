@@ -0,0 +1,33 @@
+#include "renderer/LodSelector.h"
+#include <algorithm>
+#include <cmath>
+
+void LodSelector::setView(const Vec3& cameraPos, float projScaleY, float screenHeight) {
+    cameraPos_ = cameraPos;
+    pixelsPerUnit_ = std::fabs(projScaleY) * 0.5f * screenHeight;
+}
+
+uint32_t LodSelector::select(uint32_t object, const MeshLod* lods, uint32_t lodCount,
+    const Vec3& center, float radius, float scale) {
+    if (object >= current_.size()) resize(object + 1);
+    if (!enabled_ || lodCount <= 1) {
+        current_[object] = 0;
+        return 0;
+    }
+
+    // до ближайшей точки сферы; внутри сферы — максимальная детализация
+    float dist = length(center - cameraPos_) - radius;
+    if (dist <= 1e-3f) {
+        current_[object] = 0;
+        return 0;
+    }
+    const float k = scale * pixelsPerUnit_ / dist;
+    auto pixels = [&](uint32_t l) { return lods[l].error * k; };
+
+    uint32_t lod = std::min<uint32_t>(current_[object], lodCount - 1);
+    while (lod > 0 && pixels(lod) > PIXEL_ERROR) --lod;
+    while (lod + 1 < lodCount && pixels(lod + 1) <= PIXEL_ERROR * HYSTERESIS) ++lod;
+
+    current_[object] = (uint8_t)lod;
+    return lod;
+}
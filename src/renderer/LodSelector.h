@@ -0,0 +1,42 @@
+#pragma once
+#include "asset/Mesh.h"
+#include "math/Vec3.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Выбор LOD по экранной ошибке: ошибка уровня (единицы меша) * масштаб / расстояние -> пиксели.
+// Гистерезис: детальнее — сразу, как только текущий уровень превысил порог;
+// грубее — только когда следующий уровень укладывается в HYSTERESIS * порог.
+// Между этими границами уровень не меняется -> нет мерцания на фиксированной дистанции.
+
+struct LodStats {
+	uint32_t objects = 0;
+	uint32_t trianglesSubmitted = 0; // выбранные LOD'ы (до GPU culling'а)
+	uint32_t trianglesAvailable = 0; // если бы всё рисовалось в LOD 0
+	std::array<uint32_t, MAX_MESH_LODS> perLevel{};
+};
+
+class LodSelector {
+public:
+	static constexpr float PIXEL_ERROR = 1.0f;
+	static constexpr float HYSTERESIS = 0.75f;
+
+	// projScaleY = |proj.m[5]| (1 / tan(fovY/2))
+	void setView(const Vec3& cameraPos, float projScaleY, float screenHeight);
+
+	// состояние гистерезиса хранится по индексу объекта (порядок объектов стабилен между кадрами)
+	void resize(uint32_t objectCount) { current_.resize(objectCount, 0); }
+
+	uint32_t select(uint32_t object, const MeshLod* lods, uint32_t lodCount,
+		const Vec3& center, float radius, float scale);
+
+	void setEnabled(bool e) { enabled_ = e; }
+	bool enabled() const { return enabled_; }
+
+private:
+	Vec3 cameraPos_;
+	float pixelsPerUnit_ = 1.0f; // на расстоянии 1
+	std::vector<uint8_t> current_;
+	bool enabled_ = true;
+};
@@ -0,0 +1,383 @@
+#include "renderer/MeshletCuller.h"
+#include "renderer/VkUtils.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+
+static uint32_t divUp(uint32_t a, uint32_t b) { return (a + b - 1) / b; }
+
+// гарантированный минимум maxComputeWorkGroupCount[0]
+static constexpr uint32_t MAX_GROUPS_X = 65535;
+
+static constexpr uint32_t BINDINGS = 9;
+
+bool MeshletCuller::init(VulkanContext& vk) {
+    if (!createDescriptors(vk)) return false;
+    if (!createPipeline(vk)) return false;
+    if (!createFrameBuffers(vk)) return false;
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        VkDescriptorBufferInfo bufs[3]{};
+        bufs[0] = { paramsBuf_[i], 0, sizeof(MeshletParams) };
+        bufs[1] = { drawsBuf_[i], 0, VK_WHOLE_SIZE };
+        bufs[2] = { statsBuf_[i], 0, sizeof(GpuStats) };
+        const uint32_t bindings[3] = { 0, 5, 7 };
+
+        VkWriteDescriptorSet w[3]{};
+        for (uint32_t k = 0; k < 3; ++k) {
+            w[k].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[k].dstSet = sets_[i];
+            w[k].dstBinding = bindings[k];
+            w[k].descriptorCount = 1;
+            w[k].descriptorType = (k == 0) ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            w[k].pBufferInfo = &bufs[k];
+        }
+        vkUpdateDescriptorSets(vk.device(), 3, w, 0, nullptr);
+    }
+    return true;
+}
+
+bool MeshletCuller::createDescriptors(VulkanContext& vk) {
+    // 0 params, 1 meshlets, 2 meshlet vertices, 3 meshlet triangles, 4 out indices,
+    // 5 draws, 6 state, 7 stats, 8 пирамида
+    VkDescriptorSetLayoutBinding b[BINDINGS]{};
+    for (uint32_t i = 0; i < BINDINGS; ++i) {
+        b[i].binding = i;
+        b[i].descriptorCount = 1;
+        b[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        b[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    }
+    b[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    b[8].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+    VkDescriptorSetLayoutCreateInfo li{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    li.bindingCount = BINDINGS;
+    li.pBindings = b;
+    if (vkCreateDescriptorSetLayout(vk.device(), &li, nullptr, &setLayout_) != VK_SUCCESS) return false;
+
+    VkDescriptorPoolSize sizes[3]{};
+    sizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    sizes[0].descriptorCount = MAX_FRAMES;
+    sizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    sizes[1].descriptorCount = MAX_FRAMES * 7;
+    sizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    sizes[2].descriptorCount = MAX_FRAMES;
+
+    VkDescriptorPoolCreateInfo pi{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    pi.poolSizeCount = 3;
+    pi.pPoolSizes = sizes;
+    pi.maxSets = MAX_FRAMES;
+    if (!vk_ok(vkCreateDescriptorPool(vk.device(), &pi, nullptr, &pool_), "vkCreateDescriptorPool (meshlets) failed"))
+        return false;
+
+    std::array<VkDescriptorSetLayout, MAX_FRAMES> layouts{};
+    layouts.fill(setLayout_);
+
+    VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    ai.descriptorPool = pool_;
+    ai.descriptorSetCount = MAX_FRAMES;
+    ai.pSetLayouts = layouts.data();
+    return vk_ok(vkAllocateDescriptorSets(vk.device(), &ai, sets_.data()), "vkAllocateDescriptorSets (meshlets) failed");
+}
+
+bool MeshletCuller::createPipeline(VulkanContext& vk) {
+    // push = phase
+    VkPushConstantRange pcr{};
+    pcr.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pcr.offset = 0;
+    pcr.size = sizeof(uint32_t);
+
+    VkPipelineLayoutCreateInfo pli{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    pli.setLayoutCount = 1;
+    pli.pSetLayouts = &setLayout_;
+    pli.pushConstantRangeCount = 1;
+    pli.pPushConstantRanges = &pcr;
+    if (vkCreatePipelineLayout(vk.device(), &pli, nullptr, &pipelineLayout_) != VK_SUCCESS) return false;
+
+    pipeline_ = createComputePipeline(vk.device(), "shaders/meshlet_cull.comp.spv", pipelineLayout_);
+    return pipeline_ != VK_NULL_HANDLE;
+}
+
+bool MeshletCuller::createFrameBuffers(VulkanContext& vk) {
+    const VkMemoryPropertyFlags hostMem = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        if (!createBuffer(vk, sizeof(MeshletParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, hostMem,
+            paramsBuf_[i], paramsMem_[i], "meshlet culling")) return false;
+        if (vkMapMemory(vk.device(), paramsMem_[i], 0, sizeof(MeshletParams), 0, (void**)&paramsMapped_[i]) != VK_SUCCESS)
+            return false;
+        std::memset(paramsMapped_[i], 0, sizeof(MeshletParams));
+
+        if (!createBuffer(vk, sizeof(VkDrawIndexedIndirectCommand) * 2,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, drawsBuf_[i], drawsMem_[i], "meshlet culling")) return false;
+
+        if (!createBuffer(vk, sizeof(GpuStats), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            hostMem, statsBuf_[i], statsMem_[i], "meshlet culling")) return false;
+        if (vkMapMemory(vk.device(), statsMem_[i], 0, sizeof(GpuStats), 0, (void**)&statsMapped_[i]) != VK_SUCCESS)
+            return false;
+        std::memset(statsMapped_[i], 0, sizeof(GpuStats));
+    }
+    return true;
+}
+
+// host-visible буфер сразу с данными (как остальные меши рендера)
+static bool createFilledBuffer(VulkanContext& vk, const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkBuffer& buf, VkDeviceMemory& mem) {
+    if (!createBuffer(vk, size, usage,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buf, mem, "meshlet culling")) return false;
+
+    void* p = nullptr;
+    if (vkMapMemory(vk.device(), mem, 0, size, 0, &p) != VK_SUCCESS) return false;
+    std::memcpy(p, data, (size_t)size);
+    vkUnmapMemory(vk.device(), mem);
+    return true;
+}
+
+bool MeshletCuller::upload(VulkanContext& vk, const MeshData& mesh) {
+    destroyMesh(vk);
+    if (mesh.meshlets.empty() || mesh.indices.empty()) return true;
+
+    static_assert(sizeof(Meshlet) == 48, "Meshlet layout must match meshlet_cull.comp");
+
+    if (!createFilledBuffer(vk, mesh.vertices.data(), sizeof(MeshVertex) * mesh.vertices.size(),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuf_, vertexMem_)) return false;
+    // карта рисуется только в LOD 0 (под него и построены meshlet'ы)
+    const MeshLod lod0 = meshLod(mesh, 0);
+    if (!createFilledBuffer(vk, mesh.indices.data() + lod0.indexOffset, sizeof(uint32_t) * lod0.indexCount,
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuf_, indexMem_)) return false;
+    if (!createFilledBuffer(vk, mesh.meshlets.data(), sizeof(Meshlet) * mesh.meshlets.size(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, meshletBuf_, meshletMem_)) return false;
+    if (!createFilledBuffer(vk, mesh.meshletVertices.data(), sizeof(uint32_t) * mesh.meshletVertices.size(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, meshletVertBuf_, meshletVertMem_)) return false;
+    if (!createFilledBuffer(vk, mesh.meshletTriangles.data(), mesh.meshletTriangles.size(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, meshletTriBuf_, meshletTriMem_)) return false;
+
+    indexCount_ = lod0.indexCount;
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        if (!createBuffer(vk, sizeof(uint32_t) * indexCount_ * 2,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, outIndexBuf_[i], outIndexMem_[i], "meshlet culling")) return false;
+        if (!createBuffer(vk, sizeof(uint32_t) * mesh.meshlets.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, stateBuf_[i], stateMem_[i], "meshlet culling")) return false;
+    }
+
+    meshletCount_ = (uint32_t)mesh.meshlets.size();
+    writeMeshDescriptors(vk);
+    return true;
+}
+
+void MeshletCuller::writeMeshDescriptors(VulkanContext& vk) {
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        VkDescriptorBufferInfo bufs[5]{};
+        bufs[0] = { meshletBuf_, 0, VK_WHOLE_SIZE };
+        bufs[1] = { meshletVertBuf_, 0, VK_WHOLE_SIZE };
+        bufs[2] = { meshletTriBuf_, 0, VK_WHOLE_SIZE };
+        bufs[3] = { outIndexBuf_[i], 0, VK_WHOLE_SIZE };
+        bufs[4] = { stateBuf_[i], 0, VK_WHOLE_SIZE };
+        const uint32_t bindings[5] = { 1, 2, 3, 4, 6 };
+
+        VkWriteDescriptorSet w[5]{};
+        for (uint32_t k = 0; k < 5; ++k) {
+            w[k].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[k].dstSet = sets_[i];
+            w[k].dstBinding = bindings[k];
+            w[k].descriptorCount = 1;
+            w[k].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            w[k].pBufferInfo = &bufs[k];
+        }
+        vkUpdateDescriptorSets(vk.device(), 5, w, 0, nullptr);
+    }
+}
+
+void MeshletCuller::destroyMesh(VulkanContext& vk) {
+    destroyBuffer(vk, vertexBuf_, vertexMem_);
+    destroyBuffer(vk, indexBuf_, indexMem_);
+    destroyBuffer(vk, meshletBuf_, meshletMem_);
+    destroyBuffer(vk, meshletVertBuf_, meshletVertMem_);
+    destroyBuffer(vk, meshletTriBuf_, meshletTriMem_);
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        destroyBuffer(vk, outIndexBuf_[i], outIndexMem_[i]);
+        destroyBuffer(vk, stateBuf_[i], stateMem_[i]);
+    }
+    meshletCount_ = 0;
+    indexCount_ = 0;
+    frameActive_.fill(false);
+}
+
+void MeshletCuller::setPyramid(VulkanContext& vk, VkImageView view, VkSampler sampler) {
+    pyramidView_ = view;
+    pyramidSampler_ = sampler;
+    if (!view) return;
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        VkDescriptorImageInfo pyr{};
+        pyr.sampler = sampler;
+        pyr.imageView = view;
+        pyr.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkWriteDescriptorSet w{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        w.dstSet = sets_[i];
+        w.dstBinding = 8;
+        w.descriptorCount = 1;
+        w.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        w.pImageInfo = &pyr;
+        vkUpdateDescriptorSets(vk.device(), 1, &w, 0, nullptr);
+    }
+}
+
+void MeshletCuller::shutdown(VulkanContext& vk) {
+    destroyMesh(vk);
+
+    if (pool_) { vkDestroyDescriptorPool(vk.device(), pool_, nullptr); pool_ = VK_NULL_HANDLE; }
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        if (paramsMapped_[i]) { vkUnmapMemory(vk.device(), paramsMem_[i]); paramsMapped_[i] = nullptr; }
+        if (statsMapped_[i]) { vkUnmapMemory(vk.device(), statsMem_[i]); statsMapped_[i] = nullptr; }
+
+        destroyBuffer(vk, paramsBuf_[i], paramsMem_[i]);
+        destroyBuffer(vk, drawsBuf_[i], drawsMem_[i]);
+        destroyBuffer(vk, statsBuf_[i], statsMem_[i]);
+    }
+
+    if (pipeline_) { vkDestroyPipeline(vk.device(), pipeline_, nullptr); pipeline_ = VK_NULL_HANDLE; }
+    if (pipelineLayout_) { vkDestroyPipelineLayout(vk.device(), pipelineLayout_, nullptr); pipelineLayout_ = VK_NULL_HANDLE; }
+    if (setLayout_) { vkDestroyDescriptorSetLayout(vk.device(), setLayout_, nullptr); setLayout_ = VK_NULL_HANDLE; }
+}
+
+void MeshletCuller::setFrameParams(uint32_t frame, const Mat4& model, const Mat4& viewProj, const Vec3& cameraPos,
+    const Mat4& prevViewProj, VkExtent2D pyramidExtent, uint32_t pyramidMips, bool pyramidValid) {
+    MeshletParams& p = *paramsMapped_[frame];
+    p.model = model;
+    p.viewProj = viewProj;
+    p.prevViewProj = prevViewProj;
+
+    // плоскости frustum'а в world space (Gribb-Hartmann), clip-space depth 0..1
+    const Mat4 mvp = viewProj;
+    auto row = [&](int r, float out[4]) {
+        for (int c = 0; c < 4; ++c) out[c] = mvp.m[c * 4 + r];
+    };
+    float r0[4], r1[4], r2[4], r3[4];
+    row(0, r0); row(1, r1); row(2, r2); row(3, r3);
+    for (int c = 0; c < 4; ++c) {
+        p.planes[0][c] = r3[c] + r0[c]; // left
+        p.planes[1][c] = r3[c] - r0[c]; // right
+        p.planes[2][c] = r3[c] + r1[c]; // bottom
+        p.planes[3][c] = r3[c] - r1[c]; // top
+        p.planes[4][c] = r2[c];         // near
+        p.planes[5][c] = r3[c] - r2[c]; // far
+    }
+    for (auto& pl : p.planes) {
+        float len = std::sqrt(pl[0] * pl[0] + pl[1] * pl[1] + pl[2] * pl[2]);
+        if (len > 1e-12f) for (int c = 0; c < 4; ++c) pl[c] /= len;
+    }
+
+    // масштаб model для радиусов сфер (неравномерный -> берём максимальный)
+    float maxScale = 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        Vec3 axis{ model.m[c * 4 + 0], model.m[c * 4 + 1], model.m[c * 4 + 2] };
+        maxScale = std::max(maxScale, length(axis));
+    }
+    p.cameraPos[0] = cameraPos.x;
+    p.cameraPos[1] = cameraPos.y;
+    p.cameraPos[2] = cameraPos.z;
+    p.cameraPos[3] = maxScale;
+
+    p.pyramidSize[0] = (float)pyramidExtent.width;
+    p.pyramidSize[1] = (float)pyramidExtent.height;
+    p.pyramidSize[2] = (float)pyramidMips;
+    p.pyramidSize[3] = 0.0f;
+
+    p.meshletCount = meshletCount_;
+    p.pyramidValid = (pyramidValid && pyramidView_) ? 1u : 0u;
+    p.coneCulling = coneCulling_ ? 1u : 0u;
+    p.indexCapacity = indexCount_;
+
+    frameActive_[frame] = meshletCount_ > 0;
+}
+
+MeshletStats MeshletCuller::readStats(uint32_t frame) const {
+    MeshletStats s;
+    const GpuStats* g = statsMapped_[frame];
+    if (!g || !frameActive_[frame]) return s;
+    s.meshlets = meshletCount_;
+    s.frustumCulled = g->frustumCulled;
+    s.coneCulled = g->coneCulled;
+    s.occlusionCulled = g->occlusionCulled;
+    s.earlyDrawn = g->earlyDrawn;
+    s.lateDrawn = g->lateDrawn;
+    s.triangles = g->triangles;
+    s.totalTriangles = indexCount_ / 3;
+    return s;
+}
+
+void MeshletCuller::recordBeginFrame(VkCommandBuffer cmd, uint32_t frame) {
+    if (!hasMesh()) return;
+
+    // пустые команды фаз: indexCount набирает cull-шейдер, late-область начинается с indexCapacity
+    VkDrawIndexedIndirectCommand init[2]{};
+    init[0] = { 0, 1, 0, 0, 0 };
+    init[1] = { 0, 1, indexCount_, 0, 0 };
+    vkCmdUpdateBuffer(cmd, drawsBuf_[frame], 0, sizeof(init), init);
+    vkCmdFillBuffer(cmd, statsBuf_[frame], 0, sizeof(GpuStats), 0);
+
+    VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    mb.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &mb, 0, nullptr, 0, nullptr);
+}
+
+void MeshletCuller::recordCull(VkCommandBuffer cmd, uint32_t frame, Phase phase) {
+    if (!hasMesh()) return;
+
+    // прошлое чтение indirect/index (early-проход) и запись пирамиды -> compute
+    VkMemoryBarrier pre{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    pre.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+    pre.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &pre, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout_, 0, 1, &sets_[frame], 0, nullptr);
+
+    uint32_t ph = (uint32_t)phase;
+    vkCmdPushConstants(cmd, pipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &ph);
+
+    // workgroup на meshlet; больше 65535 -> вторая размерность
+    uint32_t gx = std::min(meshletCount_, MAX_GROUPS_X);
+    uint32_t gy = divUp(meshletCount_, gx);
+    vkCmdDispatch(cmd, gx, gy, 1);
+
+    VkMemoryBarrier post{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    post.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    post.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+        0, 1, &post, 0, nullptr, 0, nullptr);
+}
+
+void MeshletCuller::draw(VkCommandBuffer cmd, uint32_t frame, Phase phase) const {
+    if (!hasMesh()) return;
+
+    VkDeviceSize off = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuf_, &off);
+    vkCmdBindIndexBuffer(cmd, outIndexBuf_[frame], 0, VK_INDEX_TYPE_UINT32);
+
+    VkDeviceSize cmdOff = (phase == Phase::Late ? 1 : 0) * sizeof(VkDrawIndexedIndirectCommand);
+    vkCmdDrawIndexedIndirect(cmd, drawsBuf_[frame], cmdOff, 1, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+void MeshletCuller::drawAll(VkCommandBuffer cmd) const {
+    if (!hasMesh()) return;
+
+    VkDeviceSize off = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuf_, &off);
+    vkCmdBindIndexBuffer(cmd, indexBuf_, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexed(cmd, indexCount_, 1, 0, 0, 0);
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "renderer/VulkanContext.h"
+#include "renderer/OcclusionCuller.h"
+#include "asset/Mesh.h"
+#include "math/Mat4.h"
+#include "math/Vec3.h"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+
+// GPU culling статического меша карты по meshlet'ам (без mesh-шейдеров):
+//  compute-шейдер, одна workgroup на meshlet: frustum (сфера), back-facing (конус нормалей),
+//  Hi-Z по пирамиде OcclusionCuller'а (те же две фазы: early по прошлому кадру, late — перепроверка).
+//  Видимые meshlet'ы дописывают свои треугольники в компактный index buffer кадра,
+//  счётчик индексов = indexCount одной indirect-команды на фазу (drawCount = 1, без multiDrawIndirect).
+
+struct MeshletStats {
+	uint32_t meshlets = 0;
+	uint32_t frustumCulled = 0;
+	uint32_t coneCulled = 0;
+	uint32_t occlusionCulled = 0; // отброшены и в early, и в late
+	uint32_t earlyDrawn = 0;
+	uint32_t lateDrawn = 0;
+	uint32_t triangles = 0;       // нарисовано за кадр (обе фазы)
+	uint32_t totalTriangles = 0;
+};
+
+class MeshletCuller {
+public:
+	static constexpr uint32_t MAX_FRAMES = 2;
+
+	using Phase = OcclusionCuller::Phase;
+
+	bool init(VulkanContext& vk);
+	void shutdown(VulkanContext& vk);
+
+	// заливка меша (GPU не должен использовать старый — вызывающий ждёт idle)
+	bool upload(VulkanContext& vk, const MeshData& mesh);
+	void destroyMesh(VulkanContext& vk);
+	bool hasMesh() const { return meshletCount_ > 0; }
+
+	// пирамида глубины OcclusionCuller'а (после каждого его createTargets)
+	void setPyramid(VulkanContext& vk, VkImageView view, VkSampler sampler);
+
+	// CPU: параметры кадра (после fence слота); prevViewProj/pyramidSize — от OcclusionCuller
+	void setFrameParams(uint32_t frame, const Mat4& model, const Mat4& viewProj, const Vec3& cameraPos,
+		const Mat4& prevViewProj, VkExtent2D pyramidExtent, uint32_t pyramidMips, bool pyramidValid);
+	MeshletStats readStats(uint32_t frame) const;
+	// кадр без culling'а (меш рисуется целиком) — статистики у слота нет
+	void skipFrame(uint32_t frame) { frameActive_[frame] = false; }
+
+	void recordBeginFrame(VkCommandBuffer cmd, uint32_t frame);
+	void recordCull(VkCommandBuffer cmd, uint32_t frame, Phase phase);
+
+	// компактные индексы фазы одной indirect-командой (pipeline/descriptors/model уже выставлены)
+	void draw(VkCommandBuffer cmd, uint32_t frame, Phase phase) const;
+	// весь меш без culling'а (тени, сравнение с выключенным culling'ом)
+	void drawAll(VkCommandBuffer cmd) const;
+
+	void setConeCulling(bool e) { coneCulling_ = e; }
+	bool coneCulling() const { return coneCulling_; }
+
+private:
+	bool createDescriptors(VulkanContext& vk);
+	bool createPipeline(VulkanContext& vk);
+	bool createFrameBuffers(VulkanContext& vk);
+	void writeMeshDescriptors(VulkanContext& vk);
+
+	// layout совпадает с MeshletParams в meshlet_cull.comp (std140)
+	struct MeshletParams {
+		Mat4 model;
+		Mat4 viewProj;
+		Mat4 prevViewProj;
+		float planes[6][4];    // world space, xyz = нормаль внутрь, w = d
+		float cameraPos[4];    // xyz, w = максимальный масштаб model (для радиусов)
+		float pyramidSize[4];  // w, h (mip 0), mipCount, -
+		uint32_t meshletCount;
+		uint32_t pyramidValid;
+		uint32_t coneCulling;
+		uint32_t indexCapacity; // начало late-области в выходном index buffer
+	};
+
+	struct GpuStats {
+		uint32_t frustumCulled;
+		uint32_t coneCulled;
+		uint32_t occlusionCulled;
+		uint32_t earlyDrawn;
+		uint32_t lateDrawn;
+		uint32_t triangles;
+	};
+
+	VkDescriptorSetLayout setLayout_{ VK_NULL_HANDLE };
+	VkPipelineLayout pipelineLayout_{ VK_NULL_HANDLE };
+	VkPipeline pipeline_{ VK_NULL_HANDLE };
+	VkDescriptorPool pool_{ VK_NULL_HANDLE };
+	std::array<VkDescriptorSet, MAX_FRAMES> sets_{};
+
+	// ---- per-frame (не зависят от меша) ----
+	std::array<VkBuffer, MAX_FRAMES> paramsBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> paramsMem_{};
+	std::array<MeshletParams*, MAX_FRAMES> paramsMapped_{};
+
+	// [0] early, [1] late
+	std::array<VkBuffer, MAX_FRAMES> drawsBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> drawsMem_{};
+
+	std::array<VkBuffer, MAX_FRAMES> statsBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> statsMem_{};
+	std::array<GpuStats*, MAX_FRAMES> statsMapped_{};
+
+	// ---- меш ----
+	VkBuffer vertexBuf_{ VK_NULL_HANDLE };
+	VkDeviceMemory vertexMem_{ VK_NULL_HANDLE };
+	VkBuffer indexBuf_{ VK_NULL_HANDLE };          // исходные индексы (drawAll)
+	VkDeviceMemory indexMem_{ VK_NULL_HANDLE };
+	VkBuffer meshletBuf_{ VK_NULL_HANDLE };
+	VkDeviceMemory meshletMem_{ VK_NULL_HANDLE };
+	VkBuffer meshletVertBuf_{ VK_NULL_HANDLE };
+	VkDeviceMemory meshletVertMem_{ VK_NULL_HANDLE };
+	VkBuffer meshletTriBuf_{ VK_NULL_HANDLE };
+	VkDeviceMemory meshletTriMem_{ VK_NULL_HANDLE };
+
+	// per-frame: компактные индексы [early | late] и флаг "ждёт late-перепроверки"
+	std::array<VkBuffer, MAX_FRAMES> outIndexBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> outIndexMem_{};
+	std::array<VkBuffer, MAX_FRAMES> stateBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> stateMem_{};
+
+	uint32_t meshletCount_ = 0;
+	uint32_t indexCount_ = 0;
+	std::array<bool, MAX_FRAMES> frameActive_{}; // слот записан с текущим мешем (статистика валидна)
+
+	VkImageView pyramidView_{ VK_NULL_HANDLE };
+	VkSampler pyramidSampler_{ VK_NULL_HANDLE };
+
+	bool coneCulling_ = true;
+};
@@ -0,0 +1,449 @@
+#include "renderer/OcclusionCuller.h"
+#include "renderer/VkUtils.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+static uint32_t divUp(uint32_t a, uint32_t b) { return (a + b - 1) / b; }
+
+bool OcclusionCuller::init(VulkanContext& vk) {
+    if (!createDescriptorLayouts(vk)) return false;
+    if (!createPipelines(vk)) return false;
+    if (!createBuffers(vk)) return false;
+
+    VkSamplerCreateInfo si{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    si.magFilter = VK_FILTER_NEAREST;
+    si.minFilter = VK_FILTER_NEAREST;
+    si.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    si.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    si.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    si.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    si.minLod = 0.0f;
+    si.maxLod = (float)MAX_PYRAMID_MIPS;
+    if (!vk_ok(vkCreateSampler(vk.device(), &si, nullptr, &sampler_), "vkCreateSampler (hi-z) failed"))
+        return false;
+
+    // UBO/SSBO на кадр + sampler пирамиды (его дописываем в createTargets)
+    VkDescriptorPoolSize sizes[3]{};
+    sizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    sizes[0].descriptorCount = MAX_FRAMES;
+    sizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    sizes[1].descriptorCount = MAX_FRAMES * 4;
+    sizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    sizes[2].descriptorCount = MAX_FRAMES;
+
+    VkDescriptorPoolCreateInfo pi{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    pi.poolSizeCount = 3;
+    pi.pPoolSizes = sizes;
+    pi.maxSets = MAX_FRAMES;
+    if (!vk_ok(vkCreateDescriptorPool(vk.device(), &pi, nullptr, &cullPool_), "vkCreateDescriptorPool (cull) failed"))
+        return false;
+
+    std::array<VkDescriptorSetLayout, MAX_FRAMES> layouts{};
+    layouts.fill(cullSetLayout_);
+
+    VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    ai.descriptorPool = cullPool_;
+    ai.descriptorSetCount = MAX_FRAMES;
+    ai.pSetLayouts = layouts.data();
+    if (!vk_ok(vkAllocateDescriptorSets(vk.device(), &ai, cullSets_.data()), "vkAllocateDescriptorSets (cull) failed"))
+        return false;
+
+    writeCullDescriptors(vk);
+    return true;
+}
+
+bool OcclusionCuller::createDescriptorLayouts(VulkanContext& vk) {
+    // reduce: src (depth или предыдущий mip) + dst mip
+    {
+        VkDescriptorSetLayoutBinding b[2]{};
+        b[0].binding = 0;
+        b[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        b[0].descriptorCount = 1;
+        b[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        b[1].binding = 1;
+        b[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        b[1].descriptorCount = 1;
+        b[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkDescriptorSetLayoutCreateInfo li{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+        li.bindingCount = 2;
+        li.pBindings = b;
+        if (vkCreateDescriptorSetLayout(vk.device(), &li, nullptr, &reduceSetLayout_) != VK_SUCCESS) return false;
+    }
+
+    // cull: params, objects, draws, state, stats, pyramid
+    {
+        VkDescriptorSetLayoutBinding b[6]{};
+        for (uint32_t i = 0; i < 6; ++i) {
+            b[i].binding = i;
+            b[i].descriptorCount = 1;
+            b[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            b[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        }
+        b[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        b[5].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+        VkDescriptorSetLayoutCreateInfo li{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+        li.bindingCount = 6;
+        li.pBindings = b;
+        if (vkCreateDescriptorSetLayout(vk.device(), &li, nullptr, &cullSetLayout_) != VK_SUCCESS) return false;
+    }
+    return true;
+}
+
+bool OcclusionCuller::createPipelines(VulkanContext& vk) {
+    // reduce: push = srcSize, dstSize
+    VkPushConstantRange pcr{};
+    pcr.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pcr.offset = 0;
+    pcr.size = sizeof(int32_t) * 4;
+
+    VkPipelineLayoutCreateInfo pli{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    pli.setLayoutCount = 1;
+    pli.pSetLayouts = &reduceSetLayout_;
+    pli.pushConstantRangeCount = 1;
+    pli.pPushConstantRanges = &pcr;
+    if (vkCreatePipelineLayout(vk.device(), &pli, nullptr, &reduceLayout_) != VK_SUCCESS) return false;
+
+    // cull: push = phase
+    pcr.size = sizeof(uint32_t);
+    pli.pSetLayouts = &cullSetLayout_;
+    if (vkCreatePipelineLayout(vk.device(), &pli, nullptr, &cullLayout_) != VK_SUCCESS) return false;
+
+    reducePipeline_ = createComputePipeline(vk.device(), "shaders/hiz_reduce.comp.spv", reduceLayout_);
+    cullPipeline_ = createComputePipeline(vk.device(), "shaders/occlusion_cull.comp.spv", cullLayout_);
+    return reducePipeline_ && cullPipeline_;
+}
+
+bool OcclusionCuller::createBuffers(VulkanContext& vk) {
+    const VkMemoryPropertyFlags hostMem = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        if (!createBuffer(vk, sizeof(CullParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, hostMem,
+            paramsBuf_[i], paramsMem_[i], "occlusion culling")) return false;
+        if (vkMapMemory(vk.device(), paramsMem_[i], 0, sizeof(CullParams), 0, (void**)&paramsMapped_[i]) != VK_SUCCESS)
+            return false;
+
+        VkDeviceSize objSize = sizeof(GpuObject) * MAX_OBJECTS;
+        if (!createBuffer(vk, objSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem,
+            objectsBuf_[i], objectsMem_[i], "occlusion culling")) return false;
+        if (vkMapMemory(vk.device(), objectsMem_[i], 0, objSize, 0, (void**)&objectsMapped_[i]) != VK_SUCCESS)
+            return false;
+
+        if (!createBuffer(vk, sizeof(VkDrawIndexedIndirectCommand) * MAX_OBJECTS * 2,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, drawsBuf_[i], drawsMem_[i], "occlusion culling")) return false;
+
+        if (!createBuffer(vk, sizeof(uint32_t) * MAX_OBJECTS, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, stateBuf_[i], stateMem_[i], "occlusion culling")) return false;
+
+        if (!createBuffer(vk, sizeof(GpuStats), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            hostMem, statsBuf_[i], statsMem_[i], "occlusion culling")) return false;
+        if (vkMapMemory(vk.device(), statsMem_[i], 0, sizeof(GpuStats), 0, (void**)&statsMapped_[i]) != VK_SUCCESS)
+            return false;
+        std::memset(statsMapped_[i], 0, sizeof(GpuStats));
+        statsObjectCount_[i] = 0;
+    }
+    return true;
+}
+
+void OcclusionCuller::writeCullDescriptors(VulkanContext& vk) {
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        VkDescriptorBufferInfo bufs[5]{};
+        bufs[0] = { paramsBuf_[i], 0, sizeof(CullParams) };
+        bufs[1] = { objectsBuf_[i], 0, VK_WHOLE_SIZE };
+        bufs[2] = { drawsBuf_[i], 0, VK_WHOLE_SIZE };
+        bufs[3] = { stateBuf_[i], 0, VK_WHOLE_SIZE };
+        bufs[4] = { statsBuf_[i], 0, sizeof(GpuStats) };
+
+        VkWriteDescriptorSet w[5]{};
+        for (uint32_t b = 0; b < 5; ++b) {
+            w[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[b].dstSet = cullSets_[i];
+            w[b].dstBinding = b;
+            w[b].descriptorCount = 1;
+            w[b].descriptorType = (b == 0) ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            w[b].pBufferInfo = &bufs[b];
+        }
+        vkUpdateDescriptorSets(vk.device(), 5, w, 0, nullptr);
+    }
+}
+
+bool OcclusionCuller::createTargets(VulkanContext& vk, VkImageView depthView, VkExtent2D depthExtent) {
+    destroyTargets(vk);
+
+    depthExtent_ = depthExtent;
+    // mip 0 пирамиды = половина depth; каждый следующий ещё /2, до 1x1
+    pyramidExtent_.width = std::max(1u, depthExtent.width / 2);
+    pyramidExtent_.height = std::max(1u, depthExtent.height / 2);
+
+    pyramidMips_ = 1;
+    while (pyramidMips_ < MAX_PYRAMID_MIPS &&
+        ((pyramidExtent_.width >> pyramidMips_) > 0 || (pyramidExtent_.height >> pyramidMips_) > 0))
+        ++pyramidMips_;
+
+    VkImageCreateInfo img{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    img.imageType = VK_IMAGE_TYPE_2D;
+    img.extent = { pyramidExtent_.width, pyramidExtent_.height, 1 };
+    img.mipLevels = pyramidMips_;
+    img.arrayLayers = 1;
+    img.format = VK_FORMAT_R32_SFLOAT;
+    img.tiling = VK_IMAGE_TILING_OPTIMAL;
+    img.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    img.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    img.samples = VK_SAMPLE_COUNT_1_BIT;
+    img.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(vk.device(), &img, nullptr, &pyramid_) != VK_SUCCESS) return false;
+
+    VkMemoryRequirements req{};
+    vkGetImageMemoryRequirements(vk.device(), pyramid_, &req);
+    pyramidMem_ = allocateDeviceMemory(vk, req, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "hi-z pyramid");
+    if (!pyramidMem_) return false;
+    if (vkBindImageMemory(vk.device(), pyramid_, pyramidMem_, 0) != VK_SUCCESS) return false;
+
+    pyramidView_ = createImageView(vk.device(), pyramid_, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, 0, pyramidMips_);
+    if (!pyramidView_) return false;
+    for (uint32_t m = 0; m < pyramidMips_; ++m) {
+        mipViews_[m] = createImageView(vk.device(), pyramid_, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, m, 1);
+        if (!mipViews_[m]) return false;
+    }
+
+    // reduce sets: mip0 читает depth, mip N читает mip N-1
+    VkDescriptorPoolSize sizes[2]{};
+    sizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    sizes[0].descriptorCount = pyramidMips_;
+    sizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    sizes[1].descriptorCount = pyramidMips_;
+
+    VkDescriptorPoolCreateInfo pi{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    pi.poolSizeCount = 2;
+    pi.pPoolSizes = sizes;
+    pi.maxSets = pyramidMips_;
+    if (!vk_ok(vkCreateDescriptorPool(vk.device(), &pi, nullptr, &reducePool_), "vkCreateDescriptorPool (hi-z) failed"))
+        return false;
+
+    std::array<VkDescriptorSetLayout, MAX_PYRAMID_MIPS> layouts{};
+    layouts.fill(reduceSetLayout_);
+
+    VkDescriptorSetAllocateInfo dai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    dai.descriptorPool = reducePool_;
+    dai.descriptorSetCount = pyramidMips_;
+    dai.pSetLayouts = layouts.data();
+    if (!vk_ok(vkAllocateDescriptorSets(vk.device(), &dai, reduceSets_.data()), "vkAllocateDescriptorSets (hi-z) failed"))
+        return false;
+
+    for (uint32_t m = 0; m < pyramidMips_; ++m) {
+        VkDescriptorImageInfo src{};
+        src.sampler = sampler_;
+        src.imageView = (m == 0) ? depthView : mipViews_[m - 1];
+        src.imageLayout = (m == 0) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo dst{};
+        dst.imageView = mipViews_[m];
+        dst.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkWriteDescriptorSet w[2]{};
+        w[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        w[0].dstSet = reduceSets_[m];
+        w[0].dstBinding = 0;
+        w[0].descriptorCount = 1;
+        w[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        w[0].pImageInfo = &src;
+        w[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        w[1].dstSet = reduceSets_[m];
+        w[1].dstBinding = 1;
+        w[1].descriptorCount = 1;
+        w[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        w[1].pImageInfo = &dst;
+        vkUpdateDescriptorSets(vk.device(), 2, w, 0, nullptr);
+    }
+
+    // пирамида в cull-сетах (все mip через один view)
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        VkDescriptorImageInfo pyr{};
+        pyr.sampler = sampler_;
+        pyr.imageView = pyramidView_;
+        pyr.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkWriteDescriptorSet w{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        w.dstSet = cullSets_[i];
+        w.dstBinding = 5;
+        w.descriptorCount = 1;
+        w.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        w.pImageInfo = &pyr;
+        vkUpdateDescriptorSets(vk.device(), 1, &w, 0, nullptr);
+    }
+
+    pyramidInitialized_ = false;
+    pyramidValid_ = false;
+    return true;
+}
+
+void OcclusionCuller::destroyTargets(VulkanContext& vk) {
+    if (reducePool_) {
+        vkDestroyDescriptorPool(vk.device(), reducePool_, nullptr);
+        reducePool_ = VK_NULL_HANDLE;
+    }
+    reduceSets_.fill(VK_NULL_HANDLE);
+
+    for (auto& v : mipViews_) {
+        if (v) { vkDestroyImageView(vk.device(), v, nullptr); v = VK_NULL_HANDLE; }
+    }
+    if (pyramidView_) { vkDestroyImageView(vk.device(), pyramidView_, nullptr); pyramidView_ = VK_NULL_HANDLE; }
+    if (pyramid_) { vkDestroyImage(vk.device(), pyramid_, nullptr); pyramid_ = VK_NULL_HANDLE; }
+    freeDeviceMemory(vk.device(), pyramidMem_);
+
+    pyramidMips_ = 0;
+    pyramidInitialized_ = false;
+    pyramidValid_ = false;
+}
+
+void OcclusionCuller::shutdown(VulkanContext& vk) {
+    destroyTargets(vk);
+
+    if (cullPool_) { vkDestroyDescriptorPool(vk.device(), cullPool_, nullptr); cullPool_ = VK_NULL_HANDLE; }
+    if (sampler_) { vkDestroySampler(vk.device(), sampler_, nullptr); sampler_ = VK_NULL_HANDLE; }
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+        if (paramsMapped_[i]) { vkUnmapMemory(vk.device(), paramsMem_[i]); paramsMapped_[i] = nullptr; }
+        if (objectsMapped_[i]) { vkUnmapMemory(vk.device(), objectsMem_[i]); objectsMapped_[i] = nullptr; }
+        if (statsMapped_[i]) { vkUnmapMemory(vk.device(), statsMem_[i]); statsMapped_[i] = nullptr; }
+
+        destroyBuffer(vk, paramsBuf_[i], paramsMem_[i]);
+        destroyBuffer(vk, objectsBuf_[i], objectsMem_[i]);
+        destroyBuffer(vk, drawsBuf_[i], drawsMem_[i]);
+        destroyBuffer(vk, stateBuf_[i], stateMem_[i]);
+        destroyBuffer(vk, statsBuf_[i], statsMem_[i]);
+    }
+
+    if (cullPipeline_) { vkDestroyPipeline(vk.device(), cullPipeline_, nullptr); cullPipeline_ = VK_NULL_HANDLE; }
+    if (reducePipeline_) { vkDestroyPipeline(vk.device(), reducePipeline_, nullptr); reducePipeline_ = VK_NULL_HANDLE; }
+    if (cullLayout_) { vkDestroyPipelineLayout(vk.device(), cullLayout_, nullptr); cullLayout_ = VK_NULL_HANDLE; }
+    if (reduceLayout_) { vkDestroyPipelineLayout(vk.device(), reduceLayout_, nullptr); reduceLayout_ = VK_NULL_HANDLE; }
+    if (cullSetLayout_) { vkDestroyDescriptorSetLayout(vk.device(), cullSetLayout_, nullptr); cullSetLayout_ = VK_NULL_HANDLE; }
+    if (reduceSetLayout_) { vkDestroyDescriptorSetLayout(vk.device(), reduceSetLayout_, nullptr); reduceSetLayout_ = VK_NULL_HANDLE; }
+}
+
+void OcclusionCuller::setFrameParams(uint32_t frame, const Mat4& viewProj, uint32_t objectCount) {
+    objectCount = std::min(objectCount, MAX_OBJECTS);
+
+    CullParams& p = *paramsMapped_[frame];
+    p.viewProj = viewProj;
+    p.prevViewProj = pyramidViewProj_;
+    p.pyramidSize[0] = (float)pyramidExtent_.width;
+    p.pyramidSize[1] = (float)pyramidExtent_.height;
+    p.pyramidSize[2] = (float)pyramidMips_;
+    p.pyramidSize[3] = 0.0f;
+    p.objectCount = objectCount;
+    p.pyramidValid = (pyramidValid_ && occlusionEnabled_) ? 1u : 0u;
+
+    frameViewProj_ = viewProj;
+    statsObjectCount_[frame] = objectCount;
+}
+
+CullStats OcclusionCuller::readStats(uint32_t frame) const {
+    CullStats s;
+    const GpuStats* g = statsMapped_[frame];
+    if (!g) return s;
+    s.total = statsObjectCount_[frame];
+    s.frustumCulled = g->frustumCulled;
+    s.occlusionCulled = g->occlusionCulled;
+    s.earlyDrawn = g->earlyDrawn;
+    s.lateDrawn = g->lateDrawn;
+    return s;
+}
+
+void OcclusionCuller::recordBeginFrame(VkCommandBuffer cmd, uint32_t frame) {
+    vkCmdFillBuffer(cmd, statsBuf_[frame], 0, sizeof(GpuStats), 0);
+
+    VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    mb.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &mb, 0, nullptr, 0, nullptr);
+}
+
+void OcclusionCuller::recordCull(VkCommandBuffer cmd, uint32_t frame, Phase phase) {
+    // early читает пирамиду прошлого кадра: её запись была в предыдущем submit,
+    // барьер ниже покрывает и её (первый scope барьера = всё, что раньше в очереди)
+    VkMemoryBarrier pre{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    pre.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    pre.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &pre, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline_);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cullLayout_, 0, 1, &cullSets_[frame], 0, nullptr);
+
+    uint32_t ph = (uint32_t)phase;
+    vkCmdPushConstants(cmd, cullLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &ph);
+
+    uint32_t count = statsObjectCount_[frame];
+    if (count > 0) vkCmdDispatch(cmd, divUp(count, 64), 1, 1);
+
+    // draw-команды -> indirect, статистика -> host (читаем после fence)
+    VkMemoryBarrier post{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    post.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    post.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+        0, 1, &post, 0, nullptr, 0, nullptr);
+}
+
+void OcclusionCuller::recordBuildPyramid(VkCommandBuffer cmd) {
+    if (!pyramid_) return;
+
+    // depth уже в DEPTH_STENCIL_READ_ONLY_OPTIMAL (finalLayout render pass + external dependency)
+    VkImageMemoryBarrier ib{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    ib.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    ib.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    ib.oldLayout = pyramidInitialized_ ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+    ib.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ib.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    ib.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    ib.image = pyramid_;
+    ib.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, pyramidMips_, 0, 1 };
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &ib);
+    pyramidInitialized_ = true;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, reducePipeline_);
+
+    int32_t srcW = (int32_t)depthExtent_.width;
+    int32_t srcH = (int32_t)depthExtent_.height;
+    for (uint32_t m = 0; m < pyramidMips_; ++m) {
+        int32_t dstW = std::max(1, (int32_t)pyramidExtent_.width >> m);
+        int32_t dstH = std::max(1, (int32_t)pyramidExtent_.height >> m);
+
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, reduceLayout_, 0, 1, &reduceSets_[m], 0, nullptr);
+        int32_t pc[4] = { srcW, srcH, dstW, dstH };
+        vkCmdPushConstants(cmd, reduceLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), pc);
+        vkCmdDispatch(cmd, divUp((uint32_t)dstW, 8), divUp((uint32_t)dstH, 8), 1);
+
+        VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        mb.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &mb, 0, nullptr, 0, nullptr);
+
+        srcW = dstW;
+        srcH = dstH;
+    }
+
+    pyramidViewProj_ = frameViewProj_;
+    pyramidValid_ = true;
+}
+
+void OcclusionCuller::drawObject(VkCommandBuffer cmd, uint32_t frame, Phase phase, uint32_t i) const {
+    VkDeviceSize base = (phase == Phase::Late) ? MAX_OBJECTS : 0;
+    VkDeviceSize off = (base + i) * sizeof(VkDrawIndexedIndirectCommand);
+    vkCmdDrawIndexedIndirect(cmd, drawsBuf_[frame], off, 1, sizeof(VkDrawIndexedIndirectCommand));
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include "renderer/VulkanContext.h"
+#include "math/Mat4.h"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+
+// Hi-Z occlusion culling на GPU (две фазы):
+//  early: frustum + тест по пирамиде глубины ПРОШЛОГО кадра (с его viewProj)
+//  -> основной проход рисует то, что прошло
+//  -> из глубины этого кадра строится новая пирамида
+//  late:  объекты, отброшенные окклюзией в early, перепроверяются по новой пирамиде
+//  -> второй проход дорисовывает "только что открывшиеся" (без pop-in)
+// Каждый объект = свой VkDrawIndexedIndirectCommand, compute пишет instanceCount 0/1.
+
+struct CullStats {
+	uint32_t total = 0;
+	uint32_t frustumCulled = 0;
+	uint32_t occlusionCulled = 0; // отброшены и в early, и в late
+	uint32_t earlyDrawn = 0;
+	uint32_t lateDrawn = 0;       // открылись в этом кадре (второй проход)
+
+	uint32_t culled() const { return frustumCulled + occlusionCulled; }
+};
+
+class OcclusionCuller {
+public:
+	static constexpr uint32_t MAX_FRAMES = 2;
+	static constexpr uint32_t MAX_OBJECTS = 16384;
+
+	enum class Phase : uint32_t { Early = 0, Late = 1 };
+
+	// layout совпадает с Object в occlusion_cull.comp (std430, 48 байт)
+	struct GpuObject {
+		float aabbMin[4];
+		float aabbMax[4];
+		uint32_t indexCount;
+		uint32_t firstIndex;
+		int32_t vertexOffset;
+		uint32_t pad;
+	};
+
+	bool init(VulkanContext& vk);
+	void shutdown(VulkanContext& vk);
+
+	// пирамида зависит от размера depth -> пересоздаётся вместе со swapchain
+	bool createTargets(VulkanContext& vk, VkImageView depthView, VkExtent2D depthExtent);
+	void destroyTargets(VulkanContext& vk);
+
+	// CPU: заполнить объекты кадра (вызывать после ожидания fence этого слота)
+	GpuObject* objects(uint32_t frame) { return objectsMapped_[frame]; }
+	void setFrameParams(uint32_t frame, const Mat4& viewProj, uint32_t objectCount);
+
+	// статистика кадра, который раньше занимал этот слот (GPU уже закончил)
+	CullStats readStats(uint32_t frame) const;
+
+	void recordBeginFrame(VkCommandBuffer cmd, uint32_t frame);
+	void recordCull(VkCommandBuffer cmd, uint32_t frame, Phase phase);
+	void recordBuildPyramid(VkCommandBuffer cmd);
+
+	// один indirect-draw объекта i в своей фазе (model в push constants выставляет вызывающий)
+	void drawObject(VkCommandBuffer cmd, uint32_t frame, Phase phase, uint32_t i) const;
+
+	void setOcclusionEnabled(bool e) { occlusionEnabled_ = e; }
+	bool occlusionEnabled() const { return occlusionEnabled_; }
+
+	// пирамида для других culler'ов (meshlet'ы): view/sampler и камера, с которой она построена
+	VkImageView pyramidView() const { return pyramidView_; }
+	VkSampler pyramidSampler() const { return sampler_; }
+	VkExtent2D pyramidExtent() const { return pyramidExtent_; }
+	uint32_t pyramidMips() const { return pyramidMips_; }
+	const Mat4& pyramidViewProj() const { return pyramidViewProj_; }
+	bool pyramidUsable() const { return pyramidValid_ && occlusionEnabled_; }
+
+private:
+	bool createDescriptorLayouts(VulkanContext& vk);
+	bool createPipelines(VulkanContext& vk);
+	bool createBuffers(VulkanContext& vk);
+	void writeCullDescriptors(VulkanContext& vk);
+
+	// layout совпадает с CullParams в occlusion_cull.comp (std140)
+	struct CullParams {
+		Mat4 viewProj;
+		Mat4 prevViewProj;     // камера, с которой построена текущая пирамида
+		float pyramidSize[4];  // w, h (mip 0), mipCount, -
+		uint32_t objectCount;
+		uint32_t pyramidValid;
+		uint32_t pad0;
+		uint32_t pad1;
+	};
+
+	struct GpuStats {
+		uint32_t frustumCulled;
+		uint32_t occlusionCulled;
+		uint32_t earlyDrawn;
+		uint32_t lateDrawn;
+	};
+
+	static constexpr uint32_t MAX_PYRAMID_MIPS = 16;
+
+	// ---- pipelines ----
+	VkDescriptorSetLayout reduceSetLayout_{ VK_NULL_HANDLE };
+	VkPipelineLayout reduceLayout_{ VK_NULL_HANDLE };
+	VkPipeline reducePipeline_{ VK_NULL_HANDLE };
+
+	VkDescriptorSetLayout cullSetLayout_{ VK_NULL_HANDLE };
+	VkPipelineLayout cullLayout_{ VK_NULL_HANDLE };
+	VkPipeline cullPipeline_{ VK_NULL_HANDLE };
+
+	VkSampler sampler_{ VK_NULL_HANDLE };
+
+	// ---- per-frame buffers ----
+	std::array<VkBuffer, MAX_FRAMES> paramsBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> paramsMem_{};
+	std::array<CullParams*, MAX_FRAMES> paramsMapped_{};
+
+	std::array<VkBuffer, MAX_FRAMES> objectsBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> objectsMem_{};
+	std::array<GpuObject*, MAX_FRAMES> objectsMapped_{};
+
+	// [0..MAX_OBJECTS) early, [MAX_OBJECTS..2*MAX_OBJECTS) late
+	std::array<VkBuffer, MAX_FRAMES> drawsBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> drawsMem_{};
+
+	// 1 = отброшен окклюзией в early, ждёт перепроверки в late
+	std::array<VkBuffer, MAX_FRAMES> stateBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> stateMem_{};
+
+	std::array<VkBuffer, MAX_FRAMES> statsBuf_{};
+	std::array<VkDeviceMemory, MAX_FRAMES> statsMem_{};
+	std::array<GpuStats*, MAX_FRAMES> statsMapped_{};
+	std::array<uint32_t, MAX_FRAMES> statsObjectCount_{};
+
+	VkDescriptorPool cullPool_{ VK_NULL_HANDLE };
+	std::array<VkDescriptorSet, MAX_FRAMES> cullSets_{};
+
+	// ---- depth pyramid (swapchain-dependent) ----
+	VkImage pyramid_{ VK_NULL_HANDLE };
+	VkDeviceMemory pyramidMem_{ VK_NULL_HANDLE };
+	VkImageView pyramidView_{ VK_NULL_HANDLE };           // все mip-уровни (для cull)
+	std::array<VkImageView, MAX_PYRAMID_MIPS> mipViews_{}; // по одному (для reduce)
+	uint32_t pyramidMips_ = 0;
+	VkExtent2D pyramidExtent_{ 0, 0 };
+	VkExtent2D depthExtent_{ 0, 0 };
+	bool pyramidInitialized_ = false; // layout ещё UNDEFINED
+
+	VkDescriptorPool reducePool_{ VK_NULL_HANDLE };
+	std::array<VkDescriptorSet, MAX_PYRAMID_MIPS> reduceSets_{};
+
+	// пирамида в GPU построена с этой матрицей (кадр, записанный последним)
+	Mat4 pyramidViewProj_ = Mat4::identity();
+	bool pyramidValid_ = false;
+	Mat4 frameViewProj_ = Mat4::identity();
+
+	bool occlusionEnabled_ = true;
+};
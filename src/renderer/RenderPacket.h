@@ -0,0 +1,86 @@
+#pragma once
+#include "renderer/Swapchain.h"
+#include "renderer/OcclusionCuller.h"
+#include "renderer/ClusteredLighting.h"
+#include "renderer/CascadedShadows.h"
+#include "renderer/MeshletCuller.h"
+#include "renderer/LodSelector.h"
+#include "renderer/FrustumCuller.h"
+#include "math/Mat4.h"
+#include "math/Vec3.h"
+#include <vector>
+#include <cstdint>
+
+// Late latch камеры: рендер спрашивает свежий поворот прямо перед записью UBO (после ожидания fence и
+// acquire — за это время мышь успевает сдвинуться). Реализует игра (engine/LookLatch), вызывается
+// из того потока, где идёт drawFrame.
+class CameraLatch {
+public:
+	virtual ~CameraLatch() = default;
+	// eye — позиция камеры кадра; inputTime — время ввода, из которого собран текущий view.
+	// true -> есть ввод новее: view перестроен, inputTime = время этого ввода
+	virtual bool latch(const Vec3& eye, Mat4& view, uint64_t& inputTime) = 0;
+};
+
+// задержка ввод -> запись UBO (последний момент, когда CPU ещё меняет картинку кадра);
+// скользящее среднее по кадрам
+struct LatencyStats {
+	float packetMs = 0.0f;  // возраст ввода из пакета
+	float latchedMs = 0.0f; // возраст ввода после late latch (= packetMs, если свежего ввода не было)
+	uint64_t frames = 0;
+	uint64_t latchedFrames = 0; // кадров, где late latch нашёл ввод новее пакета
+	float savedMs() const { return packetMs - latchedMs; }
+};
+
+// Объект сцены для рендера: prop-меш + трансформ
+struct RenderObject {
+	Mat4 model;
+	Vec3 boundsMin; // world-space AABB (для culling)
+	Vec3 boundsMax;
+	bool isStatic = false; // часть карты: попадает в кэшированные дальние каскады теней
+	uint32_t mesh = 0;     // prop-меш (Renderer::addPropMesh), 0 = куб
+};
+
+// переключатели рендера (F-клавиши); применяются вместе с пакетом кадра
+struct RenderSettings {
+	bool occlusionCulling = true;
+	bool meshletCulling = true;
+	bool lod = true;
+	bool cpuCulling = true;
+	bool gpuLightAssign = true;
+	bool lateLatch = true; // поворот камеры по самому свежему вводу прямо перед записью UBO
+	Swapchain::PresentMode presentMode = Swapchain::PresentMode::MAILBOX;
+
+	bool operator==(const RenderSettings&) const = default;
+};
+
+// Всё, что нужно рендеру для одного кадра. Собирает game-поток, дальше пакет принадлежит
+// render-потоку до конца кадра — game-поток его не трогает (см. RenderThread).
+struct RenderPacket {
+	uint64_t frame = 0;
+
+	Mat4 view = Mat4::identity();
+	Mat4 proj = Mat4::identity();
+	std::vector<RenderObject> objects;
+	std::vector<PointLight> lights;
+	Vec3 sunDir{ 0.3f, 1.0f, 0.2f }; // направление НА солнце
+	uint64_t inputTime = 0; // когда опрошен ввод, из которого собран view (steady_clock, нс; 0 = неизвестно)
+
+	RenderSettings settings;
+
+	// размер окна; swapchain пересоздаётся, если recreateSwapchain или сменился presentMode
+	uint32_t width = 0, height = 0;
+	bool recreateSwapchain = false;
+};
+
+// статистика кадра, который рендер закончил последним (снимок для game-потока)
+struct RenderStats {
+	CullStats cull;
+	MeshletStats meshlets;
+	CpuCullStats cpuCull;
+	LodStats lod;
+	ShadowStats shadows;
+	LightingStats lighting;
+	LatencyStats latency;
+	float gpuMs = 0.0f; // GPU-время кадра по timestamp'ам (отстаёт на MAX_FRAMES_IN_FLIGHT кадров; 0 = нет данных)
+};
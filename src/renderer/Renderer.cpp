@@ -1,100 +1,12 @@
 ﻿#include "renderer/Renderer.h"
+#include "renderer/VkUtils.h"
+#include "core/Profiler.h"
 #include <iostream>
-#include <fstream>
 #include <cstring>
 #include <vector>
 #include <array>
-
-static std::vector<char> readFile(const std::string& path) {
-    std::ifstream f(path, std::ios::ate | std::ios::binary);
-    if (!f) return {};
-    size_t size = (size_t)f.tellg();
-    std::vector<char> buf(size);
-    f.seekg(0);
-    f.read(buf.data(), size);
-    return buf;
-}
-
-static VkShaderModule createShaderModule(VkDevice device, const std::vector<char>& code) {
-    if (code.empty()) return VK_NULL_HANDLE;
-
-    VkShaderModuleCreateInfo ci{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
-    ci.codeSize = code.size();
-    ci.pCode = reinterpret_cast<const uint32_t*>(code.data());
-
-    VkShaderModule m{};
-    if (vkCreateShaderModule(device, &ci, nullptr, &m) != VK_SUCCESS)
-        return VK_NULL_HANDLE;
-    return m;
-}
-
-static uint32_t findMemoryType(VkPhysicalDevice phys, uint32_t typeFilter, VkMemoryPropertyFlags props) {
-    VkPhysicalDeviceMemoryProperties memProps{};
-    vkGetPhysicalDeviceMemoryProperties(phys, &memProps);
-
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
-        if ((typeFilter & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & props) == props) {
-            return i;
-        }
-    }
-    return UINT32_MAX;
-}
-
-static bool createBuffer(
-    VulkanContext& vk,
-    VkDeviceSize size,
-    VkBufferUsageFlags usage,
-    VkMemoryPropertyFlags memProps,
-    VkBuffer& outBuf,
-    VkDeviceMemory& outMem
-) {
-    VkBufferCreateInfo bi{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bi.size = size;
-    bi.usage = usage;
-    bi.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    if (vkCreateBuffer(vk.device(), &bi, nullptr, &outBuf) != VK_SUCCESS) return false;
-
-    VkMemoryRequirements req{};
-    vkGetBufferMemoryRequirements(vk.device(), outBuf, &req);
-
-    uint32_t memType = findMemoryType(vk.physicalDevice(), req.memoryTypeBits, memProps);
-    if (memType == UINT32_MAX) return false;
-
-    VkMemoryAllocateInfo ai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    ai.allocationSize = req.size;
-    ai.memoryTypeIndex = memType;
-
-    if (vkAllocateMemory(vk.device(), &ai, nullptr, &outMem) != VK_SUCCESS) return false;
-    if (vkBindBufferMemory(vk.device(), outBuf, outMem, 0) != VK_SUCCESS) return false;
-
-    return true;
-}
-
-static VkImageView createImageView(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspect) {
-    VkImageViewCreateInfo iv{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
-    iv.image = image;
-    iv.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    iv.format = format;
-    iv.subresourceRange.aspectMask = aspect;
-    iv.subresourceRange.baseMipLevel = 0;
-    iv.subresourceRange.levelCount = 1;
-    iv.subresourceRange.baseArrayLayer = 0;
-    iv.subresourceRange.layerCount = 1;
-
-    VkImageView view = VK_NULL_HANDLE;
-    if (vkCreateImageView(device, &iv, nullptr, &view) != VK_SUCCESS) return VK_NULL_HANDLE;
-    return view;
-}
-
-
-static bool vk_ok(VkResult r, const char* msg) {
-    if (r != VK_SUCCESS) {
-        std::cerr << msg << " VkResult=" << r << "\n";
-        return false;
-    }
-    return true;
-}
+#include <algorithm>
+#include <chrono>
 
 VkVertexInputBindingDescription Renderer::bindingDesc() {
     VkVertexInputBindingDescription b{};
@@ -104,8 +16,8 @@ VkVertexInputBindingDescription Renderer::bindingDesc() {
     return b;
 }
 
-std::array<VkVertexInputAttributeDescription, 2> Renderer::attrDescs() {
-    std::array<VkVertexInputAttributeDescription, 2> a{};
+std::array<VkVertexInputAttributeDescription, 3> Renderer::attrDescs() {
+    std::array<VkVertexInputAttributeDescription, 3> a{};
 
     // location 0: vec3 position
     a[0].location = 0;
@@ -113,11 +25,17 @@ std::array<VkVertexInputAttributeDescription, 2> Renderer::attrDescs() {
     a[0].format = VK_FORMAT_R32G32B32_SFLOAT;
     a[0].offset = offsetof(Vertex, pos);
 
-    // location 1: vec3 color
+    // location 1: vec3 normal
     a[1].location = 1;
     a[1].binding = 0;
     a[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-    a[1].offset = offsetof(Vertex, color);
+    a[1].offset = offsetof(Vertex, normal);
+
+    // location 2: vec3 color
+    a[2].location = 2;
+    a[2].binding = 0;
+    a[2].format = VK_FORMAT_R32G32B32_SFLOAT;
+    a[2].offset = offsetof(Vertex, color);
 
     return a;
 }
@@ -126,55 +44,45 @@ bool Renderer::createMeshBuffers(VulkanContext& vk) {
     destroyMeshBuffers(vk);
 
     // ---------- 1) Cube ----------
-    std::vector<Vertex> cubeVerts = {
-        {{-0.5f,-0.5f,-0.5f},{1,0,0}}, // 0
-        {{ 0.5f,-0.5f,-0.5f},{0,1,0}}, // 1
-        {{ 0.5f, 0.5f,-0.5f},{0,0,1}}, // 2
-        {{-0.5f, 0.5f,-0.5f},{1,1,0}}, // 3
-        {{-0.5f,-0.5f, 0.5f},{0,1,1}}, // 4
-        {{ 0.5f,-0.5f, 0.5f},{1,0,1}}, // 5
-        {{ 0.5f, 0.5f, 0.5f},{1,1,1}}, // 6
-        {{-0.5f, 0.5f, 0.5f},{0.7f,0.7f,0.7f}}, // 7
+    // 8 углов (позиция + цвет); у каждой грани свои 4 вершины, чтобы нормали были плоскими
+    const float corners[8][3] = {
+        {-0.5f,-0.5f,-0.5f}, { 0.5f,-0.5f,-0.5f}, { 0.5f, 0.5f,-0.5f}, {-0.5f, 0.5f,-0.5f},
+        {-0.5f,-0.5f, 0.5f}, { 0.5f,-0.5f, 0.5f}, { 0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f},
     };
-
-    std::vector<uint32_t> cubeIdx = {
-        // back (-Z)
-        0,1,2,  0,2,3,
-        // front (+Z)
-        4,6,5,  4,7,6,
-        // left (-X)
-        0,3,7,  0,7,4,
-        // right (+X)
-        1,5,6,  1,6,2,
-        // bottom (-Y)
-        0,4,5,  0,5,1,
-        // top (+Y)
-        3,2,6,  3,6,7
+    const float cornerColors[8][3] = {
+        {1,0,0}, {0,1,0}, {0,0,1}, {1,1,0},
+        {0,1,1}, {1,0,1}, {1,1,1}, {0.7f,0.7f,0.7f},
     };
 
-    cubeIndexCount_ = (uint32_t)cubeIdx.size();
-
-    VkDeviceSize cubeVbSize = sizeof(Vertex) * cubeVerts.size();
-    VkDeviceSize cubeIbSize = sizeof(uint32_t) * cubeIdx.size();
-
-    if (!createBuffer(vk, cubeVbSize,
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        cubeVb_, cubeVbMem_)) return false;
-
-    if (!createBuffer(vk, cubeIbSize,
-        VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        cubeIb_, cubeIbMem_)) return false;
+    struct Face { int c[4]; float n[3]; };
+    const Face faces[6] = {
+        { {0,1,2,3}, { 0, 0,-1} }, // back (-Z)
+        { {4,7,6,5}, { 0, 0, 1} }, // front (+Z)
+        { {0,3,7,4}, {-1, 0, 0} }, // left (-X)
+        { {1,5,6,2}, { 1, 0, 0} }, // right (+X)
+        { {0,4,5,1}, { 0,-1, 0} }, // bottom (-Y)
+        { {3,2,6,7}, { 0, 1, 0} }, // top (+Y)
+    };
 
-    void* p = nullptr;
-    vkMapMemory(vk.device(), cubeVbMem_, 0, cubeVbSize, 0, &p);
-    std::memcpy(p, cubeVerts.data(), (size_t)cubeVbSize);
-    vkUnmapMemory(vk.device(), cubeVbMem_);
+    MeshData cube;
+    for (const Face& f : faces) {
+        uint32_t base = (uint32_t)cube.vertices.size();
+        for (int k = 0; k < 4; ++k) {
+            const float* p = corners[f.c[k]];
+            const float* c = cornerColors[f.c[k]];
+            cube.vertices.push_back({ { p[0], p[1], p[2] }, { f.n[0], f.n[1], f.n[2] }, { c[0], c[1], c[2] } });
+        }
+        uint32_t quad[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+        cube.indices.insert(cube.indices.end(), quad, quad + 6);
+    }
+    computeBounds(cube);
 
-    vkMapMemory(vk.device(), cubeIbMem_, 0, cubeIbSize, 0, &p);
-    std::memcpy(p, cubeIdx.data(), (size_t)cubeIbSize);
-    vkUnmapMemory(vk.device(), cubeIbMem_);
+    // куб = prop-меш 0 (остальные добавляет addPropMesh)
+    propMeshes_.clear();
+    propVertices_.clear();
+    propIndices_.clear();
+    appendPropMesh(cube);
+    if (!uploadPropBuffers(vk)) return false;
 
     // ---------- 2) Grid lines (XZ plane, LINE_LIST) ----------
     const int half = 20;      // от -20 до +20
@@ -190,61 +98,120 @@ bool Renderer::createMeshBuffers(VulkanContext& vk) {
     for (int i = -half; i <= half; ++i) {
         float x = i * step;
         // линия вдоль Z при фиксированном X
-        gridVerts.push_back({ { x, y, -half * step }, {0.35f, 0.35f, 0.35f} });
-        gridVerts.push_back({ { x, y,  half * step }, {0.35f, 0.35f, 0.35f} });
+        gridVerts.push_back({ { x, y, -half * step }, {0, 1, 0}, {0.35f, 0.35f, 0.35f} });
+        gridVerts.push_back({ { x, y,  half * step }, {0, 1, 0}, {0.35f, 0.35f, 0.35f} });
         gridIdx.push_back(idx++);
         gridIdx.push_back(idx++);
     }
     for (int i = -half; i <= half; ++i) {
         float z = i * step;
         // линия вдоль X при фиксированном Z
-        gridVerts.push_back({ { -half * step, y, z }, {0.35f, 0.35f, 0.35f} });
-        gridVerts.push_back({ {  half * step, y, z }, {0.35f, 0.35f, 0.35f} });
+        gridVerts.push_back({ { -half * step, y, z }, {0, 1, 0}, {0.35f, 0.35f, 0.35f} });
+        gridVerts.push_back({ {  half * step, y, z }, {0, 1, 0}, {0.35f, 0.35f, 0.35f} });
         gridIdx.push_back(idx++);
         gridIdx.push_back(idx++);
     }
 
     gridIndexCount_ = (uint32_t)gridIdx.size();
 
-    VkDeviceSize gridVbSize = sizeof(Vertex) * gridVerts.size();
-    VkDeviceSize gridIbSize = sizeof(uint32_t) * gridIdx.size();
-
-    if (!createBuffer(vk, gridVbSize,
+    gridVb_ = gpu_.createBuffer(sizeof(Vertex) * gridVerts.size(),
         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        gridVb_, gridVbMem_)) return false;
+        "grid.vb", gridVerts.data());
+    gridIb_ = gpu_.createBuffer(sizeof(uint32_t) * gridIdx.size(),
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        "grid.ib", gridIdx.data());
+    if (!gridVb_.valid() || !gridIb_.valid()) return false;
+
+    // ---------- 3) Floor (чуть ниже сетки, чтобы линии не z-fight'ились) ----------
+    const float fy = -0.005f;
+    const float fs = half * step;
+    const float floorColor[3] = { 0.3f, 0.3f, 0.32f };
+    std::vector<Vertex> floorVerts = {
+        { { -fs, fy, -fs }, { 0, 1, 0 }, { floorColor[0], floorColor[1], floorColor[2] } },
+        { {  fs, fy, -fs }, { 0, 1, 0 }, { floorColor[0], floorColor[1], floorColor[2] } },
+        { {  fs, fy,  fs }, { 0, 1, 0 }, { floorColor[0], floorColor[1], floorColor[2] } },
+        { { -fs, fy,  fs }, { 0, 1, 0 }, { floorColor[0], floorColor[1], floorColor[2] } },
+    };
+    std::vector<uint32_t> floorIdx = { 0, 1, 2,  0, 2, 3 };
+
+    floorIndexCount_ = (uint32_t)floorIdx.size();
 
-    if (!createBuffer(vk, gridIbSize,
+    floorVb_ = gpu_.createBuffer(sizeof(Vertex) * floorVerts.size(),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        "floor.vb", floorVerts.data());
+    floorIb_ = gpu_.createBuffer(sizeof(uint32_t) * floorIdx.size(),
         VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        gridIb_, gridIbMem_)) return false;
+        "floor.ib", floorIdx.data());
+    return floorVb_.valid() && floorIb_.valid();
+}
 
-    vkMapMemory(vk.device(), gridVbMem_, 0, gridVbSize, 0, &p);
-    std::memcpy(p, gridVerts.data(), (size_t)gridVbSize);
-    vkUnmapMemory(vk.device(), gridVbMem_);
 
-    vkMapMemory(vk.device(), gridIbMem_, 0, gridIbSize, 0, &p);
-    std::memcpy(p, gridIdx.data(), (size_t)gridIbSize);
-    vkUnmapMemory(vk.device(), gridIbMem_);
+void Renderer::destroyMeshBuffers(VulkanContext&) {
+    gpu_.destroy(propVb_);
+    gpu_.destroy(propIb_);
 
-    return true;
+    gpu_.destroy(gridVb_);
+    gpu_.destroy(gridIb_);
+    gridIndexCount_ = 0;
+
+    gpu_.destroy(floorVb_);
+    gpu_.destroy(floorIb_);
+    floorIndexCount_ = 0;
 }
 
 
-void Renderer::destroyMeshBuffers(VulkanContext& vk) {
-    // Cube
-    if (cubeVb_) { vkDestroyBuffer(vk.device(), cubeVb_, nullptr); cubeVb_ = VK_NULL_HANDLE; }
-    if (cubeVbMem_) { vkFreeMemory(vk.device(), cubeVbMem_, nullptr); cubeVbMem_ = VK_NULL_HANDLE; }
-    if (cubeIb_) { vkDestroyBuffer(vk.device(), cubeIb_, nullptr); cubeIb_ = VK_NULL_HANDLE; }
-    if (cubeIbMem_) { vkFreeMemory(vk.device(), cubeIbMem_, nullptr); cubeIbMem_ = VK_NULL_HANDLE; }
-    cubeIndexCount_ = 0;
+uint32_t Renderer::appendPropMesh(const MeshData& mesh) {
+    PropMesh pm;
+    pm.vertexOffset = (int32_t)propVertices_.size();
+    pm.lodCount = std::min(lodCount(mesh), MAX_MESH_LODS);
+    for (uint32_t l = 0; l < pm.lodCount; ++l) {
+        MeshLod lod = meshLod(mesh, l);
+        pm.lods[l] = { (uint32_t)propIndices_.size(), lod.indexCount, lod.error, 0 };
+        propIndices_.insert(propIndices_.end(),
+            mesh.indices.begin() + lod.indexOffset, mesh.indices.begin() + lod.indexOffset + lod.indexCount);
+    }
 
-    // Grid
-    if (gridVb_) { vkDestroyBuffer(vk.device(), gridVb_, nullptr); gridVb_ = VK_NULL_HANDLE; }
-    if (gridVbMem_) { vkFreeMemory(vk.device(), gridVbMem_, nullptr); gridVbMem_ = VK_NULL_HANDLE; }
-    if (gridIb_) { vkDestroyBuffer(vk.device(), gridIb_, nullptr); gridIb_ = VK_NULL_HANDLE; }
-    if (gridIbMem_) { vkFreeMemory(vk.device(), gridIbMem_, nullptr); gridIbMem_ = VK_NULL_HANDLE; }
-    gridIndexCount_ = 0;
+    Vec3 c{ (mesh.boundsMin[0] + mesh.boundsMax[0]) * 0.5f,
+        (mesh.boundsMin[1] + mesh.boundsMax[1]) * 0.5f,
+        (mesh.boundsMin[2] + mesh.boundsMax[2]) * 0.5f };
+    for (const MeshVertex& v : mesh.vertices)
+        pm.radius = std::max(pm.radius, length(Vec3{ v.pos[0], v.pos[1], v.pos[2] } - c));
+
+    propVertices_.insert(propVertices_.end(), mesh.vertices.begin(), mesh.vertices.end());
+    propMeshes_.push_back(pm);
+    return (uint32_t)propMeshes_.size() - 1;
+}
+
+bool Renderer::uploadPropBuffers(VulkanContext&) {
+    // старые буферы ещё могут читаться кадрами в полёте: gpu_ уничтожит их после fence
+    gpu_.destroy(propVb_);
+    gpu_.destroy(propIb_);
+
+    propVb_ = gpu_.createBuffer(sizeof(Vertex) * propVertices_.size(),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        "props.vb", propVertices_.data());
+    propIb_ = gpu_.createBuffer(sizeof(uint32_t) * propIndices_.size(),
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        "props.ib", propIndices_.data());
+    return propVb_.valid() && propIb_.valid();
+}
+
+uint32_t Renderer::addPropMesh(VulkanContext& vk, const MeshData& mesh) {
+    // буферы пересоздаются целиком, без vkDeviceWaitIdle: старые уходят в отложенное удаление
+    uint32_t id = appendPropMesh(mesh);
+    if (!uploadPropBuffers(vk)) {
+        std::cerr << "Renderer: prop mesh upload failed\n";
+        propMeshes_.pop_back();
+        return 0;
+    }
+    shadows_.invalidateStatic();
+    return id;
 }
 
 
@@ -258,7 +225,9 @@ VkFormat Renderer::chooseDepthFormat(VulkanContext& vk) const {
     for (VkFormat f : candidates) {
         VkFormatProperties props{};
         vkGetPhysicalDeviceFormatProperties(vk.physicalDevice(), f, &props);
-        if (props.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+        // depth читается compute-шейдером (Hi-Z), поэтому нужен ещё и SAMPLED
+        const VkFormatFeatureFlags need = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+        if ((props.optimalTilingFeatures & need) == need) {
             return f;
         }
     }
@@ -283,63 +252,63 @@ bool Renderer::createDepthResources(VulkanContext& vk) {
     img.format = depthFormat_;
     img.tiling = VK_IMAGE_TILING_OPTIMAL;
     img.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    img.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    img.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
     img.samples = VK_SAMPLE_COUNT_1_BIT;
     img.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    if (vkCreateImage(vk.device(), &img, nullptr, &depthImage_) != VK_SUCCESS) return false;
-
-    VkMemoryRequirements req{};
-    vkGetImageMemoryRequirements(vk.device(), depthImage_, &req);
-
-    uint32_t memType = findMemoryType(vk.physicalDevice(), req.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    if (memType == UINT32_MAX) return false;
-
-    VkMemoryAllocateInfo ai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    ai.allocationSize = req.size;
-    ai.memoryTypeIndex = memType;
-
-    if (vkAllocateMemory(vk.device(), &ai, nullptr, &depthMemory_) != VK_SUCCESS) return false;
-    if (vkBindImageMemory(vk.device(), depthImage_, depthMemory_, 0) != VK_SUCCESS) return false;
-
-    depthView_ = createImageView(vk.device(), depthImage_, depthFormat_, VK_IMAGE_ASPECT_DEPTH_BIT);
-    return depthView_ != VK_NULL_HANDLE;
+    depth_ = gpu_.createImage(img, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_IMAGE_ASPECT_DEPTH_BIT, "depth");
+    return depth_.valid();
 }
 
 bool Renderer::createUniform(VulkanContext& vk) {
     VkDeviceSize size = sizeof(UBO);
 
     for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        if (!createBuffer(vk, size,
+        ubo_[i] = gpu_.createBuffer(size,
             VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            uboBuffer_[i], uboMemory_[i])) return false;
-
-        if (vkMapMemory(vk.device(), uboMemory_[i], 0, size, 0, &uboMapped_[i]) != VK_SUCCESS) return false;
+            "ubo", nullptr, true);
+        if (!ubo_[i].valid()) return false;
     }
     return true;
 }
 
 bool Renderer::createDescriptors(VulkanContext& vk) {
-    VkDescriptorSetLayoutBinding b{};
-    b.binding = 0;
-    b.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    b.descriptorCount = 1;
-    b.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    // 0: UBO кадра, 1..3: источники света / сетка кластеров / списки индексов (fragment),
+    // 4: каскады теней (sampler2DArrayShadow)
+    VkDescriptorSetLayoutBinding b[5]{};
+    b[0].binding = 0;
+    b[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    b[0].descriptorCount = 1;
+    b[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    for (uint32_t i = 1; i < 4; ++i) {
+        b[i].binding = i;
+        b[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        b[i].descriptorCount = 1;
+        b[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+    b[4].binding = 4;
+    b[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    b[4].descriptorCount = 1;
+    b[4].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
     VkDescriptorSetLayoutCreateInfo li{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
-    li.bindingCount = 1;
-    li.pBindings = &b;
+    li.bindingCount = 5;
+    li.pBindings = b;
 
     if (vkCreateDescriptorSetLayout(vk.device(), &li, nullptr, &descSetLayout_) != VK_SUCCESS) return false;
 
-    VkDescriptorPoolSize ps{};
-    ps.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    ps.descriptorCount = MAX_FRAMES_IN_FLIGHT;
+    VkDescriptorPoolSize ps[3]{};
+    ps[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    ps[0].descriptorCount = MAX_FRAMES_IN_FLIGHT;
+    ps[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    ps[1].descriptorCount = MAX_FRAMES_IN_FLIGHT * 3;
+    ps[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    ps[2].descriptorCount = MAX_FRAMES_IN_FLIGHT;
 
     VkDescriptorPoolCreateInfo pi{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
-    pi.poolSizeCount = 1;
-    pi.pPoolSizes = &ps;
+    pi.poolSizeCount = 3;
+    pi.pPoolSizes = ps;
     pi.maxSets = MAX_FRAMES_IN_FLIGHT;
 
     if (vkCreateDescriptorPool(vk.device(), &pi, nullptr, &descPool_) != VK_SUCCESS) return false;
@@ -355,19 +324,32 @@ bool Renderer::createDescriptors(VulkanContext& vk) {
     if (vkAllocateDescriptorSets(vk.device(), &ai, descSet_.data()) != VK_SUCCESS) return false;
 
     for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        VkDescriptorBufferInfo dbi{};
-        dbi.buffer = uboBuffer_[i];
-        dbi.offset = 0;
-        dbi.range = sizeof(UBO);
-
-        VkWriteDescriptorSet w{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
-        w.dstSet = descSet_[i];
-        w.dstBinding = 0;
-        w.descriptorCount = 1;
-        w.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        w.pBufferInfo = &dbi;
+        VkDescriptorBufferInfo dbi[4]{};
+        dbi[0] = { gpu_.buffer(ubo_[i]), 0, sizeof(UBO) };
+        dbi[1] = { lighting_.lightsBuffer(i), 0, VK_WHOLE_SIZE };
+        dbi[2] = { lighting_.clusterBuffer(i), 0, VK_WHOLE_SIZE };
+        dbi[3] = { lighting_.indexBuffer(i), 0, VK_WHOLE_SIZE };
+
+        VkDescriptorImageInfo shadowInfo{};
+        shadowInfo.sampler = shadows_.sampler();
+        shadowInfo.imageView = shadows_.arrayView();
+        shadowInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+        VkWriteDescriptorSet w[5]{};
+        for (uint32_t k = 0; k < 5; ++k) {
+            w[k].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[k].dstSet = descSet_[i];
+            w[k].dstBinding = k;
+            w[k].descriptorCount = 1;
+        }
+        for (uint32_t k = 0; k < 4; ++k) {
+            w[k].descriptorType = (k == 0) ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            w[k].pBufferInfo = &dbi[k];
+        }
+        w[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        w[4].pImageInfo = &shadowInfo;
 
-        vkUpdateDescriptorSets(vk.device(), 1, &w, 0, nullptr);
+        vkUpdateDescriptorSets(vk.device(), 5, w, 0, nullptr);
     }
     return true;
 }
@@ -386,36 +368,12 @@ void Renderer::destroyDescriptors(VulkanContext& vk) {
 }
 
 
-void Renderer::destroyUniform(VulkanContext& vk) {
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        if (uboMapped_[i]) {
-            vkUnmapMemory(vk.device(), uboMemory_[i]);
-            uboMapped_[i] = nullptr;
-        }
-        if (uboBuffer_[i]) {
-            vkDestroyBuffer(vk.device(), uboBuffer_[i], nullptr);
-            uboBuffer_[i] = VK_NULL_HANDLE;
-        }
-        if (uboMemory_[i]) {
-            vkFreeMemory(vk.device(), uboMemory_[i], nullptr);
-            uboMemory_[i] = VK_NULL_HANDLE;
-        }
-    }
+void Renderer::destroyUniform(VulkanContext&) {
+    for (BufferHandle& h : ubo_) gpu_.destroy(h);
 }
 
-void Renderer::destroyDepthResources(VulkanContext& vk) {
-    if (depthView_) {
-        vkDestroyImageView(vk.device(), depthView_, nullptr);
-        depthView_ = VK_NULL_HANDLE;
-    }
-    if (depthImage_) {
-        vkDestroyImage(vk.device(), depthImage_, nullptr);
-        depthImage_ = VK_NULL_HANDLE;
-    }
-    if (depthMemory_) {
-        vkFreeMemory(vk.device(), depthMemory_, nullptr);
-        depthMemory_ = VK_NULL_HANDLE;
-    }
+void Renderer::destroyDepthResources(VulkanContext&) {
+    gpu_.destroy(depth_);
     depthFormat_ = VK_FORMAT_UNDEFINED;
 }
 
@@ -427,13 +385,20 @@ bool Renderer::init(VulkanContext& vk, uint32_t width, uint32_t height) {
         width, height
     )) return false;
 
+    if (!gpu_.init(vk, MAX_FRAMES_IN_FLIGHT)) return false;
     if (!createDepthResources(vk)) return false;
     if (!createRenderPass(vk)) return false;
     if (!createFramebuffers(vk)) return false;
     if (!createUniform(vk)) return false;
+    if (!lighting_.init(vk)) return false; // его буферы нужны в descriptor set
+    if (!shadows_.init(vk, bindingDesc(), attrDescs()[0])) return false; // и карта теней тоже
     if (!createDescriptors(vk)) return false;
     if (!createMeshBuffers(vk)) return false;
     if (!createPipeline(vk)) return false;
+    if (!culler_.init(vk)) return false;
+    if (!culler_.createTargets(vk, gpu_.view(depth_), swapchain_.extent())) return false;
+    if (!meshlets_.init(vk)) return false;
+    meshlets_.setPyramid(vk, culler_.pyramidView(), culler_.pyramidSampler());
     if (!createCommandResources(vk)) return false;
     if (!createSync(vk)) return false;
 
@@ -451,7 +416,10 @@ void Renderer::cleanupSwapchainDependent(VulkanContext& vk) {
 
     if (renderPass_) vkDestroyRenderPass(vk.device(), renderPass_, nullptr);
     renderPass_ = VK_NULL_HANDLE;
+    if (renderPassLate_) vkDestroyRenderPass(vk.device(), renderPassLate_, nullptr);
+    renderPassLate_ = VK_NULL_HANDLE;
 
+    culler_.destroyTargets(vk);
     destroyDepthResources(vk);
     swapchain_.cleanup(vk.device());
 }
@@ -474,6 +442,8 @@ bool Renderer::recreateSwapchain(VulkanContext& vk, uint32_t width, uint32_t hei
     if (!createRenderPass(vk)) return false;
     if (!createFramebuffers(vk)) return false;
     if (!createPipeline(vk)) return false;
+    if (!culler_.createTargets(vk, gpu_.view(depth_), swapchain_.extent())) return false;
+    meshlets_.setPyramid(vk, culler_.pyramidView(), culler_.pyramidSampler());
 
     imagesInFlight_.assign(swapchain_.imageViews().size(), VK_NULL_HANDLE);
     currentFrame_ = 0;
@@ -481,8 +451,19 @@ bool Renderer::recreateSwapchain(VulkanContext& vk, uint32_t width, uint32_t hei
     return true;
 }
 
+bool Renderer::setMapMesh(VulkanContext& vk, const MeshData& mesh) {
+    // старый меш может ещё читаться кадрами в полёте
+    vkDeviceWaitIdle(vk.device());
+    if (!meshlets_.upload(vk, mesh)) {
+        std::cerr << "Renderer: map mesh upload failed\n";
+        return false;
+    }
+    shadows_.invalidateStatic();
+    return true;
+}
+
 bool Renderer::createRenderPass(VulkanContext& vk) {
-    // 1) Color attachment (swapchain)
+    // 1) Color attachment (swapchain); present делает уже late-проход
     VkAttachmentDescription color{};
     color.format = swapchain_.format();
     color.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -491,22 +472,22 @@ bool Renderer::createRenderPass(VulkanContext& vk) {
     color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     color.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    color.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    color.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
     VkAttachmentReference colorRef{};
     colorRef.attachment = 0;
     colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-    // 2) Depth attachment
+    // 2) Depth attachment: сохраняем и оставляем в read-only — из него строится Hi-Z пирамида
     VkAttachmentDescription depth{};
     depth.format = depthFormat_;
     depth.samples = VK_SAMPLE_COUNT_1_BIT;
     depth.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depth.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     depth.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depth.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depth.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    depth.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depth.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
 
     VkAttachmentReference depthRef{};
     depthRef.attachment = 1;
@@ -518,12 +499,26 @@ bool Renderer::createRenderPass(VulkanContext& vk) {
     subpass.pColorAttachments = &colorRef;
     subpass.pDepthStencilAttachment = &depthRef;
 
-    VkSubpassDependency dep{};
-    dep.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dep.dstSubpass = 0;
-    dep.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dep.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dep.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    VkSubpassDependency deps[2]{};
+    // вход: прошлый кадр (late-проход и чтение depth compute'ом при сборке пирамиды)
+    deps[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    deps[0].dstSubpass = 0;
+    deps[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    deps[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    deps[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    deps[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // выход: depth -> compute (Hi-Z reduce)
+    deps[1].srcSubpass = 0;
+    deps[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    deps[1].srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    deps[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    deps[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    deps[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
     VkAttachmentDescription attachments[2] = { color, depth };
 
@@ -532,10 +527,36 @@ bool Renderer::createRenderPass(VulkanContext& vk) {
     rp.pAttachments = attachments;
     rp.subpassCount = 1;
     rp.pSubpasses = &subpass;
+    rp.dependencyCount = 2;
+    rp.pDependencies = deps;
+
+    if (vkCreateRenderPass(vk.device(), &rp, nullptr, &renderPass_) != VK_SUCCESS) return false;
+
+    // ---- late pass: тот же формат (совместим с pipeline и framebuffer'ами), но load + present ----
+    attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[0].initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachments[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDependency late{};
+    // ждём Hi-Z reduce (читал depth) и late-cull (пишет indirect-команды — барьер в culler)
+    late.srcSubpass = VK_SUBPASS_EXTERNAL;
+    late.dstSubpass = 0;
+    late.srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    late.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    late.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    late.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
     rp.dependencyCount = 1;
-    rp.pDependencies = &dep;
+    rp.pDependencies = &late;
 
-    return vkCreateRenderPass(vk.device(), &rp, nullptr, &renderPass_) == VK_SUCCESS;
+    return vkCreateRenderPass(vk.device(), &rp, nullptr, &renderPassLate_) == VK_SUCCESS;
 }
 
 
@@ -544,7 +565,7 @@ bool Renderer::createFramebuffers(VulkanContext& vk) {
     framebuffers_.resize(views.size());
 
     for (size_t i = 0; i < views.size(); i++) {
-        VkImageView attachments[] = { views[i], depthView_ };
+        VkImageView attachments[] = { views[i], gpu_.view(depth_) };
 
         VkFramebufferCreateInfo fb{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
         fb.renderPass = renderPass_;
@@ -589,22 +610,58 @@ bool Renderer::createSync(VulkanContext& vk) {
         if (!vk_ok(vkCreateSemaphore(vk.device(), &si, nullptr, &renderFinished_[i]), "vkCreateSemaphore failed")) return false;
         if (!vk_ok(vkCreateFence(vk.device(), &fi, nullptr, &inFlightFences_[i]), "vkCreateFence failed")) return false;
     }
+
+    // GPU-время кадра: timestamp в начале и в конце командного буфера, по паре на frame-слот
+    uint32_t qfCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(vk.physicalDevice(), &qfCount, nullptr);
+    std::vector<VkQueueFamilyProperties> qf(qfCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(vk.physicalDevice(), &qfCount, qf.data());
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(vk.physicalDevice(), &props);
+
+    if (vk.graphicsQueueFamily() < qfCount && qf[vk.graphicsQueueFamily()].timestampValidBits > 0 &&
+        props.limits.timestampPeriod > 0.0f) {
+        VkQueryPoolCreateInfo qi{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        qi.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        qi.queryCount = 2 * MAX_FRAMES_IN_FLIGHT;
+        if (!vk_ok(vkCreateQueryPool(vk.device(), &qi, nullptr, &timestampPool_), "vkCreateQueryPool failed")) return false;
+        timestampPeriodNs_ = props.limits.timestampPeriod;
+    }
     return true;
 }
 
 
 bool Renderer::drawFrame(VulkanContext& vk) {
+    PROFILE_SCOPE("drawFrame");
     uint32_t frame = currentFrame_;
 
     // 1) ждём завершения GPU по этому frame-слоту
-    vkWaitForFences(vk.device(), 1, &inFlightFences_[frame], VK_TRUE, UINT64_MAX);
+    {
+        PROFILE_SCOPE("draw.waitFence");
+        vkWaitForFences(vk.device(), 1, &inFlightFences_[frame], VK_TRUE, UINT64_MAX);
+    }
+    // ...и всё, что удалили, пока этот слот был текущим, больше никем не читается
+    gpu_.beginFrame(frame);
+
+    // GPU закончил прошлый кадр этого слота -> его timestamp'ы готовы
+    if (timestampPool_ && timestampsWritten_[frame]) {
+        uint64_t ts[2] = {};
+        if (vkGetQueryPoolResults(vk.device(), timestampPool_, frame * 2, 2, sizeof(ts), ts, sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT) == VK_SUCCESS && ts[1] >= ts[0]) {
+            gpuFrameMs_ = (float)((double)(ts[1] - ts[0]) * timestampPeriodNs_ * 1e-6);
+        }
+    }
 
     // 2) получить индекс изображения swapchain
     uint32_t imageIndex = 0;
-    VkResult acq = vkAcquireNextImageKHR(
-        vk.device(), swapchain_.handle(), UINT64_MAX,
-        imageAvailable_[frame], VK_NULL_HANDLE, &imageIndex
-    );
+    VkResult acq = VK_SUCCESS;
+    {
+        PROFILE_SCOPE("draw.acquire");
+        acq = vkAcquireNextImageKHR(
+            vk.device(), swapchain_.handle(), UINT64_MAX,
+            imageAvailable_[frame], VK_NULL_HANDLE, &imageIndex
+        );
+    }
 
     if (acq == VK_ERROR_OUT_OF_DATE_KHR) { std::cout << "ACQ: OUT_OF_DATE\n"; return false; }
     if (acq == VK_SUBOPTIMAL_KHR) { std::cout << "ACQ: SUBOPTIMAL\n"; /* не return */ }
@@ -626,8 +683,88 @@ bool Renderer::drawFrame(VulkanContext& vk) {
     // 4) теперь можно ресетнуть fence нашего frame-слота
     vkResetFences(vk.device(), 1, &inFlightFences_[frame]);
 
-    // 5) обновляем UBO для текущего frame-слота
-    std::memcpy(uboMapped_[frame], &uboCpu_, sizeof(UBO));
+    // 4.5) late latch: пока ждали fence/acquire, мышь могла сдвинуться — берём самый свежий поворот.
+    //      До теней/culling/LOD, чтобы всё в кадре считалось по одной и той же view
+    lateLatchCamera();
+
+    // 5) обновляем UBO для текущего frame-слота (вместе с параметрами сетки кластеров)
+    lighting_.configure(swapchain_.extent(), uboCpu_.proj);
+    uboCpu_.cluster = lighting_.gridParams();
+    shadows_.update(uboCpu_.view, uboCpu_.proj);
+    uboCpu_.shadow = shadows_.params();
+    std::memcpy(gpu_.get(ubo_[frame])->mapped, &uboCpu_, sizeof(UBO));
+
+    // источники -> view space; на CPU-пути здесь же строятся списки кластеров
+    lighting_.update(frame, lights_, uboCpu_.view);
+
+    // GPU закончил кадр этого слота -> его culling-статистика готова
+    cullStats_ = culler_.readStats(frame);
+
+    uint32_t objectCount = (uint32_t)std::min<size_t>(objects_.size(), OcclusionCuller::MAX_OBJECTS);
+    OcclusionCuller::GpuObject* gpuObjs = culler_.objects(frame);
+
+    // LOD по экранной ошибке -> диапазон индексов, который и отдаём culler'у
+    lod_.setView(cameraPos_, uboCpu_.proj.m[5], (float)swapchain_.extent().height);
+    lod_.resize(objectCount);
+    objectLods_.resize(objectCount);
+    lodStats_ = {};
+    lodStats_.objects = objectCount;
+
+    // CPU frustum culling: SoA AABB -> список видимых; GPU-culler всё равно проверит остальное
+    auto cullStart = std::chrono::steady_clock::now();
+    objectVisible_.assign(objectCount, cpuCulling_ ? 0 : 1);
+    if (cpuCulling_) {
+        PROFILE_SCOPE("draw.cpuCull");
+        objectBounds_.clear();
+        objectBounds_.reserve(objectCount);
+        for (uint32_t i = 0; i < objectCount; ++i) objectBounds_.push(objects_[i].boundsMin, objects_[i].boundsMax);
+        frustumCuller_.cullAabbs(Frustum::fromViewProj(viewProj_), objectBounds_, visibleObjects_);
+        for (uint32_t i : visibleObjects_) objectVisible_[i] = 1;
+    }
+    cpuCullStats_.objects = objectCount;
+    cpuCullStats_.visible = cpuCulling_ ? (uint32_t)visibleObjects_.size() : objectCount;
+    cpuCullStats_.ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - cullStart).count();
+    PROFILE_COUNTER("visible objects", cpuCullStats_.visible);
+
+
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        const RenderObject& o = objects_[i];
+        const PropMesh& pm = propMeshes_[o.mesh < propMeshes_.size() ? o.mesh : 0];
+
+        Vec3 center = (o.boundsMin + o.boundsMax) * 0.5f;
+        float scale = 0.0f;
+        for (int c = 0; c < 3; ++c)
+            scale = std::max(scale, length(Vec3{ o.model.m[c * 4 + 0], o.model.m[c * 4 + 1], o.model.m[c * 4 + 2] }));
+        uint32_t lod = lod_.select(i, pm.lods.data(), pm.lodCount, center, pm.radius * scale, scale);
+        objectLods_[i] = (uint8_t)lod;
+
+        // LOD выбираем и для невидимых: их тени рисуются тем же уровнем
+        const bool visible = objectVisible_[i] != 0;
+        if (visible) {
+            lodStats_.trianglesSubmitted += pm.lods[lod].indexCount / 3;
+            lodStats_.trianglesAvailable += pm.lods[0].indexCount / 3;
+            lodStats_.perLevel[lod]++;
+        }
+
+        OcclusionCuller::GpuObject& g = gpuObjs[i];
+        g.aabbMin[0] = o.boundsMin.x; g.aabbMin[1] = o.boundsMin.y; g.aabbMin[2] = o.boundsMin.z; g.aabbMin[3] = 1.0f;
+        g.aabbMax[0] = o.boundsMax.x; g.aabbMax[1] = o.boundsMax.y; g.aabbMax[2] = o.boundsMax.z; g.aabbMax[3] = 1.0f;
+        g.indexCount = visible ? pm.lods[lod].indexCount : 0;
+        g.firstIndex = pm.lods[lod].indexOffset;
+        g.vertexOffset = pm.vertexOffset;
+        g.pad = 0;
+    }
+    culler_.setFrameParams(frame, viewProj_, objectCount);
+
+    // meshlet'ы карты: та же пирамида и те же фазы, что у объектов
+    meshletStats_ = meshlets_.readStats(frame);
+    const bool meshletCull = meshletCulling_ && meshlets_.hasMesh();
+    if (meshletCull) {
+        meshlets_.setFrameParams(frame, Mat4::identity(), viewProj_, cameraPos_,
+            culler_.pyramidViewProj(), culler_.pyramidExtent(), culler_.pyramidMips(), culler_.pyramidUsable());
+    } else {
+        meshlets_.skipFrame(frame);
+    }
 
     // 6) записываем командный буфер для frame-слота, но framebuffer берём по imageIndex
     VkCommandBuffer cmd = cmd_[frame];
@@ -636,6 +773,28 @@ bool Renderer::drawFrame(VulkanContext& vk) {
     VkCommandBufferBeginInfo bi{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
     vkBeginCommandBuffer(cmd, &bi);
 
+    if (timestampPool_) {
+        vkCmdResetQueryPool(cmd, timestampPool_, frame * 2, 2);
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampPool_, frame * 2);
+    }
+
+    // early cull: frustum + пирамида прошлого кадра
+    culler_.recordBeginFrame(cmd, frame);
+    culler_.recordCull(cmd, frame, OcclusionCuller::Phase::Early);
+    if (meshletCull) {
+        meshlets_.recordBeginFrame(cmd, frame);
+        meshlets_.recordCull(cmd, frame, OcclusionCuller::Phase::Early);
+    }
+
+
+    // списки источников по кластерам (compute или копия CPU-результата)
+    lighting_.recordAssign(cmd, frame);
+
+    // каскады теней, которым нужно обновление (ближний — каждый кадр)
+    drawShadows(cmd);
+
+
+
     VkClearValue clears[2]{};
     clears[0].color.float32[0] = 0.05f;
     clears[0].color.float32[1] = 0.07f;
@@ -670,36 +829,77 @@ bool Renderer::drawFrame(VulkanContext& vk) {
     vkCmdSetScissor(cmd, 0, 1, &scissor);
 
     // Descriptor set — по frame-слоту (как было)
+    const VkPipelineLayout layout = gpu_.layout(pipelineTriangles_);
     vkCmdBindDescriptorSets(
         cmd,
         VK_PIPELINE_BIND_POINT_GRAPHICS,
-        pipelineLayout_,
+        layout,
         0, 1, &descSet_[frame],
         0, nullptr
     );
 
     // ----- 1) GRID (lines) -----
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLines_);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, gpu_.pipeline(pipelineLines_));
 
     VkDeviceSize off = 0;
-    vkCmdBindVertexBuffers(cmd, 0, 1, &gridVb_, &off);
-    vkCmdBindIndexBuffer(cmd, gridIb_, 0, VK_INDEX_TYPE_UINT32);
+    VkBuffer gridVb = gpu_.buffer(gridVb_);
+    vkCmdBindVertexBuffers(cmd, 0, 1, &gridVb, &off);
+    vkCmdBindIndexBuffer(cmd, gpu_.buffer(gridIb_), 0, VK_INDEX_TYPE_UINT32);
 
     Mat4 gridModel = Mat4::identity();
-    vkCmdPushConstants(cmd, pipelineLayout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4), &gridModel);
+    vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4), &gridModel);
     vkCmdDrawIndexed(cmd, gridIndexCount_, 1, 0, 0, 0);
 
-    // ----- 2) CUBE (triangles) -----
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineTriangles_);
+    // ----- FLOOR (triangles) -----
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, gpu_.pipeline(pipelineTriangles_));
+    VkBuffer floorVb = gpu_.buffer(floorVb_);
+    vkCmdBindVertexBuffers(cmd, 0, 1, &floorVb, &off);
+    vkCmdBindIndexBuffer(cmd, gpu_.buffer(floorIb_), 0, VK_INDEX_TYPE_UINT32);
+    vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4), &gridModel);
+    vkCmdDrawIndexed(cmd, floorIndexCount_, 1, 0, 0, 0);
 
-    vkCmdBindVertexBuffers(cmd, 0, 1, &cubeVb_, &off);
-    vkCmdBindIndexBuffer(cmd, cubeIb_, 0, VK_INDEX_TYPE_UINT32);
+    // ----- MAP (meshlet'ы, прошедшие early cull; без culling'а — весь меш) -----
+    if (meshletCull) meshlets_.draw(cmd, frame, OcclusionCuller::Phase::Early);
+    else meshlets_.drawAll(cmd);
 
-    vkCmdPushConstants(cmd, pipelineLayout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4), &cubeModel_);
-    vkCmdDrawIndexed(cmd, cubeIndexCount_, 1, 0, 0, 0);
 
+    // ----- 2) OBJECTS (triangles), прошедшие early cull -----
+    drawObjects(cmd, frame, OcclusionCuller::Phase::Early);
 
     vkCmdEndRenderPass(cmd);
+
+    // ----- Hi-Z из глубины этого кадра + late cull -----
+    culler_.recordBuildPyramid(cmd);
+    culler_.recordCull(cmd, frame, OcclusionCuller::Phase::Late);
+    if (meshletCull) meshlets_.recordCull(cmd, frame, OcclusionCuller::Phase::Late);
+
+    // ----- late pass: дорисовываем объекты, которые только что открылись -----
+    rbi.renderPass = renderPassLate_;
+    rbi.clearValueCount = 0;
+    rbi.pClearValues = nullptr;
+    vkCmdBeginRenderPass(cmd, &rbi, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+    vkCmdBindDescriptorSets(
+        cmd,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        layout,
+        0, 1, &descSet_[frame],
+        0, nullptr
+    );
+    if (meshletCull) {
+        Mat4 mapModel = Mat4::identity();
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, gpu_.pipeline(pipelineTriangles_));
+        vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4), &mapModel);
+        meshlets_.draw(cmd, frame, OcclusionCuller::Phase::Late);
+    }
+    drawObjects(cmd, frame, OcclusionCuller::Phase::Late);
+    vkCmdEndRenderPass(cmd);
+
+    if (timestampPool_) {
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampPool_, frame * 2 + 1);
+        timestampsWritten_[frame] = true;
+    }
     vkEndCommandBuffer(cmd);
 
     // 7) submit
@@ -714,8 +914,11 @@ bool Renderer::drawFrame(VulkanContext& vk) {
     submit.signalSemaphoreCount = 1;
     submit.pSignalSemaphores = &renderFinished_[frame];
 
-    if (!vk_ok(vkQueueSubmit(vk.graphicsQueue(), 1, &submit, inFlightFences_[frame]), "vkQueueSubmit failed"))
-        return false;
+    {
+        PROFILE_SCOPE("draw.submit");
+        if (!vk_ok(vkQueueSubmit(vk.graphicsQueue(), 1, &submit, inFlightFences_[frame]), "vkQueueSubmit failed"))
+            return false;
+    }
 
     // 8) present
     VkPresentInfoKHR pi{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
@@ -726,7 +929,11 @@ bool Renderer::drawFrame(VulkanContext& vk) {
     pi.pSwapchains = &sc;
     pi.pImageIndices = &imageIndex;
 
-    VkResult pres = vkQueuePresentKHR(vk.presentQueue(), &pi);
+    VkResult pres = VK_SUCCESS;
+    {
+        PROFILE_SCOPE("draw.present");
+        pres = vkQueuePresentKHR(vk.presentQueue(), &pi);
+    }
 
     if (pres == VK_ERROR_OUT_OF_DATE_KHR) { std::cout << "PRES: OUT_OF_DATE\n"; return false; }
     if (pres == VK_SUBOPTIMAL_KHR) { std::cout << "PRES: SUBOPTIMAL\n"; return false; } // или не возвращать — см. ниже
@@ -749,18 +956,167 @@ void Renderer::shutdown(VulkanContext& vk) {
     }
 
     if (cmdPool_) vkDestroyCommandPool(vk.device(), cmdPool_, nullptr);
+    if (timestampPool_) vkDestroyQueryPool(vk.device(), timestampPool_, nullptr);
+    timestampPool_ = VK_NULL_HANDLE;
 
+    culler_.shutdown(vk);
+    meshlets_.shutdown(vk);
+    lighting_.shutdown(vk);
+    shadows_.shutdown(vk);
     destroyMeshBuffers(vk);
     destroyPipeline(vk);
     destroyDescriptors(vk);
     destroyUniform(vk);
 
     cleanupSwapchainDependent(vk);
+    gpu_.shutdown(); // устройство простаивает; всё, что осталось, — утечка
 }
 
 void Renderer::setViewProj(const Mat4& view, const Mat4& proj) {
     uboCpu_.view = view;
     uboCpu_.proj = proj;
+    viewProj_ = Mat4::mul(proj, view);
+
+    // view — поворот + перенос: eye = -R^T * t
+    const float* m = view.m;
+    cameraPos_ = {
+        -(m[0] * m[12] + m[1] * m[13] + m[2] * m[14]),
+        -(m[4] * m[12] + m[5] * m[13] + m[6] * m[14]),
+        -(m[8] * m[12] + m[9] * m[13] + m[10] * m[14]),
+    };
+}
+
+void Renderer::lateLatchCamera() {
+    uint64_t inputTime = packetInputTime_;
+    Mat4 view = uboCpu_.view;
+    bool latched = lateLatch_ && latch_ && latch_->latch(cameraPos_, view, inputTime);
+    if (latched) setViewProj(view, uboCpu_.proj);
+
+    if (packetInputTime_ == 0) return;
+    uint64_t now = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    float packetMs = (float)(now - packetInputTime_) * 1e-6f;
+    float latchedMs = (float)(now - inputTime) * 1e-6f;
+
+    // скользящее среднее: отдельный кадр шумит на величину jitter'а acquire
+    LatencyStats& ls = latencyStats_;
+    const float k = ls.frames == 0 ? 1.0f : 0.05f;
+    ls.packetMs += (packetMs - ls.packetMs) * k;
+    ls.latchedMs += (latchedMs - ls.latchedMs) * k;
+    ls.frames++;
+    if (latched) ls.latchedFrames++;
+}
+
+bool Renderer::applyPacket(RenderPacket& packet) {
+    setViewProj(packet.view, packet.proj);
+    packetInputTime_ = packet.inputTime;
+    objects_.swap(packet.objects);
+    lights_.swap(packet.lights);
+    shadows_.setSunDirection(packet.sunDir);
+
+    const RenderSettings& s = packet.settings;
+    culler_.setOcclusionEnabled(s.occlusionCulling);
+    meshletCulling_ = s.meshletCulling;
+    lod_.setEnabled(s.lod);
+    cpuCulling_ = s.cpuCulling;
+    lighting_.setGpuAssign(s.gpuLightAssign);
+    lateLatch_ = s.lateLatch;
+
+    if (s.presentMode == swapchain_.preferredPresentMode()) return false;
+    swapchain_.setPreferredPresentMode(s.presentMode);
+    return true;
+}
+
+RenderSettings Renderer::settings() const {
+    RenderSettings s;
+    s.occlusionCulling = culler_.occlusionEnabled();
+    s.meshletCulling = meshletCulling_;
+    s.lod = lod_.enabled();
+    s.cpuCulling = cpuCulling_;
+    s.gpuLightAssign = lighting_.gpuAssign();
+    s.lateLatch = lateLatch_;
+    s.presentMode = swapchain_.preferredPresentMode();
+    return s;
+}
+
+RenderStats Renderer::stats() const {
+    RenderStats s;
+    s.cull = cullStats_;
+    s.meshlets = meshletStats_;
+    s.cpuCull = cpuCullStats_;
+    s.lod = lodStats_;
+    s.shadows = shadowStats_;
+    s.lighting = lighting_.stats();
+    s.latency = latencyStats_;
+    s.gpuMs = gpuFrameMs_;
+    return s;
+}
+
+void Renderer::drawObjects(VkCommandBuffer cmd, uint32_t frame, OcclusionCuller::Phase phase) {
+    uint32_t count = (uint32_t)std::min<size_t>(objects_.size(), OcclusionCuller::MAX_OBJECTS);
+    if (count == 0) return;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, gpu_.pipeline(pipelineTriangles_));
+    const VkPipelineLayout layout = gpu_.layout(pipelineTriangles_);
+
+    VkDeviceSize off = 0;
+    VkBuffer propVb = gpu_.buffer(propVb_);
+    vkCmdBindVertexBuffers(cmd, 0, 1, &propVb, &off);
+    vkCmdBindIndexBuffer(cmd, gpu_.buffer(propIb_), 0, VK_INDEX_TYPE_UINT32);
+
+    // instanceCount каждой команды выставил cull-шейдер (0 = отброшен);
+    // отброшенные CPU frustum culling'ом не записываем вовсе
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!objectVisible_[i]) continue;
+        vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4), &objects_[i].model);
+        culler_.drawObject(cmd, frame, phase, i);
+    }
+}
+
+void Renderer::drawShadows(VkCommandBuffer cmd) {
+    shadowStats_ = {};
+    VkDeviceSize off = 0;
+    VkBuffer floorVb = gpu_.buffer(floorVb_), propVb = gpu_.buffer(propVb_);
+    uint32_t objectCount = (uint32_t)std::min<size_t>(objects_.size(), OcclusionCuller::MAX_OBJECTS);
+
+    for (uint32_t c = 0; c < CascadedShadows::CASCADES; ++c) {
+        if (!shadows_.needsRender(c)) continue;
+
+        const Mat4& lightVP = shadows_.cascadeViewProj(c);
+        shadows_.beginCascade(cmd, c);
+
+        // пол — статика карты
+        vkCmdBindVertexBuffers(cmd, 0, 1, &floorVb, &off);
+        vkCmdBindIndexBuffer(cmd, gpu_.buffer(floorIb_), 0, VK_INDEX_TYPE_UINT32);
+        vkCmdPushConstants(cmd, shadows_.pipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4), &lightVP);
+        vkCmdDrawIndexed(cmd, floorIndexCount_, 1, 0, 0, 0);
+        shadowStats_.casters++;
+
+        // карта целиком (meshlet culling тут не применяется: каскад смотрит с другой стороны)
+        if (meshlets_.hasMesh()) {
+            meshlets_.drawAll(cmd);
+            shadowStats_.casters++;
+        }
+
+
+        vkCmdBindVertexBuffers(cmd, 0, 1, &propVb, &off);
+        vkCmdBindIndexBuffer(cmd, gpu_.buffer(propIb_), 0, VK_INDEX_TYPE_UINT32);
+        for (uint32_t i = 0; i < objectCount; ++i) {
+            const RenderObject& o = objects_[i];
+            if (CascadedShadows::staticOnly(c) && !o.isStatic) continue;
+            if (!shadows_.casterVisible(c, o.boundsMin, o.boundsMax)) continue;
+
+            Mat4 mvp = Mat4::mul(lightVP, o.model);
+            vkCmdPushConstants(cmd, shadows_.pipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4), &mvp);
+            const PropMesh& pm = propMeshes_[o.mesh < propMeshes_.size() ? o.mesh : 0];
+            const MeshLod& lod = pm.lods[objectLods_[i]];
+            vkCmdDrawIndexed(cmd, lod.indexCount, 1, lod.indexOffset, pm.vertexOffset, 0);
+            shadowStats_.casters++;
+        }
+
+        shadows_.endCascade(cmd, c);
+        shadowStats_.cascadesRendered++;
+    }
 }
 
 bool Renderer::createPipeline(VulkanContext& vk) {
@@ -839,7 +1195,8 @@ bool Renderer::createPipeline(VulkanContext& vk) {
     pli.pSetLayouts = &descSetLayout_;
     pli.pushConstantRangeCount = 1;
     pli.pPushConstantRanges = &pcr;
-    if (vkCreatePipelineLayout(vk.device(), &pli, nullptr, &pipelineLayout_) != VK_SUCCESS) {
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    if (vkCreatePipelineLayout(vk.device(), &pli, nullptr, &layout) != VK_SUCCESS) {
         vkDestroyShaderModule(vk.device(), vertMod, nullptr);
         vkDestroyShaderModule(vk.device(), fragMod, nullptr);
         return false;
@@ -863,39 +1220,35 @@ bool Renderer::createPipeline(VulkanContext& vk) {
     pi.pMultisampleState = &ms;
     pi.pColorBlendState = &cb;
     pi.pDynamicState = &dyn;
-    pi.layout = pipelineLayout_;
+    pi.layout = layout;
     pi.renderPass = renderPass_;
     pi.subpass = 0;
 
     // --- triangles ---
     ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    VkResult r1 = vkCreateGraphicsPipelines(vk.device(), VK_NULL_HANDLE, 1, &pi, nullptr, &pipelineTriangles_);
+    VkPipeline triangles = VK_NULL_HANDLE;
+    VkResult r1 = vkCreateGraphicsPipelines(vk.device(), VK_NULL_HANDLE, 1, &pi, nullptr, &triangles);
     if (r1 != VK_SUCCESS) {
         vkDestroyShaderModule(vk.device(), vertMod, nullptr);
         vkDestroyShaderModule(vk.device(), fragMod, nullptr);
+        vkDestroyPipelineLayout(vk.device(), layout, nullptr);
         return false;
     }
+    pipelineTriangles_ = gpu_.addPipeline(triangles, layout, true, "triangles");
 
     // --- lines ---
     ia.topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
-    VkResult r2 = vkCreateGraphicsPipelines(vk.device(), VK_NULL_HANDLE, 1, &pi, nullptr, &pipelineLines_);
+    VkPipeline lines = VK_NULL_HANDLE;
+    VkResult r2 = vkCreateGraphicsPipelines(vk.device(), VK_NULL_HANDLE, 1, &pi, nullptr, &lines);
     vkDestroyShaderModule(vk.device(), vertMod, nullptr);
     vkDestroyShaderModule(vk.device(), fragMod, nullptr);
-
-    return r2 == VK_SUCCESS;
+    if (r2 != VK_SUCCESS) return false;
+    pipelineLines_ = gpu_.addPipeline(lines, layout, false, "lines");
+    return true;
 }
 
-void Renderer::destroyPipeline(VulkanContext& vk) {
-    if (pipelineTriangles_) {
-        vkDestroyPipeline(vk.device(), pipelineTriangles_, nullptr);
-        pipelineTriangles_ = VK_NULL_HANDLE;
-    }
-    if (pipelineLines_) {
-        vkDestroyPipeline(vk.device(), pipelineLines_, nullptr);
-        pipelineLines_ = VK_NULL_HANDLE;
-    }
-    if (pipelineLayout_) {
-        vkDestroyPipelineLayout(vk.device(), pipelineLayout_, nullptr);
-        pipelineLayout_ = VK_NULL_HANDLE;
-    }
+void Renderer::destroyPipeline(VulkanContext&) {
+    // layout уничтожится вместе с pipelineTriangles_ (и не раньше pipeline'ов: очередь gpu_ их упорядочивает)
+    gpu_.destroy(pipelineLines_);
+    gpu_.destroy(pipelineTriangles_);
 }
@@ -1,8 +1,17 @@
 #pragma once
 #include "renderer/VulkanContext.h"
 #include "renderer/Swapchain.h"
+#include "renderer/GpuResources.h"
+#include "renderer/OcclusionCuller.h"
+#include "renderer/ClusteredLighting.h"
+#include "renderer/CascadedShadows.h"
+#include "renderer/MeshletCuller.h"
+#include "renderer/LodSelector.h"
+#include "renderer/FrustumCuller.h"
+#include "renderer/RenderPacket.h"
 #include <vulkan/vulkan.h>
 #include "math/Mat4.h"
+#include "math/Vec3.h"
 #include <vector>
 #include <string>
 #include <array>
@@ -18,14 +27,67 @@ public:
 	//  1 : clear + present
 	bool drawFrame(VulkanContext& vk);
 	void setViewProj(const Mat4& view, const Mat4& proj);
-	void setCubeModel(const Mat4& m) { cubeModel_ = m; }
+	void setObjects(const std::vector<RenderObject>& objs) { objects_ = objs; }
+
+	//    game-: , , , , .
+	//    swap' (    ).
+	// true ->  present mode,   swapchain
+	bool applyPacket(RenderPacket& packet);
+	RenderSettings settings() const;
+	RenderStats stats() const;
+
+	//  culling    GPU 
+	const CullStats& cullStats() const { return cullStats_; }
+	void setOcclusionCulling(bool e) { culler_.setOcclusionEnabled(e); }
+	bool occlusionCulling() const { return culler_.occlusionEnabled(); }
+
+	//    (meshlet'), culling  meshlet'  GPU
+	bool setMapMesh(VulkanContext& vk, const MeshData& mesh);
+	const MeshletStats& meshletStats() const { return meshletStats_; }
+	void setMeshletCulling(bool e) { meshletCulling_ = e; }
+	bool meshletCulling() const { return meshletCulling_; }
+
+	// prop-  LOD-   vertex/index ; id -> RenderObject::mesh
+	uint32_t addPropMesh(VulkanContext& vk, const MeshData& mesh);
+	const LodStats& lodStats() const { return lodStats_; }
+	void setLod(bool e) { lod_.setEnabled(e); }
+	bool lodEnabled() const { return lod_.enabled(); }
+
+	// CPU frustum culling   GPU-culler' (   indexCount = 0)
+	const CpuCullStats& cpuCullStats() const { return cpuCullStats_; }
+	void setCpuCulling(bool e) { cpuCulling_ = e; }
+	bool cpuCulling() const { return cpuCulling_; }
+
+	// late latch  (nullptr = ); latch  ,   
+	void setCameraLatch(CameraLatch* latch) { latch_ = latch; }
+	const LatencyStats& latencyStats() const { return latencyStats_; }
+
+
+
+	//   (world space),  ClusteredLighting::MAX_LIGHTS
+	void setLights(const std::vector<PointLight>& lights) { lights_ = lights; }
+	const LightingStats& lightingStats() const { return lighting_.stats(); }
+	void setGpuLightAssign(bool e) { lighting_.setGpuAssign(e); }
+	bool gpuLightAssign() const { return lighting_.gpuAssign(); }
+
+	//  (  , world)   
+	void setSunDirection(const Vec3& toSun) { shadows_.setSunDirection(toSun); }
+	void setShadows(bool e) { shadows_.setEnabled(e); }
+	bool shadowsEnabled() const { return shadows_.enabled(); }
+	void invalidateStaticShadows() { shadows_.invalidateStatic(); }
+	const ShadowStats& shadowStats() const { return shadowStats_; }
 
 	void setPreferredPresentMode(Swapchain::PresentMode m) { swapchain_.setPreferredPresentMode(m); }
 	Swapchain::PresentMode preferredPresentMode() const { return swapchain_.preferredPresentMode(); }
 	VkPresentModeKHR chosenVkPresentMode() const { return swapchain_.chosenVkPresentMode(); }
 
+	//  GPU-    fence  
+	GpuResourceStats gpuResourceStats() const { return gpu_.stats(); }
+
 private:
 	bool createRenderPass(VulkanContext& vk);
+	void drawObjects(VkCommandBuffer cmd, uint32_t frame, OcclusionCuller::Phase phase);
+	void drawShadows(VkCommandBuffer cmd);
 	bool createFramebuffers(VulkanContext& vk);
 	bool createCommandResources(VulkanContext& vk);
 	bool createSync(VulkanContext& vk);
@@ -45,18 +107,19 @@ private:
 	bool createDescriptors(VulkanContext& vk);
 	void destroyDescriptors(VulkanContext& vk);
 
+	// , depth  pipeline' ;    fence 
+	GpuResources gpu_;
+
 	VkFormat depthFormat_{ VK_FORMAT_UNDEFINED };
-	VkImage depthImage_{ VK_NULL_HANDLE };
-	VkDeviceMemory depthMemory_{ VK_NULL_HANDLE };
-	VkImageView depthView_{ VK_NULL_HANDLE };
+	ImageHandle depth_;
 
-	VkPipelineLayout pipelineLayout_{ VK_NULL_HANDLE };
-	VkPipeline pipelineTriangles_{ VK_NULL_HANDLE };
-	VkPipeline pipelineLines_{ VK_NULL_HANDLE };
+	PipelineHandle pipelineTriangles_; //   pipeline layout
+	PipelineHandle pipelineLines_;
 
 	Swapchain swapchain_;
 
-	VkRenderPass renderPass_{ VK_NULL_HANDLE };
+	VkRenderPass renderPass_{ VK_NULL_HANDLE };     // early: clear, depth -> read-only  Hi-Z
+	VkRenderPass renderPassLate_{ VK_NULL_HANDLE }; // late: load,    + present
 	std::vector<VkFramebuffer> framebuffers_;
 
 	VkCommandPool cmdPool_{ VK_NULL_HANDLE };
@@ -69,13 +132,17 @@ private:
 	std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> renderFinished_{};
 	std::array<VkFence, MAX_FRAMES_IN_FLIGHT> inFlightFences_{};
 
+	// GPU-  (timestamp-,    frame-;   -> VK_NULL_HANDLE)
+	VkQueryPool timestampPool_{ VK_NULL_HANDLE };
+	float timestampPeriodNs_ = 1.0f;
+	std::array<bool, MAX_FRAMES_IN_FLIGHT> timestampsWritten_{};
+	float gpuFrameMs_ = 0.0f;
+
 	// per-frame command buffers
 	std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> cmd_{};
 
 	// per-frame UBO
-	std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> uboBuffer_{};
-	std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> uboMemory_{};
-	std::array<void*, MAX_FRAMES_IN_FLIGHT> uboMapped_{};
+	std::array<BufferHandle, MAX_FRAMES_IN_FLIGHT> ubo_{}; //  
 
 	// descriptors
 	VkDescriptorSetLayout descSetLayout_{ VK_NULL_HANDLE };
@@ -85,35 +152,82 @@ private:
 	// track swapchain images
 	std::vector<VkFence> imagesInFlight_;
 
-	Mat4 cubeModel_ = Mat4::identity();
+	std::vector<RenderObject> objects_;
+
+	OcclusionCuller culler_;
+	CullStats cullStats_;
+	Mat4 viewProj_ = Mat4::identity();
+
+	std::vector<PointLight> lights_;
+	ClusteredLighting lighting_;
+
+	CascadedShadows shadows_;
+	ShadowStats shadowStats_;
+
+	MeshletCuller meshlets_;
+	MeshletStats meshletStats_;
+	bool meshletCulling_ = true;
+	Vec3 cameraPos_;
 
 	struct UBO {
 		Mat4 view;
 		Mat4 proj;
+		ClusteredLighting::GridParams cluster;
+		CascadedShadows::GpuParams shadow;
 	} uboCpu_;
 
-	struct Vertex {
-		float pos[3];
-		float color[3];
+	//   layout,   MeshVertex (     pipeline)
+	using Vertex = MeshVertex;
+
+	// Props (triangles):  prop-   LOD'   vertex/index , 0 = 
+	struct PropMesh {
+		int32_t vertexOffset = 0;
+		uint32_t lodCount = 0;
+		std::array<MeshLod, MAX_MESH_LODS> lods{}; // indexOffset    index buffer
+		float radius = 0.0f;                      //     bounds
 	};
+	std::vector<PropMesh> propMeshes_;
+	std::vector<Vertex> propVertices_;
+	std::vector<uint32_t> propIndices_;
+	BufferHandle propVb_;
+	BufferHandle propIb_;
+
+	uint32_t appendPropMesh(const MeshData& mesh);
+	bool uploadPropBuffers(VulkanContext& vk);
+
+	// LOD   (   GpuObject,   )
+	LodSelector lod_;
+	LodStats lodStats_;
+	std::vector<uint8_t> objectLods_;
+
+	FrustumCuller frustumCuller_;
+	AabbSoA objectBounds_;
+	std::vector<uint32_t> visibleObjects_;
+	std::vector<uint8_t> objectVisible_;
+	CpuCullStats cpuCullStats_;
+	bool cpuCulling_ = true;
+
+	// late latch: view       UBO
+	void lateLatchCamera();
+	CameraLatch* latch_ = nullptr;
+	bool lateLatch_ = true;
+	uint64_t packetInputTime_ = 0;
+	LatencyStats latencyStats_;
 
-	// Cube (triangles)
-	VkBuffer cubeVb_{ VK_NULL_HANDLE };
-	VkDeviceMemory cubeVbMem_{ VK_NULL_HANDLE };
-	VkBuffer cubeIb_{ VK_NULL_HANDLE };
-	VkDeviceMemory cubeIbMem_{ VK_NULL_HANDLE };
-	uint32_t cubeIndexCount_{ 0 };
 
 	// Grid (lines)
-	VkBuffer gridVb_{ VK_NULL_HANDLE };
-	VkDeviceMemory gridVbMem_{ VK_NULL_HANDLE };
-	VkBuffer gridIb_{ VK_NULL_HANDLE };
-	VkDeviceMemory gridIbMem_{ VK_NULL_HANDLE };
+	BufferHandle gridVb_;
+	BufferHandle gridIb_;
 	uint32_t gridIndexCount_{ 0 };
 
+	// Floor (triangles,  ;  )
+	BufferHandle floorVb_;
+	BufferHandle floorIb_;
+	uint32_t floorIndexCount_{ 0 };
+
 	bool createMeshBuffers(VulkanContext& vk);
 	void destroyMeshBuffers(VulkanContext& vk);
 
 	static VkVertexInputBindingDescription bindingDesc();
-	static std::array<VkVertexInputAttributeDescription, 2> attrDescs();
+	static std::array<VkVertexInputAttributeDescription, 3> attrDescs();
 };
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "renderer/VkUtils.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+// учёт памяти устройства; выделения редкие (загрузка, ресайз) — хватает мьютекса
+struct DeviceMemoryTracker {
+    struct Allocation {
+        VkDeviceSize size;
+        uint32_t heap;
+        std::string name;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<VkDeviceMemory, Allocation> live;
+    VkPhysicalDeviceMemoryProperties props{};
+    bool hasProps = false;
+    DeviceMemoryStats stats;
+};
+
+DeviceMemoryTracker& deviceMemory() {
+    static DeviceMemoryTracker t;
+    return t;
+}
+}
+
+std::vector<char> readFile(const std::string& path) {
+    std::ifstream f(path, std::ios::ate | std::ios::binary);
+    if (!f) return {};
+    size_t size = (size_t)f.tellg();
+    std::vector<char> buf(size);
+    f.seekg(0);
+    f.read(buf.data(), size);
+    return buf;
+}
+
+VkShaderModule createShaderModule(VkDevice device, const std::vector<char>& code) {
+    if (code.empty()) return VK_NULL_HANDLE;
+
+    VkShaderModuleCreateInfo ci{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    ci.codeSize = code.size();
+    ci.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule m{};
+    if (vkCreateShaderModule(device, &ci, nullptr, &m) != VK_SUCCESS)
+        return VK_NULL_HANDLE;
+    return m;
+}
+
+uint32_t findMemoryType(VkPhysicalDevice phys, uint32_t typeFilter, VkMemoryPropertyFlags props) {
+    VkPhysicalDeviceMemoryProperties memProps{};
+    vkGetPhysicalDeviceMemoryProperties(phys, &memProps);
+
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+        if ((typeFilter & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & props) == props) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+VkDeviceMemory allocateDeviceMemory(VulkanContext& vk, const VkMemoryRequirements& req, VkMemoryPropertyFlags memProps,
+    const char* name) {
+    uint32_t memType = findMemoryType(vk.physicalDevice(), req.memoryTypeBits, memProps);
+    if (memType == UINT32_MAX) return VK_NULL_HANDLE;
+
+    VkMemoryAllocateInfo ai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    ai.allocationSize = req.size;
+    ai.memoryTypeIndex = memType;
+    VkDeviceMemory mem = VK_NULL_HANDLE;
+    if (vkAllocateMemory(vk.device(), &ai, nullptr, &mem) != VK_SUCCESS) return VK_NULL_HANDLE;
+
+    DeviceMemoryTracker& t = deviceMemory();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    if (!t.hasProps) {
+        vkGetPhysicalDeviceMemoryProperties(vk.physicalDevice(), &t.props);
+        t.stats.heapCount = t.props.memoryHeapCount;
+        for (uint32_t h = 0; h < t.props.memoryHeapCount; ++h) {
+            t.stats.heaps[h].size = t.props.memoryHeaps[h].size;
+            t.stats.heaps[h].deviceLocal = (t.props.memoryHeaps[h].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        }
+        t.hasProps = true;
+    }
+    const uint32_t heap = t.props.memoryTypes[memType].heapIndex;
+    DeviceMemoryHeapStats& hs = t.stats.heaps[heap];
+    hs.liveBytes += req.size;
+    hs.peakBytes = std::max(hs.peakBytes, hs.liveBytes);
+    hs.allocations++;
+    t.stats.liveBytes += req.size;
+    t.stats.peakBytes = std::max(t.stats.peakBytes, t.stats.liveBytes);
+    t.live[mem] = { req.size, heap, name ? name : "?" };
+    return mem;
+}
+
+void freeDeviceMemory(VkDevice device, VkDeviceMemory& mem) {
+    if (!mem) return;
+    vkFreeMemory(device, mem, nullptr);
+
+    DeviceMemoryTracker& t = deviceMemory();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    auto it = t.live.find(mem);
+    if (it != t.live.end()) {
+        DeviceMemoryHeapStats& hs = t.stats.heaps[it->second.heap];
+        hs.liveBytes -= it->second.size;
+        hs.allocations--;
+        t.stats.liveBytes -= it->second.size;
+        t.live.erase(it);
+    }
+    mem = VK_NULL_HANDLE;
+}
+
+DeviceMemoryStats deviceMemoryStats() {
+    DeviceMemoryTracker& t = deviceMemory();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    return t.stats;
+}
+
+void printDeviceMemoryReport(std::ostream& out) {
+    DeviceMemoryStats st;
+    std::vector<DeviceMemoryTracker::Allocation> largest;
+    {
+        DeviceMemoryTracker& t = deviceMemory();
+        std::lock_guard<std::mutex> lock(t.mutex);
+        st = t.stats;
+        largest.reserve(t.live.size());
+        for (const auto& kv : t.live) largest.push_back(kv.second);
+    }
+    const size_t top = std::min<size_t>(largest.size(), 8);
+    std::partial_sort(largest.begin(), largest.begin() + top, largest.end(),
+        [](const auto& a, const auto& b) { return a.size > b.size; });
+
+    const double MB = 1024.0 * 1024.0;
+    char line[160];
+    out << "memory (GPU device):\n";
+    for (uint32_t h = 0; h < st.heapCount; ++h) {
+        const DeviceMemoryHeapStats& hs = st.heaps[h];
+        std::snprintf(line, sizeof(line), "  heap %u (%s, %.0f MB): live %.2f MB, peak %.2f MB, %u allocations\n", h,
+            hs.deviceLocal ? "device local" : "host", hs.size / MB, hs.liveBytes / MB, hs.peakBytes / MB, hs.allocations);
+        out << line;
+    }
+    std::snprintf(line, sizeof(line), "  all: live %.2f MB, peak %.2f MB\n", st.liveBytes / MB, st.peakBytes / MB);
+    out << line;
+    for (size_t i = 0; i < top; ++i) {
+        std::snprintf(line, sizeof(line), "    %-24s %10.2f MB (heap %u)\n", largest[i].name.c_str(), largest[i].size / MB,
+            largest[i].heap);
+        out << line;
+    }
+}
+
+bool createBuffer(
+    VulkanContext& vk,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags memProps,
+    VkBuffer& outBuf,
+    VkDeviceMemory& outMem,
+    const char* name
+) {
+    VkBufferCreateInfo bi{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bi.size = size;
+    bi.usage = usage;
+    bi.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(vk.device(), &bi, nullptr, &outBuf) != VK_SUCCESS) return false;
+
+    VkMemoryRequirements req{};
+    vkGetBufferMemoryRequirements(vk.device(), outBuf, &req);
+
+    outMem = allocateDeviceMemory(vk, req, memProps, name);
+    if (!outMem) return false;
+    if (vkBindBufferMemory(vk.device(), outBuf, outMem, 0) != VK_SUCCESS) return false;
+
+    return true;
+}
+
+void destroyBuffer(VulkanContext& vk, VkBuffer& buf, VkDeviceMemory& mem) {
+    if (buf) { vkDestroyBuffer(vk.device(), buf, nullptr); buf = VK_NULL_HANDLE; }
+    freeDeviceMemory(vk.device(), mem);
+}
+
+VkImageView createImageView(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspect,
+    uint32_t baseMip, uint32_t mipCount) {
+    VkImageViewCreateInfo iv{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    iv.image = image;
+    iv.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    iv.format = format;
+    iv.subresourceRange.aspectMask = aspect;
+    iv.subresourceRange.baseMipLevel = baseMip;
+    iv.subresourceRange.levelCount = mipCount;
+    iv.subresourceRange.baseArrayLayer = 0;
+    iv.subresourceRange.layerCount = 1;
+
+    VkImageView view = VK_NULL_HANDLE;
+    if (vkCreateImageView(device, &iv, nullptr, &view) != VK_SUCCESS) return VK_NULL_HANDLE;
+    return view;
+}
+
+VkPipeline createComputePipeline(VkDevice device, const char* spvPath, VkPipelineLayout layout) {
+    VkShaderModule mod = createShaderModule(device, readFile(spvPath));
+    if (!mod) {
+        std::cerr << "Failed to load compute shader: " << spvPath << "\n";
+        return VK_NULL_HANDLE;
+    }
+
+    VkComputePipelineCreateInfo ci{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    ci.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    ci.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    ci.stage.module = mod;
+    ci.stage.pName = "main";
+    ci.layout = layout;
+
+    VkPipeline p = VK_NULL_HANDLE;
+    VkResult r = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &ci, nullptr, &p);
+    vkDestroyShaderModule(device, mod, nullptr);
+    if (r != VK_SUCCESS) return VK_NULL_HANDLE;
+    return p;
+}
+
+bool vk_ok(VkResult r, const char* msg) {
+    if (r != VK_SUCCESS) {
+        std::cerr << msg << " VkResult=" << r << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "renderer/VulkanContext.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <string>
+#include <iosfwd>
+
+// Общие хелперы для Vulkan-кода рендера (буферы, image view, шейдеры)
+
+std::vector<char> readFile(const std::string& path);
+VkShaderModule createShaderModule(VkDevice device, const std::vector<char>& code);
+
+uint32_t findMemoryType(VkPhysicalDevice phys, uint32_t typeFilter, VkMemoryPropertyFlags props);
+
+// Память устройства: все vkAllocateMemory/vkFreeMemory рендера идут через эти две функции —
+// учёт живых байт и пиков по кучам (пара к CPU-учёту core/MemoryTracker). name — для отчёта.
+VkDeviceMemory allocateDeviceMemory(VulkanContext& vk, const VkMemoryRequirements& req, VkMemoryPropertyFlags memProps,
+    const char* name);
+void freeDeviceMemory(VkDevice device, VkDeviceMemory& mem);
+
+struct DeviceMemoryHeapStats {
+	VkDeviceSize size = 0; // размер кучи
+	VkDeviceSize liveBytes = 0;
+	VkDeviceSize peakBytes = 0;
+	uint32_t allocations = 0; // живых
+	bool deviceLocal = false;
+};
+struct DeviceMemoryStats {
+	uint32_t heapCount = 0;
+	DeviceMemoryHeapStats heaps[VK_MAX_MEMORY_HEAPS];
+	VkDeviceSize liveBytes = 0;
+	VkDeviceSize peakBytes = 0;
+};
+DeviceMemoryStats deviceMemoryStats();
+// по кучам и самые большие живые выделения
+void printDeviceMemoryReport(std::ostream& out);
+
+bool createBuffer(
+    VulkanContext& vk,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags memProps,
+    VkBuffer& outBuf,
+    VkDeviceMemory& outMem,
+    const char* name = "buffer"
+);
+void destroyBuffer(VulkanContext& vk, VkBuffer& buf, VkDeviceMemory& mem);
+
+VkImageView createImageView(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspect,
+    uint32_t baseMip = 0, uint32_t mipCount = 1);
+
+// compute pipeline из одного .spv (пути относительно папки exe)
+VkPipeline createComputePipeline(VkDevice device, const char* spvPath, VkPipelineLayout layout);
+
+bool vk_ok(VkResult r, const char* msg);
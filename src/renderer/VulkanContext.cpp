@@ -73,7 +73,8 @@ bool VulkanContext::pickPhysicalDevice() {
 
         uint32_t g = UINT32_MAX, p = UINT32_MAX;
         for (uint32_t i = 0; i < qCount; i++) {
-            if (qprops[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) g = i;
+            // compute- (Hi-Z, culling)     graphics command buffer
+            if ((qprops[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && (qprops[i].queueFlags & VK_QUEUE_COMPUTE_BIT)) g = i;
 
             VkBool32 supportsPresent = VK_FALSE;
             vkGetPhysicalDeviceSurfaceSupportKHR(d, i, surface_, &supportsPresent);
@@ -0,0 +1,274 @@
+// darkwave_collisionbench: мир коллизий (game/CollisionWorld, BVH по боксам) против перебора всех боксов.
+//   darkwave_collisionbench [--count N] [--queries N]
+// Без --count — два прогона: 10k и 100k боксов (стены 0.2..6 м, 1% крупных 10..40 м) на поле 1 x 1 км.
+//   build   — построение в 1 поток (до jobSystem().init) и во все потоки;
+//   overlap — боксы, пересекающие AABB игрока (0.8 x 1.8 м) и AABB 10 м;
+//   closest — ближайшая точка не дальше 5 м;
+//   sweep   — бокс игрока, сдвинутый на 0.5 м (шаг кадра) и на 20 м (выстрел/рывок);
+//   capsule — капсула игрока (r 0.3, 1.8 м) по треугольникам боксов (12 на бокс): те же 0.5 и 20 м.
+// мкс/запрос у BVH и у перебора (капсула — перебор с отсевом по AABB, на каждом 10-м запросе).
+// Сверяет результаты с перебором.
+#include "game/CollisionWorld.h"
+#include "core/JobSystem.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+std::vector<AABB> randomWorld(uint32_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    std::vector<AABB> boxes(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const Vec3 c{ -500.0f + 1000.0f * u01(rng), 10.0f * u01(rng), -500.0f + 1000.0f * u01(rng) };
+        Vec3 h{ 0.1f + 2.9f * u01(rng), 0.1f + 2.9f * u01(rng), 0.1f + 2.9f * u01(rng) };
+        if (i % 100 == 0) h = h * 10.0f + Vec3{ 5.0f, 0.0f, 5.0f };
+        boxes[i] = { c - h, c + h };
+    }
+    return boxes;
+}
+
+bool strictOverlap(const AABB& a, const AABB& b) {
+    return a.min.x < b.max.x && b.min.x < a.max.x && a.min.y < b.max.y && b.min.y < a.max.y &&
+        a.min.z < b.max.z && b.min.z < a.max.z;
+}
+
+void bruteOverlap(const std::vector<AABB>& boxes, const AABB& q, std::vector<uint32_t>& out) {
+    out.clear();
+    for (uint32_t i = 0; i < (uint32_t)boxes.size(); ++i)
+        if (strictOverlap(boxes[i], q)) out.push_back(i);
+}
+
+float bruteClosest(const std::vector<AABB>& boxes, const Vec3& p, float maxDistance) {
+    float best = maxDistance * maxDistance;
+    bool found = false;
+    for (const AABB& b : boxes) {
+        const float dx = std::max(std::max(b.min.x - p.x, 0.0f), p.x - b.max.x);
+        const float dy = std::max(std::max(b.min.y - p.y, 0.0f), p.y - b.max.y);
+        const float dz = std::max(std::max(b.min.z - p.z, 0.0f), p.z - b.max.z);
+        const float d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 <= best) {
+            best = d2;
+            found = true;
+        }
+    }
+    return found ? std::sqrt(best) : -1.0f;
+}
+
+// доля пути до первого касания (1 — мимо), боксы, пересечённые в начале, пропускаются — как в sweep()
+float bruteSweep(const std::vector<AABB>& boxes, const AABB& box, const Vec3& delta) {
+    const float c[3] = { (box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f };
+    const float e[3] = { (box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f, (box.max.z - box.min.z) * 0.5f };
+    const float d[3] = { delta.x, delta.y, delta.z };
+    float best = 1.0f;
+    for (const AABB& b : boxes) {
+        const float lo[3] = { b.min.x - e[0], b.min.y - e[1], b.min.z - e[2] };
+        const float hi[3] = { b.max.x + e[0], b.max.y + e[1], b.max.z + e[2] };
+        float tNear = -FLT_MAX, tFar = FLT_MAX;
+        bool miss = false;
+        for (int a = 0; a < 3 && !miss; ++a) {
+            if (d[a] == 0.0f) {
+                miss = c[a] <= lo[a] || c[a] >= hi[a];
+                continue;
+            }
+            float t1 = (lo[a] - c[a]) / d[a], t2 = (hi[a] - c[a]) / d[a];
+            if (t1 > t2) std::swap(t1, t2);
+            tNear = std::max(tNear, t1);
+            tFar = std::min(tFar, t2);
+        }
+        if (miss || tNear >= tFar || tNear < 0.0f || tFar <= 0.0f) continue;
+        best = std::min(best, tNear);
+    }
+    return best;
+}
+
+// время касания капсулы перебором всех треугольников (отсев по AABB пути)
+float bruteCapsule(const std::vector<CollisionTriangle>& tris, const Capsule& c, const Vec3& delta, float skin) {
+    const float r = c.radius + 2.0f * skin;
+    const Vec3 c0{ std::min(c.a.x, c.b.x), std::min(c.a.y, c.b.y), std::min(c.a.z, c.b.z) };
+    const Vec3 c1{ std::max(c.a.x, c.b.x), std::max(c.a.y, c.b.y), std::max(c.a.z, c.b.z) };
+    const AABB path{
+        { std::min(c0.x, c0.x + delta.x) - r, std::min(c0.y, c0.y + delta.y) - r, std::min(c0.z, c0.z + delta.z) - r },
+        { std::max(c1.x, c1.x + delta.x) + r, std::max(c1.y, c1.y + delta.y) + r, std::max(c1.z, c1.z + delta.z) + r },
+    };
+    CapsuleHit hit;
+    for (const CollisionTriangle& t : tris) {
+        const AABB tb{ { std::min({ t.a.x, t.b.x, t.c.x }), std::min({ t.a.y, t.b.y, t.c.y }), std::min({ t.a.z, t.b.z, t.c.z }) },
+            { std::max({ t.a.x, t.b.x, t.c.x }), std::max({ t.a.y, t.b.y, t.c.y }), std::max({ t.a.z, t.b.z, t.c.z }) } };
+        if (tb.min.x > path.max.x || tb.max.x < path.min.x || tb.min.y > path.max.y || tb.max.y < path.min.y ||
+            tb.min.z > path.max.z || tb.max.z < path.min.z)
+            continue;
+        sweepCapsuleTriangle(c, delta, t, skin, hit);
+    }
+    return hit.t;
+}
+
+std::vector<CollisionTriangle> boxTriangles(const std::vector<AABB>& boxes) {
+    std::vector<CollisionTriangle> tris;
+    tris.reserve(boxes.size() * 12);
+    static const uint8_t faces[6][4] = {
+        { 0, 3, 2, 1 }, { 4, 5, 6, 7 }, { 0, 4, 7, 3 }, { 1, 2, 6, 5 }, { 0, 1, 5, 4 }, { 3, 7, 6, 2 },
+    };
+    for (const AABB& b : boxes) {
+        const Vec3 lo = b.min, hi = b.max;
+        const Vec3 v[8] = {
+            { lo.x, lo.y, lo.z }, { hi.x, lo.y, lo.z }, { hi.x, hi.y, lo.z }, { lo.x, hi.y, lo.z },
+            { lo.x, lo.y, hi.z }, { hi.x, lo.y, hi.z }, { hi.x, hi.y, hi.z }, { lo.x, hi.y, hi.z },
+        };
+        for (const auto& f : faces) {
+            tris.push_back({ v[f[0]], v[f[1]], v[f[2]] });
+            tris.push_back({ v[f[0]], v[f[2]], v[f[3]] });
+        }
+    }
+    return tris;
+}
+
+bool sameSet(std::vector<uint32_t> a, std::vector<uint32_t> b) {
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+struct Timing {
+    double bvh = 0.0;
+    double brute = 0.0;
+};
+
+bool run(uint32_t count, uint32_t queryCount) {
+    const std::vector<AABB> boxes = randomWorld(count, 1234u + count);
+
+    // 1 поток: задачи не ставятся, пока JobSystem не запущена
+    CollisionWorld world;
+    jobSystem().shutdown();
+    world.build(boxes.data(), count);
+    const float singleMs = world.stats().buildMs;
+    jobSystem().init();
+    world.build(boxes.data(), count);
+    const CollisionWorldStats st = world.stats();
+    std::printf("%u boxes: %u nodes, %u leaves, depth %u; %u triangles: %u nodes, depth %u | build 1 thread %.2f ms, "
+        "%u threads %.2f ms\n", count, st.nodes, st.leaves, st.depth, st.triangles, st.triangleNodes, st.triangleDepth,
+        singleMs, jobSystem().workerCount(), st.buildMs);
+    const std::vector<CollisionTriangle> tris = boxTriangles(boxes);
+
+    std::mt19937 rng(99u);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    const Vec3 player{ 0.4f, 0.9f, 0.4f };
+
+    bool ok = true;
+    std::vector<uint32_t> got, want;
+    Timing small, large, closest, step, dash, capStep, capDash;
+    size_t smallHits = 0, stepHits = 0;
+    uint32_t bruteCapsules = 0;
+    for (uint32_t i = 0; i < queryCount; ++i) {
+        const Vec3 c{ -500.0f + 1000.0f * u01(rng), 10.0f * u01(rng), -500.0f + 1000.0f * u01(rng) };
+
+        const AABB body{ c - player, c + player };
+        auto t0 = Clock::now();
+        world.overlap(body, got);
+        small.bvh += msSince(t0);
+        t0 = Clock::now();
+        bruteOverlap(boxes, body, want);
+        small.brute += msSince(t0);
+        ok = ok && sameSet(got, want);
+        smallHits += got.size();
+
+        const AABB area{ c - Vec3{ 5.0f, 5.0f, 5.0f }, c + Vec3{ 5.0f, 5.0f, 5.0f } };
+        t0 = Clock::now();
+        world.overlap(area, got);
+        large.bvh += msSince(t0);
+        t0 = Clock::now();
+        bruteOverlap(boxes, area, want);
+        large.brute += msSince(t0);
+        ok = ok && sameSet(got, want);
+
+        ClosestHit ch;
+        t0 = Clock::now();
+        const bool chFound = world.closestPoint(c, 5.0f, ch);
+        closest.bvh += msSince(t0);
+        t0 = Clock::now();
+        const float chWant = bruteClosest(boxes, c, 5.0f);
+        closest.brute += msSince(t0);
+        ok = ok && chFound == (chWant >= 0.0f) && (!chFound || std::fabs(ch.distance - chWant) < 1e-4f);
+
+        const float yaw = 6.2831853f * u01(rng);
+        const Vec3 dir{ std::cos(yaw), 0.2f * u01(rng) - 0.1f, std::sin(yaw) };
+        SweepHit sh;
+        for (float len : { 0.5f, 20.0f }) {
+            Timing& tm = len < 1.0f ? step : dash;
+            const Vec3 delta = dir * len;
+            t0 = Clock::now();
+            const bool shFound = world.sweep(body, delta, sh);
+            tm.bvh += msSince(t0);
+            t0 = Clock::now();
+            const float shWant = bruteSweep(boxes, body, delta);
+            tm.brute += msSince(t0);
+            ok = ok && shFound == (shWant < 1.0f) && std::fabs(sh.t - shWant) < 1e-5f;
+            if (len < 1.0f && shFound) stepHits++;
+        }
+
+        const Capsule capsule{ c - Vec3{ 0.0f, 0.6f, 0.0f }, c + Vec3{ 0.0f, 0.6f, 0.0f }, 0.3f };
+        const bool brute = i % 10 == 0;
+        bruteCapsules += brute ? 1 : 0;
+        CapsuleHit ch2;
+        for (float len : { 0.5f, 20.0f }) {
+            Timing& tm = len < 1.0f ? capStep : capDash;
+            const Vec3 delta = dir * len;
+            t0 = Clock::now();
+            const bool found = world.sweepCapsule(capsule, delta, 0.01f, ch2);
+            tm.bvh += msSince(t0);
+            if (!brute) continue;
+            t0 = Clock::now();
+            const float want = bruteCapsule(tris, capsule, delta, 0.01f);
+            tm.brute += msSince(t0);
+            ok = ok && found == (want < 1.0f) && std::fabs(ch2.t - want) < 1e-4f;
+        }
+    }
+
+    const double us = 1000.0 / queryCount;
+    std::printf("  overlap player %.3f us (brute %.1f us, %.2f hits) | overlap 10 m %.3f us (brute %.1f us)\n",
+        small.bvh * us, small.brute * us, (double)smallHits / queryCount, large.bvh * us, large.brute * us);
+    std::printf("  closest 5 m %.3f us (brute %.1f us) | sweep 0.5 m %.3f us (brute %.1f us, %.1f%% hit) | sweep 20 m %.3f us (brute %.1f us)\n",
+        closest.bvh * us, closest.brute * us, step.bvh * us, step.brute * us, 100.0 * stepHits / queryCount,
+        dash.bvh * us, dash.brute * us);
+    const double bruteUs = 1000.0 / std::max(1u, bruteCapsules);
+    std::printf("  capsule 0.5 m %.3f us (brute %.1f us) | capsule 20 m %.3f us (brute %.1f us)\n", capStep.bvh * us,
+        capStep.brute * bruteUs, capDash.bvh * us, capDash.brute * bruteUs);
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<uint32_t> counts = { 10000, 100000 };
+    uint32_t queryCount = 1000;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--count" && i + 1 < argc) counts = { (uint32_t)std::max(1, std::atoi(argv[++i])) };
+        else if (a == "--queries" && i + 1 < argc) queryCount = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "usage: darkwave_collisionbench [--count N] [--queries N]\n";
+            return 1;
+        }
+    }
+
+    bool ok = true;
+    for (uint32_t count : counts) ok = run(count, queryCount) && ok;
+    if (!ok) std::cerr << "collision world results differ from brute force\n";
+
+    jobSystem().shutdown();
+    return ok ? 0 : 1;
+}
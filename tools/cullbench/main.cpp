@@ -0,0 +1,122 @@
+// darkwave_cullbench: микробенчмарк CPU frustum culling.
+//   darkwave_cullbench [--iters N]
+// Объекты — случайные сферы/AABB в кубе 2 км, камера как в движке (lookAtRH + perspectiveRH_ZO),
+// видно ~25%. Для 1k / 100k / 1M объектов печатает ns на объект: скалярная ссылка,
+// SIMD в один поток и SIMD + потоки. Заодно сверяет списки видимых со скалярной версией.
+#include "renderer/FrustumCuller.h"
+#include "core/JobSystem.h"
+#include "math/Mat4.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// лучшее из iters прогонов, ns на объект
+template <typename Fn>
+double bestNsPerObject(uint32_t iters, uint32_t count, const Fn& fn) {
+    double best = 1e30;
+    for (uint32_t it = 0; it < iters; ++it) {
+        auto t0 = Clock::now();
+        fn();
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+        if (ns < best) best = ns;
+    }
+    return best / (double)count;
+}
+
+uint32_t scalarSpheres(const Frustum& f, const SphereSoA& s, std::vector<uint32_t>& out) {
+    out.clear();
+    for (uint32_t i = 0; i < s.size(); ++i)
+        if (f.sphereVisible({ s.x[i], s.y[i], s.z[i] }, s.r[i])) out.push_back(i);
+    return (uint32_t)out.size();
+}
+
+uint32_t scalarAabbs(const Frustum& f, const AabbSoA& b, std::vector<uint32_t>& out) {
+    out.clear();
+    for (uint32_t i = 0; i < b.size(); ++i) {
+        Vec3 c{ b.cx[i], b.cy[i], b.cz[i] }, e{ b.ex[i], b.ey[i], b.ez[i] };
+        if (f.aabbVisible(c - e, c + e)) out.push_back(i);
+    }
+    return (uint32_t)out.size();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t iters = 20;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--iters" && i + 1 < argc) {
+            iters = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        }
+        else {
+            std::cerr << "usage: darkwave_cullbench [--iters N]\n";
+            return 1;
+        }
+    }
+
+    jobSystem().init();
+
+    Mat4 view = Mat4::lookAtRH({ 0.0f, 1.7f, 0.0f }, { 1.0f, 1.5f, 0.3f }, { 0.0f, 1.0f, 0.0f });
+    Mat4 proj = Mat4::perspectiveRH_ZO(70.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+    Frustum frustum = Frustum::fromViewProj(Mat4::mul(proj, view));
+
+    std::cout << "simd width " << FrustumCuller::simdWidth() << ", threads " << parallelWorkerCount()
+              << ", best of " << iters << "\n";
+
+    bool ok = true;
+    for (uint32_t count : { 1000u, 100000u, 1000000u }) {
+        std::mt19937 rng(1234u);
+        std::uniform_real_distribution<float> pos(-1000.0f, 1000.0f);
+        std::uniform_real_distribution<float> size(0.2f, 4.0f);
+
+        SphereSoA spheres;
+        AabbSoA boxes;
+        spheres.reserve(count);
+        boxes.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            Vec3 c{ pos(rng), pos(rng) * 0.05f, pos(rng) };
+            Vec3 e{ size(rng), size(rng), size(rng) };
+            spheres.push(c, length(e));
+            boxes.push(c - e, c + e);
+        }
+
+        FrustumCuller culler;
+        std::vector<uint32_t> ref, visible;
+
+        uint32_t refCount = 0, count1 = 0, countN = 0;
+        double sScalar = bestNsPerObject(iters, count, [&] { refCount = scalarSpheres(frustum, spheres, ref); });
+        culler.setThreaded(false);
+        double sSimd = bestNsPerObject(iters, count, [&] { count1 = culler.cullSpheres(frustum, spheres, visible); });
+        culler.setThreaded(true);
+        double sMt = bestNsPerObject(iters, count, [&] { countN = culler.cullSpheres(frustum, spheres, visible); });
+        if (count1 != refCount || countN != refCount || visible != ref) {
+            std::cerr << "sphere mismatch at " << count << ": " << refCount << " / " << count1 << " / " << countN << "\n";
+            ok = false;
+        }
+
+        double bScalar = bestNsPerObject(iters, count, [&] { refCount = scalarAabbs(frustum, boxes, ref); });
+        culler.setThreaded(false);
+        double bSimd = bestNsPerObject(iters, count, [&] { count1 = culler.cullAabbs(frustum, boxes, visible); });
+        culler.setThreaded(true);
+        double bMt = bestNsPerObject(iters, count, [&] { countN = culler.cullAabbs(frustum, boxes, visible); });
+        if (count1 != refCount || countN != refCount || visible != ref) {
+            std::cerr << "aabb mismatch at " << count << ": " << refCount << " / " << count1 << " / " << countN << "\n";
+            ok = false;
+        }
+
+        std::printf("%8u objects, %6.2f%% visible | spheres ns/obj: scalar %6.3f  simd %6.3f  simd+mt %6.3f"
+                    " | aabbs ns/obj: scalar %6.3f  simd %6.3f  simd+mt %6.3f\n",
+            count, 100.0 * refCount / count, sScalar, sSimd, sMt, bScalar, bSimd, bMt);
+    }
+    jobSystem().shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+// darkwave_ecsbench: ECS (core/Ecs) на 1M сущностей.
+//   darkwave_ecsbench [--count N] [--iters N] [--oversized]
+// Сущности трёх архетипов (Position+Velocity, +Health, +Health+Team). Замеры:
+//   create  — создание N сущностей напрямую;
+//   each    — pos += vel * dt по всем (ns/сущность), рядом то же по "толстому" объекту в std::vector (AoS, как
+//             RenderObject + физика) — что даёт SoA в чанках;
+//   par     — то же через parallelEach (JobSystem);
+//   get     — случайный доступ get<Position> по Entity;
+//   cmd     — 10% сущностей получают/теряют компонент и 10% пересоздаются через EcsCommandBuffer,
+//             записанный из parallelEach; время flush на команду.
+// Сверяет сумму позиций ECS с AoS-версией. Отдельно проверяет раскладку чанка для крупных строк
+// (одна и три строки на чанк); --oversized создаёт строку больше чанка — ожидается ошибка и abort.
+#include "core/Ecs.h"
+#include "core/JobSystem.h"
+#include "math/Mat4.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Position { float x, y, z; };
+struct Velocity { float x, y, z; };
+struct Health { float hp; };
+struct Team { uint32_t id; };
+struct Stunned { float seconds; };
+
+// то, что лежало бы в одном объекте без ECS: рендер + физика + геймплей
+struct FatObject {
+    Mat4 model;
+    Vec3 boundsMin, boundsMax;
+    Position pos;
+    Velocity vel;
+    float hp = 100.0f;
+    uint32_t team = 0;
+    uint32_t mesh = 0;
+    bool alive = true;
+};
+
+template <typename Fn>
+double bestMs(uint32_t iters, const Fn& fn) {
+    double best = 1e30;
+    for (uint32_t it = 0; it < iters; ++it) {
+        auto t0 = Clock::now();
+        fn();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+template <int N>
+struct Big { unsigned char bytes[1000]; };
+
+template <int N>
+Big<N> bigValue(uint32_t seed) {
+    Big<N> b;
+    for (uint32_t i = 0; i < sizeof(b.bytes); ++i) b.bytes[i] = (unsigned char)(seed * 31u + N * 7u + i);
+    return b;
+}
+
+template <int N>
+bool bigIntact(World& world, Entity e, uint32_t seed) {
+    const Big<N>* b = world.get<Big<N>>(e);
+    const Big<N> want = bigValue<N>(seed);
+    return b && std::memcmp(b->bytes, want.bytes, sizeof(want.bytes)) == 0;
+}
+
+// крупные строки: 9 x 1000 байт -> одна строка на чанк, 5 x 1000 -> три; колонки не должны
+// перекрываться ни друг с другом, ни с массивом Entity
+bool checkLargeRows() {
+    World world;
+    std::vector<Entity> nine, five;
+    for (uint32_t i = 0; i < 8; ++i) {
+        nine.push_back(world.create(bigValue<0>(i), bigValue<1>(i), bigValue<2>(i), bigValue<3>(i), bigValue<4>(i),
+            bigValue<5>(i), bigValue<6>(i), bigValue<7>(i), bigValue<8>(i)));
+        five.push_back(world.create(bigValue<0>(i), bigValue<1>(i), bigValue<2>(i), bigValue<3>(i), bigValue<4>(i)));
+    }
+    // дырки в середине архетипов и переезд между ними (eraseRow/moveEntity читают массив Entity)
+    world.destroy(nine[2]);
+    world.destroy(five[5]);
+    world.remove<Big<8>>(nine[4]);
+    world.add(five[1], bigValue<8>(1));
+
+    bool ok = (void*)world.get<Big<0>>(nine[0]) != (void*)world.get<Big<1>>(nine[0]);
+    for (uint32_t i = 0; i < 8; ++i) {
+        if (i != 2) {
+            ok = ok && bigIntact<0>(world, nine[i], i) && bigIntact<4>(world, nine[i], i) && bigIntact<7>(world, nine[i], i);
+            ok = ok && (i == 4 ? !world.has<Big<8>>(nine[i]) : bigIntact<8>(world, nine[i], i));
+        }
+        if (i != 5) {
+            ok = ok && bigIntact<0>(world, five[i], i) && bigIntact<3>(world, five[i], i) && bigIntact<4>(world, five[i], i);
+            ok = ok && (i == 1 ? bigIntact<8>(world, five[i], i) : !world.has<Big<8>>(five[i]));
+        }
+    }
+    if (!world.alive(nine[7]) || world.alive(nine[2]) || world.entityCount() != 14) ok = false;
+    std::printf("large rows (1 and 3 per chunk): %s\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t count = 1000000;
+    uint32_t iters = 10;
+    bool oversized = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--count" && i + 1 < argc) {
+            count = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        }
+        else if (a == "--iters" && i + 1 < argc) {
+            iters = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        }
+        else if (a == "--oversized") {
+            oversized = true;
+        }
+        else {
+            std::cerr << "usage: darkwave_ecsbench [--count N] [--iters N] [--oversized]\n";
+            return 1;
+        }
+    }
+
+    if (oversized) {
+        // 17 x 1000 байт + Entity > 16 КБ: World::archetype() пишет ошибку и делает abort
+        World world;
+        world.create(bigValue<0>(0), bigValue<1>(0), bigValue<2>(0), bigValue<3>(0), bigValue<4>(0), bigValue<5>(0),
+            bigValue<6>(0), bigValue<7>(0), bigValue<8>(0), bigValue<9>(0), bigValue<10>(0), bigValue<11>(0),
+            bigValue<12>(0), bigValue<13>(0), bigValue<14>(0), bigValue<15>(0), bigValue<16>(0));
+        std::cerr << "oversized row was accepted\n";
+        return 1;
+    }
+
+    jobSystem().init();
+    std::cout << count << " entities, " << jobSystem().workerCount() << " threads, best of " << iters
+              << ", chunk " << EcsChunk::SIZE << " bytes\n";
+
+    std::mt19937 rng(1234u);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    bool ok = checkLargeRows();
+
+    std::vector<Position> startPos(count);
+    std::vector<Velocity> startVel(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        startPos[i] = { u(rng) * 100.0f, u(rng) * 10.0f, u(rng) * 100.0f };
+        startVel[i] = { u(rng), u(rng), u(rng) };
+    }
+
+    World world;
+    std::vector<Entity> entities(count);
+    auto t0 = Clock::now();
+    for (uint32_t i = 0; i < count; ++i) {
+        switch (i % 3) {
+        case 0: entities[i] = world.create(startPos[i], startVel[i]); break;
+        case 1: entities[i] = world.create(startPos[i], startVel[i], Health{ 100.0f }); break;
+        default: entities[i] = world.create(startPos[i], startVel[i], Health{ 100.0f }, Team{ i & 1u }); break;
+        }
+    }
+    const double createMs = msSince(t0);
+    std::printf("create: %.2f ms (%.1f ns/entity), %u archetypes, %u chunks\n",
+        createMs, createMs * 1e6 / count, world.archetypeCount(), world.chunkCount());
+
+    std::vector<FatObject> fat(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        fat[i].pos = startPos[i];
+        fat[i].vel = startVel[i];
+    }
+
+    const float dt = 1.0f / 128.0f;
+    const double eachMs = bestMs(iters, [&] {
+        world.each<Position, const Velocity>([dt](Position& p, const Velocity& v) {
+            p.x += v.x * dt; p.y += v.y * dt; p.z += v.z * dt;
+        });
+    });
+    const double fatMs = bestMs(iters, [&] {
+        for (FatObject& o : fat) {
+            if (!o.alive) continue;
+            o.pos.x += o.vel.x * dt; o.pos.y += o.vel.y * dt; o.pos.z += o.vel.z * dt;
+        }
+    });
+    const double parMs = bestMs(iters, [&] {
+        world.parallelEach<Position, const Velocity>([dt](Position& p, const Velocity& v) {
+            p.x += v.x * dt; p.y += v.y * dt; p.z += v.z * dt;
+        });
+    });
+    // сколько раз всего сдвинули каждую ECS-сущность; AoS догоняем до того же
+    const uint32_t ecsSteps = iters * 2;
+    for (uint32_t s = iters; s < ecsSteps; ++s)
+        for (FatObject& o : fat) { o.pos.x += o.vel.x * dt; o.pos.y += o.vel.y * dt; o.pos.z += o.vel.z * dt; }
+
+    std::printf("each pos += vel*dt: ecs %.3f ns/entity | aos (%zu-byte objects) %.3f ns/entity | ecs parallel %.3f ns/entity\n",
+        eachMs * 1e6 / count, sizeof(FatObject), fatMs * 1e6 / count, parMs * 1e6 / count);
+
+    // случайный доступ по handle
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    float sink = 0.0f;
+    const double getMs = bestMs(iters, [&] {
+        for (uint32_t i : order) sink += world.get<Position>(entities[i])->x;
+    });
+    std::printf("get<Position> random: %.2f ns/lookup\n", getMs * 1e6 / count);
+
+    // сверка: та же арифметика в том же порядке для каждой сущности
+    double maxErr = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const Position* p = world.get<Position>(entities[i]);
+        maxErr = std::max(maxErr, (double)std::fabs(p->x - fat[i].pos.x) + std::fabs(p->y - fat[i].pos.y) + std::fabs(p->z - fat[i].pos.z));
+    }
+    if (maxErr > 1e-3) {
+        std::cerr << "ecs/aos mismatch: " << maxErr << "\n";
+        ok = false;
+    }
+
+    // структурные изменения из параллельного обхода: оглушить 10% (add), снять оглушение, пересоздать 10%
+    EcsCommandBuffer cmd;
+    world.parallelEachChunk<Position, const Health>([&](uint32_t n, const Entity* es, Position*, const Health*) {
+        for (uint32_t i = 0; i < n; ++i)
+            if (es[i].index % 10 == 0) cmd.add(es[i], Stunned{ 1.0f });
+    });
+    size_t commands = cmd.size();
+    t0 = Clock::now();
+    world.flush(cmd);
+    const double addMs = msSince(t0);
+
+    uint32_t stunned = 0;
+    world.eachChunk<const Stunned>([&](uint32_t n, const Entity* es, const Stunned*) {
+        for (uint32_t i = 0; i < n; ++i) cmd.remove<Stunned>(es[i]);
+        stunned += n;
+    });
+    t0 = Clock::now();
+    world.flush(cmd);
+    const double removeMs = msSince(t0);
+
+    for (uint32_t i = 0; i < count; i += 10) {
+        cmd.destroy(entities[i]);
+        cmd.create(startPos[i], startVel[i]);
+    }
+    const size_t respawns = cmd.size();
+    t0 = Clock::now();
+    world.flush(cmd);
+    const double respawnMs = msSince(t0);
+
+    std::printf("cmd: add %zu in %.2f ms (%.1f ns/cmd) | remove %u in %.2f ms (%.1f ns/cmd) | destroy+create %zu in %.2f ms (%.1f ns/cmd)\n",
+        commands, addMs, addMs * 1e6 / std::max<size_t>(1, commands), stunned, removeMs, removeMs * 1e6 / std::max(1u, stunned),
+        respawns, respawnMs, respawnMs * 1e6 / std::max<size_t>(1, respawns));
+
+    if (world.entityCount() != count || stunned != commands) {
+        std::cerr << "entity count mismatch: " << world.entityCount() << " / " << count << ", stunned " << stunned << " / " << commands << "\n";
+        ok = false;
+    }
+    std::printf("after: %u entities, %u archetypes, %u chunks (checksum %.1f)\n",
+        world.entityCount(), world.archetypeCount(), world.chunkCount(), sink);
+
+    jobSystem().shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+// darkwave_jobbench: масштабирование JobSystem от 1 до N потоков.
+//   darkwave_jobbench [--threads N] [--iters N]
+// Нагрузки:
+//   for     — parallelFor по 4M элементов с заметной математикой на элемент (чистая пропускная способность);
+//   tiny    — 100k пустых задач с main-потока (накладные расходы на задачу, воровство из одной деки);
+//   tree    — рекурсивное дерево задач глубины 16, каждая ждёт детей (help-while-wait внутри задач);
+//   cull    — FrustumCuller на 1M AABB.
+// Для каждого числа потоков: время (лучшее из iters), ускорение относительно 1 потока, сколько задач украдено.
+#include "core/JobSystem.h"
+#include "renderer/FrustumCuller.h"
+#include "math/Mat4.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Fn>
+double bestMs(uint32_t iters, const Fn& fn) {
+    double best = 1e30;
+    for (uint32_t it = 0; it < iters; ++it) {
+        auto t0 = Clock::now();
+        fn();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+// два ребёнка, ждём обоих -> 2^depth листьев
+void treeJob(uint32_t depth, std::atomic<uint32_t>* leaves) {
+    if (depth == 0) {
+        leaves->fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    JobCounter children;
+    jobSystem().run(children, [depth, leaves]() { treeJob(depth - 1, leaves); });
+    jobSystem().run(children, [depth, leaves]() { treeJob(depth - 1, leaves); });
+    jobSystem().wait(children);
+}
+
+struct Result {
+    double ms[4];
+    uint64_t stolen[4];
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t iters = 10;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--threads" && i + 1 < argc) {
+            maxThreads = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        }
+        else if (a == "--iters" && i + 1 < argc) {
+            iters = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        }
+        else {
+            std::cerr << "usage: darkwave_jobbench [--threads N] [--iters N]\n";
+            return 1;
+        }
+    }
+    maxThreads = std::min(maxThreads, JobSystem::MAX_WORKERS);
+
+    // данные общие для всех прогонов
+    const uint32_t forCount = 4u << 20;
+    std::vector<float> in(forCount), out(forCount);
+    for (uint32_t i = 0; i < forCount; ++i) in[i] = (float)(i % 1000) * 0.01f;
+
+    const uint32_t cullCount = 1000000;
+    AabbSoA boxes;
+    {
+        std::mt19937 rng(1234u);
+        std::uniform_real_distribution<float> pos(-1000.0f, 1000.0f);
+        std::uniform_real_distribution<float> size(0.2f, 4.0f);
+        boxes.reserve(cullCount);
+        for (uint32_t i = 0; i < cullCount; ++i) {
+            Vec3 c{ pos(rng), pos(rng) * 0.05f, pos(rng) };
+            Vec3 e{ size(rng), size(rng), size(rng) };
+            boxes.push(c - e, c + e);
+        }
+    }
+    Mat4 view = Mat4::lookAtRH({ 0.0f, 1.7f, 0.0f }, { 1.0f, 1.5f, 0.3f }, { 0.0f, 1.0f, 0.0f });
+    Mat4 proj = Mat4::perspectiveRH_ZO(70.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+    Frustum frustum = Frustum::fromViewProj(Mat4::mul(proj, view));
+
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    std::printf("%7s | %10s %6s | %10s %6s | %10s %6s | %10s %6s | %s\n",
+        "threads", "for ms", "x", "tiny ns/job", "x", "tree ms", "x", "cull ms", "x", "stolen (for/tiny/tree/cull)");
+
+    Result base{};
+    bool ok = true;
+    for (uint32_t t : threadCounts) {
+        jobSystem().init(t);
+        Result r{};
+
+        jobSystem().resetStats();
+        r.ms[0] = bestMs(iters, [&] {
+            parallelFor(forCount, 1024, [&](uint32_t b, uint32_t e) {
+                for (uint32_t i = b; i < e; ++i) {
+                    float x = in[i];
+                    for (int k = 0; k < 8; ++k) x = std::sqrt(x * x + 1.0f) * 0.5f;
+                    out[i] = x;
+                }
+            });
+        });
+        r.stolen[0] = jobSystem().stats().stolen;
+
+        const uint32_t tinyJobs = 100000;
+        std::atomic<uint32_t> tinyDone{ 0 };
+        jobSystem().resetStats();
+        r.ms[1] = bestMs(iters, [&] {
+            JobCounter c;
+            std::atomic<uint32_t>* done = &tinyDone;
+            for (uint32_t i = 0; i < tinyJobs; ++i)
+                jobSystem().run(c, [done]() { done->fetch_add(1, std::memory_order_relaxed); });
+            jobSystem().wait(c);
+        });
+        r.stolen[1] = jobSystem().stats().stolen;
+        if (tinyDone.load() != tinyJobs * iters) ok = false;
+
+        std::atomic<uint32_t> leaves{ 0 };
+        jobSystem().resetStats();
+        r.ms[2] = bestMs(iters, [&] {
+            leaves = 0;
+            treeJob(16, &leaves);
+        });
+        r.stolen[2] = jobSystem().stats().stolen;
+        if (leaves.load() != (1u << 16)) ok = false;
+
+        FrustumCuller culler;
+        std::vector<uint32_t> visible;
+        jobSystem().resetStats();
+        r.ms[3] = bestMs(iters, [&] { culler.cullAabbs(frustum, boxes, visible); });
+        r.stolen[3] = jobSystem().stats().stolen;
+
+        jobSystem().shutdown();
+
+        if (t == 1) base = r;
+        std::printf("%7u | %10.3f %6.2f | %10.1f %6.2f | %10.3f %6.2f | %10.3f %6.2f | %llu/%llu/%llu/%llu\n",
+            t,
+            r.ms[0], base.ms[0] / r.ms[0],
+            r.ms[1] * 1e6 / tinyJobs, base.ms[1] / r.ms[1],
+            r.ms[2], base.ms[2] / r.ms[2],
+            r.ms[3], base.ms[3] / r.ms[3],
+            (unsigned long long)r.stolen[0], (unsigned long long)r.stolen[1],
+            (unsigned long long)r.stolen[2], (unsigned long long)r.stolen[3]);
+    }
+
+    if (!ok) std::cerr << "jobbench: lost jobs\n";
+    return ok ? 0 : 1;
+}
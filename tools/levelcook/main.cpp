@@ -0,0 +1,154 @@
+// darkwave_levelcook: cooked-уровни .dwlevel (asset/Level).
+//   darkwave_levelcook --arena <output.dwlevel>             арена движка (та же, что fallback в движке)
+//   darkwave_levelcook --stress N <output.dwlevel>          тестовая карта на N сущностей (иерархии, коллайдеры, спавны)
+//   darkwave_levelcook --bench <input.dwlevel> [--iters N]  замер загрузки
+// --bench (лучшее из N, файл в page cache):
+//   open   — mmap + проверка заголовка и границ секций (всё, что нужно до использования);
+//   touch  — первый проход по всем сущностям прямо из отображения (page faults);
+//   hash   — verifyHash() по всему файлу (для кэшей, при загрузке не нужен);
+//   read   — для сравнения: прочитать файл целиком в std::vector (ещё без разбора).
+#include "asset/Level.h"
+#include "asset/Mesh.h"
+#include "asset/MeshGen.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+void printUsage() {
+    std::cerr << "usage: darkwave_levelcook --arena <output.dwlevel>\n"
+              << "       darkwave_levelcook --stress N <output.dwlevel>\n"
+              << "       darkwave_levelcook --bench <input.dwlevel> [--iters N]\n";
+}
+
+// cooked-меш, если есть; иначе процедурный (для уровня нужны только границы)
+MeshData meshForBounds(const char* path, bool rock) {
+    MeshData m;
+    if (std::filesystem::exists(path) && loadMesh(path, m)) return m;
+    return rock ? generateRock(1u, 4) : generateArena(20.0f, 0.25f);
+}
+
+// N сущностей на поле 1 x 1 км: кластеры "куб на камне", камни россыпью, коллайдер на каждый 10-й, 64 спавна
+LevelBuilder makeStressLevel(uint32_t count, const MeshData& map, const MeshData& rock) {
+    LevelBuilder b;
+    b.mapMesh = b.addMesh(LEVEL_MESH_ARENA, map.boundsMin, map.boundsMax);
+    const float cubeMin[3] = { -0.5f, -0.5f, -0.5f };
+    const float cubeMax[3] = { 0.5f, 0.5f, 0.5f };
+    const uint32_t cubeMesh = b.addMesh(LEVEL_MESH_CUBE, cubeMin, cubeMax);
+    const uint32_t rockMesh = b.addMesh(LEVEL_MESH_ROCK, rock.boundsMin, rock.boundsMax);
+
+    std::mt19937 rng(4242u);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    b.entities.reserve(count);
+    while (b.entities.size() < count) {
+        const uint32_t index = (uint32_t)b.entities.size();
+        const float x = -500.0f + 1000.0f * u01(rng);
+        const float z = -500.0f + 1000.0f * u01(rng);
+        const float s = 0.3f + 0.6f * u01(rng);
+        const float yaw = 6.2831853f * u01(rng);
+        b.entities.push_back({ { x, -rock.boundsMin[1] * s, z }, { 0.0f, std::sin(yaw * 0.5f), 0.0f, std::cos(yaw * 0.5f) },
+            { s, s, s }, rockMesh, LEVEL_NONE, LEVEL_ENTITY_STATIC, {} });
+        if (index % 10 == 0) {
+            b.colliders.push_back({ { x - s, 0.0f, z - s }, { x + s, 2.0f * s, z + s } });
+            // ребёнок: куб на макушке камня (в локальных координатах камня)
+            if (b.entities.size() < count)
+                b.entities.push_back({ { 0.0f, rock.boundsMax[1] + 0.5f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f },
+                    { 1.0f, 1.0f, 1.0f }, cubeMesh, index, 0, {} });
+        }
+    }
+    for (uint32_t i = 0; i < 64; ++i) {
+        float a = 6.2831853f * i / 64.0f;
+        b.spawns.push_back({ { 450.0f * std::cos(a), 0.0f, 450.0f * std::sin(a) }, a + 3.1415926f, i % 2, {} });
+    }
+    return b;
+}
+
+int bench(const std::string& path, uint32_t iters) {
+    double openMs = 1e30, touchMs = 1e30, hashMs = 1e30, readMs = 1e30;
+    uint32_t entities = 0;
+    size_t bytes = 0;
+    float sink = 0.0f;
+    bool hashOk = true;
+    for (uint32_t it = 0; it < iters; ++it) {
+        LevelFile level;
+        auto t0 = Clock::now();
+        if (!level.open(path)) return 1;
+        openMs = std::min(openMs, msSince(t0));
+
+        t0 = Clock::now();
+        const LevelHeader& h = level.header();
+        for (const LevelEntity& e : h.entities) sink += e.position[0] + e.scale[1];
+        for (const LevelCollider& c : h.colliders) sink += c.max[1];
+        touchMs = std::min(touchMs, msSince(t0));
+
+        t0 = Clock::now();
+        hashOk = hashOk && level.verifyHash();
+        hashMs = std::min(hashMs, msSince(t0));
+
+        entities = h.entities.count;
+        bytes = level.size();
+
+        t0 = Clock::now();
+        std::ifstream f(path, std::ios::binary);
+        std::vector<char> copy(bytes);
+        f.read(copy.data(), (std::streamsize)bytes);
+        readMs = std::min(readMs, msSince(t0));
+        sink += copy[bytes / 2];
+    }
+    std::printf("%s: %u entities, %.1f KB, best of %u\n", path.c_str(), entities, bytes / 1024.0, iters);
+    std::printf("open %.3f ms | touch all entities %.3f ms (%.1f ns/entity) | verify hash %.3f ms (%s) | read into memory %.3f ms (checksum %.1f)\n",
+        openMs, touchMs, touchMs * 1e6 / std::max(1u, entities), hashMs, hashOk ? "ok" : "MISMATCH", readMs, sink);
+    return hashOk ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t iters = 10;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--iters" && i + 1 < argc) iters = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        else args.push_back(a);
+    }
+
+    LevelBuilder level;
+    std::string out;
+    if (args.size() == 2 && args[0] == "--bench") {
+        return bench(args[1], iters);
+    }
+    else if (args.size() == 2 && args[0] == "--arena") {
+        level = makeArenaLevel(meshForBounds(LEVEL_MESH_ARENA, false), meshForBounds(LEVEL_MESH_ROCK, true));
+        out = args[1];
+    }
+    else if (args.size() == 3 && args[0] == "--stress") {
+        uint32_t count = (uint32_t)std::max(1, std::atoi(args[1].c_str()));
+        level = makeStressLevel(count, meshForBounds(LEVEL_MESH_ARENA, false), meshForBounds(LEVEL_MESH_ROCK, true));
+        out = args[2];
+    }
+    else {
+        printUsage();
+        return 1;
+    }
+
+    auto t0 = Clock::now();
+    if (!level.save(out)) return 1;
+    std::printf("written %s: %zu entities, %zu meshes, %zu colliders, %zu spawns (%.2f ms)\n", out.c_str(),
+        level.entities.size(), level.meshes.size(), level.colliders.size(), level.spawns.size(), msSince(t0));
+    return 0;
+}
@@ -0,0 +1,86 @@
+// darkwave_meshcook: offline-подготовка мешей для движка.
+//   darkwave_meshcook [--lods N] <input.obj> <output.dwmesh>
+//   darkwave_meshcook [--lods N] --arena <output.dwmesh>   процедурная арена (та же, что fallback в движке)
+//   darkwave_meshcook [--lods N] --rock <output.dwmesh>    процедурный камень-проп
+// --lods N: LOD-цепочка из N уровней (quadric simplification, каждый ~вдвое меньше), по умолчанию 1.
+#include "asset/Mesh.h"
+#include "asset/MeshletBuilder.h"
+#include "asset/MeshGen.h"
+#include "asset/ObjLoader.h"
+#include "asset/Simplifier.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void printUsage() {
+    std::cerr << "usage: darkwave_meshcook [--lods N] <input.obj> <output.dwmesh>\n"
+              << "       darkwave_meshcook [--lods N] --arena <output.dwmesh>\n"
+              << "       darkwave_meshcook [--lods N] --rock <output.dwmesh>\n";
+}
+
+int main(int argc, char** argv) {
+    uint32_t lods = 1;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--lods" && i + 1 < argc) {
+            int n = std::atoi(argv[++i]);
+            if (n < 1 || n > (int)MAX_MESH_LODS) {
+                std::cerr << "meshcook: --lods must be 1.." << MAX_MESH_LODS << "\n";
+                return 1;
+            }
+            lods = (uint32_t)n;
+        }
+        else {
+            args.push_back(a);
+        }
+    }
+    if (args.size() != 2) {
+        printUsage();
+        return 1;
+    }
+
+    const std::string& in = args[0];
+    const std::string& out = args[1];
+
+    MeshData mesh;
+    if (in == "--arena") {
+        mesh = generateArena(20.0f, 0.25f);
+    }
+    else if (in == "--rock") {
+        mesh = generateRock(1u, 4);
+    }
+    else if (!loadObj(in, mesh)) {
+        return 1;
+    }
+
+    if (lods > 1) buildLodChain(mesh, lods, 0.5f, SimplifyOptions{});
+    buildMeshlets(mesh);
+
+    size_t tris = meshLod(mesh, 0).indexCount / 3;
+    size_t meshletTris = 0;
+    for (const Meshlet& m : mesh.meshlets) meshletTris += m.triangleCount;
+    if (meshletTris != tris) {
+        std::cerr << "meshcook: meshlets cover " << meshletTris << " of " << tris << " triangles\n";
+        return 1;
+    }
+
+    size_t n = mesh.meshlets.empty() ? 1 : mesh.meshlets.size();
+    size_t coneCount = 0;
+    for (const Meshlet& m : mesh.meshlets) coneCount += m.coneCutoff < 1.0f ? 1 : 0;
+
+    std::cout << "vertices:  " << mesh.vertices.size() << "\n"
+              << "triangles: " << tris << "\n"
+              << "meshlets:  " << mesh.meshlets.size()
+              << " (avg " << (double)mesh.meshletVertices.size() / n << " verts, "
+              << (double)meshletTris / n << " tris, " << coneCount << " with usable normal cone)\n";
+    for (uint32_t l = 0; l < lodCount(mesh); ++l) {
+        MeshLod lod = meshLod(mesh, l);
+        std::cout << "lod " << l << ": " << lod.indexCount / 3 << " triangles, error " << lod.error << "\n";
+    }
+
+    if (!saveMesh(out, mesh)) return 1;
+    std::cout << "written " << out << "\n";
+    return 0;
+}
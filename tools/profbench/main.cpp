@@ -0,0 +1,118 @@
+// darkwave_profbench: накладные расходы CPU-профайлера (core/Profiler) на зону.
+//   darkwave_profbench [--batches N]
+// Замеры (пачки по 4096 событий — меньше кольца потока, frameMark() между пачками вне замера):
+//   ticks   — один profilerTicks() (rdtsc или steady_clock);
+//   zone    — пустой PROFILE_SCOPE: два штампа + запись в кольцо;
+//   nested  — зона внутри зоны, на зону;
+//   counter — PROFILE_COUNTER;
+//   drain   — frameMark(): разбор кольца в сводку кадра, на событие.
+// Для каждого — минимум и медиана по пачкам; цель для zone — медиана < 50 нс.
+#include "core/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t BATCH = 4096;
+constexpr double ZONE_TARGET_NS = 50.0;
+
+struct Stat {
+    double minNs;
+    double medianNs;
+};
+
+Stat stat(std::vector<double>& ns) {
+    std::sort(ns.begin(), ns.end());
+    return { ns.front(), ns[ns.size() / 2] };
+}
+
+// fn() делает BATCH событий; после каждой пачки кольцо разбирается вне замера
+template <typename Fn>
+Stat perEvent(uint32_t batches, const Fn& fn) {
+    std::vector<double> ns;
+    ns.reserve(batches);
+    for (uint32_t b = 0; b < batches; ++b) {
+        auto t0 = Clock::now();
+        fn();
+        ns.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / BATCH);
+        profiler().frameMark();
+    }
+    return stat(ns);
+}
+
+void print(const char* name, const Stat& s) {
+    std::printf("%-8s min %6.1f ns | median %6.1f ns\n", name, s.minNs, s.medianNs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t batches = 2000;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--batches" && i + 1 < argc) {
+            batches = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        }
+        else {
+            std::cerr << "usage: darkwave_profbench [--batches N]\n";
+            return 1;
+        }
+    }
+
+    profiler().init();
+#ifdef DW_PROFILE_RDTSC
+    const char* clock = "rdtsc";
+#else
+    const char* clock = "steady_clock";
+#endif
+    std::printf("%u batches of %u events, clock %s\n", batches, BATCH, clock);
+
+    volatile uint64_t sink = 0;
+    print("ticks", perEvent(batches, [&] {
+        uint64_t s = 0;
+        for (uint32_t i = 0; i < BATCH; ++i) s += profilerTicks();
+        sink = sink + s;
+    }));
+
+    const Stat zone = perEvent(batches, [] {
+        for (uint32_t i = 0; i < BATCH; ++i) { PROFILE_SCOPE("zone"); }
+    });
+    print("zone", zone);
+
+    print("nested", perEvent(batches, [] {
+        for (uint32_t i = 0; i < BATCH / 2; ++i) {
+            PROFILE_SCOPE("outer");
+            { PROFILE_SCOPE("inner"); }
+        }
+    }));
+
+    print("counter", perEvent(batches, [] {
+        for (uint32_t i = 0; i < BATCH; ++i) PROFILE_COUNTER("counter", i);
+    }));
+
+    // разбор: кольцо заполняется вне замера
+    std::vector<double> drain;
+    drain.reserve(batches);
+    for (uint32_t b = 0; b < batches; ++b) {
+        for (uint32_t i = 0; i < BATCH; ++i) { PROFILE_SCOPE("zone"); }
+        auto t0 = Clock::now();
+        profiler().frameMark();
+        drain.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / BATCH);
+    }
+    print("drain", stat(drain));
+
+    if (profiler().droppedEvents() != 0) {
+        std::cerr << "dropped " << profiler().droppedEvents() << " events\n";
+        return 1;
+    }
+    std::printf("zone median %.1f ns: %s the %.0f ns target\n", zone.medianNs,
+        zone.medianNs < ZONE_TARGET_NS ? "within" : "over", ZONE_TARGET_NS);
+    return 0;
+}
@@ -0,0 +1,227 @@
+// darkwave_server: выделенный сервер без окна и GPU — только симуляция (game_lib: core + math + game).
+//   darkwave_server [--tick-rate HZ] [--players N] [--seconds S] [--stats PREFIX] [--seed N] [--brushes N]
+// Фиксированный тик (64/128 Гц): между тиками FramePacer спит (SDL_Delay) и добирает spin'ом,
+// так тик начинается в пределах десятков мкс от своего момента, не сжигая ядро на ожидание.
+// Игроки — боты: UserCmd'ы из детерминированного генератора (ходят, поворачивают, прыгают).
+// Коллизия — CollisionWorld: куб в центре, --brushes N случайных боксов вокруг (нагрузка как у карты) и пол;
+// боты — капсулы Player (скольжение, ступеньки 0.4 м, земля).
+// Раз в 5 с: время работы тика (p50/p99/max и доля бюджета тика), джиттер периода, опоздание пробуждения.
+// --stats PREFIX — то же в PREFIX.csv / PREFIX.json (FrameStats: "frame" = период тика, "cpu" = работа).
+// SDL здесь только таймер и лог: SDL_Init(SDL_INIT_TIMER), видео не поднимается.
+// Сборка с DW_MEM_TRACKING: в отчёте ещё живая куча, на выходе — память по подсистемам.
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include "core/FrameStats.h"
+#include "core/MemoryTracker.h"
+#include "core/Profiler.h"
+#include "core/Time.h"
+#include "game/CollisionWorld.h"
+#include "game/Player.h"
+#include "game/UserCmd.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> g_quit{ false };
+
+void onSignal(int) {
+    g_quit = true;
+}
+
+// бот: каждые 0.25..1 с новое желание (направление, поворот, прыжок)
+struct Bot {
+    Player player;
+    UserCmd cmd;
+    uint32_t rng = 1;
+    uint32_t ticksLeft = 0;
+    float turnRate = 0.0f; // рад/тик
+
+    uint32_t next() {
+        // xorshift32: детерминированно от seed, одинаково на всех платформах
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+    float next01() { return (float)(next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+void thinkBot(Bot& b, uint64_t tick, uint32_t tickRate) {
+    UserCmd& c = b.cmd;
+    c.tick = tick;
+    c.pressed = 0;
+
+    if (b.ticksLeft == 0) {
+        b.ticksLeft = (uint32_t)((0.25f + 0.75f * b.next01()) * (float)tickRate);
+        const uint32_t r = b.next();
+        c.buttons = 0;
+        if (r & 1u) c.buttons |= UserCmd::Forward;
+        else if (r & 2u) c.buttons |= UserCmd::Back;
+        if (r & 4u) c.buttons |= (r & 8u) ? UserCmd::Left : UserCmd::Right;
+        if ((r & 0x70u) == 0) c.pressed |= UserCmd::Jump;
+        b.turnRate = (b.next01() - 0.5f) * 0.1f;
+    }
+    b.ticksLeft--;
+
+    c.yaw += b.turnRate;
+    c.pitch = std::clamp(c.pitch + (b.next01() - 0.5f) * 0.01f, -UserCmdBuilder::PITCH_LIMIT, UserCmdBuilder::PITCH_LIMIT);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t tickRate = Time::DEFAULT_TICK_RATE;
+    uint32_t players = 32;
+    double seconds = 0.0; // 0 = пока не остановят (Ctrl+C / SIGTERM)
+    std::string statsPath;
+    uint32_t seed = 1;
+    uint32_t brushes = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--tick-rate" && i + 1 < argc) tickRate = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        else if (a == "--players" && i + 1 < argc) players = (uint32_t)std::max(0, std::atoi(argv[++i]));
+        else if (a == "--seconds" && i + 1 < argc) seconds = std::atof(argv[++i]);
+        else if (a == "--stats" && i + 1 < argc) statsPath = argv[++i];
+        else if (a == "--seed" && i + 1 < argc) seed = (uint32_t)std::atoi(argv[++i]);
+        else if (a == "--brushes" && i + 1 < argc) brushes = (uint32_t)std::max(0, std::atoi(argv[++i]));
+        else {
+            std::cerr << "usage: darkwave_server [--tick-rate HZ] [--players N] [--seconds S] [--stats PREFIX] [--seed N]"
+                " [--brushes N]\n";
+            return 1;
+        }
+    }
+
+    // только таймер (на Windows — ещё и разрешение 1 мс для SDL_Delay); окна и видео нет
+    if (SDL_Init(SDL_INIT_TIMER) != 0) {
+        std::cerr << "SDL_Init failed: " << SDL_GetError() << "\n";
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    profiler().init();
+
+    // куб в центре (боты ходят вокруг него) и браши на поле 200 x 200 м; круг спавна (r = 10 м) свободен
+    std::vector<AABB> boxes;
+    boxes.push_back({ { -1.0f, 0.0f, -1.0f }, { 1.0f, 2.0f, 1.0f } });
+    Bot gen;
+    gen.rng = seed * 747796405u + 1u;
+    while (boxes.size() < (size_t)brushes + 1) {
+        const float x = -100.0f + 200.0f * gen.next01();
+        const float z = -100.0f + 200.0f * gen.next01();
+        if (x * x + z * z < 100.0f) continue;
+        const float hx = 0.25f + 1.25f * gen.next01(), hz = 0.25f + 1.25f * gen.next01();
+        const float h = 0.3f + 2.2f * gen.next01();
+        boxes.push_back({ { x - hx, 0.0f, z - hz }, { x + hx, h, z + hz } });
+    }
+    // пол y = 0 под полем — капсула ботов стоит на треугольниках, а не на кламп-полу Player
+    const CollisionTriangle floor[2] = {
+        { { -110.0f, 0.0f, -110.0f }, { -110.0f, 0.0f, 110.0f }, { 110.0f, 0.0f, 110.0f } },
+        { { -110.0f, 0.0f, -110.0f }, { 110.0f, 0.0f, 110.0f }, { 110.0f, 0.0f, -110.0f } },
+    };
+    // job system не поднимаем (лишние потоки на каждый экземпляр сервера): BVH строится в этом потоке
+    CollisionWorld world;
+    world.build(boxes.data(), (uint32_t)boxes.size(), floor, 2);
+
+    std::vector<Bot> bots(players);
+    for (uint32_t i = 0; i < players; ++i) {
+        Bot& b = bots[i];
+        b.player.world = &world;
+        b.rng = (seed * 2654435761u) ^ (i * 0x9E3779B9u) ^ 0xA5A5A5A5u;
+        if (b.rng == 0) b.rng = 1;
+        // по кругу вокруг центрального куба
+        const float a = (float)i / (float)std::max(1u, players) * 6.2831853f;
+        b.player.position = { 8.0f * std::cos(a), 0.0f, 8.0f * std::sin(a) };
+        b.cmd.yaw = a + 3.1415926f;
+    }
+
+    const double period = 1.0 / (double)tickRate;
+    FrameStats stats;
+    stats.setHitchThreshold((float)(period * 1000.0 * 1.5)); // тик на полпериода позже — уже заметно
+    if (!statsPath.empty()) stats.setOutput(statsPath + ".csv", statsPath + ".json", 5.0);
+
+    Time time;
+    time.setFrameStats(&stats);
+    time.start();
+    time.setTickRate(tickRate);
+    FramePacer pacer;
+    pacer.setTargetFrameTime(period);
+
+    std::cout << "Server: " << tickRate << " Hz, " << players << " players, " << world.size() << " collision boxes, "
+        << world.triangleCount() << " triangles (" << world.stats().buildMs << " ms BVH)"
+        << (seconds > 0.0 ? "" : ", until stopped") << "\n";
+
+    const auto started = std::chrono::steady_clock::now();
+    double sinceReport = 0.0;
+    float maxOvershootUs = 0.0f;
+    uint64_t ticks = 0;
+
+    setMemThreadName("main");
+    MemTagScope memTag(MemTag::Game);
+    while (!g_quit) {
+        PROFILE_FRAME();
+        {
+            PROFILE_SCOPE("sleep");
+            pacer.beginFrame();
+        }
+        maxOvershootUs = std::max(maxOvershootUs, pacer.stats().overshootUs);
+
+        const auto workStart = std::chrono::steady_clock::now();
+        time.tick();
+        // обычно ровно 1; после зависания — догоняем (не больше MAX_SIM_TICKS_PER_FRAME)
+        const uint32_t n = time.consumeSimTicks();
+        const float step = time.simStep();
+        for (uint32_t t = 0; t < n; ++t) {
+            PROFILE_SCOPE("serverTick");
+            for (Bot& b : bots) {
+                thinkBot(b, ticks, tickRate);
+                b.player.update(step, b.cmd.wishDir(), b.cmd.wasPressed(UserCmd::Jump));
+            }
+            ticks++;
+        }
+        pacer.endFrame();
+        memorySample();
+        stats.reportCpu(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - workStart).count());
+
+        sinceReport += time.deltaSeconds();
+        if (sinceReport >= 5.0) {
+            sinceReport = 0.0;
+            const FrameStatsSummary s = stats.summary();
+            std::printf("ticks=%llu dropped=%llu | work p50=%.3f p99=%.3f max=%.3f ms (%.1f%% of %.2f ms) | "
+                "period p50=%.3f p99=%.3f max=%.3f ms | wake late max=%.0f us | hitches=%llu\n",
+                (unsigned long long)ticks, (unsigned long long)time.droppedSimTicks(),
+                s.cpu().p50, s.cpu().p99, s.cpu().max, s.cpu().p99 / (float)(period * 1000.0) * 100.0f,
+                period * 1000.0, s.frame().p50, s.frame().p99, s.frame().max, maxOvershootUs,
+                (unsigned long long)s.hitches);
+            if (DW_MEM_TRACKING) {
+                const MemoryStats m = memoryStats();
+                std::printf("heap: live %.2f MB, peak %.2f MB\n", m.liveBytes / (1024.0 * 1024.0),
+                    m.peakBytes / (1024.0 * 1024.0));
+            }
+            std::fflush(stdout);
+            maxOvershootUs = 0.0f;
+        }
+
+        if (seconds > 0.0 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count() >= seconds) break;
+    }
+
+    stats.flush();
+    const FrameStatsSummary s = stats.summary();
+    std::printf("server stopped: %llu ticks, work p99=%.3f ms, period p99=%.3f ms, hitches=%llu\n",
+        (unsigned long long)ticks, s.cpu().p99, s.frame().p99, (unsigned long long)s.hitches);
+    if (DW_MEM_TRACKING) printMemoryReport(std::cout);
+
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,208 @@
+// darkwave_spatialbench: пространственный индекс (core/SpatialIndex) против перебора всех объектов.
+//   darkwave_spatialbench [--count N] [--moving PERCENT] [--queries N]
+// N объектов (0.5..2 м, 1% крупных 10..40 м) на поле 1 x 1 км. Для каждой раскладки (grid, octree):
+//   insert  — вставка всех объектов;
+//   move    — --moving% объектов сдвигаются: по одному update() и батчем (SpatialUpdateBuffer из parallelFor);
+//   query   — сферы r = 10 м, AABB 20 м, frustum (fov 70, дальность 100 м): мкс/запрос у индекса и у перебора.
+// Сверяет множества найденных объектов с перебором.
+#include "core/SpatialIndex.h"
+#include "core/JobSystem.h"
+#include "math/Frustum.h"
+#include "math/Mat4.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+struct Box {
+    Vec3 min, max;
+};
+
+struct Queries {
+    std::vector<Vec3> centers;
+    std::vector<Frustum> frustums;
+};
+
+// перебор: то же, что индекс, по всем объектам подряд
+template <typename Test>
+void bruteForce(const std::vector<Box>& boxes, const Test& test, std::vector<uint32_t>& out) {
+    out.clear();
+    for (uint32_t i = 0; i < (uint32_t)boxes.size(); ++i)
+        if (test(boxes[i])) out.push_back(i);
+}
+
+bool sameSet(std::vector<uint32_t> a, std::vector<uint32_t> b) {
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t count = 100000;
+    float movingPct = 10.0f;
+    uint32_t queryCount = 1000;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--count" && i + 1 < argc) count = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        else if (a == "--moving" && i + 1 < argc) movingPct = (float)std::atof(argv[++i]);
+        else if (a == "--queries" && i + 1 < argc) queryCount = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "usage: darkwave_spatialbench [--count N] [--moving PERCENT] [--queries N]\n";
+            return 1;
+        }
+    }
+
+    jobSystem().init();
+    std::printf("%u objects, %u threads, %u queries of each kind\n", count, jobSystem().workerCount(), queryCount);
+
+    std::mt19937 rng(1234u);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    auto randomBox = [&](uint32_t i) {
+        const Vec3 c{ -500.0f + 1000.0f * u01(rng), 20.0f * u01(rng), -500.0f + 1000.0f * u01(rng) };
+        const float h = (i % 100 == 0 ? 10.0f + 30.0f * u01(rng) : 0.5f + 1.5f * u01(rng)) * 0.5f;
+        return Box{ c - Vec3{ h, h, h }, c + Vec3{ h, h, h } };
+    };
+    std::vector<Box> start(count);
+    for (uint32_t i = 0; i < count; ++i) start[i] = randomBox(i);
+
+    const uint32_t moving = std::min(count, std::max(1u, (uint32_t)(count * movingPct / 100.0f)));
+    std::vector<uint32_t> movers(count);
+    for (uint32_t i = 0; i < count; ++i) movers[i] = i;
+    std::shuffle(movers.begin(), movers.end(), rng);
+    movers.resize(moving);
+    std::vector<Vec3> velocity(count);
+    for (Vec3& v : velocity) v = { 2.0f * u01(rng) - 1.0f, 0.0f, 2.0f * u01(rng) - 1.0f };
+
+    Queries q;
+    const Mat4 proj = Mat4::perspectiveRH_ZO(70.0f * 3.1415926f / 180.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    for (uint32_t i = 0; i < queryCount; ++i) {
+        const Vec3 c{ -500.0f + 1000.0f * u01(rng), 10.0f * u01(rng), -500.0f + 1000.0f * u01(rng) };
+        q.centers.push_back(c);
+        const float yaw = 6.2831853f * u01(rng);
+        const Mat4 view = Mat4::lookAtRH(c, c + Vec3{ std::cos(yaw), 0.0f, std::sin(yaw) }, { 0, 1, 0 });
+        q.frustums.push_back(Frustum::fromViewProj(Mat4::mul(proj, view)));
+    }
+
+    bool ok = true;
+    const SpatialIndexType types[] = { SpatialIndexType::HashedGrid, SpatialIndexType::LooseOctree };
+    for (SpatialIndexType type : types) {
+        SpatialIndexConfig cfg;
+        cfg.type = type;
+        cfg.cellSize = 4.0f;
+        cfg.origin = { -512.0f, -512.0f, -512.0f };
+        cfg.worldSize = 1024.0f;
+        cfg.maxDepth = 8;
+        SpatialIndex index;
+        index.configure(cfg);
+        std::vector<Box> boxes = start;
+        std::vector<uint32_t> proxies(count);
+
+        auto t0 = Clock::now();
+        for (uint32_t i = 0; i < count; ++i) proxies[i] = index.insert(i, boxes[i].min, boxes[i].max);
+        const double insertMs = msSince(t0);
+
+        // движение: 30 кадров по 1/30 с по одному update(), потом столько же батчем из потоков
+        const float dt = 1.0f / 30.0f;
+        const uint32_t frames = 30;
+        t0 = Clock::now();
+        for (uint32_t f = 0; f < frames; ++f) {
+            for (uint32_t i : movers) {
+                boxes[i].min += velocity[i] * dt;
+                boxes[i].max += velocity[i] * dt;
+                index.update(proxies[i], boxes[i].min, boxes[i].max);
+            }
+        }
+        const double singleMs = msSince(t0) / frames;
+
+        SpatialUpdateBuffer buffer;
+        double batchMs = 0.0;
+        uint32_t relinked = 0;
+        for (uint32_t f = 0; f < frames; ++f) {
+            t0 = Clock::now();
+            parallelFor(moving, 1024, [&](uint32_t b, uint32_t e) {
+                for (uint32_t k = b; k < e; ++k) {
+                    const uint32_t i = movers[k];
+                    boxes[i].min += velocity[i] * dt;
+                    boxes[i].max += velocity[i] * dt;
+                    buffer.push(proxies[i], boxes[i].min, boxes[i].max);
+                }
+            });
+            index.apply(buffer);
+            batchMs += msSince(t0);
+            relinked += index.stats().relinked;
+        }
+        batchMs /= frames;
+
+        // запросы
+        std::vector<uint32_t> got, want;
+        size_t found = 0;
+        double sphereMs = 0.0, sphereBrute = 0.0, boxMs = 0.0, boxBrute = 0.0, frustumMs = 0.0, frustumBrute = 0.0;
+        for (uint32_t i = 0; i < queryCount; ++i) {
+            const Vec3 c = q.centers[i];
+            const float r = 10.0f;
+            t0 = Clock::now();
+            index.querySphere(c, r, got);
+            sphereMs += msSince(t0);
+            t0 = Clock::now();
+            bruteForce(boxes, [&](const Box& b) {
+                float dx = std::max(std::max(b.min.x - c.x, 0.0f), c.x - b.max.x);
+                float dy = std::max(std::max(b.min.y - c.y, 0.0f), c.y - b.max.y);
+                float dz = std::max(std::max(b.min.z - c.z, 0.0f), c.z - b.max.z);
+                return dx * dx + dy * dy + dz * dz <= r * r;
+            }, want);
+            sphereBrute += msSince(t0);
+            ok = ok && sameSet(got, want);
+            found += got.size();
+
+            const Vec3 bmin = c - Vec3{ 10.0f, 10.0f, 10.0f }, bmax = c + Vec3{ 10.0f, 10.0f, 10.0f };
+            t0 = Clock::now();
+            index.queryAabb(bmin, bmax, got);
+            boxMs += msSince(t0);
+            t0 = Clock::now();
+            bruteForce(boxes, [&](const Box& b) {
+                return b.min.x <= bmax.x && b.max.x >= bmin.x && b.min.y <= bmax.y && b.max.y >= bmin.y &&
+                    b.min.z <= bmax.z && b.max.z >= bmin.z;
+            }, want);
+            boxBrute += msSince(t0);
+            ok = ok && sameSet(got, want);
+
+            const Frustum& fr = q.frustums[i];
+            t0 = Clock::now();
+            index.queryFrustum(fr, got);
+            frustumMs += msSince(t0);
+            t0 = Clock::now();
+            bruteForce(boxes, [&](const Box& b) { return fr.aabbVisible(b.min, b.max); }, want);
+            frustumBrute += msSince(t0);
+            ok = ok && sameSet(got, want);
+        }
+
+        const SpatialStats st = index.stats();
+        const double us = 1000.0 / queryCount;
+        std::printf("%s: %u cells, %u large\n", type == SpatialIndexType::HashedGrid ? "grid (4 m)" : "loose octree (8 levels)",
+            st.cells, st.large);
+        std::printf("  insert %.1f ns/object | move %u/frame: update() %.1f ns/move, batch %.1f ns/move (%.1f%% change cell)\n",
+            insertMs * 1e6 / count, moving, singleMs * 1e6 / moving, batchMs * 1e6 / moving,
+            100.0 * relinked / ((double)moving * frames));
+        std::printf("  sphere r10 %.2f us (brute %.1f us) | aabb 20m %.2f us (brute %.1f us) | frustum %.1f us (brute %.1f us) | %.1f hits/sphere\n",
+            sphereMs * us, sphereBrute * us, boxMs * us, boxBrute * us, frustumMs * us, frustumBrute * us, (double)found / queryCount);
+    }
+    if (!ok) std::cerr << "index results differ from brute force\n";
+
+    jobSystem().shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// darkwave_transformbench: иерархия трансформов (core/TransformHierarchy) на 100k узлов.
+//   darkwave_transformbench [--nodes N] [--moving PERCENT] [--frames N]
+// Лес: 1% узлов — корни, остальные цепляются к случайному уже созданному узлу (глубина ~log N).
+// Каждый кадр двигается --moving% случайных узлов (поворот + перенос), потом update(). Печатает:
+//   dirty   — обычный кадр: пересчёт только dirty-поддеревьев (среднее / p99 / узлов за кадр);
+//   full    — invalidateAll() + update(): все узлы, SIMD-пачки по уровням (один поток и потоки);
+//   naive   — рекурсивный обход по указателям детей, Mat4::mul на каждый узел, всё дерево.
+// Сверяет мировые матрицы с naive-версией.
+#include "core/TransformHierarchy.h"
+#include "core/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// эталон: классический граф сцены
+struct NaiveNode {
+    Vec3 t;
+    Quat r;
+    Vec3 s{ 1.0f, 1.0f, 1.0f };
+    std::vector<uint32_t> children;
+    Mat4 world;
+};
+
+void naiveUpdate(std::vector<NaiveNode>& nodes, uint32_t i, const Mat4& parent) {
+    NaiveNode& n = nodes[i];
+    n.world = Mat4::mul(parent, Mat4::fromTRS(n.t, n.r.x, n.r.y, n.r.z, n.r.w, n.s));
+    for (uint32_t c : n.children) naiveUpdate(nodes, c, n.world);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t nodeCount = 100000;
+    float movingPct = 1.0f;
+    uint32_t frames = 200;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--nodes" && i + 1 < argc) nodeCount = (uint32_t)std::max(2, std::atoi(argv[++i]));
+        else if (a == "--moving" && i + 1 < argc) movingPct = (float)std::atof(argv[++i]);
+        else if (a == "--frames" && i + 1 < argc) frames = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "usage: darkwave_transformbench [--nodes N] [--moving PERCENT] [--frames N]\n";
+            return 1;
+        }
+    }
+
+    jobSystem().init();
+
+    std::mt19937 rng(1234u);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    auto randomQuat = [&]() { return normalize(Quat{ u(rng), u(rng), u(rng), u(rng) + 2.0f }); };
+
+    TransformHierarchy h;
+    std::vector<TransformHandle> handles(nodeCount);
+    std::vector<NaiveNode> naive(nodeCount);
+    std::vector<uint32_t> roots;
+    const uint32_t rootCount = std::max(1u, nodeCount / 100);
+    for (uint32_t i = 0; i < nodeCount; ++i) {
+        NaiveNode& n = naive[i];
+        n.t = { u(rng) * 2.0f, u(rng) * 2.0f, u(rng) * 2.0f };
+        n.r = randomQuat();
+        n.s = { 1.0f + 0.05f * u(rng), 1.0f + 0.05f * u(rng), 1.0f + 0.05f * u(rng) };
+        if (i < rootCount) {
+            handles[i] = h.create({}, n.t, n.r, n.s);
+            roots.push_back(i);
+        }
+        else {
+            uint32_t p = (uint32_t)(rng() % i);
+            handles[i] = h.create(handles[p], n.t, n.r, n.s);
+            naive[p].children.push_back(i);
+        }
+    }
+
+    auto t0 = Clock::now();
+    h.update();
+    const double buildMs = msSince(t0);
+    std::printf("%u nodes, %u levels, %u threads; first update (order rebuild + all nodes): %.2f ms\n",
+        h.size(), h.stats().levels, jobSystem().workerCount(), buildMs);
+
+    // обычные кадры: movingPct% узлов двигаются
+    const uint32_t moving = std::max(1u, (uint32_t)(nodeCount * movingPct / 100.0f));
+    std::vector<double> frameMs;
+    uint64_t updatedTotal = 0;
+    for (uint32_t f = 0; f < frames; ++f) {
+        for (uint32_t k = 0; k < moving; ++k) {
+            uint32_t i = (uint32_t)(rng() % nodeCount);
+            NaiveNode& n = naive[i];
+            n.r = normalize(Quat::mul(Quat::rotationY(0.01f), n.r));
+            n.t = n.t + Vec3{ 0.001f, 0.0f, 0.0f };
+            h.setRotation(handles[i], n.r);
+            h.setTranslation(handles[i], n.t);
+        }
+        t0 = Clock::now();
+        updatedTotal += h.update();
+        frameMs.push_back(msSince(t0));
+    }
+    std::sort(frameMs.begin(), frameMs.end());
+    double sum = 0.0;
+    for (double ms : frameMs) sum += ms;
+    std::printf("dirty (%u moving/frame): avg %.3f ms  p99 %.3f ms  %.0f nodes updated/frame (%.1f ns/updated node)\n",
+        moving, sum / frames, frameMs[std::min(frameMs.size() - 1, (size_t)(frames * 0.99))],
+        (double)updatedTotal / frames, sum * 1e6 / std::max<uint64_t>(1, updatedTotal));
+
+    // сверка с эталоном: после кадров с dirty-пересчётом ничего не должно отстать
+    for (uint32_t r : roots) naiveUpdate(naive, r, Mat4::identity());
+    bool ok = true;
+    double maxErr = 0.0;
+    for (uint32_t i = 0; i < nodeCount; ++i) {
+        const Mat4& a = h.world(handles[i]);
+        const Mat4& b = naive[i].world;
+        for (int k = 0; k < 16; ++k) maxErr = std::max(maxErr, (double)std::fabs(a.m[k] - b.m[k]) / (1.0 + std::fabs(b.m[k])));
+    }
+    if (maxErr > 1e-4) {
+        std::cerr << "world matrix mismatch: " << maxErr << "\n";
+        ok = false;
+    }
+    std::printf("max relative error vs naive: %.2e\n", maxErr);
+
+    // полный пересчёт
+    auto best = [&](auto&& fn) {
+        double b = 1e30;
+        for (int it = 0; it < 10; ++it) {
+            auto s = Clock::now();
+            fn();
+            b = std::min(b, msSince(s));
+        }
+        return b;
+    };
+    h.setThreaded(false);
+    const double full1 = best([&] { h.invalidateAll(); h.update(); });
+    h.setThreaded(true);
+    const double fullN = best([&] { h.invalidateAll(); h.update(); });
+    const double naiveMs = best([&] { for (uint32_t r : roots) naiveUpdate(naive, r, Mat4::identity()); });
+    std::printf("full: simd %.2f ms (%.1f ns/node) | simd+mt %.2f ms (%.1f ns/node) | naive recursive %.2f ms (%.1f ns/node)\n",
+        full1, full1 * 1e6 / nodeCount, fullN, fullN * 1e6 / nodeCount, naiveMs, naiveMs * 1e6 / nodeCount);
+
+    jobSystem().shutdown();
+    return ok ? 0 : 1;
+}